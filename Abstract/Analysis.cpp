@@ -251,7 +251,11 @@ bool Analysis::contains(const ObjectiveSet::Type type) const noexcept {
 }
 
 bool Analysis::contains(const Objective::Type type) const noexcept {
-    for (const auto& objective : this->getObjectives()) {
+    if (type == Objective::Type::NODAL_DISPLACEMENT_ASSERTION
+            and not this->getNodalDisplacementAssertionTables().empty()) {
+        return true;
+    }
+    for (const auto& objective : this->getIndividualObjectives()) {
         if (type == objective->type) {
             return true;
         }
@@ -299,6 +303,52 @@ vector<shared_ptr<Assertion>> Analysis::getAssertions() const noexcept {
     return result;
 }
 
+vector<shared_ptr<Assertion>> Analysis::getIndividualAssertions() const noexcept {
+    vector<shared_ptr<Assertion>> result;
+    for (const auto& objectiveSet : getObjectiveSets()) {
+        if (objectiveSet == nullptr) {
+            continue;
+        }
+        for (const auto& objective : objectiveSet->getIndividualObjectives()) {
+            if (objective != nullptr and objective->isAssertion()) {
+                result.push_back(static_pointer_cast<Assertion>(objective));
+            }
+        }
+    }
+    return result;
+}
+
+vector<const NodalDisplacementAssertionTable*> Analysis::getNodalDisplacementAssertionTables() const noexcept {
+    vector<const NodalDisplacementAssertionTable*> result;
+    for (const auto& objectiveSet : getObjectiveSets()) {
+        if (objectiveSet == nullptr) {
+            continue;
+        }
+        const auto& tables = objectiveSet->getNodalDisplacementAssertionTables();
+        result.insert(result.end(), tables.begin(), tables.end());
+    }
+    return result;
+}
+
+vector<shared_ptr<Objective>> Analysis::getIndividualObjectives() const noexcept {
+    vector<shared_ptr<Objective>> result;
+    for (const auto& objectiveSet : getObjectiveSets()) {
+        if (objectiveSet == nullptr) {
+            continue;
+        }
+        for (const auto& objective : objectiveSet->getIndividualObjectives()) {
+            if (objective != nullptr) {
+                result.push_back(objective);
+            }
+        }
+    }
+    return result;
+}
+
+bool Analysis::hasAssertions() const noexcept {
+    return not getNodalDisplacementAssertionTables().empty() or not getIndividualAssertions().empty();
+}
+
 vector<shared_ptr<Objective>> Analysis::getObjectives() const noexcept {
     vector<shared_ptr<Objective>> result;
     for (const auto& objectiveSet : getObjectiveSets()) {
@@ -356,10 +406,13 @@ vector<shared_ptr<Loading>> Analysis::filter(const Loading::Type& type) const no
 
 vector<shared_ptr<Objective>> Analysis::filter(const Objective::Type& type) const noexcept {
     vector<shared_ptr<Objective>> objectives;
-    for (const auto& objective : getObjectives()) {
-        if (objective->type != type)
+    for (const auto& objectiveSet : getObjectiveSets()) {
+        if (objectiveSet == nullptr) {
             continue;
-        objectives.push_back(objective);
+        }
+        for (const auto& objective : objectiveSet->getObjectivesByType(type)) {
+            objectives.push_back(objective);
+        }
     }
     return objectives;
 }
@@ -428,21 +481,28 @@ bool Analysis::validate() const {
 
 
 void Analysis::removeSPCNodeDofs(SinglePointConstraint& spc, const pos_t nodePosition,  const DOFS dofsToRemove) {
-    const DOFS& remainingDofs = spc.getDOFSForNode(nodePosition) - dofsToRemove;
+    removeSPCNodeDofs(spc, PositionSet{nodePosition}, dofsToRemove);
+}
+
+void Analysis::removeSPCNodeDofs(SinglePointConstraint& spc, const PositionSet& nodePositions,  const DOFS dofsToRemove) {
+    if (nodePositions.empty()) {
+        return;
+    }
+    // All the nodes of a SinglePointConstraint share its dofs: a single spc holds what remains
+    const DOFS& remainingDofs = spc.getDOFSForNode(*nodePositions.begin()) - dofsToRemove;
     set<shared_ptr<ConstraintSet>, ptrLess<ConstraintSet>> affectedConstraintSets =
             model.getConstraintSetsByConstraint(
                     spc);
     if (not remainingDofs.empty()) {
         const auto& remainingSpc = make_shared<SinglePointConstraint>(this->model);
-        remainingSpc->addNodePosition(nodePosition);
+        remainingSpc->addNodePositions(nodePositions);
         for (const DOF& remainingDof : remainingDofs) {
             remainingSpc->setDOF(remainingDof, spc.getDoubleForDOF(remainingDof));
         }
         model.add(remainingSpc);
         if (model.configuration.logLevel >= LogLevel::TRACE) {
-            cout << "Created spc : " << *remainingSpc << " for node id : "
-                    << model.mesh.findNodeId(nodePosition)
-                    << " to handle dofs : " << remainingDofs << endl;
+            cout << "Created spc : " << *remainingSpc << " for " << nodePositions.size()
+                    << " node(s) to handle dofs : " << remainingDofs << endl;
         }
         for (const auto& constraintSet : affectedConstraintSets) {
             model.addConstraintIntoConstraintSet(*remainingSpc, *constraintSet);
@@ -452,16 +512,15 @@ void Analysis::removeSPCNodeDofs(SinglePointConstraint& spc, const pos_t nodePos
         const auto& otherAnalysesCS = make_shared<ConstraintSet>(model, ConstraintSet::Type::SPC);
         model.add(otherAnalysesCS);
         const auto& otherAnalysesSpc = make_shared<SinglePointConstraint>(this->model);
-        otherAnalysesSpc->addNodePosition(nodePosition);
+        otherAnalysesSpc->addNodePositions(nodePositions);
         for (DOF removedDof : dofsToRemove) {
             otherAnalysesSpc->setDOF(removedDof, spc.getDoubleForDOF(removedDof));
         }
         model.add(otherAnalysesSpc);
         model.addConstraintIntoConstraintSet(*otherAnalysesSpc, *otherAnalysesCS);
         if (this->model.configuration.logLevel >= LogLevel::TRACE) {
-            cout << "Created spc : " << *otherAnalysesSpc << " for node id : "
-                    << model.mesh.findNodeId(nodePosition)
-                    << " to handle dofs : " << dofsToRemove << endl;
+            cout << "Created spc : " << *otherAnalysesSpc << " for " << nodePositions.size()
+                    << " node(s) to handle dofs : " << dofsToRemove << endl;
         }
         for (const auto& otherAnalysis : this->model.analyses) {
             if (this->getReference() == otherAnalysis->getReference()) {
@@ -476,7 +535,7 @@ void Analysis::removeSPCNodeDofs(SinglePointConstraint& spc, const pos_t nodePos
             }
         }
     }
-    spc.removeNodePosition(nodePosition);
+    spc.removeNodePositionsExcludingGroups(nodePositions);
 }
 
 void Analysis::addBoundaryDOFS(const pos_t nodePosition, const DOFS dofs) {
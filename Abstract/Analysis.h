@@ -126,6 +126,17 @@ public:
     std::vector<std::shared_ptr<Loading>> getLoadings() const noexcept;
     std::vector<std::shared_ptr<BoundaryCondition>> getBoundaryConditions() const noexcept;
     std::vector<std::shared_ptr<Assertion>> getAssertions() const noexcept;
+    /**
+     * retrieve the assertions stored one by one, without the rows of
+     * nodal displacement assertion tables (see getNodalDisplacementAssertionTables)
+     */
+    std::vector<std::shared_ptr<Assertion>> getIndividualAssertions() const noexcept;
+    std::vector<const NodalDisplacementAssertionTable*> getNodalDisplacementAssertionTables() const noexcept;
+    std::vector<std::shared_ptr<Objective>> getIndividualObjectives() const noexcept;
+    /**
+     * Return true if the analysis has at least one assertion, individual or in a table.
+     */
+    bool hasAssertions() const noexcept;
     std::vector<std::shared_ptr<Objective>> getObjectives() const noexcept;
 
     std::vector<std::shared_ptr<ConstraintSet>> filter(const ConstraintSet::Type& type) const noexcept;
@@ -141,6 +152,10 @@ public:
     bool hasSPC() const noexcept;
 
     void removeSPCNodeDofs(SinglePointConstraint& spc, pos_t nodePosition, const DOFS dofs);
+    /**
+     * Removes the same dofs from several nodes of a SinglePointConstraint at once.
+     */
+    void removeSPCNodeDofs(SinglePointConstraint& spc, const PositionSet& nodePositions, const DOFS dofs);
     void addBoundaryDOFS(pos_t nodePosition, const DOFS dofs);
     DOFS findBoundaryDOFS(const pos_t nodePosition) const;
     std::set<pos_t> boundaryNodePositions() const;
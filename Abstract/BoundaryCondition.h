@@ -30,7 +30,7 @@ public:
 	    return false;
 	}
 	virtual DOFS getDOFSForNode(const pos_t nodePosition) const = 0;
-	virtual std::set<pos_t> nodePositions() const = 0;
+	virtual PositionSet nodePositions() const = 0;
 };
 
 } /* namespace vega */
@@ -25,7 +25,9 @@ ConfigurationParameters::ConfigurationParameters(string inputFile, Solver output
         string solverServer, string solverCommand, bool convertCompletelyRigidsIntoMPCs,
         string systusRBE2TranslationMode, double systusRBEStiffness, double systusRBECoefficient,
         string systusOptionAnalysis, string systusOutputProduct, vector<vector<int> > systusSubcases,
-        string systusOutputMatrix, int systusSizeMatrix, string systusDynamicMethod, string nastranOutputDialect) :
+        string systusOutputMatrix, int systusSizeMatrix, string systusDynamicMethod, string nastranOutputDialect,
+        string nastranInputMode, int nastranParserThreads, int asterMedChunkSize,
+        bool legacyDoubleDigits, int resultReaderThreads) :
                 inputFile(inputFile), outputSolver(outputSolver), solverVersion(solverVersion), outputFile(
                 outputFile), outputPath(outputPath), logLevel(logLevel), translationMode(
                 translationMode), resultFile(resultFile), testTolerance(tolerance), runSolver(
@@ -35,7 +37,9 @@ ConfigurationParameters::ConfigurationParameters(string inputFile, Solver output
                 systusRBECoefficient(systusRBECoefficient), systusOptionAnalysis(systusOptionAnalysis),
                 systusOutputProduct(systusOutputProduct), systusSubcases(systusSubcases),
                 systusOutputMatrix(systusOutputMatrix), systusSizeMatrix(systusSizeMatrix), systusDynamicMethod(systusDynamicMethod),
-                nastranOutputDialect(nastranOutputDialect)
+                nastranOutputDialect(nastranOutputDialect), nastranInputMode(nastranInputMode),
+                nastranParserThreads(nastranParserThreads), asterMedChunkSize(asterMedChunkSize),
+                legacyDoubleDigits(legacyDoubleDigits), resultReaderThreads(resultReaderThreads)
 {
 
 }
@@ -216,7 +216,9 @@ public:
             std::string systusOptionAnalysis="auto", std::string systusOutputProduct="systus",
             std::vector< std::vector<int> > systusSubcases = {},
             std::string systusOutputMatrix="table", int systusSizeMatrix=9,
-            std::string systusDynamicMethod="auto", std::string nastranOutputDialect="cosmic95");
+            std::string systusDynamicMethod="auto", std::string nastranOutputDialect="cosmic95",
+            std::string nastranInputMode="mmap", int nastranParserThreads=1, int asterMedChunkSize=0,
+            bool legacyDoubleDigits=false, int resultReaderThreads=1);
     ModelConfiguration getModelConfiguration() const;
 
     const std::string inputFile;
@@ -257,6 +259,30 @@ public:
      * Nastran syntax that should be written: cosmic95 or modern
      */
     const std::string nastranOutputDialect;
+    /**
+     * How Nastran input files are read: memory mapped 'mmap' (default) or through a 'stream'
+     */
+    const std::string nastranInputMode;
+    /**
+     * Number of threads converting the Nastran geometry cards: 1 (default) for a serial parsing,
+     * 0 for all the available cores.
+     */
+    const int nastranParserThreads;
+    /**
+     * Maximum number of nodes (or cells) written at once in the MED file: 0 (default) writes each
+     * array in one shot, a positive size streams them by chunks to bound the memory used.
+     */
+    const int asterMedChunkSize;
+    /**
+     * Writes doubles with DBL_DIG significant digits, as older versions did, instead of their round-trip
+     * exact representation: useful to compare translations with older ones.
+     */
+    const bool legacyDoubleDigits;
+    /**
+     * Number of threads parsing the sections of the result file (test file): 1 (default) for a
+     * serial parsing, 0 for all the available cores.
+     */
+    const int resultReaderThreads;
 };
 
 }
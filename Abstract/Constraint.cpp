@@ -74,25 +74,30 @@ void ConstraintSet::add(const Reference<ConstraintSet>& constraintSetReference)
     constraintSetReferences.push_back(constraintSetReference);
 }
 
-set<shared_ptr<Constraint>, ptrLess<Constraint> > ConstraintSet::getConstraints() const noexcept {
-    auto result = model.getConstraintsByConstraintSet(this->getReference());
+MemberView<Constraint> ConstraintSet::getConstraints() const noexcept {
+    const auto& ownConstraints = model.getConstraintsByConstraintSet(this->getReference());
+    if (constraintSetReferences.empty())
+        return ownConstraints;
+    set<shared_ptr<Constraint>, ptrLess<Constraint> > result(ownConstraints.begin(), ownConstraints.end());
     for (const auto& constraintSetReference : constraintSetReferences) {
         const auto& setToInsert = model.getConstraintsByConstraintSet(
                 constraintSetReference);
         result.insert(setToInsert.begin(), setToInsert.end());
     }
-    return result;
+    return MemberView<Constraint>(vector<shared_ptr<Constraint>>(result.begin(), result.end()));
 }
 
-set<shared_ptr<Constraint>, ptrLess<Constraint> > ConstraintSet::getConstraintsByType(
+MemberView<Constraint> ConstraintSet::getConstraintsByType(
         Constraint::Type type) const noexcept {
-    set<shared_ptr<Constraint>, ptrLess<Constraint> > result;
+    if (constraintSetReferences.empty())
+        return model.getConstraintsByConstraintSet(this->getReference(), type);
+    vector<shared_ptr<Constraint>> result;
     for (const auto& constraint : getConstraints()) {
         if (constraint->type == type) {
-            result.insert(constraint);
+            result.push_back(constraint);
         }
     }
-    return result;
+    return MemberView<Constraint>(move(result));
 }
 
 size_t ConstraintSet::size() const noexcept {
@@ -144,7 +149,7 @@ NodeConstraint::NodeConstraint(Model& model, Constraint::Type type, int original
 		Constraint(model, type, original_id), NodeContainer(model.mesh) {
 }
 
-set<pos_t> NodeConstraint::nodePositions() const {
+PositionSet NodeConstraint::nodePositions() const {
 	return getNodePositionsIncludingGroups();
 }
 
@@ -189,10 +194,10 @@ void MasterSlaveConstraint::removeNodePosition(const pos_t) {
     throw logic_error("removeNodePosition for MasterSlaveConstraint not implemented");
 }
 
-set<pos_t> MasterSlaveConstraint::getSlaves() const {
+PositionSet MasterSlaveConstraint::getSlaves() const {
     if (this->masterPosition != Globals::UNAVAILABLE_POS) {
-        std::set<pos_t> result = getNodePositionsIncludingGroups();
-        result.erase(result.find(this->masterPosition));
+        PositionSet result = getNodePositionsIncludingGroups();
+        result.erase(this->masterPosition);
         return result;
     } else {
         return getNodePositionsIncludingGroups();
@@ -425,12 +430,12 @@ SinglePointConstraint::SinglePointConstraint(Model& _model, int original_id) :
 }
 
 void SinglePointConstraint::setDOF(const DOF& dof, const ValueOrReference& value) {
-    spcs[dof.position] = value;
+    spcs[dof.position()] = value;
 }
 
 void SinglePointConstraint::setDOFS(const DOFS& dofs, const ValueOrReference& value) {
     for (DOF dof : dofs) {
-        spcs[dof.position] = value;
+        spcs[dof.position()] = value;
     }
 }
 
@@ -459,7 +464,7 @@ bool SinglePointConstraint::ineffective() const noexcept {
 }
 
 double SinglePointConstraint::getDoubleForDOF(const DOF& dof) const {
-    const ValueOrReference& spcVal = spcs[dof.position];
+    const ValueOrReference& spcVal = spcs[dof.position()];
     if (spcVal == NO_SPC) {
         cerr << "SPC" << *this << " requested getDoubleForDof, dof " << dof
                 << " but the dof is free.";
@@ -474,7 +479,7 @@ double SinglePointConstraint::getDoubleForDOF(const DOF& dof) const {
 }
 
 shared_ptr<Value> SinglePointConstraint::getReferenceForDOF(const DOF& dof) const {
-    const ValueOrReference& spcVal = spcs[dof.position];
+    const ValueOrReference& spcVal = spcs[dof.position()];
     if (spcVal == NO_SPC) {
         cerr << "SPC" << *this << " requested getValueForDOF, dof " << dof
                 << " but the dof is free.";
@@ -500,7 +505,7 @@ void SinglePointConstraint::emulateLocalDisplacementConstraint() {
             if (model.configuration.logLevel >= LogLevel::TRACE)
                 cout << "Replacing local spc " << *this << " for: " << node << ",dofs " << this->getDOFSForNode(nodePosition) << endl;
             for (char i = 0; i < 6; i++) {
-                const DOF& currentDOF = *DOF::dofByPosition[i];
+                const DOF currentDOF = DOF::findByPosition(static_cast<dof_int>(i));
                 if (dofs.contains(currentDOF)) {
                     const VectorialValue& participation = coordSystem->vectorToGlobal(
                             VectorialValue::XYZ[i % 3]);
@@ -549,8 +554,8 @@ void LinearMultiplePointConstraint::addParticipation(int nodeId, double dx, doub
         dofCoefsByNodePosition[nodePosition] += DOFCoefs(dx, dy, dz, rx, ry, rz);
 }
 
-set<pos_t> LinearMultiplePointConstraint::nodePositions() const {
-    set<pos_t> result;
+PositionSet LinearMultiplePointConstraint::nodePositions() const {
+    PositionSet result;
     for (const auto& it : dofCoefsByNodePosition) {
         result.insert(it.first);
     }
@@ -626,8 +631,8 @@ vector<shared_ptr<Gap::GapParticipation>> GapTwoNodes::getGaps() const {
     return result;
 }
 
-set<pos_t> GapTwoNodes::nodePositions() const {
-    set<pos_t> result;
+PositionSet GapTwoNodes::nodePositions() const {
+    PositionSet result;
     for (const auto& it : directionNodePositionByconstrainedNodePosition) {
         result.insert(it.first);
     }
@@ -682,8 +687,8 @@ vector<shared_ptr<Gap::GapParticipation>> GapNodeDirection::getGaps() const {
     return result;
 }
 
-set<pos_t> GapNodeDirection::nodePositions() const {
-    set<pos_t> result;
+PositionSet GapNodeDirection::nodePositions() const {
+    PositionSet result;
     for (const auto& it : directionBynodePosition) {
         result.insert(it.first);
     }
@@ -735,8 +740,8 @@ double SlideContact::getFriction() const {
     }
 }
 
-set<pos_t> SlideContact::nodePositions() const {
-    set<pos_t> result;
+PositionSet SlideContact::nodePositions() const {
+    PositionSet result;
     const auto& masterLine = dynamic_pointer_cast<BoundaryNodeLine>(model.find(master));
     if (masterLine == nullptr) {
         throw logic_error("Cannot find master node list");
@@ -774,8 +779,8 @@ SurfaceContact::SurfaceContact(Model& model, Reference<Target> master, Reference
     Contact(model, Constraint::Type::SURFACE_CONTACT, original_id), master(master), slave(slave) {
 }
 
-set<pos_t> SurfaceContact::nodePositions() const {
-    set<pos_t> result;
+PositionSet SurfaceContact::nodePositions() const {
+    PositionSet result;
     const auto& masterSurface = dynamic_pointer_cast<BoundaryNodeSurface>(model.find(master));
     if (masterSurface== nullptr) {
         throw logic_error("Cannot find master node list");
@@ -861,8 +866,8 @@ ZoneContact::ZoneContact(Model& model, Reference<Target> master, Reference<Targe
 }
 
 
-set<pos_t> ZoneContact::nodePositions() const {
-    set<pos_t> result;
+PositionSet ZoneContact::nodePositions() const {
+    PositionSet result;
     const auto& masterBody = dynamic_pointer_cast<ContactBody>(model.find(master));
     if (masterBody == nullptr) {
         throw logic_error("Cannot find master body in zone contact");
@@ -920,8 +925,8 @@ SurfaceSlide::SurfaceSlide(Model& model, Reference<Target> master, Reference<Tar
     Constraint(model, Constraint::Type::SURFACE_SLIDE_CONTACT, original_id), master(master), slave(slave) {
 }
 
-set<pos_t> SurfaceSlide::nodePositions() const {
-    set<pos_t> result;
+PositionSet SurfaceSlide::nodePositions() const {
+    PositionSet result;
     const auto& masterBoundary = dynamic_pointer_cast<BoundaryElementFace>(model.find(master));
     if (masterBoundary == nullptr) {
         throw logic_error("Cannot find master body boundary in surface slide");
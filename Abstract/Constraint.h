@@ -87,8 +87,8 @@ public:
 	static const std::map<Type, std::string> stringByType;
 	std::string getGroupName() const noexcept;
 	void add(const Reference<ConstraintSet>&); // LD Hack : see parseSPCADD
-	std::set<std::shared_ptr<Constraint>, ptrLess<Constraint>> getConstraints() const noexcept;
-	std::set<std::shared_ptr<Constraint>, ptrLess<Constraint>> getConstraintsByType(Constraint::Type) const noexcept;
+	MemberView<Constraint> getConstraints() const noexcept;
+	MemberView<Constraint> getConstraintsByType(Constraint::Type) const noexcept;
 	size_t size() const noexcept;
 	inline bool empty() const noexcept {return size() == 0;};
 	std::shared_ptr<ConstraintSet> clone() const;
@@ -103,7 +103,7 @@ class NodeConstraint: public Constraint, public NodeContainer {
 protected:
 	NodeConstraint(Model&, Constraint::Type, const int original_id = NO_ORIGINAL_ID);
 public:
-	std::set<pos_t> nodePositions() const override final;
+	PositionSet nodePositions() const override final;
 	bool isNodeLoading() const noexcept override final {
 		return true;
 	}
@@ -125,7 +125,7 @@ public:
 	virtual void addSlave(int slaveId);
 	virtual pos_t getMaster() const;
 	virtual bool hasMaster() const noexcept;
-	virtual std::set<pos_t> getSlaves() const final;
+	virtual PositionSet getSlaves() const final;
 	DOFS getDOFS() const;
 	void removeNodePosition(const pos_t nodePosition) override;
 };
@@ -218,7 +218,7 @@ public:
     void addParticipation(int nodeId, double dx = 0, double dy = 0, double dz = 0, double rx = 0,
             double ry = 0, double rz = 0);
     DOFCoefs getDoFCoefsForNode(const pos_t nodePosition) const;
-    std::set<pos_t> nodePositions() const override final;
+    PositionSet nodePositions() const override final;
     DOFS getDOFSForNode(const pos_t nodePosition) const override;
     void removeNodePosition(const pos_t nodePosition) override;
     bool ineffective() const override;
@@ -255,7 +255,7 @@ private:
 public:
 	GapTwoNodes(Model& model, int original_id = NO_ORIGINAL_ID);
 	void addGapNodes(int constrainedNodeId, int directionNodeId);
-	std::set<pos_t> nodePositions() const override;
+	PositionSet nodePositions() const override;
 	DOFS getDOFSForNode(const pos_t nodePosition) const override;
 	std::vector<std::shared_ptr<GapParticipation>> getGaps() const override;
 	void removeNodePosition(pos_t nodePosithasFunctionsion) override;
@@ -269,7 +269,7 @@ public:
 	GapNodeDirection(Model& model, int original_id = NO_ORIGINAL_ID);
 	void addGapNodeDirection(int constrainedNodeId, double directionX, double directionY = 0,
 			double directionZ = 0);
-	std::set<pos_t> nodePositions() const override;
+	PositionSet nodePositions() const override;
 	DOFS getDOFSForNode(const pos_t nodePosition) const override;
 	std::vector<std::shared_ptr<GapParticipation>> getGaps() const override;
 	void removeNodePosition(const pos_t nodePosition) override;
@@ -290,7 +290,7 @@ public:
     std::shared_ptr<CellGroup> masterCellGroup = nullptr;
     std::shared_ptr<CellGroup> slaveCellGroup = nullptr;
     int coordinateSystemPos = CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID;
-	std::set<pos_t> nodePositions() const override;
+	PositionSet nodePositions() const override;
 	DOFS getDOFSForNode(const pos_t nodePosition) const override;
 	void removeNodePosition(const pos_t nodePosition) override;
 	bool ineffective() const override;
@@ -306,7 +306,7 @@ public:
     const Reference<Target> slave;
     std::shared_ptr<CellGroup> masterCellGroup = nullptr;
     std::shared_ptr<CellGroup> slaveCellGroup = nullptr;
-	std::set<pos_t> nodePositions() const override;
+	PositionSet nodePositions() const override;
 	DOFS getDOFSForNode(const pos_t nodePosition) const override;
 	void removeNodePosition(const pos_t nodePosition) override;
 	void makeBoundarySurfaces();
@@ -321,7 +321,7 @@ public:
 	ZoneContact(Model& model, Reference<Target> master, Reference<Target> slave, int original_id = NO_ORIGINAL_ID);
     const Reference<Target> master;
     const Reference<Target> slave;
-	std::set<pos_t> nodePositions() const override;
+	PositionSet nodePositions() const override;
 	DOFS getDOFSForNode(const pos_t nodePosition) const override;
 	void removeNodePosition(const pos_t nodePosition) override;
 	bool ineffective() const override;
@@ -335,7 +335,7 @@ public:
 	SurfaceSlide(Model& model, Reference<Target> master, Reference<Target> slave, int original_id = NO_ORIGINAL_ID);
     const Reference<Target> master;
     const Reference<Target> slave;
-	std::set<pos_t> nodePositions() const override;
+	PositionSet nodePositions() const override;
 	DOFS getDOFSForNode(const pos_t nodePosition) const override;
 	void removeNodePosition(const pos_t nodePosition) override;
 	bool ineffective() const override;
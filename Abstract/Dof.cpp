@@ -9,75 +9,30 @@
  */
 
 #include "Dof.h"
-#include <boost/lexical_cast.hpp>
-#include <boost/bimap/list_of.hpp>
-#include <boost/assign.hpp>
+#include <algorithm>
 #include <ciso646>
 #include <math.h>
 
 namespace vega {
 using namespace std;
 
-unordered_map<DOF::Code, DOF*, EnumClassHash> DOF::dofByCode;
-unordered_map<dof_int, DOF*> DOF::dofByPosition;
+constexpr const char* DOF::LABELS[6];
+constexpr DOF::Code DOF::CODE_BY_POSITION[6];
 
-DOF::DOF(Code _code, bool _isTranslation, bool _isRotation, const string _label, dof_int _position) noexcept :
-		code(_code), isTranslation(_isTranslation), isRotation(_isRotation), label(_label), position(
-				_position) {
-	dofByCode[code] = this;
-	dofByPosition[position] = this;
-}
-
-bool DOF::operator<(const DOF& other) const noexcept {
-	return this->code < other.code;
-}
-
-bool DOF::operator==(const DOF& other) const noexcept {
-	return this->code == other.code;
-}
-
-dof_int DOF::operator|(const DOF& other) const noexcept {
-	return static_cast<dof_int>(this->code) | static_cast<dof_int>(other.code);
-}
-
-const DOF DOF::DX(DOF::Code::DX_CODE, true, false, "DX", 0);
-const DOF DOF::DY(DOF::Code::DY_CODE, true, false, "DY", 1);
-const DOF DOF::DZ(DOF::Code::DZ_CODE, true, false, "DZ", 2);
-const DOF DOF::RX(DOF::Code::RX_CODE, false, true, "RX", 3);
-const DOF DOF::RY(DOF::Code::RY_CODE, false, true, "RY", 4);
-const DOF DOF::RZ(DOF::Code::RZ_CODE, false, true, "RZ", 5);
-
-DOF DOF::findByPosition(dof_int position) {
-	if (position > 5) {
-        throw invalid_argument("DOF Position not allowed : "+std::to_string(position));
-	}
-	auto dofIter = dofByPosition.find(position);
-	if (dofIter == dofByPosition.end()) {
-		throw invalid_argument("unexpected error");
-	}
-	return *(dofIter->second);
-}
-
-DOF::operator dof_int() const noexcept {
-	return static_cast<dof_int>(code);
-}
+const DOF DOF::DX(DOF::Code::DX_CODE);
+const DOF DOF::DY(DOF::Code::DY_CODE);
+const DOF DOF::DZ(DOF::Code::DZ_CODE);
+const DOF DOF::RX(DOF::Code::RX_CODE);
+const DOF DOF::RY(DOF::Code::RY_CODE);
+const DOF DOF::RZ(DOF::Code::RZ_CODE);
 
 ostream &operator<<(ostream &out, const DOF& dof) noexcept {
-	out << dof.label;
+	out << dof.label();
 	return out;
 }
 
 const double DOFS::FREE_DOF = -DBL_MAX;
 
-const boost::bimap<int, DOF::Code> DOFS::DOF_BY_NASTRANCODE = boost::assign::list_of<
-		boost::bimap<int, DOF::Code>::relation>
-		( 1, DOF::Code::DX_CODE )
-		( 2, DOF::Code::DY_CODE )
-		( 3, DOF::Code::DZ_CODE )
-		( 4, DOF::Code::RX_CODE )
-		( 5, DOF::Code::RY_CODE )
-		( 6, DOF::Code::RZ_CODE );
-
 const DOFS DOFS::NO_DOFS(static_cast<char>(0));
 const DOFS DOFS::TRANSLATIONS(static_cast<char>(static_cast<char>(DOF::Code::DX_CODE) | static_cast<char>(DOF::Code::DY_CODE) | static_cast<char>(DOF::Code::DZ_CODE)));
 const DOFS DOFS::ROTATIONS(static_cast<char>(static_cast<char>(DOF::Code::RX_CODE) | static_cast<char>(DOF::Code::RY_CODE) | static_cast<char>(DOF::Code::RZ_CODE)));
@@ -167,12 +122,12 @@ int DOFS::size() const noexcept {
 }
 
 int DOFS::nastranCode() const noexcept {
-	string dofsString = "";
+	// Nastran components are the digits of the (1-based) dof positions, in increasing order
+	int result = 0;
 	for (DOF dof : *this) {
-		int dofCode = DOF_BY_NASTRANCODE.right.find(dof.code)->second;
-		dofsString += to_string(dofCode);
+		result = result * 10 + dof.position() + 1;
 	}
-	return dofsString.empty() ? 0: boost::lexical_cast<int>(dofsString);
+	return result;
 }
 
 // Should be in NastranTokenizer, imho
@@ -188,11 +143,10 @@ DOFS DOFS::nastranCodeToDOFS(int nastranCode) {
 	while (number) {
 		int nastranDigit = number % 10;
 		number = number / 10;
-		auto codeiter = DOF_BY_NASTRANCODE.left.find(nastranDigit);
-		if (codeiter == DOF_BY_NASTRANCODE.left.end()) {
-			throw invalid_argument("Invalid Nastran code: " + nastranCode);
+		if (nastranDigit < 1 or nastranDigit > 6) {
+			throw invalid_argument("Invalid Nastran code: " + to_string(nastranCode));
 		}
-		DOFS internalDOFCode {static_cast<char>(codeiter->second)};
+		DOFS internalDOFCode {DOF::findByPosition(static_cast<dof_int>(nastranDigit - 1))};
 		dofs += internalDOFCode;
 	}
 	return dofs;
@@ -353,7 +307,7 @@ bool DOFMatrix::hasRotations() const noexcept {
 	for (const auto& kv : componentByDofs) {
 		DOF dof1 = kv.first.first;
 		DOF dof2 = kv.first.second;
-		if (dof1.isRotation or dof2.isRotation) {
+		if (dof1.isRotation() or dof2.isRotation()) {
 			hasRotations = true;
 			break;
 		}
@@ -366,7 +320,7 @@ bool DOFMatrix::hasTranslations() const noexcept {
 	for (const auto& kv : componentByDofs) {
 		DOF dof1 = kv.first.first;
 		DOF dof2 = kv.first.second;
-		if (dof1.isTranslation or dof2.isTranslation) {
+		if (dof1.isTranslation() or dof2.isTranslation()) {
 			hasTranslations = true;
 			break;
 		}
@@ -464,6 +418,144 @@ bool DOFMatrix::isEqual(const DOFMatrix& other) const noexcept {
     return true;
 }
 
+namespace {
+// Components of a block between two translations, or between two rotations
+const uint64_t TRANSLATION_COMPONENTS = 0x7ull | 0x7ull << 6 | 0x7ull << 12;
+const uint64_t ROTATION_COMPONENTS = 0x7ull << 21 | 0x7ull << 27 | 0x7ull << 33;
+}
+
+bool DOFBlockMatrix::Block::hasTranslations() const noexcept {
+	return (definedMask & ~ROTATION_COMPONENTS) != 0;
+}
+
+bool DOFBlockMatrix::Block::hasRotations() const noexcept {
+	return (definedMask & ~TRANSLATION_COMPONENTS) != 0;
+}
+
+const size_t DOFBlockMatrix::MAX_PENDING_COMPONENTS;
+
+DOFBlockMatrix::DOFBlockMatrix(MatrixType _matrixType) noexcept : matrixType(_matrixType) {
+}
+
+void DOFBlockMatrix::addComponent(pos_t rowNode, DOF rowDof, pos_t colNode, DOF colDof, const double value) {
+	if (matrixType == MatrixType::DIAGONAL and (rowNode != colNode or rowDof != colDof) and not is_zero(value)) {
+		throw logic_error("Cannot assign non-zero value out of diagonal for a diagonal matrix");
+	}
+	if (matrixType == MatrixType::SYMMETRIC
+			and (rowNode > colNode or (rowNode == colNode and colDof < rowDof))) {
+		swap(rowNode, colNode);
+		swap(rowDof, colDof);
+	}
+	pending.push_back({rowNode, colNode, rowDof.position(), colDof.position(), value});
+	if (pending.size() >= MAX_PENDING_COMPONENTS) {
+		compress();
+	}
+}
+
+void DOFBlockMatrix::clear() noexcept {
+	pending.clear();
+	rowNodes.clear();
+	rowOffsets.clear();
+	colNodes.clear();
+	blocks.clear();
+}
+
+size_t DOFBlockMatrix::blockCount() const {
+	compress();
+	return blocks.size();
+}
+
+const DOFBlockMatrix::Block* DOFBlockMatrix::findBlock(const pos_t rowNode, const pos_t colNode) const {
+	compress();
+	const auto rowIt = lower_bound(rowNodes.begin(), rowNodes.end(), rowNode);
+	if (rowIt == rowNodes.end() or *rowIt != rowNode) {
+		return nullptr;
+	}
+	const auto row = static_cast<size_t>(rowIt - rowNodes.begin());
+	const auto colBegin = colNodes.begin() + static_cast<ptrdiff_t>(rowOffsets[row]);
+	const auto colEnd = colNodes.begin() + static_cast<ptrdiff_t>(rowOffsets[row + 1]);
+	const auto colIt = lower_bound(colBegin, colEnd, colNode);
+	if (colIt == colEnd or *colIt != colNode) {
+		return nullptr;
+	}
+	return &blocks[static_cast<size_t>(colIt - colNodes.begin())];
+}
+
+PositionSet DOFBlockMatrix::nodePositions() const {
+	compress();
+	PositionSet result;
+	result.insert(rowNodes.begin(), rowNodes.end());
+	result.insert(colNodes.begin(), colNodes.end());
+	return result;
+}
+
+void DOFBlockMatrix::compress() const {
+	if (pending.empty()) {
+		return;
+	}
+	// stable: the last of several components given for the same dofs wins
+	stable_sort(pending.begin(), pending.end(), [](const PendingComponent& a, const PendingComponent& b) {
+		return a.rowNode < b.rowNode or (a.rowNode == b.rowNode and a.colNode < b.colNode);
+	});
+	vector<pos_t> mergedRowNodes;
+	vector<size_t> mergedRowOffsets;
+	vector<pos_t> mergedColNodes;
+	vector<Block> mergedBlocks;
+	size_t pendingBlocks = 1;
+	for (size_t i = 1; i < pending.size(); i++) {
+		if (pending[i].rowNode != pending[i - 1].rowNode or pending[i].colNode != pending[i - 1].colNode) {
+			pendingBlocks++;
+		}
+	}
+	mergedColNodes.reserve(colNodes.size() + pendingBlocks);
+	mergedBlocks.reserve(blocks.size() + pendingBlocks);
+	auto append = [&](const pos_t rowNode, const pos_t colNode, const Block& block) {
+		if (mergedRowNodes.empty() or mergedRowNodes.back() != rowNode) {
+			mergedRowNodes.push_back(rowNode);
+			mergedRowOffsets.push_back(mergedBlocks.size());
+		}
+		mergedColNodes.push_back(colNode);
+		mergedBlocks.push_back(block);
+	};
+	// merges the blocks already compressed with the pending components, both ordered by row then column
+	size_t row = 0;
+	size_t stored = 0;
+	auto next = pending.begin();
+	while (stored < blocks.size() or next != pending.end()) {
+		while (stored < blocks.size() and stored >= rowOffsets[row + 1]) {
+			row++;
+		}
+		const bool storedFirst = next == pending.end()
+				or (stored < blocks.size() and (rowNodes[row] < next->rowNode
+						or (rowNodes[row] == next->rowNode and colNodes[stored] < next->colNode)));
+		if (storedFirst) {
+			append(rowNodes[row], colNodes[stored], blocks[stored]);
+			stored++;
+			continue;
+		}
+		const pos_t rowNode = next->rowNode;
+		const pos_t colNode = next->colNode;
+		if (stored < blocks.size() and rowNodes[row] == rowNode and colNodes[stored] == colNode) {
+			append(rowNode, colNode, blocks[stored]);
+			stored++;
+		} else {
+			append(rowNode, colNode, Block());
+		}
+		Block& block = mergedBlocks.back();
+		for (; next != pending.end() and next->rowNode == rowNode and next->colNode == colNode; ++next) {
+			block.setComponent(DOF::findByPosition(next->rowPosition), DOF::findByPosition(next->colPosition),
+					next->value);
+		}
+	}
+	mergedRowOffsets.push_back(mergedBlocks.size());
+	rowNodes.swap(mergedRowNodes);
+	rowOffsets.swap(mergedRowOffsets);
+	colNodes.swap(mergedColNodes);
+	blocks.swap(mergedBlocks);
+	pending.clear();
+	pending.shrink_to_fit();
+}
+
 DOFCoefs::DOFCoefs(double dx, double dy, double dz, double rx, double ry, double rz) noexcept {
     coefs[0] = dx;
     coefs[1] = dy;
@@ -476,25 +568,25 @@ DOFCoefs::DOFCoefs(double dx, double dy, double dz, double rx, double ry, double
 DOFCoefs::DOFCoefs(DOFS dofs, double val) noexcept {
     for(const DOF dof : DOFS::ALL_DOFS) {
         if (dofs.contains(dof))
-            coefs[dof.position] = val;
+            coefs[dof.position()] = val;
         else
-            coefs[dof.position] = Globals::UNAVAILABLE_DOUBLE;
+            coefs[dof.position()] = Globals::UNAVAILABLE_DOUBLE;
     }
 }
 
 DOFCoefs::DOFCoefs(DOF dof, double val) noexcept {
     for(const DOF dof2 : DOFS::ALL_DOFS) {
         if (dof2 == dof)
-            coefs[dof2.position] = val;
+            coefs[dof2.position()] = val;
         else
-            coefs[dof2.position] = Globals::UNAVAILABLE_DOUBLE;
+            coefs[dof2.position()] = Globals::UNAVAILABLE_DOUBLE;
     }
 }
 
 DOFS DOFCoefs::getDOFS() const noexcept {
     DOFS dofs;
     for(const DOF dof : DOFS::ALL_DOFS) {
-        if (not is_equal(coefs[dof.position], Globals::UNAVAILABLE_DOUBLE))
+        if (not is_equal(coefs[dof.position()], Globals::UNAVAILABLE_DOUBLE))
             dofs += dof;
     }
     return dofs;
@@ -502,18 +594,18 @@ DOFS DOFCoefs::getDOFS() const noexcept {
 
 bool DOFCoefs::isEmpty() const noexcept {
     for(const DOF dof : DOFS::ALL_DOFS) {
-        if (not is_equal(coefs[dof.position], Globals::UNAVAILABLE_DOUBLE))
+        if (not is_equal(coefs[dof.position()], Globals::UNAVAILABLE_DOUBLE))
             return false;
     }
     return true;
 }
 
 double DOFCoefs::getValue(const DOF dof) const noexcept {
-    return coefs[dof.position];
+    return coefs[dof.position()];
 }
 
 void DOFCoefs::setValue(const DOF dof, double val) noexcept {
-    coefs[dof.position] = val;
+    coefs[dof.position()] = val;
 }
 
 DOFCoefs& DOFCoefs::operator+=(const DOFCoefs& rv) noexcept {
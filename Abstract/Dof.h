@@ -13,14 +13,26 @@
 
 #include <cfloat>
 #include "Value.h"
-#include <boost/bimap.hpp>
+#include <array>
+#include <cstdint>
 #include <unordered_map>
 #include <set>
+#include <vector>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace vega {
 
 using dof_int = unsigned char;
 
+/**
+ * A single degree of freedom. It is a one byte value (its code), label and kind
+ * are read from constant tables, so copying or comparing DOFs never allocates.
+ */
 class DOF {
 private:
 	friend std::ostream &operator<<(std::ostream &out, const DOF& node) noexcept;
@@ -34,10 +46,6 @@ public:
 		RZ_CODE = 32
 	};
 
-	// enum class value DECLARATIONS - they are defined later
-	static std::unordered_map<DOF::Code, DOF*, EnumClassHash> dofByCode;
-	static std::unordered_map<dof_int, DOF*> dofByPosition;
-
 	static const DOF DX;
 	static const DOF DY;
 	static const DOF DZ;
@@ -46,25 +54,56 @@ public:
 	static const DOF RZ;
 
 private:
-	DOF(Code code, bool isTranslation, bool isRotation, const std::string label, dof_int position) noexcept;
+	static constexpr const char* LABELS[6] = {"DX", "DY", "DZ", "RX", "RY", "RZ"};
+	static constexpr Code CODE_BY_POSITION[6] = {Code::DX_CODE, Code::DY_CODE, Code::DZ_CODE,
+			Code::RX_CODE, Code::RY_CODE, Code::RZ_CODE};
 public:
 	Code code;
-	bool isTranslation;
-	bool isRotation;
-	std::string label;
-	dof_int position;
 
-	static DOF findByPosition(dof_int position);
-	bool operator<(const DOF& other) const noexcept;
-	bool operator==(const DOF& other) const noexcept;
-	dof_int operator|(const DOF& other) const noexcept;
-	operator dof_int() const noexcept;
+	constexpr DOF(Code _code) noexcept : code(_code) {
+	}
+	constexpr dof_int position() const noexcept {
+		return code == Code::DX_CODE ? 0 : code == Code::DY_CODE ? 1 : code == Code::DZ_CODE ? 2 :
+				code == Code::RX_CODE ? 3 : code == Code::RY_CODE ? 4 : 5;
+	}
+	constexpr bool isTranslation() const noexcept {
+		return static_cast<dof_int>(code) < static_cast<dof_int>(Code::RX_CODE);
+	}
+	constexpr bool isRotation() const noexcept {
+		return !isTranslation();
+	}
+	constexpr const char* label() const noexcept {
+		return LABELS[position()];
+	}
+
+	static constexpr DOF findByPosition(dof_int position) {
+		return position > 5 ?
+				throw std::invalid_argument("DOF Position not allowed : "+std::to_string(position)) :
+				DOF(CODE_BY_POSITION[position]);
+	}
+	constexpr bool operator<(const DOF& other) const noexcept {
+		return code < other.code;
+	}
+	constexpr bool operator==(const DOF& other) const noexcept {
+		return code == other.code;
+	}
+	constexpr bool operator!=(const DOF& other) const noexcept {
+		return code != other.code;
+	}
+	constexpr dof_int operator|(const DOF& other) const noexcept {
+		return static_cast<dof_int>(static_cast<dof_int>(code) | static_cast<dof_int>(other.code));
+	}
+	constexpr operator dof_int() const noexcept {
+		return static_cast<dof_int>(code);
+	}
 };
 
+static_assert(sizeof(DOF) == 1, "DOF should fit in one byte");
+static_assert(std::is_trivially_copyable<DOF>::value, "DOF should be trivially copyable");
+static_assert(DOF::findByPosition(4).code == DOF::Code::RY_CODE, "DOF lookup tables should be usable at compile time");
+
 class DOFS {
 private:
-	static const boost::bimap<int, DOF::Code> DOF_BY_NASTRANCODE;
-
 	friend DOFS operator+(const DOFS lhs, const DOFS& rhs) noexcept;
 	friend DOFS operator-(const DOFS lhs, const DOFS& rhs) noexcept;
 	friend DOFS operator+(const DOFS lhs, const DOF& rhs) noexcept;
@@ -188,6 +227,109 @@ public:
 		std::vector<double> asColumnsVector(bool addRotationsIfNotPresent) const noexcept;
 };
 
+/**
+ * Sparse matrix between the dofs of several nodes, stored as 6x6 blocks (one for each couple of nodes)
+ * in compressed rows of blocks (BSR).
+ *
+ * Components are first appended to a pending list, which is compressed into the blocks on the first
+ * read (or when it grows too much): later components overwrite earlier ones, as in DOFMatrix.
+ * A SYMMETRIC matrix only stores its upper triangle: row node <= column node and, in diagonal
+ * blocks, row dof <= column dof.
+ */
+class DOFBlockMatrix final {
+public:
+	class Block final {
+	private:
+		friend class DOFBlockMatrix;
+		std::array<double, 36> values;
+		uint64_t definedMask = 0; /**< One bit for each component that was set **/
+		static constexpr unsigned int index(const DOF rowDof, const DOF colDof) noexcept {
+			return rowDof.position() * 6u + colDof.position();
+		}
+	public:
+		Block() noexcept {
+			values.fill(0.0);
+		}
+		void setComponent(const DOF rowDof, const DOF colDof, const double value) noexcept {
+			values[index(rowDof, colDof)] = value;
+			definedMask |= uint64_t(1) << index(rowDof, colDof);
+		}
+		/**
+		 * Value of the component as stored (no symmetry applied), zero if it was never set.
+		 */
+		double findComponent(const DOF rowDof, const DOF colDof) const noexcept {
+			return values[index(rowDof, colDof)];
+		}
+		bool empty() const noexcept {
+			return definedMask == 0;
+		}
+		bool hasTranslations() const noexcept;
+		bool hasRotations() const noexcept;
+		static inline unsigned int lowestSetBit(const uint64_t mask) noexcept {
+#ifdef _MSC_VER
+			unsigned long result;
+			_BitScanForward64(&result, mask);
+			return static_cast<unsigned int>(result);
+#else
+			return static_cast<unsigned int>(__builtin_ctzll(mask));
+#endif
+		}
+		/**
+		 * Calls visitor(rowDof, colDof, value) for each component that was set, row by row.
+		 */
+		template<typename Visitor>
+		void visitComponents(Visitor&& visitor) const {
+			for (uint64_t mask = definedMask; mask != 0; mask &= mask - 1) {
+				const auto i = lowestSetBit(mask);
+				visitor(DOF::findByPosition(static_cast<dof_int>(i / 6)),
+						DOF::findByPosition(static_cast<dof_int>(i % 6)), values[i]);
+			}
+		}
+	};
+	static const size_t MAX_PENDING_COMPONENTS = 1 << 20;
+	const MatrixType matrixType;
+
+	explicit DOFBlockMatrix(MatrixType matrixType) noexcept;
+	void addComponent(pos_t rowNode, DOF rowDof, pos_t colNode, DOF colDof, const double value);
+	void clear() noexcept;
+	bool empty() const noexcept {
+		return pending.empty() and blocks.empty();
+	}
+	size_t blockCount() const;
+	/**
+	 * @return the stored block, or nullptr (no symmetry applied: for a SYMMETRIC matrix rowNode must not
+	 * be greater than colNode).
+	 */
+	const Block* findBlock(const pos_t rowNode, const pos_t colNode) const;
+	PositionSet nodePositions() const;
+	/**
+	 * Calls visitor(rowNode, colNode, block) for each stored block, ordered by row node then column node.
+	 */
+	template<typename Visitor>
+	void visitBlocks(Visitor&& visitor) const {
+		compress();
+		for (size_t row = 0; row < rowNodes.size(); row++) {
+			for (size_t i = rowOffsets[row]; i < rowOffsets[row + 1]; i++) {
+				visitor(rowNodes[row], colNodes[i], blocks[i]);
+			}
+		}
+	}
+private:
+	struct PendingComponent {
+		pos_t rowNode;
+		pos_t colNode;
+		unsigned char rowPosition;
+		unsigned char colPosition;
+		double value;
+	};
+	mutable std::vector<PendingComponent> pending;
+	mutable std::vector<pos_t> rowNodes;     /**< Sorted row nodes having at least one block **/
+	mutable std::vector<size_t> rowOffsets;  /**< First block of each row in colNodes and blocks, plus the end **/
+	mutable std::vector<pos_t> colNodes;     /**< Column node of each block, sorted inside a row **/
+	mutable std::vector<Block> blocks;
+	void compress() const;
+};
+
 
 /**
  * This class regroups one coefficient by DOF.
@@ -224,7 +366,7 @@ namespace std {
 template<>
 struct hash<vega::DOF> {
 	size_t operator()(const vega::DOF& dof) const noexcept {
-		return hash<int>()(dof.position);
+		return hash<int>()(dof.position());
 	}
 };
 
@@ -1046,102 +1046,53 @@ double ISectionBeam::getShearAreaFactorZ() const {
 }
 
 MatrixElement::MatrixElement(Model& model, Type elementType, MatrixType matrixType, int original_id) :
-		CellElementSet(model, elementType, model.modelType, original_id), matrixType{matrixType} {
+		CellElementSet(model, elementType, model.modelType, original_id), components{matrixType}, matrixType{matrixType} {
 }
 
 void MatrixElement::addComponent(const int nodeid1, const DOF dof1, const int nodeid2, const DOF dof2, const double value) {
-	pos_t nodePosition1 = model.mesh.findOrReserveNode(nodeid1);
-	pos_t nodePosition2 = model.mesh.findOrReserveNode(nodeid2);
-	DOF myDof1 = dof1;
-	DOF myDof2 = dof2;
-
-	if (nodePosition1 > nodePosition2) {
-		const auto swapPos = nodePosition2;
-		nodePosition2 = nodePosition1;
-		nodePosition1 = swapPos;
-		myDof1 = dof2;
-		myDof2 = dof1;
+	if (matrixType != MatrixType::SYMMETRIC) {
+		throw logic_error("not yet implemented");
 	}
-	auto it = submatrixByNodes.find({nodePosition1, nodePosition2});
-	shared_ptr<DOFMatrix> subMatrix = nullptr;
-	if (it != submatrixByNodes.end()) {
-		subMatrix = it->second;
-	} else {
-	    if (matrixType == MatrixType::SYMMETRIC and nodePosition1 != nodePosition2) {
-            // a triangular symmetric matrix has the upper right block which is full (see K_TR_L)
-            subMatrix = make_shared<DOFMatrix>(MatrixType::FULL);
-	    } else if (matrixType == MatrixType::SYMMETRIC and nodePosition1 == nodePosition2) {
-	        subMatrix = make_shared<DOFMatrix>(MatrixType::SYMMETRIC);
-	    } else {
-            throw logic_error("not yet implemented");
-	    }
-		this->submatrixByNodes[{nodePosition1, nodePosition2}] = subMatrix;
-	}
-    subMatrix->addComponent(myDof1, myDof2, value);
+	const pos_t nodePosition1 = model.mesh.findOrReserveNode(nodeid1);
+	const pos_t nodePosition2 = model.mesh.findOrReserveNode(nodeid2);
+	components.addComponent(nodePosition1, dof1, nodePosition2, dof2, value);
 }
 
 void MatrixElement::clear() noexcept {
-    submatrixByNodes.clear();
+    components.clear();
     CellContainer::clear();
 }
 
-
 shared_ptr<const DOFMatrix> MatrixElement::findSubmatrix(const pos_t nodePosition1, const pos_t nodePosition2) const {
 	shared_ptr<DOFMatrix> result = make_shared<DOFMatrix>(matrixType);
-	auto it = submatrixByNodes.find({nodePosition1, nodePosition2});
-	if (it != submatrixByNodes.end()) {
-		std::copy(it->second->componentByDofs.begin(), it->second->componentByDofs.end(),
-				std::inserter(result->componentByDofs, result->componentByDofs.end()));
+	const auto block = components.findBlock(nodePosition1, nodePosition2);
+	if (block != nullptr) {
+		block->visitComponents([&result](const DOF rowDof, const DOF colDof, const double value) {
+			result->componentByDofs[{rowDof, colDof}] = value;
+		});
 	}
 	return result;
 }
 
-set<pos_t> MatrixElement::nodePositions() const {
-	set<pos_t> result;
-	for (const auto& kv : submatrixByNodes) {
-		result.insert(kv.first.first);
-		result.insert(kv.first.second);
-	}
-	return result;
+PositionSet MatrixElement::nodePositions() const {
+	return components.nodePositions();
 }
 
 DOFS MatrixElement::getDOFSForNode(const pos_t nodePosition) const {
 	DOFS dofs;
-	for (const auto& kv : submatrixByNodes) {
-		if (kv.first.first == nodePosition or kv.first.second) {
-			if (kv.second->hasRotations()) {
+	components.visitBlocks([&dofs, nodePosition](const pos_t rowNode, const pos_t colNode, const DOFBlockMatrix::Block& block) {
+		if (rowNode == nodePosition or colNode == nodePosition) {
+			if (block.hasRotations()) {
 				dofs += DOFS::ROTATIONS;
 			}
-			if (kv.second->hasTranslations()) {
+			if (block.hasTranslations()) {
 				dofs += DOFS::TRANSLATIONS;
 			}
 		}
-	}
+	});
 	return dofs;
 }
 
-set<pair<pos_t, pos_t>> MatrixElement::nodePairs() const {
-	set<pair<pos_t, pos_t>> result;
-	for (const auto& kv : submatrixByNodes) {
-		result.insert({kv.first.first, kv.first.second});
-	}
-	return result;
-}
-
-std::set<std::pair<pos_t, pos_t>> MatrixElement::findInPairs(const pos_t nodePosition) const {
-	set<pair<pos_t, pos_t>> result;
-	for (const auto& kv : submatrixByNodes) {
-		if (kv.first.first != nodePosition and kv.first.second != nodePosition) {
-			continue;
-		}
-		if (kv.first.first == kv.first.second) {
-			continue;
-		}
-		result.insert({kv.first.first, kv.first.second});
-	}
-	return result;
-}
-
 StiffnessMatrix::StiffnessMatrix(Model& model, MatrixType matrixType, int original_id) :
 		MatrixElement(model, ElementSet::Type::STIFFNESS_MATRIX, matrixType, original_id) {
 }
@@ -85,8 +85,8 @@ public:
     virtual bool validate() const override;
     virtual std::unique_ptr<ElementSet> clone() const = 0;
     virtual DOFS getDOFSForNode(const pos_t nodePosition) const = 0;
-    virtual std::set<pos_t> nodePositions() const = 0;
-    virtual std::set<pos_t> cellPositions() const = 0;
+    virtual PositionSet nodePositions() const = 0;
+    virtual PositionSet cellPositions() const = 0;
     virtual double getAdditionalRho() const {
         return 0;
     }
@@ -117,10 +117,10 @@ protected:
             int original_id = NO_ORIGINAL_ID);
 public:
     using CellContainer::add;
-    virtual std::set<pos_t> nodePositions() const override {
+    virtual PositionSet nodePositions() const override {
         return getNodePositionsIncludingGroups();
     }
-    virtual std::set<pos_t> cellPositions() const override {
+    virtual PositionSet cellPositions() const override {
         return getCellPositionsIncludingGroups();
     }
     virtual void add(const CellGroup& cellGroup) noexcept override final {
@@ -547,7 +547,7 @@ class NodalMass: public CellElementSet {
 /* Matrix for a group nodes.*/
 class MatrixElement : public CellElementSet {
 private:
-	std::map<std::pair<pos_t, pos_t>, std::shared_ptr<DOFMatrix>> submatrixByNodes;
+	DOFBlockMatrix components;
 public:
 	MatrixElement(Model&, Type type, MatrixType matrixType, int original_id = NO_ORIGINAL_ID);
 	const MatrixType matrixType;
@@ -556,16 +556,20 @@ public:
 	 * Clear all nodes and submatrices of the Matrix.
 	 */
 	void clear() noexcept override final;
+	/**
+	 * Components stored by couple of node positions (upper triangle of blocks).
+	 */
+	const DOFBlockMatrix& getComponents() const noexcept {
+		return components;
+	}
 	std::shared_ptr<const DOFMatrix> findSubmatrix(const pos_t nodePosition1, const pos_t nodePosition2) const;
-	std::set<pos_t> nodePositions() const override final;
-	std::set<std::pair<pos_t, pos_t>> nodePairs() const;
-	std::set<std::pair<pos_t, pos_t>> findInPairs(const pos_t nodePosition) const;
+	PositionSet nodePositions() const override final;
 	DOFS getDOFSForNode(const pos_t nodePosition) const override final;
 	bool isMatrixElement() const override final {
 		return true;
 	}
     virtual bool effective() const override {
-        return not submatrixByNodes.empty();
+        return not components.empty();
     }
 	virtual bool validate() const override {
 		return true;
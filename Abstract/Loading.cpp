@@ -12,6 +12,8 @@
 #include "Model.h"
 //if with "or" and "and" under windows
 #include <ciso646>
+#include <algorithm>
+#include <numeric>
 
 namespace vega {
 
@@ -90,18 +92,12 @@ size_t LoadSet::size() const {
 	return getLoadings().size();
 }
 
-set<shared_ptr<Loading>, ptrLess<Loading> > LoadSet::getLoadings() const {
+MemberView<Loading> LoadSet::getLoadings() const {
 	return model.getLoadingsByLoadSet(this->getReference());
 }
 
-set<shared_ptr<Loading>, ptrLess<Loading> > LoadSet::getLoadingsByType(Loading::Type loadingType) const {
-	set<shared_ptr<Loading>, ptrLess<Loading> > result;
-	for (const auto& loading : getLoadings()) {
-		if (loading->type == loadingType) {
-			result.insert(loading);
-		}
-	}
-	return result;
+MemberView<Loading> LoadSet::getLoadingsByType(Loading::Type loadingType) const {
+	return model.getLoadingsByLoadSet(this->getReference(), loadingType);
 }
 
 bool LoadSet::validate() const {
@@ -132,7 +128,7 @@ NodeLoading::NodeLoading(Model& model, const std::shared_ptr<LoadSet> loadset, L
 		Loading(model, loadset, type, original_id, csref), NodeContainer(model.mesh) {
 }
 
-set<pos_t> NodeLoading::nodePositions() const {
+PositionSet NodeLoading::nodePositions() const {
 	return NodeContainer::getNodePositionsIncludingGroups();
 }
 
@@ -150,7 +146,7 @@ DOFS Gravity::getDOFSForNode(const pos_t nodePosition) const {
 	UNUSEDV(nodePosition);
 	return DOFS::NO_DOFS;
 }
-set<pos_t> Gravity::nodePositions() const {
+PositionSet Gravity::nodePositions() const {
 	return {};
 }
 
@@ -188,7 +184,7 @@ DOFS Rotation::getDOFSForNode(const pos_t nodePosition) const {
 	return DOFS::NO_DOFS;
 }
 
-set<pos_t> Rotation::nodePositions() const {
+PositionSet Rotation::nodePositions() const {
 	return {};
 }
 
@@ -272,7 +268,7 @@ double ImposedDisplacement::getDoubleForDOF(const DOF& dof) const {
 
 void ImposedDisplacement::scale(const double factor) {
     for(DOF dof : DOFS::ALL_DOFS) {
-        if (not is_equal(displacements[dof.position], Globals::UNAVAILABLE_DOUBLE))
+        if (not is_equal(displacements[dof.position()], Globals::UNAVAILABLE_DOUBLE))
             displacements *= factor;
     }
 }
@@ -288,12 +284,17 @@ NodalForce::NodalForce(Model& model, const std::shared_ptr<LoadSet> loadset, dou
 }
 
 VectorialValue NodalForce::localToGlobal(const pos_t nodePosition, const VectorialValue& vectorialValue) const {
-	if (!hasCoordinateSystem())
+	return localToGlobal(nodePosition, vectorialValue, csref);
+}
+
+VectorialValue NodalForce::localToGlobal(const pos_t nodePosition, const VectorialValue& vectorialValue,
+		const Reference<CoordinateSystem>& coordinateSystemReference) const {
+	if (coordinateSystemReference == CoordinateSystem::GLOBAL_COORDINATE_SYSTEM)
 		return vectorialValue;
-	const auto& coordSystem = model.mesh.findCoordinateSystem(csref);
+	const auto& coordSystem = model.mesh.findCoordinateSystem(coordinateSystemReference);
 	if (!coordSystem) {
 		ostringstream oss;
-		oss << "Coordinate system: " << csref
+		oss << "Coordinate system: " << coordinateSystemReference
 				<< " for nodal force not found." << endl;
 		throw logic_error(oss.str());
 	}
@@ -316,6 +317,14 @@ VectorialValue NodalForce::getMomentInGlobalCS(const pos_t nodePosition) const {
 	return localToGlobal(nodePosition, moment);
 }
 
+vector<NodalForce::NodeForce> NodalForce::getForcesInGlobalCS() const {
+	vector<NodeForce> result;
+	for (const pos_t nodePosition : nodePositions()) {
+		result.push_back({nodePosition, getForceInGlobalCS(nodePosition), getMomentInGlobalCS(nodePosition)});
+	}
+	return result;
+}
+
 DOFS NodalForce::getDOFSForNode(const pos_t nodePosition) const {
 	DOFS dofs(DOFS::NO_DOFS);
 	const auto& posSet = nodePositions();
@@ -351,6 +360,151 @@ bool NodalForce::ineffective() const {
 	return force.iszero() and moment.iszero();
 }
 
+NodalForceTable::NodalForceTable(Model& model, const std::shared_ptr<LoadSet> loadset) :
+		NodalForce(model, loadset, 0.0) {
+}
+
+void NodalForceTable::add(int nodeId, int csId, const VectorialValue& force, const VectorialValue& moment,
+		int lineNumber) {
+	if (force.iszero() and moment.iszero())
+		return; // would have been removed as an ineffective NodalForce
+	const pos_t nodePosition = model.mesh.findOrReserveNode(nodeId);
+	addNodePosition(nodePosition);
+	positions.push_back(nodePosition);
+	coordinateSystemIds.push_back(csId);
+	components.insert(components.end(), {force.x(), force.y(), force.z(), moment.x(), moment.y(), moment.z()});
+	lineNumbers.push_back(lineNumber);
+}
+
+const vector<size_t>& NodalForceTable::sortedRows() const {
+	if (rowsByNode.size() != positions.size()) {
+		rowsByNode.resize(positions.size());
+		iota(rowsByNode.begin(), rowsByNode.end(), 0);
+		stable_sort(rowsByNode.begin(), rowsByNode.end(), [this](size_t row1, size_t row2) {
+			return positions[row1] < positions[row2];
+		});
+	}
+	return rowsByNode;
+}
+
+pair<vector<size_t>::const_iterator, vector<size_t>::const_iterator> NodalForceTable::rowsOfNode(
+		const pos_t nodePosition) const {
+	const auto& rows = sortedRows();
+	const auto& first = lower_bound(rows.begin(), rows.end(), nodePosition, [this](size_t row, pos_t position) {
+		return positions[row] < position;
+	});
+	const auto& last = upper_bound(first, rows.end(), nodePosition, [this](pos_t position, size_t row) {
+		return position < positions[row];
+	});
+	return {first, last};
+}
+
+VectorialValue NodalForceTable::rowForceInGlobalCS(size_t row) const {
+	return localToGlobal(positions[row],
+			VectorialValue(components[6 * row], components[6 * row + 1], components[6 * row + 2]),
+			Reference<CoordinateSystem>(CoordinateSystem::Type::ABSOLUTE, coordinateSystemIds[row]));
+}
+
+VectorialValue NodalForceTable::rowMomentInGlobalCS(size_t row) const {
+	return localToGlobal(positions[row],
+			VectorialValue(components[6 * row + 3], components[6 * row + 4], components[6 * row + 5]),
+			Reference<CoordinateSystem>(CoordinateSystem::Type::ABSOLUTE, coordinateSystemIds[row]));
+}
+
+VectorialValue NodalForceTable::getForceInGlobalCS(const pos_t nodePosition) const {
+	const auto& range = rowsOfNode(nodePosition);
+	if (range.first == range.second)
+		throw logic_error("Requested node has not been assigned to this loading");
+	VectorialValue result(0, 0, 0);
+	for (auto it = range.first; it != range.second; ++it) {
+		result = result + rowForceInGlobalCS(*it);
+	}
+	return result;
+}
+
+VectorialValue NodalForceTable::getMomentInGlobalCS(const pos_t nodePosition) const {
+	const auto& range = rowsOfNode(nodePosition);
+	if (range.first == range.second)
+		throw logic_error("Requested node has not been assigned to this loading");
+	VectorialValue result(0, 0, 0);
+	for (auto it = range.first; it != range.second; ++it) {
+		result = result + rowMomentInGlobalCS(*it);
+	}
+	return result;
+}
+
+vector<NodalForce::NodeForce> NodalForceTable::getForcesInGlobalCS() const {
+	vector<NodeForce> result;
+	for (const size_t row : sortedRows()) {
+		if (result.empty() or result.back().nodePosition != positions[row]) {
+			result.push_back({positions[row], rowForceInGlobalCS(row), rowMomentInGlobalCS(row)});
+		} else {
+			result.back().force = result.back().force + rowForceInGlobalCS(row);
+			result.back().moment = result.back().moment + rowMomentInGlobalCS(row);
+		}
+	}
+	return result;
+}
+
+DOFS NodalForceTable::getDOFSForNode(const pos_t nodePosition) const {
+	// Union of the rows, as if each row was a NodalForce
+	DOFS dofs(DOFS::NO_DOFS);
+	const auto& range = rowsOfNode(nodePosition);
+	for (auto it = range.first; it != range.second; ++it) {
+		const VectorialValue& globalForce = rowForceInGlobalCS(*it);
+		const VectorialValue& globalTorque = rowMomentInGlobalCS(*it);
+		if (!is_zero(globalForce.x()))
+			dofs += DOF::DX;
+		if (!is_zero(globalForce.y()))
+			dofs += DOF::DY;
+		if (!is_zero(globalForce.z()))
+			dofs += DOF::DZ;
+		if (!is_zero(globalTorque.x()))
+			dofs += DOF::RX;
+		if (!is_zero(globalTorque.y()))
+			dofs += DOF::RY;
+		if (!is_zero(globalTorque.z()))
+			dofs += DOF::RZ;
+	}
+	return dofs;
+}
+
+unique_ptr<Loading> NodalForceTable::clone() const {
+	return make_unique<NodalForceTable>(*this);
+}
+
+void NodalForceTable::scale(const double factor) {
+	for (auto& component : components) {
+		component *= factor;
+	}
+}
+
+bool NodalForceTable::ineffective() const {
+	for (const auto component : components) {
+		if (!is_zero(component))
+			return false;
+	}
+	return true;
+}
+
+bool NodalForceTable::validate() const {
+	bool valid = Loading::validate();
+	set<int> checkedIds{CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID};
+	for (size_t row = 0; row < coordinateSystemIds.size(); row++) {
+		const int csId = coordinateSystemIds[row];
+		if (not checkedIds.insert(csId).second)
+			continue;
+		const Reference<CoordinateSystem> csref(CoordinateSystem::Type::ABSOLUTE, csId);
+		if (model.mesh.findCoordinateSystem(csref) == nullptr) {
+			// the input context of the table is the one of its first row
+			cerr << "Coordinate system:" << csref << " for loading " << *this << " (node "
+					<< model.mesh.findNodeId(positions[row]) << ", line " << lineNumbers[row] << ") not found." << endl;
+			valid = false;
+		}
+	}
+	return valid;
+}
+
 NodalForceTwoNodes::NodalForceTwoNodes(Model& model, const std::shared_ptr<LoadSet> loadset, const int node1_id,
 		const int node2_id, double magnitude, const int original_id) :
 		NodalForce(model, loadset, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, original_id, CoordinateSystem::GLOBAL_COORDINATE_SYSTEM), node_position1(
@@ -513,7 +667,7 @@ CellLoading::CellLoading(Model& model, const std::shared_ptr<LoadSet> loadset, L
 		Loading(model, loadset, type, original_id, csref), CellContainer(model.mesh) {
 }
 
-set<pos_t> CellLoading::nodePositions() const {
+PositionSet CellLoading::nodePositions() const {
 	return CellContainer::getNodePositionsIncludingGroups();
 }
 
@@ -836,7 +990,7 @@ shared_ptr<FunctionPlaceHolder> DynamicExcitation::getFunctionTablePPlaceHolder(
     return make_unique<FunctionPlaceHolder>(model, functionTableP.type, functionTableP.original_id, Function::ParaName::FREQ);
 }
 
-set<pos_t> DynamicExcitation::nodePositions() const {
+PositionSet DynamicExcitation::nodePositions() const {
     return {};
 }
 
@@ -20,6 +20,7 @@
 #include "Reference.h"
 #include <climits>
 #include <tuple>
+#include <vector>
 
 namespace vega {
 
@@ -99,8 +100,8 @@ public:
 	static const std::map<Type, std::string> stringByType;
 	size_t size() const;
 	inline bool empty() const noexcept { return size() == 0;};
-	std::set<std::shared_ptr<Loading>, ptrLess<Loading> > getLoadings() const;
-	std::set<std::shared_ptr<Loading>, ptrLess<Loading> > getLoadingsByType(Loading::Type) const;
+	MemberView<Loading> getLoadings() const;
+	MemberView<Loading> getLoadingsByType(Loading::Type) const;
 	std::string getGroupName() const noexcept;
 	bool validate() const override;
 	std::unique_ptr<LoadSet> clone() const;
@@ -116,7 +117,7 @@ protected:
 	NodeLoading(Model&, const std::shared_ptr<LoadSet> loadset, Loading::Type, const int original_id = NO_ORIGINAL_ID,
 			const Reference<CoordinateSystem> csref = CoordinateSystem::GLOBAL_COORDINATE_SYSTEM);
 public:
-	std::set<pos_t> nodePositions() const override final;
+	PositionSet nodePositions() const override final;
 	SpaceDimension getLoadingDimension() const {
 		return SpaceDimension::DIMENSION_0D;
 	}
@@ -153,7 +154,7 @@ public:
 	Gravity(Model&, const std::shared_ptr<LoadSet> loadset, double scalingFactor, const VectorialValue& gravityVector,
 			const int original_id = NO_ORIGINAL_ID);
 	DOFS getDOFSForNode(const pos_t nodePosition) const override;
-	std::set<pos_t> nodePositions() const override;
+	PositionSet nodePositions() const override;
 	std::unique_ptr<Loading> clone() const override;
 	void scale(const double factor) override;
 	bool ineffective() const override;
@@ -177,7 +178,7 @@ public:
 	 */
 	virtual VectorialValue getCenter() const = 0;
 	DOFS getDOFSForNode(const pos_t nodePosition) const override;
-	std::set<pos_t> nodePositions() const override;
+	PositionSet nodePositions() const override;
 	bool ineffective() const override;
 };
 
@@ -238,17 +239,63 @@ public:
 			const Reference<CoordinateSystem> csref = CoordinateSystem::GLOBAL_COORDINATE_SYSTEM);
 protected:
 	VectorialValue localToGlobal(const pos_t nodePosition, const VectorialValue&) const;
+	VectorialValue localToGlobal(const pos_t nodePosition, const VectorialValue&, const Reference<CoordinateSystem>&) const;
 	VectorialValue force;
 	VectorialValue moment;
 public:
+	/**
+	 * Force and moment applied on a node, in the global coordinate system.
+	 */
+	struct NodeForce {
+		pos_t nodePosition;
+		VectorialValue force;
+		VectorialValue moment;
+	};
 	virtual VectorialValue getForceInGlobalCS(const pos_t nodePosition) const;
 	virtual VectorialValue getMomentInGlobalCS(const pos_t nodePosition) const;
+	/**
+	 * Forces and moments of every node of the loading, by increasing node position.
+	 */
+	virtual std::vector<NodeForce> getForcesInGlobalCS() const;
 	DOFS getDOFSForNode(const pos_t nodePosition) const override;
 	std::unique_ptr<Loading> clone() const override;
 	void scale(const double factor) override;
 	bool ineffective() const override;
 };
 
+/**
+ * Nodal forces and moments of a LoadSet stored by columns, one row per card (see Nastran FORCE, MOMENT).
+ * Rows applied on the same node are summed when the forces are requested.
+ */
+class NodalForceTable final: public NodalForce {
+	std::vector<pos_t> positions;
+	std::vector<int> coordinateSystemIds;
+	std::vector<double> components; /**< FX, FY, FZ, MX, MY, MZ of each row */
+	std::vector<int> lineNumbers; /**< Input line of each row, for the diagnostics */
+	mutable std::vector<size_t> rowsByNode; /**< Rows sorted by node position, built on demand */
+	const std::vector<size_t>& sortedRows() const;
+	std::pair<std::vector<size_t>::const_iterator, std::vector<size_t>::const_iterator> rowsOfNode(const pos_t nodePosition) const;
+	VectorialValue rowForceInGlobalCS(size_t row) const;
+	VectorialValue rowMomentInGlobalCS(size_t row) const;
+public:
+	NodalForceTable(Model&, const std::shared_ptr<LoadSet> loadset);
+	/**
+	 * Append a row: force and moment are given in the coordinate system csId.
+	 * lineNumber is the input line of the card, reported by validate().
+	 */
+	void add(int nodeId, int csId, const VectorialValue& force, const VectorialValue& moment = VectorialValue(0, 0, 0),
+			int lineNumber = -1);
+	inline size_t rowCount() const noexcept {return positions.size();};
+	VectorialValue getForceInGlobalCS(const pos_t nodePosition) const override;
+	VectorialValue getMomentInGlobalCS(const pos_t nodePosition) const override;
+	std::vector<NodeForce> getForcesInGlobalCS() const override;
+	DOFS getDOFSForNode(const pos_t nodePosition) const override;
+	std::unique_ptr<Loading> clone() const override;
+	void scale(const double factor) override;
+	bool ineffective() const override;
+	bool validate() const override;
+};
+
 class NodalForceTwoNodes: public NodalForce {
 	const pos_t node_position1;
 	const pos_t node_position2;
@@ -311,7 +358,7 @@ public:
 	 * Return true if all cells are of the dimension passed as parameter.
 	 */
 	bool cellDimensionGreatherThan(SpaceDimension dimension);
-	std::set<pos_t> nodePositions() const override final;
+	PositionSet nodePositions() const override final;
 	virtual SpaceDimension getLoadingDimension() const = 0;
     virtual std::vector<int> getApplicationFaceNodeIds() const = 0;
 	bool isCellLoading() const noexcept override final {
@@ -474,7 +521,7 @@ public:
     std::shared_ptr<LoadSet> getLoadSet() const;
     std::shared_ptr<FunctionPlaceHolder> getFunctionTableBPlaceHolder() const;
     std::shared_ptr<FunctionPlaceHolder> getFunctionTablePPlaceHolder() const;
-    std::set<pos_t> nodePositions() const override;
+    PositionSet nodePositions() const override;
     DOFS getDOFSForNode(const pos_t nodePosition) const override;
     void scale(const double factor) override;
     std::unique_ptr<Loading> clone() const override;
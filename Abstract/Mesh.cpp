@@ -20,8 +20,11 @@
 #include <boost/geometry/algorithms/comparable_distance.hpp>
 #include "Model.h"
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <cfloat>
+#include <functional>
 #include <utility>
 #include <iostream>
 #include <iterator>
@@ -32,6 +35,7 @@
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -42,8 +46,117 @@ namespace fs = boost::filesystem;
 
 const double NodeStorage::RESERVED_POSITION = -DBL_MAX;
 
-NodeData::NodeData(int id, const DOFS& dofs, double x, double y, double z, pos_t cpPos, pos_t cdPos, int nodePart) :
-    id(id), dofs(dofs), x(x), y(y), z(z), cpPos(cpPos), cdPos(cdPos), nodePart(nodePart) {
+/**
+ * Id index
+ */
+
+const size_t IdIndex::DENSE_SLACK;
+const size_t IdIndex::DENSE_RATIO;
+
+pos_t IdIndex::find(const int id) const noexcept {
+	if (dense) {
+		if (id < 0 or static_cast<size_t>(id) >= positionById.size()) {
+			return Globals::UNAVAILABLE_POS;
+		}
+		return positionById[static_cast<size_t>(id)];
+	}
+	return slots[slotOf(id)].second;
+}
+
+size_t IdIndex::slotOf(const int id) const noexcept {
+	// Fibonacci hashing, then linear probing until the id or an empty slot is found
+	const size_t mask = slots.size() - 1;
+	size_t slot = (static_cast<uint64_t>(static_cast<uint32_t>(id)) * UINT64_C(0x9E3779B97F4A7C15)) >> hashShift;
+	while (slots[slot].second != Globals::UNAVAILABLE_POS and slots[slot].first != id) {
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+void IdIndex::insertSlot(const int id, const pos_t position) noexcept {
+	auto& slot = slots[slotOf(id)];
+	if (slot.second == Globals::UNAVAILABLE_POS) {
+		entryCount++;
+	}
+	slot = {id, position};
+}
+
+void IdIndex::rehash(const size_t capacity) {
+	vector<Entry> oldSlots;
+	oldSlots.swap(slots);
+	slots.assign(capacity, {0, Globals::UNAVAILABLE_POS});
+	hashShift = 64;
+	for (size_t c = capacity; c > 1; c >>= 1) {
+		hashShift--;
+	}
+	entryCount = 0;
+	for (const auto& entry : oldSlots) {
+		if (entry.second != Globals::UNAVAILABLE_POS) {
+			insertSlot(entry.first, entry.second);
+		}
+	}
+}
+
+void IdIndex::set(const int id, const pos_t position) {
+	sortedEntries = nullptr;
+	if (dense) {
+		const size_t maxSize = max(DENSE_SLACK, DENSE_RATIO * (entryCount + 1));
+		if (id >= 0 and static_cast<size_t>(id) < maxSize) {
+			const size_t index = static_cast<size_t>(id);
+			if (index >= positionById.size()) {
+				positionById.resize(min(maxSize, max(index + 1, 2 * positionById.size())), Globals::UNAVAILABLE_POS);
+			}
+			if (positionById[index] == Globals::UNAVAILABLE_POS) {
+				entryCount++;
+			}
+			positionById[index] = position;
+			return;
+		}
+		// Too sparse: moving the ids to a hash table
+		size_t capacity = 16;
+		while (capacity < 2 * (entryCount + 1)) {
+			capacity <<= 1;
+		}
+		rehash(capacity);
+		for (size_t index = 0; index < positionById.size(); index++) {
+			if (positionById[index] != Globals::UNAVAILABLE_POS) {
+				insertSlot(static_cast<int>(index), positionById[index]);
+			}
+		}
+		vector<pos_t>().swap(positionById);
+		dense = false;
+	}
+	if (2 * (entryCount + 1) > slots.size()) {
+		rehash(2 * slots.size());
+	}
+	insertSlot(id, position);
+}
+
+shared_ptr<const vector<IdIndex::Entry>> IdIndex::sorted() const {
+	if (sortedEntries == nullptr) {
+		const auto& entries = make_shared<vector<Entry>>();
+		entries->reserve(entryCount);
+		if (dense) {
+			for (size_t index = 0; index < positionById.size(); index++) {
+				if (positionById[index] != Globals::UNAVAILABLE_POS) {
+					entries->push_back({static_cast<int>(index), positionById[index]});
+				}
+			}
+		} else {
+			for (const auto& entry : slots) {
+				if (entry.second != Globals::UNAVAILABLE_POS) {
+					entries->push_back(entry);
+				}
+			}
+			sort(entries->begin(), entries->end());
+		}
+		sortedEntries = entries;
+	}
+	return sortedEntries;
+}
+
+NodeData::NodeData(int id, const DOFS& dofs, pos_t cpPos, pos_t cdPos, int nodePart) :
+    id(id), dofs(dofs), cpPos(cpPos), cdPos(cdPos), nodePart(nodePart) {
 }
 
 /**
@@ -55,31 +168,68 @@ int NodeStorage::lastNodePart = 0;
 NodeStorage::NodeStorage(Mesh& mesh, LogLevel logLevel) :
 		logLevel(logLevel), mesh(mesh) {
 	nodeDatas.reserve(4096);
+	localCoordinates.x.reserve(4096);
+	localCoordinates.y.reserve(4096);
+	localCoordinates.z.reserve(4096);
+}
+
+const NodeCoordinates& NodeStorage::getGlobalCoordinates() const {
+	if (globalCoordinatesValid) {
+		return globalCoordinates;
+	}
+	globalCoordinates = localCoordinates;
+	pos_t cachedCpPos = CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID;
+	shared_ptr<CoordinateSystem> coordSystem = nullptr;
+	for (size_t i = 0; i < nodeDatas.size(); ++i) {
+		const pos_t cpPos = nodeDatas[i].cpPos;
+		if (cpPos == CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID) {
+			continue;
+		}
+		if (cpPos != cachedCpPos) {
+			coordSystem = mesh.getCoordinateSystemByPosition(cpPos);
+			cachedCpPos = cpPos;
+		}
+		if (coordSystem == nullptr) {
+			cerr << "ERROR: Coordinate System of position " << cpPos << " for Node " << nodeDatas[i].id << " not found."
+					<< " Global Coordinate System used instead." << endl;
+			continue;
+		}
+		const VectorialValue& gCoord = coordSystem->positionToGlobal(
+				VectorialValue(localCoordinates.x[i], localCoordinates.y[i], localCoordinates.z[i]));
+		globalCoordinates.x[i] = gCoord.x();
+		globalCoordinates.y[i] = gCoord.y();
+		globalCoordinates.z[i] = gCoord.z();
+	}
+	globalCoordinatesValid = true;
+	return globalCoordinates;
 }
 
 NodeStorage::NodeIterator NodeStorage::begin() const {
-	return NodeStorage::NodeIterator(*this, nodepositionById.begin());
+	// Nodes are then read from the cache
+	getGlobalCoordinates();
+	return NodeStorage::NodeIterator(*this, nodepositionById.sorted(), 0);
 }
 
 NodeStorage::NodeIterator NodeStorage::end() const {
-	return NodeStorage::NodeIterator(*this, nodepositionById.end());
+	const auto& entries = nodepositionById.sorted();
+	return NodeStorage::NodeIterator(*this, entries, entries->size());
 }
 
-NodeStorage::NodeIterator::NodeIterator(const NodeStorage& nodeStorage, mapid_iterator currentIdIterator) :
-		nodeStorage(nodeStorage), currentIdIterator(currentIdIterator) {
+NodeStorage::NodeIterator::NodeIterator(const NodeStorage& nodeStorage, shared_ptr<const vector<IdIndex::Entry>> entries, size_t currentEntry) :
+		nodeStorage(nodeStorage), entries(entries), currentEntry(currentEntry) {
 }
 
 void NodeStorage::NodeIterator::increment() {
-	currentIdIterator++;
+	currentEntry++;
 }
 
 bool NodeStorage::NodeIterator::hasNext() const {
-	return currentIdIterator != nodeStorage.nodepositionById.end();
+	return currentEntry < entries->size();
 }
 
 bool NodeStorage::NodeIterator::equal(NodeStorage::NodeIterator const& other) const {
 	//this.mesh == other.mesh
-	return this->currentIdIterator == other.currentIdIterator;
+	return this->currentEntry == other.currentEntry;
 }
 
 NodeStorage::NodeIterator& NodeStorage::NodeIterator::operator ++() {
@@ -92,19 +242,19 @@ NodeStorage::NodeIterator NodeStorage::NodeIterator::operator ++(int) {
 }
 
 bool NodeStorage::NodeIterator::operator ==(const NodeStorage::NodeIterator& rhs) const {
-	return this->currentIdIterator == rhs.currentIdIterator;
+	return this->currentEntry == rhs.currentEntry;
 }
 
 bool NodeStorage::NodeIterator::operator !=(const NodeStorage::NodeIterator& rhs) const {
-	return this->currentIdIterator != rhs.currentIdIterator;
+	return this->currentEntry != rhs.currentEntry;
 }
 
 Node NodeStorage::NodeIterator::operator *() {
-	return nodeStorage.mesh.findNode(this->currentIdIterator->second);
+	return nodeStorage.mesh.findNode((*entries)[currentEntry].second);
 }
 
 Node NodeStorage::NodeIterator::next() {
-	const Node& result(nodeStorage.mesh.findNode(this->currentIdIterator->second));
+	const Node& result(nodeStorage.mesh.findNode((*entries)[currentEntry].second));
 	this->increment();
 	return result;
 }
@@ -156,8 +306,8 @@ CellIterator CellStorage::cells_end(const CellType &type) const {
 
 vector<CellType> CellStorage::cellTypes() const {
     vector<CellType> keys;
-    keys.reserve(nodepositionsByCelltype.size());
-    for (const auto kv : nodepositionsByCelltype) {
+    keys.reserve(connectivityByCelltype.size());
+    for (const auto& kv : connectivityByCelltype) {
         keys.push_back(kv.first);
     }
 	return keys;
@@ -192,21 +342,24 @@ pos_t Mesh::addNode(const int id, const double x, const double y, const double z
 	} else {
         assignId = id;
 	}
-	auto positionIterator = nodes.nodepositionById.find(assignId);
-	if (positionIterator == nodes.nodepositionById.end()) {
+	nodePosition = nodes.nodepositionById.find(assignId);
+	if (nodePosition == Node::UNAVAILABLE_NODE) {
 		nodePosition = static_cast<pos_t>(nodes.nodeDatas.size());
-		NodeData nodeData(assignId, DOFS::NO_DOFS, x, y, z, cpPos, cdPos, nodePart);
+		NodeData nodeData(assignId, DOFS::NO_DOFS, cpPos, cdPos, nodePart);
 		nodes.nodeDatas.push_back(nodeData);
-		nodes.nodepositionById[assignId] = nodePosition;
+		nodes.localCoordinates.x.push_back(x);
+		nodes.localCoordinates.y.push_back(y);
+		nodes.localCoordinates.z.push_back(z);
+		nodes.nodepositionById.set(assignId, nodePosition);
 	} else {
-		nodePosition = positionIterator->second;
 		NodeData& nodeData = nodes.nodeDatas[nodePosition];
-		nodeData.x = x;
-		nodeData.y = y;
-		nodeData.z = z;
+		nodes.localCoordinates.x[nodePosition] = x;
+		nodes.localCoordinates.y[nodePosition] = y;
+		nodes.localCoordinates.z[nodePosition] = z;
         nodeData.cpPos = cpPos;
         nodeData.cdPos = cdPos;
 	}
+	nodes.invalidateGlobalCoordinates();
 
 	return nodePosition;
 }
@@ -221,10 +374,17 @@ Node Mesh::findNode(const pos_t nodePosition) const {
 				"Node position " + to_string(nodePosition) + " not found.");
 	}
 	const NodeData &nodeData = nodes.nodeDatas[nodePosition];
+	const double x = nodes.localCoordinates.x[nodePosition];
+	const double y = nodes.localCoordinates.y[nodePosition];
+	const double z = nodes.localCoordinates.z[nodePosition];
 	if (nodeData.cpPos == CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID) {
       // Should always be an "unnamed return" to avoid useless copies
-      return Node(nodeData.id, nodeData.x, nodeData.y, nodeData.z, nodePosition, nodeData.dofs,
-          nodeData.x, nodeData.y, nodeData.z, nodeData.cpPos, nodeData.cdPos, nodeData.nodePart);
+      return Node(nodeData.id, x, y, z, nodePosition, nodeData.dofs,
+          x, y, z, nodeData.cpPos, nodeData.cdPos, nodeData.nodePart);
+	} else if (nodes.globalCoordinatesValid) {
+      const auto& global = nodes.globalCoordinates;
+      return Node(nodeData.id, x, y, z, nodePosition, nodeData.dofs,
+          global.x[nodePosition], global.y[nodePosition], global.z[nodePosition], nodeData.cpPos, nodeData.cdPos);
 	} else {
       shared_ptr<CoordinateSystem> coordSystem = this->getCoordinateSystemByPosition(nodeData.cpPos);
       if (coordSystem == nullptr) {
@@ -235,11 +395,11 @@ Node Mesh::findNode(const pos_t nodePosition) const {
           //throw logic_error(oss.str());
           oss <<  " Global Coordinate System used instead."<< endl;
           cerr<< oss.str();
-          return Node(nodeData.id, nodeData.x, nodeData.y, nodeData.z, nodePosition, nodeData.dofs,
-              nodeData.x, nodeData.y, nodeData.z, nodeData.cpPos, nodeData.cdPos);
+          return Node(nodeData.id, x, y, z, nodePosition, nodeData.dofs,
+              x, y, z, nodeData.cpPos, nodeData.cdPos);
       }
-      const VectorialValue& gCoord = coordSystem->positionToGlobal(VectorialValue(nodeData.x,nodeData.y,nodeData.z));
-      return Node(nodeData.id, nodeData.x, nodeData.y, nodeData.z, nodePosition, nodeData.dofs,
+      const VectorialValue& gCoord = coordSystem->positionToGlobal(VectorialValue(x, y, z));
+      return Node(nodeData.id, x, y, z, nodePosition, nodeData.dofs,
           gCoord.x(), gCoord.y(), gCoord.z(), nodeData.cpPos, nodeData.cdPos);
 	}
 }
@@ -263,7 +423,7 @@ pos_t Mesh::findOrReserveNode(int nodeId, int cellPartId) noexcept {
 
         nodePosition = addNode(nodeId, NodeStorage::RESERVED_POSITION, NodeStorage::RESERVED_POSITION,
                 NodeStorage::RESERVED_POSITION, CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID, CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID, mainNodePart);
-        nodes.nodepositionById[nodeId] = nodePosition;
+        nodes.nodepositionById.set(nodeId, nodePosition);
         nodes.reservedButUnusedNodePositions.insert(nodePosition);
         if (this->logLevel >= LogLevel::TRACE) {
             cout << "Reserve node id:" << nodeId << " position:" << nodePosition << endl;
@@ -321,11 +481,7 @@ int Mesh::findNodePartId(const pos_t nodePosition) const noexcept {
 }
 
 pos_t Mesh::findNodePosition(const int nodeId) const noexcept {
-	auto positionIterator = this->nodes.nodepositionById.find(nodeId);
-	if (positionIterator == this->nodes.nodepositionById.end()) {
-		return Node::UNAVAILABLE_NODE;
-	}
-	return positionIterator->second;
+	return this->nodes.nodepositionById.find(nodeId);
 }
 
 void Mesh::allowDOFS(const pos_t nodePosition, const DOFS& allowed) noexcept {
@@ -365,7 +521,7 @@ pos_t Mesh::addCell(const int id, const CellType& cellType, const std::vector<in
 					"Duplicate node in connectivity cellId:"
 							+ to_string(cellId));
 		}
-		if (cells.cellpositionById.find(cellId) != cells.cellpositionById.end()) {
+		if (cells.cellpositionById.find(cellId) != Cell::UNAVAILABLE_CELL) {
 			throw logic_error(
 					"CellId: " + to_string(cellId) + " Already used.");
 		}
@@ -377,18 +533,17 @@ pos_t Mesh::addCell(const int id, const CellType& cellType, const std::vector<in
         }
 	}
 
-	cells.cellpositionById[cellId] = cellPosition;
+	cells.cellpositionById.set(cellId, cellPosition);
+	nodeCellsIndexed = false;
 	const auto cellTypePosition = static_cast<pos_t>(cellPositionsByType.find(cellType)->second.size());
 	cellPositionsByType.find(cellType)->second.push_back(cellPosition);
 	CellData cellData(cellId, cellType, virtualCell, elementId, cellTypePosition);
 
-	if (cells.nodepositionsByCelltype.find(cellType) == cells.nodepositionsByCelltype.end()) {
-		cells.nodepositionsByCelltype[cellType] = make_shared<deque<pos_t>>(deque<pos_t>());
-	}
-	const auto& nodePositionsPtr = cells.nodepositionsByCelltype[cellType];
+	auto& connectivity = cells.connectivityByCelltype[cellType];
 	for (const auto& nodeId : nodeIds) {
-		nodePositionsPtr->push_back(findOrReserveNode(nodeId, elementId));
+		connectivity.nodePositions.push_back(findOrReserveNode(nodeId, elementId));
 	}
+	connectivity.offsets.push_back(connectivity.nodePositions.size());
 
     switch (cellType.dimension.code) {
     case SpaceDimension::Code::DIMENSION0D_CODE: {
@@ -413,6 +568,7 @@ pos_t Mesh::addCell(const int id, const CellType& cellType, const std::vector<in
         break;
     }
     case SpaceDimension::Code::DIMENSION3D_CODE: {
+        volumeFacesIndexed = false;
 /*        if (cells.additional3DdataByCelltype.find(cellType) == cells.additional3DdataByCelltype.end())
             cells.additional3DdataByCelltype[cellType] = {};
         cells.additional3DdataByCelltype[cellType].push_back(DimensionData3D{});*/
@@ -441,6 +597,8 @@ pos_t Mesh::updateCell(int id, const CellType &cellType, const std::vector<int>
     if (oldCellPosition == Cell::UNAVAILABLE_CELL){
         throw invalid_argument("Can't update a cell which does not exist yet.");
     }
+    volumeFacesIndexed = false;
+    nodeCellsIndexed = false;
     if (cellType.numNodes == 0) {
         cerr << "Unsupported cell type" << cellType << endl;
     }
@@ -469,21 +627,19 @@ pos_t Mesh::updateCell(int id, const CellType &cellType, const std::vector<int>
     // We build another CellData, with an other cellPosition, and hope
     // for the best
     const pos_t cellPosition = static_cast<pos_t>(cells.cellDatas.size());
-    cells.cellpositionById[id] = cellPosition;
+    cells.cellpositionById.set(id, cellPosition);
 
     const pos_t cellTypePosition = static_cast<pos_t>(cellPositionsByType.find(cellType)->second.size());
     cellPositionsByType.find(cellType)->second.push_back(cellPosition);
     CellData cellData(id, cellType, virtualCell, elementId, cellTypePosition);
 
-    if (cells.nodepositionsByCelltype.find(cellType) == cells.nodepositionsByCelltype.end()) {
-        cells.nodepositionsByCelltype[cellType] = make_shared<deque<pos_t>>(deque<pos_t>());
-    }
-    const auto& nodePositionsPtr = cells.nodepositionsByCelltype[cellType];
+    auto& connectivity = cells.connectivityByCelltype[cellType];
 	for (const auto& nodeId : nodeIds) {
         cout << "updateCell nodeId:" << nodeId << endl;
         cout << "updateCell nodePos:" << findOrReserveNode(nodeId) << endl;
-		nodePositionsPtr->push_back(findOrReserveNode(nodeId));
+		connectivity.nodePositions.push_back(findOrReserveNode(nodeId));
 	}
+    connectivity.offsets.push_back(connectivity.nodePositions.size());
     if (cpos != CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID) {
         this->getOrCreateCellGroupForCS(cpos)->addCellId(id);
         cellData.csPos = cpos;
@@ -509,17 +665,12 @@ Cell Mesh::findCell(const pos_t cellPosition) const {
 	}
 	const auto& cellData = cells.cellDatas[cellPosition];
 	const CellType* cellType = CellType::findByCode(cellData.typeCode);
-	const unsigned int numNodes = cellType->numNodes;
+	const auto& cellNodePositions = cells.connectivityByCelltype.find(*cellType)->second.cellNodePositions(cellData.cellTypePosition);
+	vector<pos_t> nodePositions(cellNodePositions.begin(), cellNodePositions.end());
 	vector<int> nodeIds;
-	nodeIds.resize(numNodes);
-	auto it = cells.nodepositionsByCelltype.find(*cellType);
-	const auto& globalNodePositions = *(it->second);
-	const auto start = cellData.cellTypePosition * numNodes;
-	vector<pos_t> nodePositions(globalNodePositions.begin() + start,
-			globalNodePositions.begin() + start + numNodes);
-	for (unsigned int i = 0; i < numNodes; i++) {
-		const NodeData &nodeData = nodes.nodeDatas[nodePositions[i]];
-		nodeIds[i] = nodeData.id;
+	nodeIds.reserve(nodePositions.size());
+	for (const pos_t nodePosition : nodePositions) {
+		nodeIds.push_back(nodes.nodeDatas[nodePosition].id);
 	}
 	shared_ptr<OrientationCoordinateSystem> ocs = nullptr;
 	if (cellData.csPos!=CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID)
@@ -554,6 +705,16 @@ Cell Mesh::findCell(const pos_t cellPosition) const {
 	return Cell(cellData.id, *cellType, nodeIds, cellPosition, nodePositions, false, cellData.csPos, cellData.elementId, cellData.cellTypePosition, ocs, offset);
 }
 
+CellView Mesh::cellView(const pos_t cellPosition) const {
+	if (cellPosition == Cell::UNAVAILABLE_CELL) {
+		throw logic_error("Unavailable cell requested.");
+	}
+	const auto& cellData = cells.cellDatas[cellPosition];
+	const CellType* cellType = CellType::findByCode(cellData.typeCode);
+	const auto& connectivity = cells.connectivityByCelltype.find(*cellType)->second;
+	return CellView(cellData, *cellType, cellPosition, connectivity.cellNodePositions(cellData.cellTypePosition));
+}
+
 pos_t Mesh::generateSkinCell(const vector<int>& faceIds, const SpaceDimension& dimension) {
     CellType* cellTypeFound = nullptr;
     for (const auto& typeAndCodePair : CellType::typeByCode) {
@@ -571,26 +732,164 @@ pos_t Mesh::generateSkinCell(const vector<int>& faceIds, const SpaceDimension& d
     return addCell(Cell::AUTO_ID, *cellTypeFound, faceIds, true);
 }
 
-pair<Cell, int> Mesh::volcellAndFaceNum_from_skincell(const Cell& skinCell) const {
-    const set<int> surfOrderedNodeIds(skinCell.nodeIds.begin(), skinCell.nodeIds.end());
+size_t Mesh::faceKey(vector<pos_t>& cornerPositions) noexcept {
+    sort(cornerPositions.begin(), cornerPositions.end());
+    size_t key = cornerPositions.size();
+    for (const pos_t position : cornerPositions) {
+        key = (key ^ position) * 11400714819323198485ull;
+    }
+    return key;
+}
+
+void Mesh::indexVolumeFaces() const {
+    volumeFaces.clear();
+    vector<pos_t> cornerPositions;
     for (const auto& cellEntry : this->cellPositionsByType) {
-        if (cellEntry.first.dimension != SpaceDimension::DIMENSION_3D)
+        const CellType& cellType = cellEntry.first;
+        if (cellType.dimension != SpaceDimension::DIMENSION_3D or cellEntry.second.empty())
             continue;
+        const auto& it = Cell::FACE_BY_CELLTYPE.find(cellType.code);
+        if (it == Cell::FACE_BY_CELLTYPE.end())
+            throw logic_error("Missing FACE_BY_CELLTYPE configuration for cell type :" + cellType.description);
+        const auto& nodeConnectivityPosByFace = it->second;
+        const auto& connectivity = cells.connectivityByCelltype.find(cellType)->second;
         for (const pos_t cellPosition : cellEntry.second) {
-            const Cell& volCell = this->findCell(cellPosition);
-            for (const auto& faceEntry : volCell.nodeIdsByFaceNum()) {
-                const vector<int>& faceNodeIds = faceEntry.second;
-                if (faceNodeIds.size() != surfOrderedNodeIds.size())
-                    continue;
-                const set<int> faceOrderedNodeIds(faceNodeIds.begin(), faceNodeIds.end());
-                if (faceOrderedNodeIds == surfOrderedNodeIds) //< Must be ordered for set comparison
-                    return {volCell, faceEntry.first};
+            const auto& nodePositions = connectivity.cellNodePositions(cells.cellDatas[cellPosition].cellTypePosition);
+            int faceNum = 1;
+            for (const auto& nodeConnectivityPos : nodeConnectivityPosByFace) {
+                // Corner nodes come first, quadratic faces have as many middle nodes as corners
+                const size_t cornerCount = nodeConnectivityPos.size() > 4 ? nodeConnectivityPos.size() / 2 : nodeConnectivityPos.size();
+                cornerPositions.clear();
+                for (size_t i = 0; i < cornerCount; ++i) {
+                    cornerPositions.push_back(nodePositions[nodeConnectivityPos[i] - 1]);
+                }
+                volumeFaces.push_back({faceKey(cornerPositions), cellPosition, faceNum});
+                faceNum++;
             }
         }
     }
+    stable_sort(volumeFaces.begin(), volumeFaces.end(), [](const VolumeFace& a, const VolumeFace& b) {
+        return a.key < b.key;
+    });
+    volumeFacesIndexed = true;
+}
+
+pair<Cell, int> Mesh::volcellAndFaceNum_from_skincell(const Cell& skinCell) const {
+    if (not volumeFacesIndexed) {
+        indexVolumeFaces();
+    }
+    const size_t nodeCount = skinCell.nodePositions.size();
+    const size_t cornerCount = nodeCount > 4 ? nodeCount / 2 : nodeCount;
+    vector<pos_t> cornerPositions(skinCell.nodePositions.begin(), skinCell.nodePositions.begin() + cornerCount);
+    const VolumeFace searched{faceKey(cornerPositions), Cell::UNAVAILABLE_CELL, 0};
+    const auto& candidates = equal_range(volumeFaces.begin(), volumeFaces.end(), searched, [](const VolumeFace& a, const VolumeFace& b) {
+        return a.key < b.key;
+    });
+    vector<pos_t> surfOrderedNodePositions(skinCell.nodePositions);
+    sort(surfOrderedNodePositions.begin(), surfOrderedNodePositions.end());
+    vector<pos_t> faceOrderedNodePositions;
+    for (auto candidate = candidates.first; candidate != candidates.second; ++candidate) {
+        // Keys only tell the corner nodes (and may collide), the whole faces must be compared
+        const CellView& volCell = cellView(candidate->cellPosition);
+        const auto& faceNodeConnectivityPos = Cell::FACE_BY_CELLTYPE.find(volCell.type.code)->second[candidate->faceNum - 1];
+        if (faceNodeConnectivityPos.size() != nodeCount)
+            continue;
+        faceOrderedNodePositions.clear();
+        for (const int nodenum : faceNodeConnectivityPos) {
+            faceOrderedNodePositions.push_back(volCell.nodePositions[nodenum - 1]);
+        }
+        sort(faceOrderedNodePositions.begin(), faceOrderedNodePositions.end());
+        if (faceOrderedNodePositions == surfOrderedNodePositions)
+            return {findCell(candidate->cellPosition), candidate->faceNum};
+    }
     throw logic_error("Cannot find volume cell corresponding to surface cell id : " + to_string(skinCell.id));
 }
 
+const size_t Mesh::PARALLEL_INDEX_MIN_CELLS;
+
+void Mesh::indexNodeCells() const {
+    const size_t nodeCount = nodes.nodeDatas.size();
+    // Cells are split in chunks of the connectivity of a single type
+    struct Chunk {
+        const CellConnectivity* connectivity;
+        const vector<pos_t>* cellPositions;
+        size_t begin;
+        size_t end;
+    };
+    static const size_t CHUNK_SIZE = 1 << 14;
+    vector<Chunk> chunks;
+    size_t cellCount = 0;
+    for (const auto& connectivityEntry : cells.connectivityByCelltype) {
+        const auto& cellPositions = cellPositionsByType.find(connectivityEntry.first)->second;
+        for (size_t begin = 0; begin < cellPositions.size(); begin += CHUNK_SIZE) {
+            chunks.push_back({&connectivityEntry.second, &cellPositions, begin, min(begin + CHUNK_SIZE, cellPositions.size())});
+        }
+        cellCount += cellPositions.size();
+    }
+    const unsigned int threadCount = cellCount < PARALLEL_INDEX_MIN_CELLS ? 1 :
+            max(1u, min(thread::hardware_concurrency(), static_cast<unsigned int>(chunks.size())));
+    const auto runChunks = [&chunks, threadCount](const function<void(const Chunk&)>& task) {
+        atomic<size_t> nextChunk(0);
+        const auto worker = [&chunks, &nextChunk, &task]() {
+            for (size_t i = nextChunk++; i < chunks.size(); i = nextChunk++) {
+                task(chunks[i]);
+            }
+        };
+        vector<thread> workers;
+        for (unsigned int i = 1; i < threadCount; ++i) {
+            workers.emplace_back(worker);
+        }
+        worker();
+        for (auto& workerThread : workers) {
+            workerThread.join();
+        }
+    };
+
+    vector<atomic<pos_t>> counts(nodeCount);
+    runChunks([&counts, nodeCount](const Chunk& chunk) {
+        for (size_t cellTypePosition = chunk.begin; cellTypePosition < chunk.end; ++cellTypePosition) {
+            for (const pos_t nodePosition : chunk.connectivity->cellNodePositions(static_cast<pos_t>(cellTypePosition))) {
+                if (nodePosition < nodeCount) {
+                    counts[nodePosition].fetch_add(1, memory_order_relaxed);
+                }
+            }
+        }
+    });
+    cellOffsetsByNode.assign(nodeCount + 1, 0);
+    for (size_t nodePosition = 0; nodePosition < nodeCount; ++nodePosition) {
+        cellOffsetsByNode[nodePosition + 1] = cellOffsetsByNode[nodePosition] + counts[nodePosition].load(memory_order_relaxed);
+        counts[nodePosition].store(0, memory_order_relaxed);
+    }
+    cellPositionsByNode.resize(cellOffsetsByNode.back());
+    runChunks([this, &counts, nodeCount](const Chunk& chunk) {
+        for (size_t cellTypePosition = chunk.begin; cellTypePosition < chunk.end; ++cellTypePosition) {
+            const pos_t cellPosition = (*chunk.cellPositions)[cellTypePosition];
+            for (const pos_t nodePosition : chunk.connectivity->cellNodePositions(static_cast<pos_t>(cellTypePosition))) {
+                if (nodePosition < nodeCount) {
+                    cellPositionsByNode[cellOffsetsByNode[nodePosition] + counts[nodePosition].fetch_add(1, memory_order_relaxed)] = cellPosition;
+                }
+            }
+        }
+    });
+    // Threads filled the rows in any order
+    for (size_t nodePosition = 0; nodePosition < nodeCount; ++nodePosition) {
+        sort(cellPositionsByNode.begin() + cellOffsetsByNode[nodePosition], cellPositionsByNode.begin() + cellOffsetsByNode[nodePosition + 1]);
+    }
+    nodeCellsIndexed = true;
+}
+
+boost::iterator_range<const pos_t*> Mesh::findCellPositionsByNode(const pos_t nodePosition) const {
+    if (not nodeCellsIndexed) {
+        indexNodeCells();
+    }
+    if (nodePosition + 1 >= cellOffsetsByNode.size()) {
+        // Node added after the index
+        return boost::iterator_range<const pos_t*>(nullptr, nullptr);
+    }
+    const pos_t* rows = cellPositionsByNode.data();
+    return boost::iterator_range<const pos_t*>(rows + cellOffsetsByNode[nodePosition], rows + cellOffsetsByNode[nodePosition + 1]);
+}
+
 shared_ptr<CellGroup> Mesh::getOrCreateCellGroupForCS(pos_t cspos){
 	shared_ptr<CellGroup> result;
 	auto cellGroupNameIter = cellGroupNameByCspos.find(cspos);
@@ -616,6 +915,7 @@ void Mesh::add(const CoordinateSystem& coordinateSystem) {
       cout << "Adding " << coordinateSystem << endl;
   }
   coordinateSystemStorage.add(coordinateSystem);
+  nodes.invalidateGlobalCoordinates();
 }
 
 shared_ptr<CoordinateSystem> Mesh::findCoordinateSystem(const Reference<CoordinateSystem> csref) const {
@@ -845,17 +1145,11 @@ size_t Mesh::countCells(const CellType& type) const noexcept {
 }
 
 bool Mesh::hasCell(int cellId) const noexcept {
-	auto positionIterator =
-			cells.cellpositionById.find(cellId);
-	return positionIterator != cells.cellpositionById.end();
+	return cells.cellpositionById.find(cellId) != Cell::UNAVAILABLE_CELL;
 }
 
 pos_t Mesh::findCellPosition(int cellId) const noexcept {
-	auto it = this->cells.cellpositionById.find(cellId);
-	if (it == this->cells.cellpositionById.end()) {
-		return Cell::UNAVAILABLE_CELL;
-	}
-	return it->second;
+	return this->cells.cellpositionById.find(cellId);
 }
 
 bool Mesh::validate() const {
@@ -877,8 +1171,7 @@ MeshStatistics Mesh::calcStats() {
             continue;
         vector<double> squareDistances;
         squareDistances.reserve(cellType.numNodes * (cellType.numNodes - 1) / 2);
-        for (auto cellit = cells.cells_begin(cellType); cellit != cells.cells_end(cellType); cellit++) {
-            const Cell& cell = *cellit;
+        visitCells(cellType, [&](const CellView& cell) {
             for (unsigned i = 0; i < cellType.numNodes - 1; i++) {
                 for (unsigned j = i; j < cellType.numNodes; j++) {
                     const Node& n1 = findNode(cell.nodePositions[i]);
@@ -887,7 +1180,7 @@ MeshStatistics Mesh::calcStats() {
                     //squareDistances.push_back(n1.square_distance(n2));
                 }
             }
-        }
+        });
         const auto mm = minmax_element(squareDistances.begin(), squareDistances.end());
         if (minSquareDistance > 0)
             minSquareDistance = min(minSquareDistance, *(mm.first));
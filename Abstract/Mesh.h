@@ -27,14 +27,66 @@ namespace vega {
 
 class Mesh;
 
+/**
+ * Index from the ids given by the input solver to the positions in a mesh storage.
+ * Ids are usually compact (1..n): they are then stored in a direct-mapped array. As soon as they
+ * are negative or too sparse for the array, the index switches to an open addressing hash table.
+ */
+class IdIndex final {
+public:
+    using Entry = std::pair<int, pos_t>;
+private:
+    static const size_t DENSE_SLACK = 1 << 16; /**< Array size always accepted in dense mode **/
+    static const size_t DENSE_RATIO = 4;       /**< Array size accepted by stored id in dense mode **/
+    bool dense = true;
+    std::vector<pos_t> positionById;          /**< Dense mode: position of each id, UNAVAILABLE_POS for holes **/
+    std::vector<Entry> slots;                 /**< Hash mode: linear probing, UNAVAILABLE_POS for empty slots **/
+    unsigned int hashShift = 64;
+    size_t entryCount = 0;
+    mutable std::shared_ptr<const std::vector<Entry>> sortedEntries;
+    size_t slotOf(int id) const noexcept;
+    void insertSlot(int id, pos_t position) noexcept;
+    void rehash(size_t capacity);
+public:
+    pos_t find(int id) const noexcept;
+    /**
+     * Sets (or replaces) the position of an id.
+     */
+    void set(int id, pos_t position);
+    inline size_t size() const noexcept {
+        return entryCount;
+    }
+    inline bool isDense() const noexcept {
+        return dense;
+    }
+    /**
+     * Entries sorted by id. The snapshot is shared and rebuilt only after changes: it stays valid for the
+     * iterations started before them.
+     */
+    std::shared_ptr<const std::vector<Entry>> sorted() const;
+};
+
+/**
+ * Coordinates of the nodes, by node position, stored as one array by axis.
+ */
+class NodeCoordinates final {
+public:
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    inline size_t size() const noexcept {
+        return x.size();
+    }
+};
+
+/**
+ * Node record, without its coordinates: see NodeStorage::getLocalCoordinates()
+ */
 class NodeData final {
 public:
-    NodeData(int id, const DOFS& dofs, double x, double y, double z, pos_t cpPos, pos_t cdPos, int nodePart);
+    NodeData(int id, const DOFS& dofs, pos_t cpPos, pos_t cdPos, int nodePart);
 	const int id;
 	char dofs;
-	double x;
-	double y;
-	double z;
 	pos_t cpPos = CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID; /**< Vega Position Number of the CS used for location (x,y,z) **/;
 	pos_t cdPos = CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID; /**< Vega Position Number of the CS used for displacements, forces, constraints **/;
 	int nodePart = 0; /**< Node grouping by element part */
@@ -46,8 +98,10 @@ private:
 	friend NodeGroup;
 	const LogLevel logLevel;
 	std::vector<NodeData> nodeDatas;
-	using mapid_iterator = std::map<int, pos_t>::const_iterator;
-	std::map<int, pos_t> nodepositionById;
+	NodeCoordinates localCoordinates; /**< Coordinates in the cpPos coordinate system of each node **/
+	mutable NodeCoordinates globalCoordinates;
+	mutable bool globalCoordinatesValid = false;
+	IdIndex nodepositionById;
 	static const double RESERVED_POSITION;
 	static int lastNodePart;
 public:
@@ -61,9 +115,10 @@ public:
         friend NodeStorage;
         void increment();
         bool equal(NodeIterator const& other) const;
-        NodeIterator(const NodeStorage& nodeStorage, mapid_iterator currentIdIterator);
+        NodeIterator(const NodeStorage& nodeStorage, std::shared_ptr<const std::vector<IdIndex::Entry>> entries, size_t currentEntry);
         const NodeStorage& nodeStorage;
-        mapid_iterator currentIdIterator;
+        std::shared_ptr<const std::vector<IdIndex::Entry>> entries; /**< Snapshot of the node ids, sorted **/
+        size_t currentEntry;
     public:
         //java style iteration
         bool hasNext() const;
@@ -78,14 +133,28 @@ public:
 	NodeStorage(Mesh& mesh, LogLevel logLevel);
 	NodeIterator begin() const;
 	NodeIterator end() const;
-	std::vector<NodeData> getNodeDatas() const {
+	const std::vector<NodeData>& getNodeDatas() const noexcept {
 	    return nodeDatas;
 	}
+	const NodeCoordinates& getLocalCoordinates() const noexcept {
+	    return localCoordinates;
+	}
+	/**
+	 * Coordinates of all the nodes in the global coordinate system. They are computed at the first call,
+	 * then kept until a node or a coordinate system changes.
+	 */
+	const NodeCoordinates& getGlobalCoordinates() const;
+	/**
+	 * Forgets the global coordinates: must be called when a coordinate system used by the nodes changes.
+	 */
+	void invalidateGlobalCoordinates() noexcept {
+	    globalCoordinatesValid = false;
+	}
 	int getMinNodeId() const {
-	    return nodepositionById.begin()->first;
+	    return nodepositionById.sorted()->front().first;
 	}
 	int getMaxNodeId() const {
-	    return nodepositionById.rbegin()->first;
+	    return nodepositionById.sorted()->back().first;
 	}
 	bool validate() const;
 };
@@ -101,6 +170,39 @@ public:
 	const pos_t cellTypePosition;
 };
 
+/**
+ * Node positions of all the cells of one type, stored contiguously (CSR layout): the nodes of the cell
+ * in cellTypePosition are nodePositions[offsets[cellTypePosition]] to nodePositions[offsets[cellTypePosition + 1] - 1].
+ */
+class CellConnectivity final {
+public:
+    std::vector<size_t> offsets{0};
+    std::vector<pos_t> nodePositions;
+    inline boost::iterator_range<const pos_t*> cellNodePositions(pos_t cellTypePosition) const noexcept {
+        return {nodePositions.data() + offsets[cellTypePosition], nodePositions.data() + offsets[cellTypePosition + 1]};
+    }
+};
+
+/**
+ * Lightweight view of a cell, pointing inside the mesh storage: nothing is allocated to build it,
+ * but it is only valid until a cell is added to the mesh. Mesh::findCell() gives a full Cell instead.
+ */
+class CellView final {
+public:
+    CellView(const CellData& cellData, const CellType& type, pos_t position, boost::iterator_range<const pos_t*> nodePositions) noexcept :
+            id(cellData.id), type(type), position(position), isvirtual(cellData.isvirtual), elementId(cellData.elementId),
+            cellTypePosition(cellData.cellTypePosition), cspos(cellData.csPos), nodePositions(nodePositions) {
+    }
+    const int id;
+    const CellType& type;
+    const pos_t position;
+    const bool isvirtual;
+    const int elementId;
+    const pos_t cellTypePosition;
+    const pos_t cspos; /**< Position of the local Coordinate System **/
+    const boost::iterator_range<const pos_t*> nodePositions;
+};
+
 class CellStorage final {
 private:
 	friend Mesh;
@@ -113,8 +215,8 @@ private:
 	std::map<CellType, std::vector<DimensionData1D>> additional1DdataByCelltype;
 	std::map<CellType, std::vector<DimensionData2D>> additional2DdataByCelltype;
 	std::map<CellType, std::vector<DimensionData3D>> additional3DdataByCelltype;
-	std::map<int, pos_t> cellpositionById;
-	std::map<CellType, std::shared_ptr<std::deque<pos_t>>> nodepositionsByCelltype;
+	IdIndex cellpositionById;
+	std::map<CellType, CellConnectivity> connectivityByCelltype;
 	/*
 	 * Reserve a cell position given an id
 	 */
@@ -160,6 +262,34 @@ private:
 	std::shared_ptr<CellGroup> getOrCreateCellGroupForCS(const pos_t cspos);
 
 	std::unique_ptr<MeshStatistics> stats = nullptr;
+
+	/**
+	 * A face of a volume cell, indexed by a hash of its sorted corner node positions.
+	 */
+	struct VolumeFace {
+	    size_t key;
+	    pos_t cellPosition;
+	    int faceNum;
+	};
+	/**
+	 * Faces of all the volume cells sorted by key (then in cellPositionsByType order).
+	 * Built at the first lookup, dropped when a volume cell is added or updated.
+	 */
+	mutable std::vector<VolumeFace> volumeFaces;
+	mutable bool volumeFacesIndexed = false;
+	static size_t faceKey(std::vector<pos_t>& cornerPositions) noexcept;
+	void indexVolumeFaces() const;
+
+	static const size_t PARALLEL_INDEX_MIN_CELLS = 100000; /**< Smaller meshes are indexed in the calling thread **/
+	/**
+	 * Cells using each node, in compressed rows: the cells of node n are in
+	 * cellPositionsByNode[cellOffsetsByNode[n]..cellOffsetsByNode[n+1]).
+	 * Built at the first lookup, dropped when a cell is added or updated.
+	 */
+	mutable std::vector<size_t> cellOffsetsByNode;
+	mutable std::vector<pos_t> cellPositionsByNode;
+	mutable bool nodeCellsIndexed = false;
+	void indexNodeCells() const;
 public:
 	std::map<CellType, std::vector<pos_t>> cellPositionsByType;
 	std::map<pos_t, std::string> cellGroupNameByCspos; /**< mapping position->group name **/
@@ -276,11 +406,64 @@ public:
         return cells.cellDatas[cellPosition].id;
     };
 	Cell findCell(pos_t cellPosition) const;
+	/**
+	 * Same as findCell(), without any allocation: see CellView.
+	 */
+	CellView cellView(pos_t cellPosition) const;
+	/**
+	 * Calls visitor(const CellView&) for every cell of cellType, in the order of cellPositionsByType.
+	 * No allocation is done by cell: this is the way to go for writers on big meshes.
+	 */
+	template<typename Visitor>
+	void visitCells(const CellType& cellType, Visitor&& visitor) const {
+	    const auto& connectivityEntry = cells.connectivityByCelltype.find(cellType);
+	    if (connectivityEntry == cells.connectivityByCelltype.end()) {
+	        return;
+	    }
+	    for (const pos_t cellPosition : cellPositionsByType.find(cellType)->second) {
+	        const CellData& cellData = cells.cellDatas[cellPosition];
+	        visitor(CellView(cellData, cellType, cellPosition, connectivityEntry->second.cellNodePositions(cellData.cellTypePosition)));
+	    }
+	}
+	/**
+	 * Same as visitCells() over any range of cell positions (e.g. ElementSet::cellPositions()), in its order.
+	 * Unavailable positions are skipped.
+	 */
+	template<typename CellPositions, typename Visitor>
+	void visitCellPositions(const CellPositions& cellPositions, Visitor&& visitor) const {
+	    for (const pos_t cellPosition : cellPositions) {
+	        if (cellPosition != Cell::UNAVAILABLE_CELL) {
+	            visitor(cellView(cellPosition));
+	        }
+	    }
+	}
+	/**
+	 * Same as visitCells() over the cells of a group, in position order.
+	 */
+	template<typename Visitor>
+	void visitCells(const CellGroup& cellGroup, Visitor&& visitor) const {
+	    visitCellPositions(cellGroup.cellPositions(), visitor);
+	}
+	/**
+	 * Same as visitCells() over the cells of a container (e.g. a CellElementSet) and of its groups, in position order.
+	 */
+	template<typename Visitor>
+	void visitCells(const CellContainer& cellContainer, Visitor&& visitor) const {
+	    visitCellPositions(cellContainer.getCellPositionsIncludingGroups(), visitor);
+	}
 	bool hasNonZeroOffset() const noexcept {
         return withNonZeroOffsets;
 	}
 	pos_t generateSkinCell(const std::vector<int>& faceIds, const SpaceDimension& dimension);
+    /**
+     * Find the volume cell having skinCell as a face, and the number (1 based) of this face.
+     * Throws if there is none.
+     */
     std::pair<Cell, int> volcellAndFaceNum_from_skincell(const Cell& skinCell) const;
+    /**
+     * Positions of the cells using a node, in increasing order.
+     */
+    boost::iterator_range<const pos_t*> findCellPositionsByNode(pos_t nodePosition) const;
 	bool hasCell(int cellId) const noexcept;
 
 	/**
@@ -261,7 +261,7 @@ bool NodeGroup::containsNodePosition(const pos_t nodePosition) const noexcept {
     return NodeContainer::containsNodePositionExcludingGroups(nodePosition);
 }
 
-std::set<pos_t> NodeGroup::nodePositions() const noexcept {
+PositionSet NodeGroup::nodePositions() const noexcept {
 	return NodeContainer::getNodePositionsExcludingGroups();
 }
 
@@ -281,15 +281,16 @@ set<Cell> CellGroup::getCells() {
 	return CellContainer::getCellsIncludingGroups();
 }
 
-set<pos_t> CellGroup::cellPositions() noexcept {
-	return CellContainer::getCellPositionsIncludingGroups();
+const PositionSet& CellGroup::cellPositions() const noexcept {
+	// Cell groups never contain other groups
+	return CellContainer::getCellPositionsExcludingGroups();
 }
 
 set<int> CellGroup::cellIds() noexcept {
 	return CellContainer::getCellIdsIncludingGroups();
 }
 
-set<pos_t> CellGroup::nodePositions() const noexcept {
+PositionSet CellGroup::nodePositions() const noexcept {
 	return CellContainer::getNodePositionsIncludingGroups();
 }
 
@@ -682,30 +683,21 @@ void CellContainer::addCellId(int cellId) noexcept {
 }
 
 void CellContainer::addCellIds(const vector<int>& otherIds) noexcept {
-	transform(otherIds.begin(),
-              otherIds.end(),
-              std::inserter(cellPositions, cellPositions.begin()),
-              [&](const int cellId) {
-                  return mesh.findCellPosition(cellId);
-              });
+	for (const int cellId : otherIds) {
+		cellPositions.insert(mesh.findCellPosition(cellId));
+	}
 }
 
 void CellContainer::addCellIds(const set<int>& otherIds) noexcept {
-	transform(otherIds.begin(),
-              otherIds.end(),
-              std::inserter(cellPositions, cellPositions.begin()),
-              [&](const int cellId) {
-                  return mesh.findCellPosition(cellId);
-              });
+	for (const int cellId : otherIds) {
+		cellPositions.insert(mesh.findCellPosition(cellId));
+	}
 }
 
 void CellContainer::addCellIds(const list<int>& otherIds) noexcept {
-	transform(otherIds.begin(),
-              otherIds.end(),
-              std::inserter(cellPositions, cellPositions.begin()),
-              [&](const int cellId) {
-                  return mesh.findCellPosition(cellId);
-              });
+	for (const int cellId : otherIds) {
+		cellPositions.insert(mesh.findCellPosition(cellId));
+	}
 }
 
 
@@ -721,6 +713,10 @@ void CellContainer::addCellPositions(const list<pos_t>& otherPositions) noexcept
     cellPositions.insert(otherPositions.begin(), otherPositions.end());
 }
 
+void CellContainer::addCellPositions(const PositionSet& otherPositions) noexcept {
+    cellPositions.insert(otherPositions);
+}
+
 void CellContainer::addCellGroup(const string& groupName) {
 	const auto& group = mesh.findGroup(groupName);
 	if (group == nullptr) {
@@ -740,7 +736,7 @@ void CellContainer::add(const CellGroup& cellGroup) noexcept {
 void CellContainer::add(const CellContainer& cellContainer) noexcept {
     const auto& otherCellPositions = cellContainer.getCellPositionsExcludingGroups();
 	if (not otherCellPositions.empty()) {
-		cellPositions.insert(otherCellPositions.begin(), otherCellPositions.end());
+		cellPositions.insert(otherCellPositions);
 	}
 
 	if (not cellContainer.cellGroupNames.empty()) {
@@ -749,7 +745,7 @@ void CellContainer::add(const CellContainer& cellContainer) noexcept {
 }
 
 bool CellContainer::containsCellPosition(pos_t cellPosition) const noexcept {
-	return cellPositions.find(cellPosition) != cellPositions.end();
+	return cellPositions.contains(cellPosition);
 }
 
 void CellContainer::removeCellPositionExcludingGroups(pos_t cellPosition) noexcept {
@@ -807,35 +803,34 @@ set<int> CellContainer::getCellIdsIncludingGroups() const noexcept {
 	return result;
 }
 
-set<pos_t> CellContainer::getCellPositionsIncludingGroups() const noexcept {
-	set<pos_t> result(cellPositions.begin(), cellPositions.end());
+PositionSet CellContainer::getCellPositionsIncludingGroups() const noexcept {
+	PositionSet result(cellPositions);
     for (const auto& groupName : cellGroupNames) {
         const auto& group = dynamic_pointer_cast<CellGroup>(mesh.findGroup(groupName));
         if (group != nullptr) {
-            const auto& groupCellPositions = group->cellPositions();
-            result.insert(groupCellPositions.begin(), groupCellPositions.end());
+            result.insert(group->cellPositions());
         }
     }
 	return result;
 }
 
-set<pos_t> CellContainer::getCellPositionsExcludingGroups() const noexcept {
+const PositionSet& CellContainer::getCellPositionsExcludingGroups() const noexcept {
 	return cellPositions;
 }
 
-set<pos_t> CellContainer::getNodePositionsIncludingGroups() const noexcept {
-	set<pos_t> result;
-	for (const auto& cell : getCellsIncludingGroups()) {
+PositionSet CellContainer::getNodePositionsIncludingGroups() const noexcept {
+	PositionSet result;
+	mesh.visitCellPositions(getCellPositionsIncludingGroups(), [&result](const CellView& cell) {
 		result.insert(cell.nodePositions.begin(), cell.nodePositions.end());
-	}
+	});
 	return result;
 }
 
-set<pos_t> CellContainer::getNodePositionsExcludingGroups() const noexcept {
-	set<pos_t> result;
-	for (const auto& cell : getCellsExcludingGroups()) {
+PositionSet CellContainer::getNodePositionsExcludingGroups() const noexcept {
+	PositionSet result;
+	mesh.visitCellPositions(cellPositions, [&result](const CellView& cell) {
 		result.insert(cell.nodePositions.begin(), cell.nodePositions.end());
-	}
+	});
 	return result;
 }
 
@@ -939,6 +934,10 @@ void NodeContainer::addNodePositions(const list<pos_t>& range) noexcept {
     nodePositions.insert(range.begin(), range.end());
 }
 
+void NodeContainer::addNodePositions(const PositionSet& range) noexcept {
+    nodePositions.insert(range);
+}
+
 void NodeContainer::addNodePosition(const pos_t nodePosition) noexcept {
 	nodePositions.insert(nodePosition);
 }
@@ -952,7 +951,11 @@ void NodeContainer::addNodeGroup(const string& groupName) {
 }
 
 void NodeContainer::removeNodePositionExcludingGroups(const pos_t nodePosition) noexcept {
-	nodePositions.erase(nodePositions.find(nodePosition));
+	nodePositions.erase(nodePosition);
+}
+
+void NodeContainer::removeNodePositionsExcludingGroups(const PositionSet& range) noexcept {
+	nodePositions.erase(range);
 }
 
 void NodeContainer::add(const Node& node) noexcept {
@@ -966,7 +969,7 @@ void NodeContainer::add(const NodeGroup& nodeGroup) noexcept {
 void NodeContainer::add(const NodeContainer& nodeContainer) noexcept {
     const auto& otherNodePositions = nodeContainer.getNodePositionsExcludingGroups();
 	if (not otherNodePositions.empty()) {
-		nodePositions.insert(otherNodePositions.begin(), otherNodePositions.end());
+		nodePositions.insert(otherNodePositions);
 	}
 
 	if (not nodeContainer.nodeGroupNames.empty()) {
@@ -974,26 +977,23 @@ void NodeContainer::add(const NodeContainer& nodeContainer) noexcept {
 	}
 }
 
-set<pos_t> NodeContainer::getNodePositionsExcludingGroups() const noexcept {
+PositionSet NodeContainer::getNodePositionsExcludingGroups() const noexcept {
     if (CellContainer::empty()) {
         return nodePositions;
     } else {
-        set<pos_t> result(nodePositions);
-        const auto& cellNodePositions = CellContainer::getNodePositionsExcludingGroups();
-        result.insert(cellNodePositions.begin(), cellNodePositions.end());
+        PositionSet result(nodePositions);
+        result.insert(CellContainer::getNodePositionsExcludingGroups());
         return result;
     }
 }
 
-set<pos_t> NodeContainer::getNodePositionsIncludingGroups() const noexcept {
-    set<pos_t> result(nodePositions);
+PositionSet NodeContainer::getNodePositionsIncludingGroups() const noexcept {
+    PositionSet result(nodePositions);
 	for (const auto& groupName : nodeGroupNames) {
 		const auto& group = static_pointer_cast<NodeGroup>(mesh.findGroup(groupName));
-		const auto& groupNodePositions = group->nodePositions();
-		result.insert(groupNodePositions.begin(), groupNodePositions.end());
+		result.insert(group->nodePositions());
 	}
-    const auto& cellNodePositions = CellContainer::getNodePositionsIncludingGroups();
-    result.insert(cellNodePositions.begin(), cellNodePositions.end());
+    result.insert(CellContainer::getNodePositionsIncludingGroups());
 	return result;
 }
 
@@ -1022,7 +1022,7 @@ set<Node> NodeContainer::getNodesExcludingGroups() const {
 }
 
 bool NodeContainer::containsNodePositionExcludingGroups(const pos_t nodePosition) const {
-	return nodePositions.find(nodePosition) != nodePositions.end();
+	return nodePositions.contains(nodePosition);
 }
 
 bool NodeContainer::empty() const noexcept {
@@ -265,7 +265,7 @@ public:
     inline std::string getComment() const noexcept {
         return this->comment;
     }
-    virtual std::set<pos_t> nodePositions() const noexcept = 0;
+    virtual PositionSet nodePositions() const noexcept = 0;
     virtual bool empty() const noexcept = 0;
     virtual ~Group() = default;
     Group(const Group& that) = delete;
@@ -437,7 +437,7 @@ class CellGroup;
  */
 class CellContainer {
 private:
-    std::set<pos_t> cellPositions;
+    PositionSet cellPositions;
     std::set<std::string> cellGroupNames;
     const Mesh& mesh;
 public:
@@ -456,6 +456,7 @@ public:
     void addCellPositions(const std::vector<pos_t>&) noexcept;
     void addCellPositions(const std::set<pos_t>&) noexcept;
     void addCellPositions(const std::list<pos_t>&) noexcept;
+    void addCellPositions(const PositionSet&) noexcept;
     void addCellGroup(const std::string& groupName);
     void add(const Cell& cell) noexcept;
     //virtual void add(const Group& group);
@@ -469,11 +470,14 @@ public:
 
     std::set<int> getCellIdsIncludingGroups() const noexcept;
     std::set<int> getCellIdsExcludingGroups() const noexcept;
-    std::set<pos_t> getCellPositionsIncludingGroups() const noexcept;
-    std::set<pos_t> getCellPositionsExcludingGroups() const noexcept;
+    PositionSet getCellPositionsIncludingGroups() const noexcept;
+    /**
+     * The positions stored by the container itself: no copy is done.
+     */
+    const PositionSet& getCellPositionsExcludingGroups() const noexcept;
 
-    virtual std::set<pos_t> getNodePositionsExcludingGroups() const noexcept;
-    virtual std::set<pos_t> getNodePositionsIncludingGroups() const noexcept;
+    virtual PositionSet getNodePositionsExcludingGroups() const noexcept;
+    virtual PositionSet getNodePositionsIncludingGroups() const noexcept;
 
     /**
      * True if the container contains some cellGroup
@@ -517,9 +521,9 @@ public:
     using CellContainer::containsCellPosition;
     void removeCellPosition(pos_t cellPosition) noexcept;
     std::set<Cell> getCells();
-    std::set<pos_t> cellPositions() noexcept;
+    const PositionSet& cellPositions() const noexcept;
     std::set<int> cellIds() noexcept;
-    std::set<pos_t> nodePositions() const noexcept override;
+    PositionSet nodePositions() const noexcept override;
     bool empty() const noexcept override {
         return CellContainer::empty();
     }
@@ -535,7 +539,7 @@ class NodeGroup;
 class NodeContainer : public CellContainer {
 private:
     Mesh& mesh; // because CellContainer mesh needs to be const
-    std::set<pos_t> nodePositions;
+    PositionSet nodePositions;
     std::set<std::string> nodeGroupNames;
 public:
     NodeContainer(Mesh& mesh) noexcept;
@@ -553,6 +557,7 @@ public:
     void addNodePositions(const std::set<pos_t>&) noexcept;
     void addNodePositions(const std::vector<pos_t>&) noexcept;
     void addNodePositions(const std::list<pos_t>&) noexcept;
+    void addNodePositions(const PositionSet&) noexcept;
     void addNodePosition(pos_t) noexcept;
     //void addNodeGroup(const std::string& groupName);
     void add(const Node&) noexcept;
@@ -561,8 +566,9 @@ public:
     void add(const NodeContainer& nodeContainer) noexcept;
     bool containsNodePositionExcludingGroups(pos_t nodePosition) const;
     void removeNodePositionExcludingGroups(pos_t nodePosition) noexcept;
-    virtual std::set<pos_t> getNodePositionsExcludingGroups() const noexcept override final;
-    virtual std::set<pos_t> getNodePositionsIncludingGroups() const noexcept override final;
+    void removeNodePositionsExcludingGroups(const PositionSet&) noexcept;
+    virtual PositionSet getNodePositionsExcludingGroups() const noexcept override final;
+    virtual PositionSet getNodePositionsIncludingGroups() const noexcept override final;
     virtual std::set<int> getNodeIdsIncludingGroups() const noexcept final;
     virtual std::set<int> getNodeIdsExcludingGroups() const noexcept final;
     virtual std::set<Node> getNodesExcludingGroups() const final;
@@ -591,7 +597,7 @@ public:
     void addNodeByPosition(pos_t nodePosition) noexcept;
     void removeNodeByPosition(pos_t nodePosition) noexcept;
     bool containsNodePosition(pos_t nodePosition) const noexcept;
-    std::set<pos_t> nodePositions() const noexcept override;
+    PositionSet nodePositions() const noexcept override;
     std::set<int> getNodeIds() const noexcept;
     std::set<Node> getNodes() const;
     bool empty() const noexcept override {
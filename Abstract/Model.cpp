@@ -175,76 +175,104 @@ vector<int> Model::getElementSetsId() const{
 	return v;
 }
 
-template<>
-void Model::remove(const Reference<Constraint> constraintReference) {
-    for (const auto& it : constraintReferences_by_constraintSet_ids) {
-        for (const auto& it2 : it.second) {
-            if (it2 == constraintReference) {
-                constraintReferences_by_constraintSet_ids[it.first].erase(it2);
-                break; // iterator is invalid now
-            }
+void Model::removeFromConstraintSet(const Reference<Constraint>& constraintReference,
+        const Reference<ConstraintSet>& constraintSetReference) {
+    membershipChanged();
+    // Mirrors addConstraintIntoConstraintSet()
+    if (constraintSetReference.has_id()) {
+        const auto& itm = constraintReferences_by_constraintSet_ids.find(constraintSetReference.id);
+        if (itm != constraintReferences_by_constraintSet_ids.end())
+            itm->second.erase(constraintReference);
+    }
+    if (constraintSetReference.has_original_id()) {
+        const auto& itm = constraintReferences_by_constraintSet_original_ids_by_constraintSet_type.find(
+                constraintSetReference.type);
+        if (itm != constraintReferences_by_constraintSet_original_ids_by_constraintSet_type.end()) {
+            const auto& itm2 = itm->second.find(constraintSetReference.original_id);
+            if (itm2 != itm->second.end())
+                itm2->second.erase(constraintReference);
         }
     }
-    for (const auto& it : constraintReferences_by_constraintSet_original_ids_by_constraintSet_type) {
-        for (const auto& it2 : it.second) {
-            for (const auto& it3 : it2.second) {
-                if (it3 == constraintReference) {
-                    constraintReferences_by_constraintSet_original_ids_by_constraintSet_type[it.first][it2.first].erase(
-                            it3);
-                    break; // iterator is invalid now
-                }
+}
+
+void Model::removeFromConstraintSets(const Reference<Constraint>& constraintReference) {
+    const auto& it = constraintSetReferences_by_constraint.find(constraintReference);
+    if (it == constraintSetReferences_by_constraint.end())
+        return;
+    for (const auto& constraintSetReference : it->second) {
+        removeFromConstraintSet(constraintReference, constraintSetReference);
+    }
+    constraintSetReferences_by_constraint.erase(it);
+}
 
+void Model::removeFromLoadSets(const Reference<Loading>& loadingReference) {
+    const auto& it = loadSetReferences_by_loading.find(loadingReference);
+    if (it == loadSetReferences_by_loading.end())
+        return;
+    membershipChanged();
+    // Mirrors addLoadingIntoLoadSet()
+    for (const auto& loadSetReference : it->second) {
+        if (loadSetReference.has_id()) {
+            const auto& itm = loadingReferences_by_loadSet_ids.find(loadSetReference.id);
+            if (itm != loadingReferences_by_loadSet_ids.end())
+                itm->second.erase(loadingReference);
+        }
+        if (loadSetReference.has_original_id()) {
+            const auto& itm = loadingReferences_by_loadSet_original_ids_by_loadSet_type.find(loadSetReference.type);
+            if (itm != loadingReferences_by_loadSet_original_ids_by_loadSet_type.end()) {
+                const auto& itm2 = itm->second.find(loadSetReference.original_id);
+                if (itm2 != itm->second.end())
+                    itm2->second.erase(loadingReference);
             }
         }
     }
+    loadSetReferences_by_loading.erase(it);
+}
+
+template<>
+void Model::remove(const Reference<Constraint> constraintReference) {
+    removeFromConstraintSets(constraintReference);
     constraints.erase(constraintReference);
 }
 
+template<>
+void Model::removeAll(const vector<Reference<Constraint>>& constraintReferences) {
+    for (const auto& constraintReference : constraintReferences) {
+        remove(constraintReference);
+    }
+}
+
 void Model::remove(const Reference<Constraint> refC, const Reference<ConstraintSet> refCSet) {
+    removeAll(vector<Reference<Constraint>>{refC}, refCSet);
+}
 
-    const auto & cR = constraintReferences_by_constraintSet_ids[refCSet.id];
-    for (const auto& it2 : cR) {
-        if (it2 == refC){
-            constraintReferences_by_constraintSet_ids[refCSet.id].erase(it2);
-            break; // iterator is invalid now
+void Model::removeAll(const vector<Reference<Constraint>>& constraintReferences,
+        const Reference<ConstraintSet> constraintSetReference) {
+    for (const auto& constraintReference : constraintReferences) {
+        removeFromConstraintSet(constraintReference, constraintSetReference);
+        const auto& it = constraintSetReferences_by_constraint.find(constraintReference);
+        if (it != constraintSetReferences_by_constraint.end()) {
+            it->second.erase(constraintSetReference);
+            if (it->second.empty())
+                constraintSetReferences_by_constraint.erase(it);
         }
+        constraints.erase(constraintReference);
     }
-    if (refCSet.has_original_id()){
-        const auto & cR2 = constraintReferences_by_constraintSet_original_ids_by_constraintSet_type[refCSet.type][refCSet.original_id];
-        for (const auto& it3 : cR2) {
-            if (it3 == refC){
-                constraintReferences_by_constraintSet_original_ids_by_constraintSet_type[refCSet.type][refCSet.original_id].erase(it3);
-                break; // iterator is invalid now
-            }
-        }
-    }
-    constraints.erase(refC);
 }
 
 template<>
 void Model::remove(const Reference<Loading> loadingReference) {
-    for (const auto& it : loadingReferences_by_loadSet_ids) {
-        for (const auto& it2 : it.second) {
-            if (it2 == loadingReference) {
-                loadingReferences_by_loadSet_ids[it.first].erase(it2);
-                break; // iterator is invalid now
-            }
-        }
-    }
-    for (const auto& it : loadingReferences_by_loadSet_original_ids_by_loadSet_type) {
-        for (const auto& it2 : it.second) {
-            for (const auto& it3 : it2.second) {
-                if (it3 == loadingReference) {
-                    loadingReferences_by_loadSet_original_ids_by_loadSet_type[it.first][it2.first].erase(
-                            it3);
-                            break; // iterator is invalid now
-                }
-            }
-        }
-    }
+    removeFromLoadSets(loadingReference);
     loadings.erase(loadingReference);
 }
 
+template<>
+void Model::removeAll(const vector<Reference<Loading>>& loadingReferences) {
+    for (const auto& loadingReference : loadingReferences) {
+        remove(loadingReference);
+    }
+}
+
 template<>
 void Model::remove(const Reference<LoadSet> loadSetReference) {
     for (const auto& analysis : analyses) {
@@ -289,6 +317,7 @@ void Model::remove(const Reference<ObjectiveSet> objectiveSetReference) {
 
 template<>
 void Model::remove(const Reference<Objective> objectiveReference) {
+    membershipChanged();
     for (const auto& it : objectiveReferences_by_objectiveSet_ids) {
         for (const auto& it2 : it.second) {
             if (it2 == objectiveReference) {
@@ -381,11 +410,14 @@ shared_ptr<Target> Model::find(const Reference<Target> reference) const {
 
 void Model::addLoadingIntoLoadSet(const Reference<Loading>& loadingReference,
         const Reference<LoadSet>& loadSetReference) {
+    membershipChanged();
     if (loadSetReference.has_id())
         loadingReferences_by_loadSet_ids[loadSetReference.id].insert(loadingReference);
     if (loadSetReference.has_original_id())
         loadingReferences_by_loadSet_original_ids_by_loadSet_type[loadSetReference.type][loadSetReference.original_id].insert(
                 loadingReference);
+    if (loadSetReference.has_id() or loadSetReference.has_original_id())
+        loadSetReferences_by_loading[loadingReference].insert(loadSetReference);
     if (loadSetReference == commonLoadSet->getReference() && find(commonLoadSet->getReference()) == nullptr)
         add(commonLoadSet); // commonLoadSet is added to the model if needed
     if (this->find(loadSetReference) == nullptr) {
@@ -396,6 +428,7 @@ void Model::addLoadingIntoLoadSet(const Reference<Loading>& loadingReference,
 
 void Model::addObjectiveIntoObjectiveSet(const Reference<Objective>& objectiveReference,
         const Reference<ObjectiveSet>& objectiveSetReference) {
+    membershipChanged();
     if (objectiveReference.has_id())
         objectiveReferences_by_objectiveSet_ids[objectiveSetReference.id].insert(objectiveReference);
     if (objectiveReference.has_original_id())
@@ -421,6 +454,30 @@ shared_ptr<LoadSet> Model::getOrCreateLoadSet(int loadset_id, LoadSet::Type load
     return loadSetPtr;
 }
 
+shared_ptr<NodalForceTable> Model::getOrCreateNodalForceTable(const shared_ptr<LoadSet>& loadSet) {
+    shared_ptr<NodalForceTable> table = nodalForceTable_by_loadSet_id[loadSet->getId()].lock();
+    if (table == nullptr or this->find(table->getReference()) == nullptr) {
+        table = make_shared<NodalForceTable>(*this, loadSet);
+        this->add(table);
+        nodalForceTable_by_loadSet_id[loadSet->getId()] = table;
+    }
+    return table;
+}
+
+shared_ptr<SinglePointConstraint> Model::getOrCreateSinglePointConstraint(
+        const Reference<ConstraintSet>& constraintSetReference, const DOFS& dofs, double value) {
+    auto& group = spcGroup_by_constraintSet_dofs_value[make_tuple(constraintSetReference.type,
+            constraintSetReference.original_id, constraintSetReference.id, static_cast<char>(dofs), value)];
+    shared_ptr<SinglePointConstraint> spc = group.lock();
+    if (spc == nullptr or this->find(spc->getReference()) == nullptr) {
+        spc = make_shared<SinglePointConstraint>(*this, dofs, value);
+        this->add(spc);
+        this->addConstraintIntoConstraintSet(*spc, constraintSetReference);
+        group = spc;
+    }
+    return spc;
+}
+
 shared_ptr<ObjectiveSet> Model::getOrCreateObjectiveSet(int objectiveset_id, ObjectiveSet::Type objectiveset_type){
 
     Reference<ObjectiveSet> objectiveSetReference(objectiveset_type, objectiveset_id);
@@ -433,8 +490,11 @@ shared_ptr<ObjectiveSet> Model::getOrCreateObjectiveSet(int objectiveset_id, Obj
     return objectiveSetPtr;
 }
 
-set<shared_ptr<Loading>, ptrLess<Loading>> Model::getLoadingsByLoadSet(
-        const Reference<LoadSet>& loadSetReference) const {
+Model::ResolvedMembers<Loading>& Model::resolveLoadSet(const Reference<LoadSet>& loadSetReference) const {
+    auto& resolved = resolvedLoadings[make_tuple(loadSetReference.type, loadSetReference.original_id,
+            loadSetReference.id)];
+    if (resolved.all != nullptr)
+        return resolved;
     set<shared_ptr<Loading>, ptrLess<Loading>> result;
     auto itm = loadingReferences_by_loadSet_ids.find(loadSetReference.id);
     if (itm != loadingReferences_by_loadSet_ids.end()) {
@@ -453,31 +513,48 @@ set<shared_ptr<Loading>, ptrLess<Loading>> Model::getLoadingsByLoadSet(
         if (itm3 != itm2->second.end()) {
             for (const auto& itm4 : itm3->second) {
                 shared_ptr<Loading> loading = find(itm4);
-            if (loading == nullptr) {
-                throw logic_error("Missing loading declared in loadingSet : " + to_str(itm4));
-            }
+                if (loading == nullptr) {
+                    throw logic_error("Missing loading declared in loadingSet : " + to_str(itm4));
+                }
                 result.insert(loading);
             }
         }
     }
-    return result;
+    resolved.all = make_shared<const vector<shared_ptr<Loading>>>(result.begin(), result.end());
+    return resolved;
+}
+
+MemberView<Loading> Model::getLoadingsByLoadSet(const Reference<LoadSet>& loadSetReference) const {
+    return resolveLoadSet(loadSetReference).all;
+}
+
+MemberView<Loading> Model::getLoadingsByLoadSet(const Reference<LoadSet>& loadSetReference,
+        const Loading::Type type) const {
+    return resolveLoadSet(loadSetReference).ofType(type);
 }
 
 void Model::addConstraintIntoConstraintSet(const Reference<Constraint>& constraintReference,
         const Reference<ConstraintSet>& constraintSetReference) {
+    membershipChanged();
     if (constraintSetReference.has_id())
         constraintReferences_by_constraintSet_ids[constraintSetReference.id].insert(
                 constraintReference);
     if (constraintSetReference.has_original_id())
         constraintReferences_by_constraintSet_original_ids_by_constraintSet_type[constraintSetReference.type][constraintSetReference.original_id].insert(
                 constraintReference);
+    if (constraintSetReference.has_id() or constraintSetReference.has_original_id())
+        constraintSetReferences_by_constraint[constraintReference].insert(constraintSetReference);
     if (constraintSetReference == commonConstraintSet->getReference()
             and find(commonConstraintSet->getReference()) == nullptr)
         add(commonConstraintSet); // commonConstraintSet is added to the model if needed
 }
 
-set<shared_ptr<Constraint>, ptrLess<Constraint>> Model::getConstraintsByConstraintSet(
+Model::ResolvedMembers<Constraint>& Model::resolveConstraintSet(
         const Reference<ConstraintSet>& constraintSetReference) const {
+    auto& resolved = resolvedConstraints[make_tuple(constraintSetReference.type,
+            constraintSetReference.original_id, constraintSetReference.id)];
+    if (resolved.all != nullptr)
+        return resolved;
     set<shared_ptr<Constraint>, ptrLess<Constraint>> result;
     auto itm = constraintReferences_by_constraintSet_ids.find(constraintSetReference.id);
     if (itm != constraintReferences_by_constraintSet_ids.end()) {
@@ -495,33 +572,41 @@ set<shared_ptr<Constraint>, ptrLess<Constraint>> Model::getConstraintsByConstrai
             }
         }
     }
-    return result;
+    resolved.all = make_shared<const vector<shared_ptr<Constraint>>>(result.begin(), result.end());
+    return resolved;
+}
+
+MemberView<Constraint> Model::getConstraintsByConstraintSet(
+        const Reference<ConstraintSet>& constraintSetReference) const {
+    return resolveConstraintSet(constraintSetReference).all;
+}
+
+MemberView<Constraint> Model::getConstraintsByConstraintSet(
+        const Reference<ConstraintSet>& constraintSetReference, const Constraint::Type type) const {
+    return resolveConstraintSet(constraintSetReference).ofType(type);
 }
 
 set<shared_ptr<ConstraintSet>, ptrLess<ConstraintSet>> Model::getConstraintSetsByConstraint(
         const Reference<Constraint>& constraintReference) const {
     set<shared_ptr<ConstraintSet>, ptrLess<ConstraintSet>> result;
-    for (const auto& it : constraintSets) {
-        const auto& constraints = getConstraintsByConstraintSet(it->getReference());
-        bool found = false;
-        for (const auto& constraint : constraints) {
-            if (constraint == nullptr) {
-                throw logic_error("Missing constraint declared in constraintSet : " + to_str(*it));
-            }
-            if (constraint->getReference() == constraintReference) {
-                found = true;
-                break;
+    const auto& it = constraintSetReferences_by_constraint.find(constraintReference);
+    if (it != constraintSetReferences_by_constraint.end()) {
+        for (const auto& constraintSetReference : it->second) {
+            const auto& constraintSet = find(constraintSetReference);
+            if (constraintSet != nullptr) {
+                result.insert(constraintSet);
             }
         }
-        if (found) {
-            result.insert(it);
-        }
     }
     return result;
 }
 
-set<shared_ptr<Objective>, ptrLess<Objective>> Model::getObjectivesByObjectiveSet(
+MemberView<Objective> Model::getObjectivesByObjectiveSet(
         const Reference<ObjectiveSet>& objectiveSetReference) const {
+    auto& resolved = resolvedObjectives[make_tuple(objectiveSetReference.type,
+            objectiveSetReference.original_id, objectiveSetReference.id)];
+    if (resolved.all != nullptr)
+        return resolved.all;
     set<shared_ptr<Objective>, ptrLess<Objective>> result;
     auto itm = objectiveReferences_by_objectiveSet_ids.find(objectiveSetReference.id);
     if (itm != objectiveReferences_by_objectiveSet_ids.end()) {
@@ -539,7 +624,8 @@ set<shared_ptr<Objective>, ptrLess<Objective>> Model::getObjectivesByObjectiveSe
             }
         }
     }
-    return result;
+    resolved.all = make_shared<const vector<shared_ptr<Objective>>>(result.begin(), result.end());
+    return resolved.all;
 }
 
 vector<shared_ptr<ConstraintSet>> Model::getActiveConstraintSets() const {
@@ -890,14 +976,16 @@ void Model::generateSkin() {
 
 void Model::emulateLocalDisplacementConstraint() {
 
+    vector<Reference<Constraint>> emptySpcs;
     for (const auto& constraint : constraints.filter(Constraint::Type::SPC)) {
         const auto& spc = static_pointer_cast<SinglePointConstraint>(   constraint);
         spc->emulateLocalDisplacementConstraint();
         if (spc->empty()) {
-            this->remove(spc->getReference());
+            emptySpcs.push_back(spc->getReference());
         }
         spc->markAsWritten();
     }
+    removeAll(emptySpcs);
 
 }
 
@@ -1010,11 +1098,13 @@ void Model::removeIneffectives() {
         if (loading->ineffective())
             loadingsToRemove.push_back(loading);
     }
+    vector<Reference<Loading>> loadingReferences;
     for (const auto& loading : loadingsToRemove) {
         if (configuration.logLevel >= LogLevel::TRACE)
             cout << "Removed ineffective " << *loading << endl;
-        remove(Reference<Loading>(*loading));
+        loadingReferences.push_back(Reference<Loading>(*loading));
     }
+    removeAll(loadingReferences);
 
     // remove empty loadSets from the model
     vector<Reference<LoadSet>> loadSetSetsToRemove;
@@ -1035,11 +1125,13 @@ void Model::removeIneffectives() {
         if (constraint->ineffective())
             constraintsToRemove.push_back(constraint);
     }
+    vector<Reference<Constraint>> constraintReferences;
     for (const auto& constraint : constraintsToRemove) {
         if (configuration.logLevel >= LogLevel::TRACE)
             cout << "Removed ineffective " << *constraint << endl;
-        remove(Reference<Constraint>(*constraint));
+        constraintReferences.push_back(Reference<Constraint>(*constraint));
     }
+    removeAll(constraintReferences);
 
     // remove empty constraintSets from the model
     vector<Reference<ConstraintSet>> constraintSetSetsToRemove;
@@ -1131,7 +1223,30 @@ void Model::removeAssertionsMissingDOFS()
 {
     vector<shared_ptr<Objective> > objectivesToRemove;
     for (const auto& analysis : analyses) {
-        for(const auto& assertion : analysis->getAssertions()) {
+        for (const auto& objectiveSet : analysis->getObjectiveSets()) {
+            if (objectiveSet == nullptr) {
+                continue;
+            }
+            auto& table = objectiveSet->nodalDisplacementAssertions;
+            vector<bool> keep(table.size(), true);
+            size_t removedCount = 0;
+            for (size_t row = 0; row < table.size(); row++) {
+                const pos_t nodePosition = table.nodePositions[row];
+                const Node& node = mesh.findNode(nodePosition);
+                const DOFS& availableDOFS = node.dofs + analysis->findBoundaryDOFS(nodePosition);
+                if (not availableDOFS.contains(table.dofs[row])) {
+                    keep[row] = false;
+                    removedCount++;
+                }
+            }
+            if (removedCount > 0) {
+                if (configuration.logLevel >= LogLevel::TRACE)
+                    cout << "Removed " << removedCount << " ineffective nodal displacement assertions from "
+                            << *objectiveSet << endl;
+                table.filter(keep);
+            }
+        }
+        for(const auto& assertion : analysis->getIndividualAssertions()) {
             for(const auto nodePosition: assertion->nodePositions()) {
                 const DOFS& assertionDOFS = assertion->getDOFSForNode(nodePosition);
                 if (not assertionDOFS.empty()) {
@@ -1176,45 +1291,47 @@ void Model::replaceDirectMatrices()
             continue;
         }
         const auto& matrix = static_pointer_cast<MatrixElement>(elementSetM);
+        // Dofs given to the nodes of each cell by the element sets (including the discretes already created)
+        vector<DOFS> ownedDofsByCell(mesh.countCells(), DOFS::NO_DOFS);
+        for (const auto& elementSetI : elementSets) {
+            if (not elementSetI->effective()) {
+                continue;
+            }
+            const DOFS cellDofs = (elementSetI->isBeam() or elementSetI->isShell()) ? DOFS::ALL_DOFS : DOFS::TRANSLATIONS;
+            for (const auto cellPosition : elementSetI->cellPositions()) {
+                if (cellPosition < ownedDofsByCell.size()) {
+                    ownedDofsByCell[cellPosition] += cellDofs;
+                }
+            }
+        }
         for (const auto nodePosition : matrix->nodePositions()) {
             requiredDofsByNode[nodePosition] = DOFS();
-            const int nodeId = mesh.findNodeId(nodePosition);
             DOFS owned;
-            for (const auto elementSetI : elementSets) {
-                if (not elementSetI->effective()) {
-                    continue;
-                }
-                for (const auto cellPosition : elementSetI->cellPositions()) {
-                    const Cell& cell = mesh.findCell(cellPosition);
-                    for (int cellNodeId : cell.nodeIds) {
-                        if (cellNodeId == nodeId) {
-                            if (elementSetI->isBeam() or elementSetI->isShell()) {
-                                owned += DOFS::ALL_DOFS;
-                            } else {
-                                owned += DOFS::TRANSLATIONS;
-                            }
-                            break;
-                        }
-                    }
-                }
+            for (const pos_t cellPosition : mesh.findCellPositionsByNode(nodePosition)) {
+                owned += ownedDofsByCell[cellPosition];
             }
             ownedDofsByNode[nodePosition] = owned;
         }
-        for (const auto& pair : matrix->nodePairs()) {
-            if (pair.first == pair.second) {
-                if (not matrix->findInPairs(pair.first).empty()) {
-                    continue; // will be handled by a segment cell with another node
+        const auto& blockMatrix = matrix->getComponents();
+        // Number of other nodes coupled to each node of the matrix
+        unordered_map<pos_t, int> coupleCountByNode;
+        blockMatrix.visitBlocks([&coupleCountByNode](const pos_t rowNodePosition, const pos_t colNodePosition, const DOFBlockMatrix::Block&) {
+            if (rowNodePosition != colNodePosition) {
+                coupleCountByNode[rowNodePosition]++;
+                coupleCountByNode[colNodePosition]++;
+            }
+        });
+        blockMatrix.visitBlocks([&](const pos_t rowNodePosition, const pos_t colNodePosition, const DOFBlockMatrix::Block& block) {
+            if (rowNodePosition == colNodePosition) {
+                if (coupleCountByNode.find(rowNodePosition) != coupleCountByNode.end()) {
+                    return; // will be handled by a segment cell with another node
                 }
                 // single node
-                const auto nodePosition = pair.first;
+                const auto nodePosition = rowNodePosition;
                 const int nodeId = mesh.findNodeId(nodePosition);
                 DOFS requiredDofs = requiredDofsByNode.find(nodePosition)->second;
-                const auto& submatrix = matrix->findSubmatrix(nodePosition, nodePosition);
-                const auto& discrete = make_shared<DiscretePoint>(*this, submatrix->matrixType);
-                for (const auto& kv : submatrix->componentByDofs) {
-                    double value = kv.second;
-                    const vega::DOF& dof1 = kv.first.first;
-                    const vega::DOF& dof2 = kv.first.second;
+                const auto& discrete = make_shared<DiscretePoint>(*this, matrix->matrixType);
+                block.visitComponents([&](const DOF dof1, const DOF dof2, const double value) {
                     if (!is_equal(value, 0)) {
                         switch (matrix->type) {
                         case ElementSet::Type::STIFFNESS_MATRIX:
@@ -1232,7 +1349,7 @@ void Model::replaceDirectMatrices()
                         requiredDofs += dof1;
                         requiredDofs += dof2;
                     }
-                }
+                });
                 if (configuration.addVirtualMaterial) {
                     discrete->assignMaterial(getVirtualMaterial());
                 }
@@ -1258,8 +1375,6 @@ void Model::replaceDirectMatrices()
                 this->add(discrete);
             } else {
                 // node couple
-                const auto rowNodePosition = pair.first;
-                const auto colNodePosition = pair.second;
                 const int rowNodeId = mesh.findNodeId(rowNodePosition);
                 const int colNodeId = mesh.findNodeId(colNodePosition);
                 DOFS requiredRowDofs = requiredDofsByNode.find(rowNodePosition)->second;
@@ -1289,27 +1404,18 @@ void Model::replaceDirectMatrices()
                     addedDofsByNode[colNodePosition] = DOFS::TRANSLATIONS;
                     mesh.allowDOFS(colNodePosition, DOFS::TRANSLATIONS);
                 }
+                // We are disassembling the matrix, so we must divide the values by the segments
+                const int segmentCount = coupleCountByNode[rowNodePosition];
                 for (int row_index = 0; row_index < 2; ++row_index) {
                     for (int col_index = 0; col_index < 2; ++col_index) {
-                        pos_t rowNodePosition2;
-                        pos_t colNodePosition2;
-                        if (row_index == 0) {
-                            rowNodePosition2 = rowNodePosition;
-                        } else {
-                            rowNodePosition2 = colNodePosition;
-                        }
-                        if (col_index == 0) {
-                            colNodePosition2 = rowNodePosition;
-                        } else {
-                            colNodePosition2 = colNodePosition;
+                        const pos_t rowNodePosition2 = row_index == 0 ? rowNodePosition : colNodePosition;
+                        const pos_t colNodePosition2 = col_index == 0 ? rowNodePosition : colNodePosition;
+                        const auto submatrix = blockMatrix.findBlock(rowNodePosition2, colNodePosition2);
+                        if (submatrix == nullptr) {
+                            continue;
                         }
-                        shared_ptr<const DOFMatrix> submatrix = matrix->findSubmatrix(rowNodePosition2,
-                                colNodePosition2);
-                        for (const auto& kv : submatrix->componentByDofs) {
-                            // We are disassembling the matrix, so we must divide the value by the segments
-                            double value = kv.second / static_cast<int>(matrix->findInPairs(pair.first).size());
-                            const DOF& rowDof = kv.first.first;
-                            const DOF& colDof = kv.first.second;
+                        submatrix->visitComponents([&](const DOF rowDof, const DOF colDof, const double component) {
+                            const double value = component / segmentCount;
                             if (!is_equal(value, 0)) {
                                 switch (matrix->type) {
                                 case ElementSet::Type::STIFFNESS_MATRIX:
@@ -1330,7 +1436,7 @@ void Model::replaceDirectMatrices()
                                 requiredRowDofs += rowDof;
                                 requiredColDofs += colDof;
                             }
-                        }
+                        });
                     }
                 }
                 if (this->configuration.logLevel >= LogLevel::TRACE) {
@@ -1339,9 +1445,24 @@ void Model::replaceDirectMatrices()
                 }
                 this->add(discrete);
             }
-        }
+        });
         elementSetsToRemove.push_back(elementSetM);
     }
+    // Dofs required by the loadings and the constraints, computed once for all the added nodes
+    DOFS loadingDofs;
+    for (const auto loading : loadings) {
+        for (const auto nodePosition2 : loading->nodePositions()) {
+            loadingDofs += loading->getDOFSForNode(nodePosition2);
+        }
+    }
+    map<pos_t, DOFS> constraintDofsByNode;
+    for (const auto constraint : constraints) {
+        for (const auto nodePosition : constraint->nodePositions()) {
+            if (addedDofsByNode.find(nodePosition) != addedDofsByNode.end()) {
+                constraintDofsByNode[nodePosition] += constraint->getDOFSForNode(nodePosition);
+            }
+        }
+    }
     for (const auto& kv : addedDofsByNode) {
         const auto nodePosition = kv.first;
         const DOFS& added = kv.second;
@@ -1361,17 +1482,10 @@ void Model::replaceDirectMatrices()
             owned = it2->second;
         }
 
-        for (const auto loading : loadings) {
-            for (const auto nodePosition2 : loading->nodePositions()) {
-                required += loading->getDOFSForNode(nodePosition2);
-            }
-        }
-        for (const auto constraint : constraints) {
-            const auto& constraintNodes = constraint->nodePositions();
-            if (constraintNodes.find(nodePosition) == constraintNodes.end()) {
-                continue;
-            }
-            required += constraint->getDOFSForNode(nodePosition);
+        required += loadingDofs;
+        const auto& constraintDofs = constraintDofsByNode.find(nodePosition);
+        if (constraintDofs != constraintDofsByNode.end()) {
+            required += constraintDofs->second;
         }
         const DOFS& extra = added - owned - required;
         if (extra != DOFS::NO_DOFS) {
@@ -1425,6 +1539,7 @@ void Model::removeRedundantSpcs() {
             }
             for (const auto& constraint : spcs) {
                 const auto& spc = static_pointer_cast<SinglePointConstraint>(constraint);
+                map<char, PositionSet> nodePositionsByDofsToRemove;
                 for (const auto nodePosition : spc->nodePositions()) {
                     DOFS dofsToRemove;
                     DOFS blockedDofs = spc->getDOFSForNode(nodePosition);
@@ -1441,17 +1556,21 @@ void Model::removeRedundantSpcs() {
                                             + " value : " + to_string(spcValue)
                                             + " different by other spc value : "
                                             + to_string(entry->second) + " on same node id : "
-                                            + to_string(nodeId) + " and dof : " + dof.label);
+                                            + to_string(nodeId) + " and dof : " + dof.label());
                         } else {
                             dofsToRemove = dofsToRemove + dof;
                         }
                     }
                     if (not dofsToRemove.empty()) {
-                        analysis->removeSPCNodeDofs(*spc, nodePosition, dofsToRemove);
-                        if (configuration.logLevel >= LogLevel::TRACE) {
-                            cout << "Removed redundant dofs : " << dofsToRemove << " from node id : " << this->mesh.findNodeId(nodePosition)
-                                    << " from spc : " << *spc << " for analysis : " << *analysis << endl;
-                        }
+                        nodePositionsByDofsToRemove[dofsToRemove].insert(nodePosition);
+                    }
+                }
+                for (const auto& entry : nodePositionsByDofsToRemove) {
+                    const DOFS dofsToRemove(entry.first);
+                    analysis->removeSPCNodeDofs(*spc, entry.second, dofsToRemove);
+                    if (configuration.logLevel >= LogLevel::TRACE) {
+                        cout << "Removed redundant dofs : " << dofsToRemove << " from " << entry.second.size()
+                                << " node(s) from spc : " << *spc << " for analysis : " << *analysis << endl;
                     }
                 }
             }
@@ -1481,16 +1600,24 @@ void Model::removeConstrainedImposed() {
             }
             for (const auto& constraint : spcs) {
                 const auto& spc = static_pointer_cast<SinglePointConstraint>(constraint);
+                map<char, PositionSet> nodePositionsByDofsToRemove;
                 for (const auto nodePosition : spc->nodePositions()) {
-                    DOFS imposedDofs = imposedDofsByNodePosition[nodePosition];
+                    const auto& imposed = imposedDofsByNodePosition.find(nodePosition);
+                    if (imposed == imposedDofsByNodePosition.end()) {
+                        continue;
+                    }
                     DOFS blockedDofs = spc->getDOFSForNode(nodePosition);
-                    DOFS dofsToRemove = imposedDofs.intersection(blockedDofs);
+                    DOFS dofsToRemove = imposed->second.intersection(blockedDofs);
                     if (not dofsToRemove.empty()) {
-                        analysis->removeSPCNodeDofs(*spc, nodePosition, dofsToRemove);
-                        if (configuration.logLevel >= LogLevel::TRACE) {
-                            cout << "Removed imposed dofs : " << dofsToRemove << " from node id : " << this->mesh.findNodeId(nodePosition)
-                                    << " from spc : " << *spc << " for analysis : " << *analysis << endl;
-                        }
+                        nodePositionsByDofsToRemove[dofsToRemove].insert(nodePosition);
+                    }
+                }
+                for (const auto& entry : nodePositionsByDofsToRemove) {
+                    const DOFS dofsToRemove(entry.first);
+                    analysis->removeSPCNodeDofs(*spc, entry.second, dofsToRemove);
+                    if (configuration.logLevel >= LogLevel::TRACE) {
+                        cout << "Removed imposed dofs : " << dofsToRemove << " from " << entry.second.size()
+                                << " node(s) from spc : " << *spc << " for analysis : " << *analysis << endl;
                     }
                 }
             }
@@ -1541,21 +1668,21 @@ void Model::splitDirectMatrices(const unsigned int sizeMax){
         map<pair<int, int>, shared_ptr<ElementSet>>  esToAddByStackNumber;
 
         // Splitting the matrices, pairs of nodes by pairs of node (I,J).
-        for (const auto np : matrix->nodePairs()){
+        matrix->getComponents().visitBlocks([&](const pos_t rowNodePosition, const pos_t colNodePosition, const DOFBlockMatrix::Block& block) {
 
             // We attribute a stack of sizeStack to each node.
             int sI, sJ;
-            auto it = stackOfNodesByNodes.find(np.first);
+            auto it = stackOfNodesByNodes.find(rowNodePosition);
             if (it == stackOfNodesByNodes.end()){
                 sI = static_cast<int>(stackOfNodesByNodes.size()/sizeStack);
-                stackOfNodesByNodes[np.first]=sI;
+                stackOfNodesByNodes[rowNodePosition]=sI;
             }else{
                 sI = it->second;
             }
-            it = stackOfNodesByNodes.find(np.second);
+            it = stackOfNodesByNodes.find(colNodePosition);
             if (it == stackOfNodesByNodes.end()){
                 sJ = static_cast<int>(stackOfNodesByNodes.size()/sizeStack);
-                stackOfNodesByNodes[np.second]=sJ;
+                stackOfNodesByNodes[colNodePosition]=sJ;
             }else{
                 sJ = it->second;
             }
@@ -1591,12 +1718,12 @@ void Model::splitDirectMatrices(const unsigned int sizeMax){
 
             // We copy the values
             const auto& nM = static_pointer_cast<MatrixElement>(newElementSet);
-            const auto& dM = matrix->findSubmatrix(np.first, np.second);
-            for (const auto dof: dM->componentByDofs){
-                nM->addComponent(nodeIdOfElement[np.first], dof.first.first, nodeIdOfElement[np.second], dof.first.second, dof.second);
-            }
-
-        }
+            const int rowNodeId = nodeIdOfElement[rowNodePosition];
+            const int colNodeId = nodeIdOfElement[colNodePosition];
+            block.visitComponents([&](const DOF rowDof, const DOF colDof, const double value) {
+                nM->addComponent(rowNodeId, rowDof, colNodeId, colDof, value);
+            });
+        });
 
         if (configuration.logLevel >= LogLevel::DEBUG) {
             cout << "Element Matrix "<<matrix->bestId()<< " has been split into the smaller matrices ";
@@ -1674,7 +1801,7 @@ void Model::makeCellsFromLMPC() {
         for (const auto& constraintSet : analysis->getConstraintSets()) {
 
             // Group lmpcs by nodePositions
-            map<set<pos_t>, vector<shared_ptr<LinearMultiplePointConstraint>>> lmpcsByNodepositions;
+            map<PositionSet, vector<shared_ptr<LinearMultiplePointConstraint>>> lmpcsByNodepositions;
             for (const auto& constraint : constraintSet->getConstraintsByType(Constraint::Type::LMPC)) {
                 const auto& lmpc = static_pointer_cast<LinearMultiplePointConstraint>(constraint);
                 const auto& nodePositions = lmpc->nodePositions();
@@ -1746,10 +1873,12 @@ void Model::makeCellsFromLMPC() {
     // We don't do this during the loop because some LMPC may be used by several analysis.
     for (const auto& analysis : this->analyses) {
         for (const auto& constraintSet : analysis->getConstraintSets()) {
+            vector<Reference<Constraint>> constraintReferences;
             for (const auto& constraint : constraintSet->getConstraintsByType(Constraint::Type::LMPC)) {
-                remove(constraint->getReference(), constraintSet->getReference());
+                constraintReferences.push_back(constraint->getReference());
                 constraint->markAsWritten();
             }
+            removeAll(constraintReferences, constraintSet->getReference());
             if (constraintSet->empty())
                 constraintSet->markAsWritten();
         }
@@ -1897,10 +2026,12 @@ void Model::makeCellsFromRBE(){
             toBeRemoved.push_back(constraint);
         }
 
+        vector<Reference<Constraint>> constraintReferences;
         for(const auto& constraint: toBeRemoved) {
-            remove(constraint->getReference(), constraintSet->getReference());
+            constraintReferences.push_back(constraint->getReference());
             constraint->markAsWritten();
         }
+        removeAll(constraintReferences, constraintSet->getReference());
         if (constraintSet->empty())
             constraintSet->markAsWritten();
     }
@@ -1916,10 +2047,12 @@ void Model::makeCellsFromSurfaceSlide() {
             toBeRemoved.push_back(constraint);
         }
 
+        vector<Reference<Constraint>> constraintReferences;
         for(const auto& constraint: toBeRemoved) {
-            remove(constraint->getReference(), constraintSet->getReference());
+            constraintReferences.push_back(constraint->getReference());
             constraint->markAsWritten();
         }
+        removeAll(constraintReferences, constraintSet->getReference());
         if (constraintSet->empty())
             constraintSet->markAsWritten();
     }
@@ -2025,7 +2158,7 @@ void Model::changeParametricForceLineToAbsolute() {
         if (forceLine->getCellPositionsIncludingGroups().size() != 1)
             throw logic_error("Conversion of more than one cell per ForceLine not yet implemented (but should be doable)");
         const auto cellPosition = *(forceLine->getCellPositionsIncludingGroups().begin());
-        const Cell& cell = mesh.findCell(cellPosition);
+        const CellView& cell = mesh.cellView(cellPosition);
         const Node& node1 = mesh.findNode(cell.nodePositions[0]);
         const Node& node2 = mesh.findNode(cell.nodePositions[1]);
         if (is_equal(node1.x, node2.x))
@@ -2223,6 +2356,7 @@ void Model::finish() {
     for (const auto& coordinateSystemEntry : mesh.coordinateSystemStorage.coordinateSystemByRef) {
         coordinateSystemEntry.second->build();
     }
+    mesh.nodes.invalidateGlobalCoordinates();
 
     for (const auto& elementSet : elementSets) {
         for (const auto nodePosition : elementSet->nodePositions()) {
@@ -2447,7 +2581,7 @@ bool Model::checkWritten() const {
             }
         }
 
-        for (const auto& objective : analysis->getObjectives()) {
+        for (const auto& objective : analysis->getIndividualObjectives()) {
             if (objective->isWritten()) {
                 continue;
             }
@@ -24,6 +24,7 @@
 #include "Reference.h"
 #include "Target.h"
 #include <string>
+#include <tuple>
 
 namespace vega {
 
@@ -208,11 +209,53 @@ private:
     std::map< int, std::set<Reference<Objective>>>
     objectiveReferences_by_objectiveSet_ids;
 
+    /**
+     * Reverse indexes: the sets in which each loading (or constraint) has been added, so that it is
+     * removed from them without scanning every set.
+     */
+    std::map<Reference<Loading>, std::set<Reference<LoadSet>>>
+    loadSetReferences_by_loading;
+    std::map<Reference<Constraint>, std::set<Reference<ConstraintSet>>>
+    constraintSetReferences_by_constraint;
+    void removeFromLoadSets(const Reference<Loading>&);
+    void removeFromConstraintSets(const Reference<Constraint>&);
+    void removeFromConstraintSet(const Reference<Constraint>&, const Reference<ConstraintSet>&);
+
+    /**
+     * Members of a set resolved from the reference maps, once for all the objects and
+     * once by type when asked for.
+     */
+    template<class T> class ResolvedMembers final {
+    public:
+        std::shared_ptr<const std::vector<std::shared_ptr<T>>> all;
+        std::map<typename T::Type, std::shared_ptr<const std::vector<std::shared_ptr<T>>>> byType;
+        MemberView<T> ofType(typename T::Type);
+    };
+    /**
+     * Resolved members by set reference (type, original id, id): they are computed on demand and
+     * dropped as soon as a set membership or a container of the model changes.
+     */
+    mutable std::map<std::tuple<LoadSet::Type, int, int>, ResolvedMembers<Loading>> resolvedLoadings;
+    mutable std::map<std::tuple<ConstraintSet::Type, int, int>, ResolvedMembers<Constraint>> resolvedConstraints;
+    mutable std::map<std::tuple<ObjectiveSet::Type, int, int>, ResolvedMembers<Objective>> resolvedObjectives;
+    void membershipChanged() noexcept;
+    std::map<int, std::weak_ptr<NodalForceTable>> nodalForceTable_by_loadSet_id;
+    std::map<std::tuple<ConstraintSet::Type, int, int, char, double>, std::weak_ptr<SinglePointConstraint>> spcGroup_by_constraintSet_dofs_value;
+    ResolvedMembers<Loading>& resolveLoadSet(const Reference<LoadSet>&) const;
+    ResolvedMembers<Constraint>& resolveConstraintSet(const Reference<ConstraintSet>&) const;
+
     template<class T> class Container final {
     private:
         std::map<int, std::shared_ptr<T>> by_id;
         std::unordered_map< typename T::Type, std::map<int, std::shared_ptr<T>>,
         EnumClassHash> by_original_ids_by_type;
+        std::unordered_map< typename T::Type, std::map<int, std::shared_ptr<T>>,
+        EnumClassHash> by_ids_by_type; /**< Same content as by_id, split by type */
+        std::unordered_map<int, std::shared_ptr<T>> by_original_id; /**< Last object added with a given original id, whatever its type */
+        mutable std::unordered_map< typename T::Type, std::shared_ptr<const std::vector<std::shared_ptr<T>>>,
+        EnumClassHash> filtered_by_type; /**< Results of filter(), dropped when an object of the type is added or erased */
+        void indexById(const std::shared_ptr<T>&);
+        void indexByOriginalId(const std::shared_ptr<T>&);
         Model& model;
     public:
         Container(Model& model): model(model) {}
@@ -255,7 +298,7 @@ private:
         std::shared_ptr<T> find(int) const; /**< Find an object by its Original Id **/
         std::shared_ptr<T> get(int) const; /**< Return an object by its Vega Id **/
         bool contains(const typename T::Type type) const; /**< Ask if objects of a given type exist inside */
-        std::vector<std::shared_ptr<T>> filter(const typename T::Type type) const; /**< Choose objects based on their type */
+        MemberView<T> filter(const typename T::Type type) const; /**< Choose objects based on their type, in Vega id order */
         //const std::vector<std::shared_ptr<T>> filter(const std::unordered_set<const typename T::Type> types) const; /**< Choose objects based on their types */
         bool validate(); /**< Says if model parts are coherent (no unresolved references, etc.) AND SOMETIMES IT TRIES TO FIX THEM :( */
         bool checkWritten() const; /**< Says if all container objects have been written in output (or not) */
@@ -315,6 +358,8 @@ public:
 
     std::shared_ptr<LoadSet> getOrCreateLoadSet(int loadset_id, vega::LoadSet::Type); /**< Return or create a LoadSet by its real Id **/
     std::shared_ptr<ObjectiveSet> getOrCreateObjectiveSet(int objectiveSet_id, vega::ObjectiveSet::Type); /**< Return or create a LoadSet by its real Id **/
+    std::shared_ptr<NodalForceTable> getOrCreateNodalForceTable(const std::shared_ptr<LoadSet>&); /**< Return or create the table of nodal forces of a LoadSet **/
+    std::shared_ptr<SinglePointConstraint> getOrCreateSinglePointConstraint(const Reference<ConstraintSet>&, const DOFS&, double value); /**< Return or create the SPC of a ConstraintSet grouping the nodes blocked on these dofs to this value **/
 
     void setParameter(const ModelParameter& parameter, const std::string& value) noexcept;
 
@@ -328,15 +373,27 @@ public:
     std::vector<int> getElementSetsId() const;
     /**
      * Remove any kind of object from the model, by giving a reference.
-     * Very time consuming when the list is big : restrict use to the minimum
+     * Loadings and constraints are found in their sets through an index, other objects
+     * are searched in every set: restrict use to the minimum.
      */
     template<typename T>
     void remove(const Reference<T>);
 
+    /**
+     * Remove a batch of objects (Loading or Constraint) from the model and from their sets.
+     */
+    template<typename T>
+    void removeAll(const std::vector<Reference<T>>&);
+
     /**
      * Remove a constraint from a known reference set when we already know some informations
      */
     void remove(const Reference<Constraint>, const Reference<ConstraintSet>);
+
+    /**
+     * Remove a batch of constraints from a known reference set.
+     */
+    void removeAll(const std::vector<Reference<Constraint>>&, const Reference<ConstraintSet>);
     /**
      * Retrieve any kind of object from the model, by giving a reference.
      * Return nullptr if the object is not found in the model.
@@ -358,7 +415,12 @@ public:
     /**
      * Retrieve all the Loadings corresponding to a given LoadSet.
      */
-    std::set<std::shared_ptr<Loading>, ptrLess<Loading>> getLoadingsByLoadSet(const Reference<LoadSet>&) const;
+    MemberView<Loading> getLoadingsByLoadSet(const Reference<LoadSet>&) const;
+
+    /**
+     * Retrieve the Loadings of a given type corresponding to a given LoadSet.
+     */
+    MemberView<Loading> getLoadingsByLoadSet(const Reference<LoadSet>&, Loading::Type) const;
 
     /**
      * Create a material
@@ -390,7 +452,12 @@ public:
     /**
      * Retrieve all the Constraints corresponding to a given ConstraintSet.
      */
-    std::set<std::shared_ptr<Constraint>, ptrLess<Constraint>> getConstraintsByConstraintSet(const Reference<ConstraintSet>&) const;
+    MemberView<Constraint> getConstraintsByConstraintSet(const Reference<ConstraintSet>&) const;
+
+    /**
+     * Retrieve the Constraints of a given type corresponding to a given ConstraintSet.
+     */
+    MemberView<Constraint> getConstraintsByConstraintSet(const Reference<ConstraintSet>&, Constraint::Type) const;
 
     /**
      * Retrieve all the ConstraintSet containing a corresponding Constraint.
@@ -410,7 +477,7 @@ public:
     /**
      * Retrieve all the Objectives corresponding to a given ObjectiveSet.
      */
-    std::set<std::shared_ptr<Objective>, ptrLess<Objective>> getObjectivesByObjectiveSet(const Reference<ObjectiveSet>&) const;
+    MemberView<Objective> getObjectivesByObjectiveSet(const Reference<ObjectiveSet>&) const;
 
     /**
      * Retrieve all the ConstraintSet of the model that are common to all analysis
@@ -461,20 +528,79 @@ public:
  * Template implementations need to stay in header
  */
 
+template<class T>
+MemberView<T> Model::ResolvedMembers<T>::ofType(const typename T::Type type) {
+    auto& members = byType[type];
+    if (members == nullptr) {
+        std::vector<std::shared_ptr<T>> result;
+        for (const auto& member : *all) {
+            if (member->type == type) {
+                result.push_back(member);
+            }
+        }
+        members = std::make_shared<const std::vector<std::shared_ptr<T>>>(std::move(result));
+    }
+    return members;
+}
+
+inline void Model::membershipChanged() noexcept {
+    resolvedLoadings.clear();
+    resolvedConstraints.clear();
+    resolvedObjectives.clear();
+}
+
+template<class T>
+void Model::Container<T>::indexById(const std::shared_ptr<T>& ptr) {
+    by_id[ptr->getId()] = ptr;
+    by_ids_by_type[ptr->type][ptr->getId()] = ptr;
+    filtered_by_type.erase(ptr->type);
+}
+
+template<class T>
+void Model::Container<T>::indexByOriginalId(const std::shared_ptr<T>& ptr) {
+    by_original_ids_by_type[ptr->type][ptr->getOriginalId()] = ptr;
+    by_original_id[ptr->getOriginalId()] = ptr;
+}
+
 template<class T>
 void Model::Container<T>::erase(const Reference<T> ref) {
-    by_id.erase(ref.id);
-    if (ref.has_original_id())
+    model.membershipChanged();
+    const auto& it = by_id.find(ref.id);
+    if (it != by_id.end()) {
+        const auto type = it->second->type;
+        by_ids_by_type[type].erase(ref.id);
+        filtered_by_type.erase(type);
+        by_id.erase(it);
+    }
+    if (ref.has_original_id()) {
         by_original_ids_by_type[ref.type].erase(ref.original_id);
+        const auto& itOriginal = by_original_id.find(ref.original_id);
+        if (itOriginal != by_original_id.end() and itOriginal->second->type == ref.type) {
+            // Another type can still hold this original id
+            by_original_id.erase(itOriginal);
+            for (const auto& original_ids : by_original_ids_by_type) {
+                const auto& it2 = original_ids.second.find(ref.original_id);
+                if (it2 != original_ids.second.end()) {
+                    by_original_id[ref.original_id] = it2->second;
+                }
+            }
+        }
+    }
 }
 
 template<class T>
-std::vector<std::shared_ptr<T>> Model::Container<T>::filter(const typename T::Type type) const {
-    std::vector<std::shared_ptr<T>> result;
-    for (const auto& id_obj_pair: by_id) {
-        if (id_obj_pair.second->type == type) {
-            result.push_back(id_obj_pair.second);
+MemberView<T> Model::Container<T>::filter(const typename T::Type type) const {
+    auto& result = filtered_by_type[type];
+    if (result == nullptr) {
+        std::vector<std::shared_ptr<T>> objects;
+        const auto& it = by_ids_by_type.find(type);
+        if (it != by_ids_by_type.end()) {
+            objects.reserve(it->second.size());
+            for (const auto& id_obj_pair : it->second) {
+                objects.push_back(id_obj_pair.second);
+            }
         }
+        result = std::make_shared<const std::vector<std::shared_ptr<T>>>(std::move(objects));
     }
     return result;
 }
@@ -492,12 +618,8 @@ std::vector<std::shared_ptr<T>> Model::Container<T>::filter(const std::unordered
 
 template<class T>
 bool Model::Container<T>::contains(const typename T::Type type) const {
-    for (const auto& id_obj_pair: by_id) {
-        if (id_obj_pair.second->type == type) {
-            return true;
-        }
-    }
-    return false;
+    const auto& it = by_ids_by_type.find(type);
+    return it != by_ids_by_type.end() and not it->second.empty();
 }
 
 template<class T>
@@ -572,10 +694,10 @@ inline void Model::Container<NamedValue>::add(std::shared_ptr<NamedValue> ptr) {
         }
     }
     if (!ptr->isPlaceHolder()) {
-        by_id[ptr->getId()] = ptr;
+        indexById(ptr);
     }
     if (ptr->isOriginal()) {
-        by_original_ids_by_type[ptr->type][ptr->getOriginalId()] = ptr;
+        indexByOriginalId(ptr);
     }
 }
 
@@ -586,9 +708,10 @@ void Model::Container<T>::add(std::shared_ptr<T> ptr) {
         oss << *ptr << " is already in the model";
         throw std::runtime_error(oss.str());
     }
-    by_id[ptr->getId()] = ptr;
+    model.membershipChanged();
+    indexById(ptr);
     if (ptr->isOriginal())
-        by_original_ids_by_type[ptr->type][ptr->getOriginalId()] = ptr;
+        indexByOriginalId(ptr);
 }
 
 template<class T>
@@ -617,11 +740,9 @@ std::shared_ptr<T> Model::Container<T>::find(const Reference<T>& reference) cons
 template<class T>
 std::shared_ptr<T> Model::Container<T>::find(int original_id) const {
     std::shared_ptr<T> t;
-    for (const auto& it : by_original_ids_by_type) {
-        const auto& it2 = it.second.find(original_id);
-        if (it2 != it.second.end()) {
-            t = it2->second;
-        }
+    const auto& it = by_original_id.find(original_id);
+    if (it != by_original_id.end()) {
+        t = it->second;
     }
     return t;
 }
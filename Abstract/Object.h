@@ -27,9 +27,11 @@
 
 #include "Reference.h"
 #include <climits>
+#include <memory>
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <vector>
 
 namespace vega {
 
@@ -109,6 +111,20 @@ public:
             original_id(original_id), id(++auto_id) {
     }
 
+protected:
+    /**
+     * Id given by the owner of a transient view, which must not consume auto_id
+     */
+    struct ViewId final {
+        int id;
+    };
+
+    explicit Identifiable(const ViewId viewId) noexcept :
+            original_id(NO_ORIGINAL_ID), id(viewId.id) {
+    }
+
+public:
+
     virtual bool validate() const {
         return true;
     }
@@ -202,6 +218,28 @@ struct ptrLess {
     }
 };
 
+/**
+ * Read-only view over the members of a set (LoadSet, ConstraintSet...), in ptrLess order.
+ * The vector is shared with the cache of the model: the view stays valid if the model changes.
+ */
+template<class T>
+class MemberView final {
+    std::shared_ptr<const std::vector<std::shared_ptr<T>>> members;
+public:
+    using const_iterator = typename std::vector<std::shared_ptr<T>>::const_iterator;
+    MemberView(std::shared_ptr<const std::vector<std::shared_ptr<T>>> members) noexcept :
+            members(std::move(members)) {
+    }
+    explicit MemberView(std::vector<std::shared_ptr<T>>&& members) :
+            members(std::make_shared<const std::vector<std::shared_ptr<T>>>(std::move(members))) {
+    }
+    const_iterator begin() const noexcept {return members->begin();};
+    const_iterator end() const noexcept {return members->end();};
+    size_t size() const noexcept {return members->size();};
+    bool empty() const noexcept {return members->empty();};
+    const std::shared_ptr<T>& operator[](size_t i) const noexcept {return (*members)[i];};
+};
+
 //template<class T>
 //struct ptrGroup {
 //    bool operator()(const std::shared_ptr<T>& lhs,
@@ -35,6 +35,10 @@ Objective::Objective(Model& model, const std::shared_ptr<ObjectiveSet> objective
     }
 }
 
+Objective::Objective(Model& model, Objective::Type type, ViewId viewId) :
+        Identifiable(viewId), model(model), type(type), objectiveset(nullptr) {
+}
+
 const string Objective::name = "Objective";
 
 const map<Objective::Type, string> Objective::stringByType = {
@@ -66,33 +70,129 @@ ObjectiveSet::ObjectiveSet(Model& model, const Reference<ObjectiveSet>& objectiv
 		Identifiable(objectiveSetRef.original_id), model(model), type(objectiveSetRef.type) {
 }
 
+void NodalDisplacementAssertionTable::add(pos_t nodePosition, int nodeId, DOF dof, double value, double instant,
+        double tolerance) {
+    nodePositions.push_back(nodePosition);
+    nodeIds.push_back(nodeId);
+    dofs.push_back(dof);
+    values.push_back(value);
+    instants.push_back(instant);
+    tolerances.push_back(tolerance);
+}
+
+void NodalDisplacementAssertionTable::append(const NodalDisplacementAssertionTable& other) {
+    nodePositions.insert(nodePositions.end(), other.nodePositions.begin(), other.nodePositions.end());
+    nodeIds.insert(nodeIds.end(), other.nodeIds.begin(), other.nodeIds.end());
+    dofs.insert(dofs.end(), other.dofs.begin(), other.dofs.end());
+    values.insert(values.end(), other.values.begin(), other.values.end());
+    instants.insert(instants.end(), other.instants.begin(), other.instants.end());
+    tolerances.insert(tolerances.end(), other.tolerances.begin(), other.tolerances.end());
+}
+
+void NodalDisplacementAssertionTable::reserve(size_t rowCount) {
+    nodePositions.reserve(rowCount);
+    nodeIds.reserve(rowCount);
+    dofs.reserve(rowCount);
+    values.reserve(rowCount);
+    instants.reserve(rowCount);
+    tolerances.reserve(rowCount);
+}
+
+void NodalDisplacementAssertionTable::filter(const vector<bool>& keep) {
+    size_t kept = 0;
+    for (size_t row = 0; row < size(); row++) {
+        if (not keep[row])
+            continue;
+        if (kept != row) {
+            nodePositions[kept] = nodePositions[row];
+            nodeIds[kept] = nodeIds[row];
+            dofs[kept] = dofs[row];
+            values[kept] = values[row];
+            instants[kept] = instants[row];
+            tolerances[kept] = tolerances[row];
+        }
+        kept++;
+    }
+    nodePositions.resize(kept);
+    nodeIds.resize(kept);
+    dofs.erase(dofs.begin() + static_cast<ptrdiff_t>(kept), dofs.end());
+    values.resize(kept);
+    instants.resize(kept);
+    tolerances.resize(kept);
+}
+
 void ObjectiveSet::add(const Reference<ObjectiveSet>& objectiveSetReference) {
     objectiveSetReferences.push_back(objectiveSetReference);
 }
 
-set<shared_ptr<Objective>, ptrLess<Objective> > ObjectiveSet::getObjectives() const {
-    auto result = model.getObjectivesByObjectiveSet(this->getReference());
+void ObjectiveSet::add(const NodalDisplacementAssertionTable& rows) {
+    if (this->getReference() == model.commonObjectiveSet->getReference()
+            && model.find(this->getReference()) == nullptr)
+        model.add(model.commonObjectiveSet); // commonObjectiveSet is added to the model if needed
+    nodalDisplacementAssertions.append(rows);
+}
+
+MemberView<Objective> ObjectiveSet::getIndividualObjectives() const {
+    const auto& ownObjectives = model.getObjectivesByObjectiveSet(this->getReference());
+    if (objectiveSetReferences.empty())
+        return ownObjectives;
+    set<shared_ptr<Objective>, ptrLess<Objective> > result(ownObjectives.begin(), ownObjectives.end());
     for (const auto& objectiveSetReference : objectiveSetReferences) {
         const auto& setToInsert = model.getObjectivesByObjectiveSet(
                 objectiveSetReference);
         result.insert(setToInsert.begin(), setToInsert.end());
     }
+    return MemberView<Objective>(vector<shared_ptr<Objective>>(result.begin(), result.end()));
+}
+
+vector<const NodalDisplacementAssertionTable*> ObjectiveSet::getNodalDisplacementAssertionTables() const {
+    vector<const NodalDisplacementAssertionTable*> result;
+    if (not nodalDisplacementAssertions.empty())
+        result.push_back(&nodalDisplacementAssertions);
+    for (const auto& objectiveSetReference : objectiveSetReferences) {
+        const auto& objectiveSet = model.find(objectiveSetReference);
+        if (objectiveSet != nullptr and not objectiveSet->nodalDisplacementAssertions.empty())
+            result.push_back(&objectiveSet->nodalDisplacementAssertions);
+    }
+    return result;
+}
+
+void ObjectiveSet::insertTableViews(set<shared_ptr<Objective>, ptrLess<Objective> >& result) const {
+    int viewId = 0;
+    for (const auto& table : getNodalDisplacementAssertionTables()) {
+        for (size_t row = 0; row < table->size(); row++) {
+            result.insert(make_shared<NodalDisplacementAssertion>(model, *table, row, --viewId));
+        }
+    }
+}
+
+set<shared_ptr<Objective>, ptrLess<Objective> > ObjectiveSet::getObjectives() const {
+    const auto& individualObjectives = getIndividualObjectives();
+    set<shared_ptr<Objective>, ptrLess<Objective> > result(individualObjectives.begin(), individualObjectives.end());
+    insertTableViews(result);
     return result;
 }
 
 set<shared_ptr<Objective>, ptrLess<Objective> > ObjectiveSet::getObjectivesByType(
         Objective::Type type) const {
     set<shared_ptr<Objective>, ptrLess<Objective> > result;
-    for (const auto& objective : getObjectives()) {
+    for (const auto& objective : getIndividualObjectives()) {
         if (objective->type == type) {
             result.insert(objective);
         }
     }
+    if (type == Objective::Type::NODAL_DISPLACEMENT_ASSERTION) {
+        insertTableViews(result);
+    }
     return result;
 }
 
 size_t ObjectiveSet::size() const {
-    return getObjectives().size();
+    size_t tableRows = 0;
+    for (const auto& table : getNodalDisplacementAssertionTables()) {
+        tableRows += table->size();
+    }
+    return getIndividualObjectives().size() + tableRows;
 }
 
 unique_ptr<ObjectiveSet> ObjectiveSet::clone() const {
@@ -123,16 +223,25 @@ Assertion::Assertion(Model& model, const std::shared_ptr<ObjectiveSet> objective
         Objective(model, objectiveset, type, original_id), tolerance(tolerance) {
 }
 
+Assertion::Assertion(Model& model, Type type, double tolerance, ViewId viewId) :
+        Objective(model, type, viewId), tolerance(tolerance) {
+}
+
 NodalAssertion::NodalAssertion(Model& model, const std::shared_ptr<ObjectiveSet> objectiveset, Type type, double tolerance, int nodeId,
         DOF dof, int original_id) :
         Assertion(model, objectiveset, type, tolerance, original_id), nodePosition(model.mesh.findOrReserveNode(nodeId)), nodeId(nodeId), dof(dof) {
 }
 
+NodalAssertion::NodalAssertion(Model& model, Type type, double tolerance, pos_t nodePosition, int nodeId, DOF dof,
+        ViewId viewId) :
+        Assertion(model, type, tolerance, viewId), nodePosition(nodePosition), nodeId(nodeId), dof(dof) {
+}
+
 DOFS NodalAssertion::getDOFSForNode(const pos_t nodePosition) const {
     UNUSEDV(nodePosition);
     return dof;
 }
-set<pos_t> NodalAssertion::nodePositions() const {
+PositionSet NodalAssertion::nodePositions() const {
     return {nodePosition};
 }
 
@@ -142,6 +251,13 @@ NodalDisplacementAssertion::NodalDisplacementAssertion(Model& model, const std::
                 original_id), value(value), instant(instant) {
 }
 
+NodalDisplacementAssertion::NodalDisplacementAssertion(Model& model, const NodalDisplacementAssertionTable& table,
+        size_t row, int viewId) :
+        NodalAssertion(model, Objective::Type::NODAL_DISPLACEMENT_ASSERTION, table.tolerances[row],
+                table.nodePositions[row], table.nodeIds[row], table.dofs[row], ViewId{viewId}),
+                value(table.values[row]), instant(table.instants[row]) {
+}
+
 ostream &operator<<(ostream &out, const NodalDisplacementAssertion& objective) {
     out << to_str(objective) << "Node Pos " << objective.nodePosition << " DOF " << objective.dof << " "
             << objective.value;
@@ -171,7 +287,7 @@ DOFS FrequencyAssertion::getDOFSForNode(const pos_t nodePosition) const {
     UNUSEDV(nodePosition);
     return DOFS::NO_DOFS;
 }
-set<pos_t> FrequencyAssertion::nodePositions() const {
+PositionSet FrequencyAssertion::nodePositions() const {
     return {};
 }
 
@@ -190,7 +306,7 @@ NodalCellVonMisesAssertion::NodalCellVonMisesAssertion(Model& model,
 DOFS NodalCellVonMisesAssertion::getDOFSForNode(const pos_t) const {
     return DOFS::NO_DOFS;
 }
-set<pos_t> NodalCellVonMisesAssertion::nodePositions() const {
+PositionSet NodalCellVonMisesAssertion::nodePositions() const {
     return {nodePosition};
 }
 
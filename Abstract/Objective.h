@@ -28,6 +28,7 @@
 #include <memory>
 #include <set>
 #include <complex>
+#include <vector>
 #include "Value.h"
 #include "Object.h"
 #include "Reference.h"
@@ -68,6 +69,7 @@ public:
     const std::shared_ptr<ObjectiveSet> objectiveset;
 protected:
     Objective(Model&, const std::shared_ptr<ObjectiveSet>, Objective::Type, int original_id = NO_ORIGINAL_ID);
+    Objective(Model&, Objective::Type, ViewId);
     Objective(const Objective& that) = delete;
 public:
     virtual ~Objective() = default;
@@ -79,6 +81,32 @@ public:
     }
 };
 
+class NodalDisplacementAssertion;
+
+/**
+ * Nodal displacement assertions stored by columns, one row per node and DOF.
+ * Result readers can bring one row per DOF of every node of the model, these rows
+ * are kept in flat arrays instead of one Objective each.
+ */
+class NodalDisplacementAssertionTable final {
+public:
+    std::vector<pos_t> nodePositions;
+    std::vector<int> nodeIds;
+    std::vector<DOF> dofs;
+    std::vector<double> values;
+    std::vector<double> instants;
+    std::vector<double> tolerances;
+    void add(pos_t nodePosition, int nodeId, DOF dof, double value, double instant, double tolerance);
+    void append(const NodalDisplacementAssertionTable&);
+    void reserve(size_t rowCount);
+    /**
+     * Keep only the rows for which keep[row] is true, preserving their order.
+     */
+    void filter(const std::vector<bool>& keep);
+    inline size_t size() const noexcept {return values.size();};
+    inline bool empty() const noexcept {return values.empty();};
+};
+
 /**
  * Set of objectives that are referenced by an analysis.
  */
@@ -86,6 +114,7 @@ class ObjectiveSet final: public Identifiable<ObjectiveSet> {
 	Model& model;
 	std::vector<Reference<ObjectiveSet>> objectiveSetReferences;
 	friend std::ostream &operator<<(std::ostream&, const ObjectiveSet&);
+	void insertTableViews(std::set<std::shared_ptr<Objective>, ptrLess<Objective>>&) const;
 public:
 	enum class Type {
 	    DISP,
@@ -105,7 +134,24 @@ public:
 	const Type type;
 	static const std::string name;
 	static const std::map<Type, std::string> stringByType;
+	NodalDisplacementAssertionTable nodalDisplacementAssertions;
 	void add(const Reference<ObjectiveSet>&);
+	/**
+	 * Append rows to the nodal displacement assertions of this set.
+	 */
+	void add(const NodalDisplacementAssertionTable&);
+	/**
+	 * Objectives stored one by one in the model, without the table rows.
+	 */
+	MemberView<Objective> getIndividualObjectives() const;
+	/**
+	 * Tables of this set and of the sets it references, to be iterated in bulk.
+	 */
+	std::vector<const NodalDisplacementAssertionTable*> getNodalDisplacementAssertionTables() const;
+	/**
+	 * All the objectives: table rows are returned as NodalDisplacementAssertion views,
+	 * with negative ids that are only unique within the returned set.
+	 */
 	std::set<std::shared_ptr<Objective>, ptrLess<Objective>> getObjectives() const;
 	std::set<std::shared_ptr<Objective>, ptrLess<Objective>> getObjectivesByType(Objective::Type) const;
 	size_t size() const;
@@ -116,10 +162,11 @@ public:
 class Assertion: public Objective {
 protected:
     Assertion(Model&, const std::shared_ptr<ObjectiveSet>, Type, double tolerance, int original_id = NO_ORIGINAL_ID);
+    Assertion(Model&, Type, double tolerance, ViewId);
 public:
     const double tolerance;
     virtual DOFS getDOFSForNode(const pos_t nodePosition) const = 0;
-    virtual std::set<pos_t> nodePositions() const = 0;
+    virtual PositionSet nodePositions() const = 0;
     bool isAssertion() const noexcept override {
         return true;
     }
@@ -129,12 +176,13 @@ class NodalAssertion: public Assertion {
 protected:
     NodalAssertion(Model&, const std::shared_ptr<ObjectiveSet>, Type, double tolerance, int nodeId, DOF dof,
             int original_id = NO_ORIGINAL_ID);
+    NodalAssertion(Model&, Type, double tolerance, pos_t nodePosition, int nodeId, DOF dof, ViewId);
 public:
     const pos_t nodePosition;
     const int nodeId;
     const DOF dof;
     DOFS getDOFSForNode(const pos_t nodePosition) const override final;
-    std::set<pos_t> nodePositions() const override final;
+    PositionSet nodePositions() const override final;
 };
 
 class NodalDisplacementAssertion: public NodalAssertion {
@@ -143,6 +191,11 @@ public:
     const double instant = -1;
     NodalDisplacementAssertion(Model&, const std::shared_ptr<ObjectiveSet>, double tolerance, int nodeId, DOF dof,
             double value, double instant, int original_id = NO_ORIGINAL_ID);
+    /**
+     * View over a table row: it is not registered in the model nor in any ObjectiveSet,
+     * and takes viewId instead of a new auto id.
+     */
+    NodalDisplacementAssertion(Model&, const NodalDisplacementAssertionTable&, size_t row, int viewId);
     friend std::ostream& operator<<(std::ostream&, const NodalDisplacementAssertion&);
 };
 
@@ -166,7 +219,7 @@ public:
     FrequencyAssertion(Model&, const std::shared_ptr<ObjectiveSet>, int number, double cycles, double eigenValue, double generalizedMass, double generalizedStiffness, double tolerance, int original_id =
             NO_ORIGINAL_ID);
     DOFS getDOFSForNode(const pos_t nodePosition) const override final;
-    std::set<pos_t> nodePositions() const override final;
+    PositionSet nodePositions() const override final;
     friend std::ostream& operator<<(std::ostream&, const FrequencyAssertion&);
 };
 
@@ -181,7 +234,7 @@ public:
     NodalCellVonMisesAssertion(Model&, const std::shared_ptr<ObjectiveSet>, double tolerance, int cellId, int nodeId, double value, int original_id =
             NO_ORIGINAL_ID);
     DOFS getDOFSForNode(const pos_t nodePosition) const override final;
-    std::set<pos_t> nodePositions() const override final;
+    PositionSet nodePositions() const override final;
     friend std::ostream& operator<<(std::ostream&, const NodalCellVonMisesAssertion&);
 };
 
@@ -136,11 +136,12 @@ void Tokenizer::handleParsingError(const string& message) {
 
     switch (translationMode) {
     case ConfigurationParameters::TranslationMode::MODE_STRICT:
+        if (deferStrictErrors) {
+            throw ParsingException(message, fileName, lineNumber, currentKeyword);
+        }
         // Problem on static over Alpine
         //throw ParsingException(message, fileName, lineNumber, currentKeyword);
-        cerr << ParsingException(message, fileName, lineNumber, currentKeyword);
-        vega::stacktrace();
-        exit(2);
+        exitOnParsingError(ParsingException(message, fileName, lineNumber, currentKeyword));
     case ConfigurationParameters::TranslationMode::MESH_AT_LEAST:
         //model.onlyMesh = true;
         cerr << ParsingMessageException(message, fileName, lineNumber, currentKeyword) << endl;
@@ -156,6 +157,12 @@ void Tokenizer::handleParsingError(const string& message) {
     }
 }
 
+void Tokenizer::exitOnParsingError(const ParsingException& parsingException) {
+    cerr << parsingException;
+    vega::stacktrace();
+    exit(2);
+}
+
 void Tokenizer::handleParsingWarning(const string& message) {
     cerr << ParsingMessageWarning(message, fileName, lineNumber, currentKeyword);
 }
@@ -58,6 +58,8 @@ protected:
 	vega::ConfigurationParameters::TranslationMode translationMode;
 	int lineNumber;
 	std::string currentKeyword; /**< Current Keyword: only used for printout and error managment. **/
+	bool deferStrictErrors = false; /**< Strict mode throws the ParsingException instead of exiting **/
+	[[noreturn]] static void exitOnParsingError(const ParsingException&);
 
 public:
 	virtual ~Tokenizer() = default;
@@ -69,6 +71,11 @@ public:
 	virtual std::string currentRawDataLine() const = 0;
 	inline InputContext getInputContext() const noexcept {return {lineNumber, fileName, currentRawDataLine()};}
 	void setCurrentKeyword(std::string cK) noexcept {currentKeyword=cK;};
+	/**
+	 * Used by tokenizers running outside of the parsing thread: in strict mode, errors are thrown as
+	 * ParsingException, to be reported by the parsing thread, instead of exiting the program.
+	 */
+	void deferParsingErrors() noexcept {deferStrictErrors=true;};
 
     /**
      * Generic handler for parsing exceptions.
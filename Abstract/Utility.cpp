@@ -16,8 +16,11 @@
 #include <boost/numeric/ublas/io.hpp>
 #include <boost/numeric/ublas/lu.hpp>
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <cstring>
+#include <locale>
 
 namespace ublas = boost::numeric::ublas;
 
@@ -166,4 +169,599 @@ void handler(int sig) {
     exit(1);
 }
 
+PositionSet::PositionSet(initializer_list<pos_t> positions) {
+    insert(positions.begin(), positions.end());
+}
+
+void PositionSet::append(const pos_t position) noexcept {
+    if (not runs.empty() and runEnd(runs.back()) == position) {
+        runs.back().count++;
+    } else {
+        runs.push_back({position, 1});
+    }
+    positionCount++;
+}
+
+void PositionSet::insert(const pos_t position) {
+    if (pending.empty() and (runs.empty() or position >= runEnd(runs.back()))) {
+        append(position);
+    } else {
+        pending.push_back(position);
+    }
+}
+
+void PositionSet::insert(const PositionSet& other) {
+    if (other.empty() or &other == this) {
+        return;
+    }
+    normalize();
+    other.normalize();
+    if (runs.empty() or other.runs.front().first >= runEnd(runs.back())) {
+        for (const auto& run : other.runs) {
+            if (not runs.empty() and runEnd(runs.back()) == run.first) {
+                runs.back().count += run.count;
+            } else {
+                runs.push_back(run);
+            }
+            positionCount += run.count;
+        }
+        return;
+    }
+    vector<Run> merged;
+    merged.reserve(runs.size() + other.runs.size());
+    positionCount = 0;
+    auto it1 = runs.begin();
+    auto it2 = other.runs.begin();
+    while (it1 != runs.end() or it2 != other.runs.end()) {
+        Run next;
+        if (it2 == other.runs.end() or (it1 != runs.end() and it1->first <= it2->first)) {
+            next = *it1++;
+        } else {
+            next = *it2++;
+        }
+        if (not merged.empty() and next.first <= runEnd(merged.back())) {
+            Run& last = merged.back();
+            const size_t end = max(runEnd(last), runEnd(next));
+            positionCount += end - runEnd(last);
+            last.count = static_cast<pos_t>(end - last.first);
+        } else {
+            merged.push_back(next);
+            positionCount += next.count;
+        }
+    }
+    runs.swap(merged);
+}
+
+void PositionSet::normalize() const {
+    if (pending.empty()) {
+        return;
+    }
+    sort(pending.begin(), pending.end());
+    pending.erase(unique(pending.begin(), pending.end()), pending.end());
+    PositionSet others;
+    for (const pos_t position : pending) {
+        others.append(position);
+    }
+    pending.clear();
+    const_cast<PositionSet*>(this)->insert(others);
+}
+
+size_t PositionSet::erase(const pos_t position) {
+    normalize();
+    auto it = upper_bound(runs.begin(), runs.end(), position, [](const pos_t pos, const Run& run) {
+        return pos < run.first;
+    });
+    if (it == runs.begin()) {
+        return 0;
+    }
+    --it;
+    if (position >= runEnd(*it)) {
+        return 0;
+    }
+    if (it->count == 1) {
+        runs.erase(it);
+    } else if (position == it->first) {
+        it->first++;
+        it->count--;
+    } else if (static_cast<size_t>(position) + 1 == runEnd(*it)) {
+        it->count--;
+    } else {
+        const Run after{position + 1, static_cast<pos_t>(runEnd(*it) - position - 1)};
+        it->count = position - it->first;
+        runs.insert(it + 1, after);
+    }
+    positionCount--;
+    return 1;
+}
+
+size_t PositionSet::erase(const PositionSet& other) {
+    if (other.empty() or empty()) {
+        return 0;
+    }
+    if (&other == this) {
+        const size_t erased = size();
+        clear();
+        return erased;
+    }
+    normalize();
+    other.normalize();
+    vector<Run> remaining;
+    remaining.reserve(runs.size() + other.runs.size());
+    const size_t previousCount = positionCount;
+    positionCount = 0;
+    auto it2 = other.runs.begin();
+    for (const auto& run : runs) {
+        size_t first = run.first;
+        const size_t end = runEnd(run);
+        while (it2 != other.runs.end() and runEnd(*it2) <= first) {
+            ++it2;
+        }
+        for (; it2 != other.runs.end() and it2->first < end; ++it2) {
+            if (it2->first > first) {
+                remaining.push_back({static_cast<pos_t>(first), static_cast<pos_t>(it2->first - first)});
+                positionCount += it2->first - first;
+            }
+            first = max(first, runEnd(*it2));
+            if (runEnd(*it2) > end) {
+                // may also cover the next runs
+                break;
+            }
+        }
+        if (first < end) {
+            remaining.push_back({static_cast<pos_t>(first), static_cast<pos_t>(end - first)});
+            positionCount += end - first;
+        }
+    }
+    runs.swap(remaining);
+    return previousCount - positionCount;
+}
+
+void PositionSet::clear() noexcept {
+    runs.clear();
+    pending.clear();
+    positionCount = 0;
+}
+
+PositionSet::const_iterator PositionSet::find(const pos_t position) const {
+    normalize();
+    auto it = upper_bound(runs.begin(), runs.end(), position, [](const pos_t pos, const Run& run) {
+        return pos < run.first;
+    });
+    if (it == runs.begin()) {
+        return end();
+    }
+    --it;
+    if (position >= runEnd(*it)) {
+        return end();
+    }
+    return const_iterator(&runs, static_cast<size_t>(it - runs.begin()), position - it->first);
+}
+
+bool PositionSet::contains(const pos_t position) const {
+    return find(position) != end();
+}
+
+size_t PositionSet::size() const {
+    normalize();
+    return positionCount;
+}
+
+PositionSet::const_iterator PositionSet::begin() const {
+    normalize();
+    return const_iterator(&runs, 0, 0);
+}
+
+PositionSet::const_iterator PositionSet::end() const {
+    normalize();
+    return const_iterator(&runs, runs.size(), 0);
+}
+
+const vector<PositionSet::Run>& PositionSet::getRuns() const {
+    normalize();
+    return runs;
+}
+
+bool PositionSet::operator==(const PositionSet& other) const {
+    normalize();
+    other.normalize();
+    if (runs.size() != other.runs.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < runs.size(); ++i) {
+        if (runs[i].first != other.runs[i].first or runs[i].count != other.runs[i].count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PositionSet::operator<(const PositionSet& other) const {
+    return lexicographical_compare(begin(), end(), other.begin(), other.end());
+}
+
+namespace {
+
+/**
+ * Floating point number f * 2^e with a 64 bits significand, as in Grisu (Loitsch, "Printing floating-point
+ * numbers quickly and accurately with integers", 2010).
+ */
+struct DiyFp final {
+    static const uint64_t HIDDEN_BIT = uint64_t(1) << 52;
+    uint64_t f;
+    int e;
+    DiyFp(const uint64_t f, const int e) noexcept : f(f), e(e) {
+    }
+    explicit DiyFp(const double value) noexcept {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        const int biasedExponent = static_cast<int>((bits >> 52) & 0x7FF);
+        const uint64_t significand = bits & (HIDDEN_BIT - 1);
+        if (biasedExponent != 0) {
+            f = significand + HIDDEN_BIT;
+            e = biasedExponent - 1075;
+        } else {
+            f = significand; // subnormal
+            e = -1074;
+        }
+    }
+    DiyFp operator-(const DiyFp& other) const noexcept {
+        return DiyFp(f - other.f, e);
+    }
+    /**
+     * Product rounded to the 64 upper bits.
+     */
+    DiyFp operator*(const DiyFp& other) const noexcept {
+        const uint64_t M32 = 0xFFFFFFFF;
+        const uint64_t a = f >> 32, b = f & M32, c = other.f >> 32, d = other.f & M32;
+        const uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+        uint64_t middle = (bd >> 32) + (ad & M32) + (bc & M32);
+        middle += uint64_t(1) << 31;
+        return DiyFp(ac + (ad >> 32) + (bc >> 32) + (middle >> 32), e + other.e + 64);
+    }
+    DiyFp normalize() const noexcept {
+        DiyFp result = *this;
+        while (not (result.f & (uint64_t(1) << 63))) {
+            result.f <<= 1;
+            result.e--;
+        }
+        return result;
+    }
+    /**
+     * Boundaries m- and m+ of the double: halfway to its neighbours, with the exponent of normalized m+.
+     */
+    void normalizedBoundaries(DiyFp& minus, DiyFp& plus) const noexcept {
+        plus = DiyFp((f << 1) + 1, e - 1).normalize();
+        minus = f == HIDDEN_BIT ? DiyFp((f << 2) - 1, e - 2) : DiyFp((f << 1) - 1, e - 1);
+        minus.f <<= minus.e - plus.e;
+        minus.e = plus.e;
+    }
+};
+
+/**
+ * Normalized powers 10^k for k = -348, -340, ..., 340, rounded to 64 bits. They are computed once with
+ * exact integers rather than stored as a table.
+ */
+class CachedPowers final {
+    static const int FIRST_POWER = -348;
+    static const int POWER_STEP = 8;
+    static const int POWER_COUNT = 87;
+    vector<DiyFp> powers;
+    /** Little endian unsigned big integer **/
+    using BigInt = vector<uint32_t>;
+    static void multiply(BigInt& n, const uint32_t factor) noexcept {
+        uint64_t carry = 0;
+        for (auto& word : n) {
+            const uint64_t product = static_cast<uint64_t>(word) * factor + carry;
+            word = static_cast<uint32_t>(product);
+            carry = product >> 32;
+        }
+        if (carry) {
+            n.push_back(static_cast<uint32_t>(carry));
+        }
+    }
+    static int bitLength(const BigInt& n) noexcept {
+        int length = static_cast<int>(n.size() - 1) * 32;
+        for (uint32_t top = n.back(); top; top >>= 1) {
+            length++;
+        }
+        return length;
+    }
+    static bool bit(const BigInt& n, const int position) noexcept {
+        return (n[static_cast<size_t>(position / 32)] >> (position % 32)) & 1;
+    }
+    static bool lessThan(const BigInt& a, const BigInt& b) noexcept {
+        if (a.size() != b.size()) {
+            return a.size() < b.size();
+        }
+        for (size_t i = a.size(); i-- > 0;) {
+            if (a[i] != b[i]) {
+                return a[i] < b[i];
+            }
+        }
+        return false;
+    }
+    static void shiftLeftOne(BigInt& n) noexcept {
+        uint32_t carry = 0;
+        for (auto& word : n) {
+            const uint32_t next = word >> 31;
+            word = (word << 1) | carry;
+            carry = next;
+        }
+        if (carry) {
+            n.push_back(carry);
+        }
+    }
+    static void subtract(BigInt& a, const BigInt& b) noexcept {
+        int64_t borrow = 0;
+        for (size_t i = 0; i < a.size(); ++i) {
+            int64_t difference = static_cast<int64_t>(a[i]) - (i < b.size() ? b[i] : 0) - borrow;
+            borrow = difference < 0 ? 1 : 0;
+            a[i] = static_cast<uint32_t>(difference + (borrow << 32));
+        }
+        while (a.size() > 1 and a.back() == 0) {
+            a.pop_back();
+        }
+    }
+    static DiyFp power(const int k) {
+        BigInt n{1};
+        for (int i = 0; i < abs(k); ++i) {
+            multiply(n, 10);
+        }
+        const int length = bitLength(n);
+        if (k >= 0) {
+            if (length <= 64) {
+                const uint64_t value = n.size() > 1 ? (static_cast<uint64_t>(n[1]) << 32) | n[0] : n[0];
+                return DiyFp(value << (64 - length), length - 64);
+            }
+            uint64_t f = 0;
+            for (int position = length - 1; position >= length - 64; --position) {
+                f = (f << 1) | bit(n, position);
+            }
+            int e = length - 64;
+            if (bit(n, length - 65) and ++f == 0) {
+                f = uint64_t(1) << 63;
+                e++;
+            }
+            return DiyFp(f, e);
+        }
+        // 2^(63 + length) / 10^-k is in [2^63, 2^64): long division of the 65 bits after 2^(length - 1)
+        BigInt remainder(static_cast<size_t>((length - 1) / 32 + 1), 0);
+        remainder.back() = uint32_t(1) << ((length - 1) % 32);
+        uint64_t f = 0;
+        bool roundUp = false;
+        for (int i = 0; i <= 64; ++i) {
+            shiftLeftOne(remainder);
+            const bool quotientBit = not lessThan(remainder, n);
+            if (quotientBit) {
+                subtract(remainder, n);
+            }
+            if (i < 64) {
+                f = (f << 1) | quotientBit;
+            } else {
+                roundUp = quotientBit;
+            }
+        }
+        int e = -63 - length;
+        if (roundUp and ++f == 0) {
+            f = uint64_t(1) << 63;
+            e++;
+        }
+        return DiyFp(f, e);
+    }
+    CachedPowers() {
+        powers.reserve(POWER_COUNT);
+        for (int i = 0; i < POWER_COUNT; ++i) {
+            powers.push_back(power(FIRST_POWER + i * POWER_STEP));
+        }
+    }
+public:
+    static const CachedPowers& instance() {
+        static const CachedPowers cachedPowers;
+        return cachedPowers;
+    }
+    /**
+     * Power c = 10^-k such that e + c.e + 64 is in [-60, -32], with k in decimalExponent.
+     */
+    DiyFp forBinaryExponent(const int e, int& decimalExponent) const noexcept {
+        const double dk = (-61 - e) * 0.30102999566398114 + 347;
+        int k = static_cast<int>(dk);
+        if (dk - k > 0.0) {
+            k++;
+        }
+        const size_t index = static_cast<size_t>((k >> 3) + 1);
+        decimalExponent = -(FIRST_POWER + static_cast<int>(index) * POWER_STEP);
+        return powers[index];
+    }
+};
+
+const uint64_t POWERS_OF_TEN[] = { 1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+        100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+        100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+        1000000000000000000ULL, 10000000000000000000ULL };
+
+void grisuRound(char* digits, const int length, const uint64_t delta, uint64_t rest, const uint64_t tenKappa,
+        const uint64_t wpw) noexcept {
+    while (rest < wpw and delta - rest >= tenKappa
+            and (rest + tenKappa < wpw or wpw - rest > rest + tenKappa - wpw)) {
+        digits[length - 1]--;
+        rest += tenKappa;
+    }
+}
+
+/**
+ * Digits of value (at most 17) in digits, value being digits * 10^decimalExponent.
+ */
+int grisu2(const double value, char* digits, int& decimalExponent) noexcept {
+    const DiyFp v(value);
+    DiyFp minus(0, 0), plus(0, 0);
+    v.normalizedBoundaries(minus, plus);
+    const DiyFp cachedPower = CachedPowers::instance().forBinaryExponent(plus.e, decimalExponent);
+    const DiyFp w = v.normalize() * cachedPower;
+    DiyFp wp = plus * cachedPower;
+    DiyFp wm = minus * cachedPower;
+    wm.f++;
+    wp.f--;
+    uint64_t delta = wp.f - wm.f;
+
+    const DiyFp one(uint64_t(1) << -wp.e, wp.e);
+    const DiyFp wpw = wp - w;
+    uint32_t p1 = static_cast<uint32_t>(wp.f >> -one.e);
+    uint64_t p2 = wp.f & (one.f - 1);
+    int kappa = 1;
+    while (kappa < 10 and p1 >= POWERS_OF_TEN[kappa]) {
+        kappa++;
+    }
+    int length = 0;
+    while (kappa > 0) {
+        const uint32_t divisor = static_cast<uint32_t>(POWERS_OF_TEN[kappa - 1]);
+        const uint32_t digit = p1 / divisor;
+        p1 %= divisor;
+        if (digit or length) {
+            digits[length++] = static_cast<char>('0' + digit);
+        }
+        kappa--;
+        const uint64_t rest = (static_cast<uint64_t>(p1) << -one.e) + p2;
+        if (rest <= delta) {
+            decimalExponent += kappa;
+            grisuRound(digits, length, delta, rest, POWERS_OF_TEN[kappa] << -one.e, wpw.f);
+            return length;
+        }
+    }
+    for (;;) {
+        p2 *= 10;
+        delta *= 10;
+        const char digit = static_cast<char>(p2 >> -one.e);
+        if (digit or length) {
+            digits[length++] = static_cast<char>('0' + digit);
+        }
+        p2 &= one.f - 1;
+        kappa--;
+        if (p2 < delta) {
+            decimalExponent += kappa;
+            grisuRound(digits, length, delta, p2, one.f, -kappa < 20 ? wpw.f * POWERS_OF_TEN[-kappa] : 0);
+            return length;
+        }
+    }
+}
+
+/**
+ * num_put facet of OutputFile: doubles in the default floatfield are formatted here, without the locale.
+ */
+class DoubleNumPut final : public num_put<char> {
+private:
+    const bool legacyDigits;
+protected:
+    iter_type do_put(iter_type out, ios_base& io, char_type fill, double value) const override {
+        const ios_base::fmtflags flags = io.flags();
+        const streamsize precision = io.precision();
+        if ((flags & (ios_base::floatfield | ios_base::showpos | ios_base::showpoint | ios_base::uppercase))
+                or precision > 17) {
+            return num_put<char>::do_put(out, io, fill, value);
+        }
+        char chars[DOUBLE_CHARS];
+        size_t length;
+        if (legacyDigits or precision < DBL_DIG) {
+            length = static_cast<size_t>(snprintf(chars, sizeof(chars), "%.*g", static_cast<int>(precision), value));
+        } else {
+            length = formatRoundTripDouble(value, chars);
+        }
+        const size_t width = io.width() > 0 ? static_cast<size_t>(io.width()) : 0;
+        io.width(0);
+        size_t padding = width > length ? width - length : 0;
+        const char* begin = chars;
+        const ios_base::fmtflags adjust = flags & ios_base::adjustfield;
+        if (adjust == ios_base::internal and chars[0] == '-') {
+            *out++ = *begin++;
+        }
+        if (adjust != ios_base::left) {
+            for (; padding > 0; --padding) {
+                *out++ = fill;
+            }
+        }
+        out = copy(begin, static_cast<const char*>(chars + length), out);
+        for (; padding > 0; --padding) {
+            *out++ = fill;
+        }
+        return out;
+    }
+public:
+    explicit DoubleNumPut(const bool legacyDigits) : legacyDigits(legacyDigits) {
+    }
+};
+
+} // namespace
+
+size_t formatRoundTripDouble(const double value, char* chars) noexcept {
+    if (not isfinite(value)) {
+        return static_cast<size_t>(snprintf(chars, DOUBLE_CHARS, "%g", value));
+    }
+    size_t length = 0;
+    if (signbit(value)) {
+        chars[length++] = '-';
+    }
+    if (fpclassify(value) == FP_ZERO) {
+        chars[length++] = '0';
+        return length;
+    }
+    char digits[DOUBLE_CHARS];
+    int decimalExponent;
+    const int digitCount = grisu2(fabs(value), digits, decimalExponent);
+    // exponent of the first digit
+    const int exponent = digitCount + decimalExponent - 1;
+    if (exponent < -4 or exponent >= DBL_DIG) {
+        chars[length++] = digits[0];
+        if (digitCount > 1) {
+            chars[length++] = '.';
+            memcpy(chars + length, digits + 1, static_cast<size_t>(digitCount - 1));
+            length += static_cast<size_t>(digitCount - 1);
+        }
+        length += static_cast<size_t>(snprintf(chars + length, 8, "e%c%02d", exponent < 0 ? '-' : '+', abs(exponent)));
+    } else if (exponent < 0) {
+        chars[length++] = '0';
+        chars[length++] = '.';
+        for (int i = -1; i > exponent; --i) {
+            chars[length++] = '0';
+        }
+        memcpy(chars + length, digits, static_cast<size_t>(digitCount));
+        length += static_cast<size_t>(digitCount);
+    } else if (digitCount <= exponent + 1) {
+        memcpy(chars + length, digits, static_cast<size_t>(digitCount));
+        length += static_cast<size_t>(digitCount);
+        for (int i = digitCount; i <= exponent; ++i) {
+            chars[length++] = '0';
+        }
+    } else {
+        memcpy(chars + length, digits, static_cast<size_t>(exponent + 1));
+        length += static_cast<size_t>(exponent + 1);
+        chars[length++] = '.';
+        memcpy(chars + length, digits + exponent + 1, static_cast<size_t>(digitCount - exponent - 1));
+        length += static_cast<size_t>(digitCount - exponent - 1);
+    }
+    return length;
+}
+
+const size_t OutputFile::BUFFER_SIZE;
+
+OutputFile::OutputFile(const bool legacyDigits) : buffer(new char[BUFFER_SIZE]) {
+    // before any open: the file buffer uses it from then on
+    rdbuf()->pubsetbuf(buffer.get(), BUFFER_SIZE);
+    setLegacyDigits(legacyDigits);
+}
+
+OutputFile::OutputFile(const string& path, const ios_base::openmode mode, const bool legacyDigits) : OutputFile(legacyDigits) {
+    open(path, mode);
+}
+
+OutputFile::~OutputFile() {
+    // the buffer is released before the base class would flush it
+    if (is_open()) {
+        close();
+    }
+}
+
+void OutputFile::setLegacyDigits(const bool legacyDigits) {
+    imbue(locale(locale::classic(), new DoubleNumPut(legacyDigits)));
+}
+
+
 } /* namespace vega */
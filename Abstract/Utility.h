@@ -18,6 +18,11 @@
 #include <cmath>
 #include <stdio.h>
 #include <cfloat>
+#include <initializer_list>
+#include <iterator>
+#include <vector>
+#include <fstream>
+#include <memory>
 #include "prettyprint.hpp"
 
 #if defined(__GNUC__)
@@ -126,6 +131,148 @@ T from_string(const std::string& s) {
     return c;
 }
 
+/**
+ * Ordered set of node or cell positions, stored as runs of consecutive positions: the cells of a
+ * property, or the nodes of a group, are usually numbered contiguously.
+ * Positions inserted in increasing order are appended to the last run. The others are kept aside
+ * and merged at the next read: a set must be read once (or normalize() called) before being shared
+ * between threads.
+ */
+class PositionSet final {
+public:
+    struct Run {
+        pos_t first;
+        pos_t count;
+    };
+    class const_iterator final: public std::iterator<std::forward_iterator_tag, const pos_t, std::ptrdiff_t, const pos_t*, pos_t> {
+    private:
+        friend PositionSet;
+        const std::vector<Run>* runs = nullptr;
+        size_t run = 0;
+        pos_t offset = 0;
+        const_iterator(const std::vector<Run>* runs, size_t run, pos_t offset) noexcept :
+                runs(runs), run(run), offset(offset) {
+        }
+    public:
+        const_iterator() = default;
+        inline pos_t operator*() const noexcept {
+            return (*runs)[run].first + offset;
+        }
+        inline const_iterator& operator++() noexcept {
+            if (++offset == (*runs)[run].count) {
+                ++run;
+                offset = 0;
+            }
+            return *this;
+        }
+        inline const_iterator operator++(int) noexcept {
+            const_iterator result(*this);
+            ++(*this);
+            return result;
+        }
+        inline bool operator==(const const_iterator& other) const noexcept {
+            return run == other.run and offset == other.offset;
+        }
+        inline bool operator!=(const const_iterator& other) const noexcept {
+            return not (*this == other);
+        }
+    };
+    using iterator = const_iterator;
+    using value_type = pos_t;
+    using key_type = pos_t;
+    using size_type = size_t;
+private:
+    mutable std::vector<Run> runs;
+    mutable std::vector<pos_t> pending; /**< Positions inserted out of order, not yet in runs **/
+    mutable size_t positionCount = 0;   /**< Positions in runs **/
+    void append(pos_t position) noexcept;
+    static inline size_t runEnd(const Run& run) noexcept {
+        return static_cast<size_t>(run.first) + run.count; // UNAVAILABLE_POS can be stored too
+    }
+public:
+    PositionSet() = default;
+    PositionSet(std::initializer_list<pos_t> positions);
+    template<typename InputIterator>
+    PositionSet(InputIterator first, InputIterator last) {
+        insert(first, last);
+    }
+    void insert(pos_t position);
+    template<typename InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        for (; first != last; ++first) {
+            insert(static_cast<pos_t>(*first));
+        }
+    }
+    /**
+     * Union with another set, by merging the runs.
+     */
+    void insert(const PositionSet& other);
+    size_t erase(pos_t position);
+    /**
+     * Difference with another set, in a single pass over the runs. Returns the number of erased positions.
+     */
+    size_t erase(const PositionSet& other);
+    void clear() noexcept;
+    /**
+     * Merges the pending insertions into the runs.
+     */
+    void normalize() const;
+    bool contains(pos_t position) const;
+    inline size_t count(pos_t position) const {
+        return contains(position) ? 1 : 0;
+    }
+    const_iterator find(pos_t position) const;
+    inline bool empty() const noexcept {
+        return positionCount == 0 and pending.empty();
+    }
+    size_t size() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+    const std::vector<Run>& getRuns() const;
+    bool operator==(const PositionSet& other) const;
+    inline bool operator!=(const PositionSet& other) const {
+        return not (*this == other);
+    }
+    /**
+     * Lexicographical order of the positions, same as std::set.
+     */
+    bool operator<(const PositionSet& other) const;
+};
+
+/**
+ * Size of a buffer large enough for formatRoundTripDouble().
+ */
+static const size_t DOUBLE_CHARS = 32;
+
+/**
+ * Writes in chars a decimal representation of value that reads back to the same double (Grisu2 digit
+ * generation), and returns its length. It is round-trip exact and has at most 17 significant digits, but
+ * Grisu2 is not always the shortest: a few values get one digit more than needed (for instance
+ * -3.4077362267111672e+16, where -3.407736226711167e+16 reads back too). The layout is the one of
+ * printf("%.15g"): exponent notation only below 1e-4 or from 1e15, no trailing zeros.
+ */
+size_t formatRoundTripDouble(double value, char* chars) noexcept;
+
+/**
+ * Output file used by the solver writers. It writes through a large buffer, and it formats doubles
+ * without the locale machinery. In the default floatfield (neither fixed nor scientific), a precision of
+ * at least DBL_DIG gives a round-trip exact representation (see formatRoundTripDouble()), unless
+ * legacyDigits is set: the digits are then exactly the ones of a standard ofstream, for comparisons with
+ * older translations.
+ */
+class OutputFile final : public std::ofstream {
+private:
+    std::unique_ptr<char[]> buffer;
+public:
+    static const size_t BUFFER_SIZE = 1 << 20;
+    explicit OutputFile(bool legacyDigits = false);
+    OutputFile(const std::string& path, std::ios_base::openmode mode, bool legacyDigits = false);
+    OutputFile(const OutputFile&) = delete;
+    OutputFile& operator=(const OutputFile&) = delete;
+    ~OutputFile();
+    void setLegacyDigits(bool legacyDigits);
+};
+
 } /* namespace vega */
 
 // https://isocpp.org/files/papers/N3656.txt
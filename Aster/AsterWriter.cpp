@@ -77,6 +77,7 @@ string AsterWriter::writeModel(Model& model,
 
 	//comm_file_ofs.setf(ios::scientific);
  	comm_file_ofs.precision(DBL_DIG);
+	comm_file_ofs.setLegacyDigits(configuration.legacyDoubleDigits);
 
 	exp_file_ofs.open(exp_path.c_str(), ios::trunc | ios::out);
 	if (!exp_file_ofs.is_open()) {
@@ -95,7 +96,7 @@ string AsterWriter::writeModel(Model& model,
 	this->writeComm();
 	comm_file_ofs.close();
 
-	MedWriter medWriter;
+	MedWriter medWriter(static_cast<size_t>(configuration.asterMedChunkSize));
 	medWriter.writeMED(model, med_path.c_str());
 	return exp_path;
 }
@@ -565,11 +566,18 @@ void AsterWriter::writeAnalyses() {
             compositeNumber++;
         }
 
-		const auto& assertions = analysis->getAssertions();
-		if (not assertions.empty()) {
+		if (analysis->hasAssertions()) {
 			comm_file_ofs << "TEST_RESU(RESU = (" << endl;
 
-			for (const auto& assertion : assertions) {
+			for (const auto& table : analysis->getNodalDisplacementAssertionTables()) {
+				for (size_t row = 0; row < table->size(); row++) {
+					comm_file_ofs << "                  _F(RESULTAT=" << resuName << "," << endl;
+					writeNodalDisplacementAssertion(table->nodePositions[row], table->dofs[row], table->values[row],
+							table->instants[row], table->tolerances[row]);
+					comm_file_ofs << "                     )," << endl;
+				}
+			}
+			for (const auto& assertion : analysis->getIndividualAssertions()) {
 				switch (assertion->type) {
 				case Objective::Type::NODAL_DISPLACEMENT_ASSERTION:
 					comm_file_ofs << "                  _F(RESULTAT=" << resuName << "," << endl;
@@ -1090,7 +1098,8 @@ void AsterWriter::writeAffeCaraElem() {
 
 		const auto& discrets_0d = asterModel->model.elementSets.filter(
 				ElementSet::Type::DISCRETE_0D);
-		auto discrets_1d = asterModel->model.elementSets.filter(ElementSet::Type::DISCRETE_1D);
+		const auto& discrets_1d_only = asterModel->model.elementSets.filter(ElementSet::Type::DISCRETE_1D);
+		vector<shared_ptr<ElementSet>> discrets_1d(discrets_1d_only.begin(), discrets_1d_only.end());
         const auto& scalar_springs = asterModel->model.elementSets.filter(ElementSet::Type::SCALAR_SPRING);
         const auto& structural_segments = asterModel->model.elementSets.filter(ElementSet::Type::STRUCTURAL_SEGMENT);
         discrets_1d.insert(discrets_1d.end(), scalar_springs.begin(), scalar_springs.end());
@@ -1993,15 +2002,13 @@ void AsterWriter::writeNodalForce( const LoadSet& loadSet) {
         map<pos_t, pair<VectorialValue, VectorialValue>> forceAndMomentByPosition;
 		for (const auto& loading : nodalForces) {
 			const auto& nodal_force = static_pointer_cast<NodalForce>(loading);
-			for(const auto nodePosition : nodal_force->nodePositions()) {
-                VectorialValue force = nodal_force->getForceInGlobalCS(nodePosition);
-                VectorialValue moment = nodal_force->getMomentInGlobalCS(nodePosition);
-
-                const auto& it = forceAndMomentByPosition.find(nodePosition);
+			for(const auto& nodeForce : nodal_force->getForcesInGlobalCS()) {
+                const auto& it = forceAndMomentByPosition.find(nodeForce.nodePosition);
                 if (it == forceAndMomentByPosition.end()) {
-                    forceAndMomentByPosition[nodePosition] = {force, moment};
+                    forceAndMomentByPosition.emplace_hint(it, nodeForce.nodePosition,
+                            make_pair(nodeForce.force, nodeForce.moment));
                 } else {
-                    forceAndMomentByPosition[nodePosition] = {force+it->second.first, moment+it->second.second};
+                    it->second = {nodeForce.force + it->second.first, nodeForce.moment + it->second.second};
                 }
 			}
 			nodal_force->markAsWritten();
@@ -2755,9 +2762,10 @@ double AsterWriter::writeAnalysis(const shared_ptr<Analysis>& analysis, double d
 						for (const auto& loading2 : nodalForces) {
 							const auto& nodal_force = dynamic_pointer_cast<NodalForce>(
 									loading2);
-                            for(const pos_t nodePosition : nodal_force->nodePositions()) {
-                                const auto& force = nodal_force->getForceInGlobalCS(nodePosition);
-                                const auto& moment = nodal_force->getMomentInGlobalCS(nodePosition);
+                            for(const auto& nodeForce : nodal_force->getForcesInGlobalCS()) {
+                                const pos_t nodePosition = nodeForce.nodePosition;
+                                const auto& force = nodeForce.force;
+                                const auto& moment = nodeForce.moment;
                                 comm_file_ofs << "                                    _F(NOEUD='"
                                         << Node::MedName(nodePosition) << "'," << endl;
                                 comm_file_ofs << "                                      AVEC_CMP=(";
@@ -3062,22 +3070,27 @@ double AsterWriter::writeAnalysis(const shared_ptr<Analysis>& analysis, double d
 }
 
 void AsterWriter::writeNodalDisplacementAssertion(const shared_ptr<NodalDisplacementAssertion>& nda) {
+	writeNodalDisplacementAssertion(nda->nodePosition, nda->dof, nda->value, nda->instant, nda->tolerance);
+}
+
+void AsterWriter::writeNodalDisplacementAssertion(pos_t nodePosition, DOF dof, double value, double instant,
+		double tolerance) {
 
-	bool relativeComparison = abs(nda->value) >= SMALLEST_RELATIVE_COMPARISON;
+	bool relativeComparison = abs(value) >= SMALLEST_RELATIVE_COMPARISON;
 	comm_file_ofs << "                     CRITERE = " << (relativeComparison ? "'RELATIF'," : "'ABSOLU',") << endl;
-	comm_file_ofs << "                     NOEUD='" << Node::MedName(nda->nodePosition) << "'," << endl;
-	comm_file_ofs << "                     NOM_CMP    = '" << AsterModel::DofByPosition.at(nda->dof.position) << "'," << endl;
+	comm_file_ofs << "                     NOEUD='" << Node::MedName(nodePosition) << "'," << endl;
+	comm_file_ofs << "                     NOM_CMP    = '" << AsterModel::DofByPosition.at(dof.position()) << "'," << endl;
 	comm_file_ofs << "                     NOM_CHAM   = 'DEPL'," << endl;
-	if (!is_equal(nda->instant, -1)) {
-		comm_file_ofs << "                     INST = " << nda->instant << "," << endl;
+	if (!is_equal(instant, -1)) {
+		comm_file_ofs << "                     INST = " << instant << "," << endl;
 	} else {
 		comm_file_ofs << "                     NUME_ORDRE = 1," << endl;
 	}
     comm_file_ofs << "                     REFERENCE = 'SOURCE_EXTERNE'," << endl;
-    comm_file_ofs << "                     PRECISION = " << nda->tolerance << "," << endl;
-	comm_file_ofs << "                     VALE_REFE = " << nda->value << "," << endl;
-	comm_file_ofs << "                     VALE_CALC = " << (is_zero(nda->value) ? 1e-10 : nda->value) << "," << endl;
-	comm_file_ofs << "                     TOLE_MACHINE = (" << nda->tolerance << "," << 1e-5 << ")," << endl;
+    comm_file_ofs << "                     PRECISION = " << tolerance << "," << endl;
+	comm_file_ofs << "                     VALE_REFE = " << value << "," << endl;
+	comm_file_ofs << "                     VALE_CALC = " << (is_zero(value) ? 1e-10 : value) << "," << endl;
+	comm_file_ofs << "                     TOLE_MACHINE = (" << tolerance << "," << 1e-5 << ")," << endl;
 
 }
 
@@ -3087,7 +3100,7 @@ void AsterWriter::writeNodalComplexDisplacementAssertion(const shared_ptr<NodalC
     comm_file_ofs << "                     CRITERE = "
             << (relativeComparison ? "'RELATIF'," : "'ABSOLU',") << endl;
     comm_file_ofs << "                     NOEUD='" << Node::MedName(nda->nodePosition) << "'," << endl;
-    comm_file_ofs << "                     NOM_CMP = '" << AsterModel::DofByPosition.at(nda->dof.position)
+    comm_file_ofs << "                     NOM_CMP = '" << AsterModel::DofByPosition.at(nda->dof.position())
             << "'," << endl;
     comm_file_ofs << "                     NOM_CHAM = 'DEPL'," << endl;
     comm_file_ofs << "                     FREQ = " << nda->frequency << "," << endl;
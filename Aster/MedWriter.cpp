@@ -26,6 +26,11 @@
 #include <med.h>
 #define MESGERR 1
 #include <boost/filesystem.hpp>
+#include <atomic>
+#include <thread>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
 
 namespace vega {
 namespace aster {
@@ -35,50 +40,180 @@ using namespace std;
 // Declaration to avoid Wmissing-declarations error
 void createFamilies(med_idt fid, const char meshname[], const std::vector<Family>& families);
 
-NodeGroup2Families::NodeGroup2Families(med_int nnodes, const vector<shared_ptr<NodeGroup>> nodeGroups) {
-	int currentFamilyId = 0;
-	unordered_map<med_int, med_int> newFamilyByOldfamily;
-	unordered_map<med_int, Family> familyByFamilyId;
-	if (nnodes > 0 && nodeGroups.size() > 0) {
-		this->nodes.resize(nnodes, 0);
-		for (const auto& nodeGroup : nodeGroups) {
-			newFamilyByOldfamily.clear();
-			for (const auto nodePosition : nodeGroup->nodePositions()) {
-				med_int oldFamilyId = nodes[nodePosition];
-				auto newFamilyPair = newFamilyByOldfamily.find(oldFamilyId);
-				med_int newFamilyId;
-				if (newFamilyPair == newFamilyByOldfamily.end()) {
-					//family not found, create one
-					currentFamilyId++;
-                    newFamilyId = currentFamilyId;
-					Family fam;
-					fam.num = currentFamilyId;
-					auto oldFamilyPair = familyByFamilyId.find(oldFamilyId);
-					if (oldFamilyPair != familyByFamilyId.end()) {
-						Family& oldFamily = oldFamilyPair->second;
-						fam.groups.insert(fam.groups.begin(), oldFamily.groups.begin(),
-								oldFamily.groups.end());
-						fam.name = oldFamily.name + "_" + nodeGroup->getName();
-						if (fam.name.length() >= MED_LNAME_SIZE) {
-							fam.name = "Family" + to_string(currentFamilyId);
-						}
-					} else {
-						fam.name = nodeGroup->getName();
-					}
-					fam.groups.push_back(nodeGroup);
-					newFamilyByOldfamily.insert({oldFamilyId, currentFamilyId});
-					familyByFamilyId.insert({currentFamilyId, fam});
-				} else {
-					newFamilyId = newFamilyPair->second;
+void GroupSignatures::parallelFor(const size_t count, const function<void(size_t)>& task) const {
+	atomic<size_t> next(0);
+	const auto worker = [count, &next, &task]() {
+		for (size_t i = next++; i < count; i = next++) {
+			task(i);
+		}
+	};
+	vector<thread> workers;
+	for (unsigned int i = 1; i < min(threadCount, static_cast<unsigned int>(count)); ++i) {
+		workers.emplace_back(worker);
+	}
+	worker();
+	for (auto& workerThread : workers) {
+		workerThread.join();
+	}
+}
+
+void GroupSignatures::parallelForEntities(const function<void(size_t)>& task) const {
+	parallelFor((entityCount + ENTITY_CHUNK_SIZE - 1) / ENTITY_CHUNK_SIZE, [this, &task](const size_t chunk) {
+		const size_t end = min(entityCount, (chunk + 1) * ENTITY_CHUNK_SIZE);
+		for (size_t entity = chunk * ENTITY_CHUNK_SIZE; entity < end; ++entity) {
+			task(entity);
+		}
+	});
+}
+
+bool GroupSignatures::samePrefix(const pos_t entity, const size_t membership, const pos_t otherEntity,
+		const size_t otherMembership) const noexcept {
+	const auto begin = groupIndexes.begin() + offsets[entity];
+	const auto otherBegin = groupIndexes.begin() + offsets[otherEntity];
+	return membership - offsets[entity] == otherMembership - offsets[otherEntity]
+			and equal(begin, groupIndexes.begin() + membership, otherBegin);
+}
+
+GroupSignatures::GroupSignatures(const size_t maxEntityCount, const vector<const PositionSet*>& groupPositions,
+		const uint64_t hashMask) {
+	const size_t groupCount = groupPositions.size();
+	size_t membershipCount = 0;
+	for (const auto positions : groupPositions) {
+		positions->normalize(); // before sharing the sets between threads
+		const auto& runs = positions->getRuns();
+		for (auto run = runs.rbegin(); run != runs.rend(); ++run) {
+			if (run->first < maxEntityCount) {
+				entityCount = max(entityCount, min(maxEntityCount, static_cast<size_t>(run->first) + run->count));
+				break;
+			}
+		}
+		membershipCount += positions->size();
+	}
+	if (membershipCount >= PARALLEL_MIN_MEMBERSHIPS) {
+		threadCount = max(1u, thread::hardware_concurrency());
+	}
+	const auto visitGroup = [this, &groupPositions](const size_t groupIndex, const function<void(pos_t)>& visitor) {
+		for (const auto& run : groupPositions[groupIndex]->getRuns()) {
+			const size_t end = min(entityCount, static_cast<size_t>(run.first) + run.count);
+			for (size_t position = run.first; position < end; ++position) {
+				visitor(static_cast<pos_t>(position));
+			}
+		}
+	};
+
+	// Signatures: entity to group indexes, sorted
+	vector<atomic<uint32_t>> counts(entityCount);
+	parallelFor(groupCount, [&counts, &visitGroup](const size_t groupIndex) {
+		visitGroup(groupIndex, [&counts](const pos_t entity) {
+			counts[entity].fetch_add(1, memory_order_relaxed);
+		});
+	});
+	offsets.assign(entityCount + 1, 0);
+	for (size_t entity = 0; entity < entityCount; ++entity) {
+		offsets[entity + 1] = offsets[entity] + counts[entity].load(memory_order_relaxed);
+		counts[entity].store(0, memory_order_relaxed);
+	}
+	groupIndexes.resize(offsets.back());
+	parallelFor(groupCount, [this, &counts, &visitGroup](const size_t groupIndex) {
+		visitGroup(groupIndex, [this, &counts, groupIndex](const pos_t entity) {
+			groupIndexes[offsets[entity] + counts[entity].fetch_add(1, memory_order_relaxed)] = static_cast<uint32_t>(groupIndex);
+		});
+	});
+	prefixHashes.resize(groupIndexes.size());
+	parallelForEntities([this, hashMask](const size_t entity) {
+		// Threads filled the rows in any order
+		sort(groupIndexes.begin() + offsets[entity], groupIndexes.begin() + offsets[entity + 1]);
+		uint64_t hash = 14695981039346656037ULL;
+		for (size_t membership = offsets[entity]; membership < offsets[entity + 1]; ++membership) {
+			hash = (hash ^ groupIndexes[membership]) * 1099511628211ULL;
+			prefixHashes[membership] = hash & hashMask;
+		}
+	});
+
+	// Each group numbers the distinct prefixes of its entities, from 0 in the order of their first entity
+	createdFamilies.resize(groupIndexes.size());
+	vector<vector<pos_t>> firstEntitiesByGroup(groupCount);
+	parallelFor(groupCount, [this, &visitGroup, &firstEntitiesByGroup](const size_t groupIndex) {
+		vector<pos_t>& firstEntities = firstEntitiesByGroup[groupIndex];
+		unordered_multimap<uint64_t, pair<size_t, med_int>> familyByPrefixHash;
+		visitGroup(groupIndex, [this, groupIndex, &firstEntities, &familyByPrefixHash](const pos_t entity) {
+			const auto rowBegin = groupIndexes.begin() + offsets[entity];
+			const size_t membership = static_cast<size_t>(lower_bound(rowBegin, groupIndexes.begin() + offsets[entity + 1],
+					static_cast<uint32_t>(groupIndex)) - groupIndexes.begin());
+			const uint64_t prefixHash = membership == offsets[entity] ? 0 : prefixHashes[membership - 1];
+			const auto candidates = familyByPrefixHash.equal_range(prefixHash);
+			for (auto candidate = candidates.first; candidate != candidates.second; ++candidate) {
+				const size_t otherMembership = candidate->second.first;
+				if (samePrefix(entity, membership, firstEntities[candidate->second.second], otherMembership)) {
+					createdFamilies[membership] = candidate->second.second;
+					return;
 				}
-				nodes[nodePosition] = newFamilyId;
 			}
+			const med_int family = static_cast<med_int>(firstEntities.size());
+			familyByPrefixHash.insert({prefixHash, {membership, family}});
+			firstEntities.push_back(entity);
+			createdFamilies[membership] = family;
+		});
+	});
+	vector<med_int> familyOffsets(groupCount + 1, 0);
+	for (size_t groupIndex = 0; groupIndex < groupCount; ++groupIndex) {
+		familyOffsets[groupIndex + 1] = familyOffsets[groupIndex] + static_cast<med_int>(firstEntitiesByGroup[groupIndex].size());
+		entityByFamily.insert(entityByFamily.end(), firstEntitiesByGroup[groupIndex].begin(), firstEntitiesByGroup[groupIndex].end());
+	}
+	parallelForEntities([this, &familyOffsets](const size_t entity) {
+		for (size_t membership = offsets[entity]; membership < offsets[entity + 1]; ++membership) {
+			createdFamilies[membership] += familyOffsets[groupIndexes[membership]] + 1;
+		}
+	});
+}
+
+Family GroupSignatures::family(const med_int familyNumber, const med_int sign,
+		const vector<shared_ptr<Group>>& groups, const string& truncatedPrefix) const {
+	Family fam;
+	fam.num = sign * familyNumber;
+	const pos_t entity = entityByFamily[familyNumber - 1];
+	for (size_t membership = offsets[entity]; membership < offsets[entity + 1]; ++membership) {
+		const auto& group = groups[groupIndexes[membership]];
+		if (fam.groups.empty()) {
+			fam.name = group->getName();
+		} else {
+			fam.name += "_" + group->getName();
+			if (fam.name.length() >= MED_LNAME_SIZE) {
+				fam.name = truncatedPrefix + to_string(createdFamilies[membership]);
+			}
+		}
+		fam.groups.push_back(group);
+		if (createdFamilies[membership] == familyNumber) {
+			break;
 		}
 	}
-	set<int> familiesInUse(nodes.begin(), nodes.end());
-	for (int fam_id : familiesInUse) {
-		if (fam_id != 0) {
-			families.push_back(familyByFamilyId[fam_id]);
+	return fam;
+}
+
+NodeGroup2Families::NodeGroup2Families(med_int nnodes, const vector<shared_ptr<NodeGroup>> nodeGroups) {
+	if (nnodes <= 0 or nodeGroups.empty()) {
+		return;
+	}
+	vector<PositionSet> nodePositionsByGroup;
+	nodePositionsByGroup.reserve(nodeGroups.size());
+	for (const auto& nodeGroup : nodeGroups) {
+		nodePositionsByGroup.push_back(nodeGroup->nodePositions());
+	}
+	vector<const PositionSet*> groupPositions;
+	for (const auto& nodePositions : nodePositionsByGroup) {
+		groupPositions.push_back(&nodePositions);
+	}
+	const GroupSignatures signatures(static_cast<size_t>(nnodes), groupPositions);
+	this->nodes.resize(nnodes, 0);
+	vector<bool> familiesInUse(signatures.familyCount() + 1, false);
+	for (pos_t nodePosition = 0; nodePosition < static_cast<pos_t>(nnodes); ++nodePosition) {
+		nodes[nodePosition] = signatures.familyNumber(nodePosition);
+		familiesInUse[nodes[nodePosition]] = true;
+	}
+	const vector<shared_ptr<Group>> groups(nodeGroups.begin(), nodeGroups.end());
+	for (med_int familyNumber = 1; familyNumber < static_cast<med_int>(familiesInUse.size()); ++familyNumber) {
+		if (familiesInUse[familyNumber]) {
+			families.push_back(signatures.family(familyNumber, 1, groups, "Family"));
 		}
 	}
 }
@@ -87,70 +222,61 @@ vector<Family> NodeGroup2Families::getFamilies() const {
 	return this->families;
 }
 
-vector<med_int> NodeGroup2Families::getFamilyOnNodes() const {
-	vector<med_int> famlong(begin(this->nodes), end(this->nodes));
-	return famlong;
+const vector<med_int>& NodeGroup2Families::getFamilyOnNodes() const {
+	return this->nodes;
 }
 
 CellGroup2Families::CellGroup2Families(
 		const Mesh& mesh, unordered_map<CellType::Code, size_t, EnumClassHash> cellCountByType,
 		const vector<shared_ptr<CellGroup>>& cellGroups) : mesh(mesh) {
-	med_int currentFamilyId = 0;
-	unordered_map<med_int, med_int> newFamilyByOldfamily;
-	unordered_map<med_int, Family> familyByFamilyId;
+	vector<const PositionSet*> groupPositions;
+	for (const auto& cellGroup : cellGroups) {
+		groupPositions.push_back(&cellGroup->cellPositions());
+	}
+	// unexisting cells in group definitions (UNAVAILABLE_CELL) are ignored
+	const GroupSignatures signatures(Cell::UNAVAILABLE_CELL, groupPositions);
+
+	vector<CellType::Code> cellCodes;
 	for (const auto& cellCountByTypePair : cellCountByType) {
 		shared_ptr<vector<med_int>> cells = make_shared<vector<med_int>>();
 		cells->resize(cellCountByTypePair.second, 0);
 		cellFamiliesByType[cellCountByTypePair.first] = cells;
+		cellCodes.push_back(cellCountByTypePair.first);
 	}
-
-	for (const auto& cellGroup : cellGroups) {
-		newFamilyByOldfamily.clear();
-		for (const auto& cellPosition : cellGroup->cellPositions()) {
-            if (cellPosition == Cell::UNAVAILABLE_CELL) {
-                continue; // ignoring unexisting cells in group definitions
-            }
-			const Cell&& cell = mesh.findCell(cellPosition);
-			shared_ptr<vector<med_int>> currentCellFamilies = cellFamiliesByType[cell.type.code];
-			med_int oldFamilyId = currentCellFamilies->at(cell.cellTypePosition);
-			auto newFamilyPair = newFamilyByOldfamily.find(oldFamilyId);
-			med_int newFamilyId;
-			if (newFamilyPair == newFamilyByOldfamily.end()) {
-				//family not found, create one
-				currentFamilyId--;
-                newFamilyId = currentFamilyId;
-                Family fam;
-                fam.num = currentFamilyId;
-				auto oldFamilyPair = familyByFamilyId.find(oldFamilyId);
-				if (oldFamilyPair != familyByFamilyId.end()) {
-					Family& oldFamily = oldFamilyPair->second;
-					fam.groups.insert(fam.groups.begin(), oldFamily.groups.begin(),
-							oldFamily.groups.end());
-					fam.name = oldFamily.name + "_" + cellGroup->getName();
-					if (fam.name.length() >= MED_LNAME_SIZE) {
-						fam.name = "CELLFamily" + to_string(-currentFamilyId);
-					}
-				} else {
-					fam.name = cellGroup->getName();
+	// Every type has its own family vector: they are filled in parallel
+	atomic<size_t> nextType(0);
+	const auto worker = [&mesh, &signatures, &cellCodes, &nextType, this]() {
+		for (size_t i = nextType++; i < cellCodes.size(); i = nextType++) {
+			vector<med_int>& cells = *cellFamiliesByType.find(cellCodes[i])->second;
+			mesh.visitCells(*CellType::findByCode(cellCodes[i]), [&cells, &signatures](const CellView& cell) {
+				if (cell.cellTypePosition < cells.size()) {
+					cells[cell.cellTypePosition] = -signatures.familyNumber(cell.position);
 				}
-				fam.groups.push_back(cellGroup);
-				newFamilyByOldfamily[oldFamilyId] = currentFamilyId;
-				familyByFamilyId[currentFamilyId] = fam;
-			} else {
-				newFamilyId = newFamilyPair->second;
-			}
-			currentCellFamilies->at(cell.cellTypePosition) = newFamilyId;
+			});
+		}
+	};
+	vector<thread> workers;
+	if (signatures.familyCount() > 0) {
+		for (size_t i = 1; i < min(cellCodes.size(), static_cast<size_t>(signatures.getThreadCount())); ++i) {
+			workers.emplace_back(worker);
 		}
+		worker();
+	}
+	for (auto& workerThread : workers) {
+		workerThread.join();
 	}
 
-	set<med_int> familiesInUse;
+	vector<bool> familiesInUse(signatures.familyCount() + 1, false);
 	for (const auto& cellFamilyAndTypePair : cellFamiliesByType) {
-		familiesInUse.insert(cellFamilyAndTypePair.second->begin(),
-				cellFamilyAndTypePair.second->end());
+		for (const med_int familyId : *cellFamilyAndTypePair.second) {
+			familiesInUse[-familyId] = true;
+		}
 	}
-	for (med_int fam_id : familiesInUse) {
-		if (fam_id != 0) {
-			families.push_back(familyByFamilyId[fam_id]);
+	// Same order as the family ids: the last created family first
+	const vector<shared_ptr<Group>> groups(cellGroups.begin(), cellGroups.end());
+	for (med_int familyNumber = static_cast<med_int>(familiesInUse.size()) - 1; familyNumber > 0; --familyNumber) {
+		if (familiesInUse[familyNumber]) {
+			families.push_back(signatures.family(familyNumber, -1, groups, "CELLFamily"));
 		}
 	}
 }
@@ -180,6 +306,95 @@ void createFamilies(med_idt fid, const char meshname[],
 	}
 }
 
+MedWriter::MedWriter(size_t chunkSize) noexcept : chunkSize(chunkSize) {
+}
+
+size_t MedWriter::chunkLength(size_t count) const noexcept {
+	return (chunkSize == 0 or chunkSize > count) ? count : chunkSize;
+}
+
+void MedWriter::noteBuffer(size_t bytes) noexcept {
+	bufferHighWater = max(bufferHighWater, bytes);
+}
+
+void MedWriter::writeCoordinates(med_idt fid, const char meshname[], const NodeCoordinates& coordinates) {
+	const size_t nnodes = coordinates.size();
+	const size_t chunk = chunkLength(nnodes);
+	vector<med_float> buffer;
+	buffer.reserve(3 * chunk);
+	noteBuffer(buffer.capacity() * sizeof(med_float));
+	for (size_t first = 0; first < nnodes; first += chunk) {
+		const size_t count = min(chunk, nnodes - first);
+		buffer.clear();
+		for (size_t i = first; i < first + count; ++i) {
+			buffer.push_back(coordinates.x[i]);
+			buffer.push_back(coordinates.y[i]);
+			buffer.push_back(coordinates.z[i]);
+		}
+		med_err result;
+		if (count == nnodes) {
+			result = MEDmeshNodeCoordinateWr(fid, meshname, MED_NO_DT, MED_NO_IT, 0.0, MED_FULL_INTERLACE,
+					static_cast<med_int>(nnodes), buffer.data());
+		} else {
+			med_filter filter = MED_FILTER_INIT;
+			if (MEDfilterBlockOfEntityCr(fid, static_cast<med_int>(nnodes), 1, 3, MED_ALL_CONSTITUENT,
+					MED_FULL_INTERLACE, MED_COMPACT_STMODE, MED_ALLENTITIES_PROFILE,
+					first + 1, count, 1, count, 0, &filter) < 0) {
+				throw logic_error("ERROR : creating filter on nodes ...");
+			}
+			result = MEDmeshNodeCoordinateAdvancedWr(fid, meshname, MED_NO_DT, MED_NO_IT, 0.0, &filter, buffer.data());
+			MEDfilterClose(&filter);
+		}
+		if (result < 0) {
+			throw logic_error("ERROR : writing nodes ...");
+		}
+	}
+}
+
+void MedWriter::writeConnectivity(med_idt fid, const char meshname[], const Mesh& mesh, const CellType& type, med_int numCells) {
+	const med_geometry_type code = static_cast<med_geometry_type>(type.code);
+	const size_t chunk = chunkLength(static_cast<size_t>(numCells));
+	vector<med_int> connectivity;
+	connectivity.reserve(chunk * type.numNodes);
+	noteBuffer(connectivity.capacity() * sizeof(med_int));
+	size_t first = 0;
+	auto flush = [&]() {
+		const size_t count = connectivity.size() / type.numNodes;
+		med_err result;
+		if (count == static_cast<size_t>(numCells)) {
+			result = MEDmeshElementConnectivityWr(fid, meshname, MED_NO_DT, MED_NO_IT, 0.0, MED_CELL, code,
+					MED_NODAL, MED_FULL_INTERLACE, numCells, connectivity.data());
+		} else {
+			med_filter filter = MED_FILTER_INIT;
+			if (MEDfilterBlockOfEntityCr(fid, numCells, 1, static_cast<med_int>(type.numNodes), MED_ALL_CONSTITUENT,
+					MED_FULL_INTERLACE, MED_COMPACT_STMODE, MED_ALLENTITIES_PROFILE,
+					first + 1, count, 1, count, 0, &filter) < 0) {
+				throw logic_error("ERROR : creating filter on cells ...");
+			}
+			result = MEDmeshElementConnectivityAdvancedWr(fid, meshname, MED_NO_DT, MED_NO_IT, 0.0, MED_CELL, code,
+					MED_NODAL, &filter, connectivity.data());
+			MEDfilterClose(&filter);
+		}
+		if (result < 0) {
+			throw logic_error("ERROR : writing cells ...");
+		}
+		first += count;
+		connectivity.clear();
+	};
+	mesh.visitCells(type, [&](const CellView& cell) {
+		for (const auto nodePosition : cell.nodePositions) {
+			// med nodes starts at node number 1.
+			connectivity.push_back(static_cast<med_int>(nodePosition) + 1);
+		}
+		if (connectivity.size() == chunk * type.numNodes) {
+			flush();
+		}
+	});
+	if (not connectivity.empty()) {
+		flush();
+	}
+}
+
 void MedWriter::writeMED(const Model& model, const string& medFileName) {
 	//if (!finished) {
 	//	this->finish();
@@ -209,25 +424,8 @@ void MedWriter::writeMED(const Model& model, const string& medFileName) {
 			MED_SORT_DTIT, MED_CARTESIAN, axisname, unitname) < 0) {
 		throw logic_error("ERROR : Mesh creation ...");
 	}
-	vector<med_float> coordinates;
-	coordinates.reserve(nnodes);
-	for (const NodeData& nodeData : model.mesh.nodes.getNodeDatas()) {
-	    if (nodeData.cpPos == CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID){
-            coordinates.push_back(nodeData.x);
-            coordinates.push_back(nodeData.y);
-            coordinates.push_back(nodeData.z);
-	    } else {
-	        shared_ptr<CoordinateSystem> coordSystem = model.mesh.getCoordinateSystemByPosition(nodeData.cpPos);
-            VectorialValue gCoord = coordSystem->positionToGlobal(VectorialValue(nodeData.x,nodeData.y,nodeData.z));
-            coordinates.push_back(gCoord.x());
-            coordinates.push_back(gCoord.y());
-            coordinates.push_back(gCoord.z());
-	    }
-	}
-	if (MEDmeshNodeCoordinateWr(fid, meshname, MED_NO_DT, MED_NO_IT, 0.0, MED_FULL_INTERLACE,
-			nnodes, coordinates.data()) < 0) {
-		throw logic_error("ERROR : writing nodes ...");
-	}
+	bufferHighWater = 0;
+	writeCoordinates(fid, meshname, model.mesh.nodes.getGlobalCoordinates());
 
 /*	char* nodeNames = new char[nnodes*MED_SNAME_SIZE]();
 
@@ -245,6 +443,7 @@ void MedWriter::writeMED(const Model& model, const string& medFileName) {
         numnoe.push_back(i+1);
     }
     MEDmeshEntityNumberWr(fid, meshname, MED_NO_DT, MED_NO_IT, MED_NODE, MED_NONE,nnodes, numnoe.data());
+    noteBuffer(numnoe.capacity() * sizeof(med_int));
     numnoe.clear();
 
 	for (const auto& kv : model.mesh.cellPositionsByType) {
@@ -255,23 +454,7 @@ void MedWriter::writeMED(const Model& model, const string& medFileName) {
 		if (type.numNodes == 0 || numCells == 0) {
 			continue;
 		}
-		vector<med_int> connectivity;
-		connectivity.reserve(numCells * type.numNodes);
-		for (const auto cellPosition : cellPositions) {
-			const auto&& cell = model.mesh.findCell(cellPosition);
- 			for (const auto nodePosition : cell.nodePositions) {
-				// med nodes starts at node number 1.
-				connectivity.push_back(static_cast<med_int>(nodePosition) + 1);
-			}
-		}
-		int result = MEDmeshElementConnectivityWr(fid, meshname, MED_NO_DT,
-		MED_NO_IT, 0.0, MED_CELL, code, MED_NODAL, MED_FULL_INTERLACE,
-				numCells,
-				connectivity.data());
-		if (result < 0) {
-			throw logic_error("ERROR : writing cells ...");
-		}
-		connectivity.clear();
+		writeConnectivity(fid, meshname, model.mesh, type, numCells);
 
 /*		char* cellNames = new char[numCells*MED_SNAME_SIZE]();
 		//med_int* cellNum=new med_int[numCells];
@@ -296,7 +479,8 @@ void MedWriter::writeMED(const Model& model, const string& medFileName) {
         for (const auto cellPosition : cellPositions) {
             cellnums.push_back(static_cast<med_int>(cellPosition)+1);
         }
-        MEDmeshEntityNumberWr(fid, meshname, MED_NO_DT, MED_NO_IT, MED_CELL, code, numCells, cellnums.data());
+        const med_err result = MEDmeshEntityNumberWr(fid, meshname, MED_NO_DT, MED_NO_IT, MED_CELL, code, numCells, cellnums.data());
+        noteBuffer(cellnums.capacity() * sizeof(med_int));
         cellnums.clear();
 
         if (result < 0) {
@@ -355,6 +539,14 @@ void MedWriter::writeMED(const Model& model, const string& medFileName) {
 	}
 	if (model.configuration.logLevel >= LogLevel::DEBUG) {
 		cout << "File created : " << fs::absolute(medFileName) << endl;
+		cout << "Largest MED write buffer : " << bufferHighWater / 1024 << " kB";
+#ifndef _WIN32
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) == 0) {
+			cout << ", peak resident memory : " << usage.ru_maxrss << " kB";
+		}
+#endif
+		cout << endl;
 	}
 }
 
@@ -28,6 +28,8 @@
 #include "../Abstract/ConfigurationParameters.h"
 #include "../Abstract/Mesh.h"
 #include <med.h>
+#include <cstdint>
+#include <functional>
 
 namespace vega {
 
@@ -40,13 +42,64 @@ public:
     med_int num = Globals::UNAVAILABLE_INT;
 };
 
+/**
+ * Family numbers of entities (nodes or cells) computed from their signatures: the sorted list of the groups
+ * containing each entity.
+ *
+ * The numbering is the one given by assigning the groups one after the other, each group splitting the families
+ * of its entities and numbering the new ones 1, 2... in the order of their first entity. The family created for an
+ * entity by one of its groups only depends on the previous groups of its signature (its prefix), so every group
+ * numbers the distinct prefixes of its entities on its own: groups are processed in parallel, then the numbers
+ * are shifted by the count of families created by the previous groups.
+ */
+class GroupSignatures final {
+private:
+    static const size_t PARALLEL_MIN_MEMBERSHIPS = 100000; /**< Smaller signatures are computed in the calling thread **/
+    static const size_t ENTITY_CHUNK_SIZE = 16384;
+    unsigned int threadCount = 1;
+    size_t entityCount = 0;
+    std::vector<size_t> offsets; /**< Groups of entity e are groupIndexes[offsets[e]] to groupIndexes[offsets[e + 1] - 1] **/
+    std::vector<uint32_t> groupIndexes;
+    std::vector<uint64_t> prefixHashes; /**< Hash of the groups of the entity up to this membership (included) **/
+    std::vector<med_int> createdFamilies; /**< Family number created for the entity by this membership **/
+    std::vector<pos_t> entityByFamily; /**< An entity holding each family (number - 1), to rebuild its groups **/
+    void parallelFor(size_t count, const std::function<void(size_t)>& task) const;
+    void parallelForEntities(const std::function<void(size_t)>& task) const;
+    bool samePrefix(pos_t entity, size_t membership, pos_t otherEntity, size_t otherMembership) const noexcept;
+public:
+    /**
+     * Positions not lower than entityCount are ignored. Group positions are normalized here.
+     * hashMask keeps only some bits of the prefix hashes: tests lower it to force collisions.
+     */
+    GroupSignatures(size_t entityCount, const std::vector<const PositionSet*>& groupPositions,
+            uint64_t hashMask = UINT64_MAX);
+    /**
+     * Number of the family of the entity (from 1 in the order of creation), 0 for an entity without group.
+     */
+    inline med_int familyNumber(const pos_t entity) const noexcept {
+        return entity >= entityCount or offsets[entity] == offsets[entity + 1] ? 0 : createdFamilies[offsets[entity + 1] - 1];
+    }
+    inline size_t familyCount() const noexcept {
+        return entityByFamily.size();
+    }
+    inline unsigned int getThreadCount() const noexcept {
+        return threadCount;
+    }
+    /**
+     * Family of this number, numbered sign * familyNumber. Names too long for MED are replaced by
+     * truncatedPrefix followed by the family number.
+     */
+    Family family(med_int familyNumber, med_int sign, const std::vector<std::shared_ptr<Group>>& groups,
+            const std::string& truncatedPrefix) const;
+};
+
 class NodeGroup2Families {
     std::vector<Family> families;
     std::vector<med_int> nodes;
 public:
     NodeGroup2Families(med_int nnodes, const std::vector<std::shared_ptr<NodeGroup>> nodeGroups);
     std::vector<Family> getFamilies() const;
-    std::vector<med_int> getFamilyOnNodes() const;
+    const std::vector<med_int>& getFamilyOnNodes() const;
 };
 
 class CellGroup2Families final {
@@ -62,12 +115,23 @@ public:
 };
 
 
+/**
+ * Writes the mesh of a model in a MED file.
+ * With a positive chunk size, coordinates and connectivities are converted and written by chunks of at
+ * most chunkSize nodes (or cells) through MED filters, instead of being copied entirely before writing.
+ */
 class MedWriter {
 private:
     friend Mesh;
     friend NodeData;
+    const size_t chunkSize;
+    size_t bufferHighWater = 0; /**< Largest buffer allocated during the last write, in bytes **/
+    size_t chunkLength(size_t count) const noexcept;
+    void noteBuffer(size_t bytes) noexcept;
+    void writeCoordinates(med_idt fid, const char meshname[], const NodeCoordinates& coordinates);
+    void writeConnectivity(med_idt fid, const char meshname[], const Mesh& mesh, const CellType& type, med_int numCells);
 public:
-    MedWriter() = default;
+    explicit MedWriter(size_t chunkSize = 0) noexcept;
 	MedWriter(const MedWriter& that) = delete;
 	void writeMED(const Model& model, const std::string& medFileName);
 };
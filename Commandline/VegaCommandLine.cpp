@@ -247,6 +247,15 @@ ConfigurationParameters VegaCommandLine::readCommandLineParameters(const po::var
         }
     }
 
+    const bool legacyDoubleDigits = vm.count("legacy-digits") > 0;
+    int resultReaderThreads=1;
+    if (vm.count("result-threads")){
+        resultReaderThreads = vm["result-threads"].as<int>();
+        if (resultReaderThreads < 0) {
+            throw invalid_argument("Result reader threads must be positive, or 0 for all the available cores.");
+        }
+    }
+
     // Option for Nastran Conversion
     string nastranOutputDialect="cosmic95";
     if (vm.count("nastran.OutputDialect")){
@@ -257,6 +266,28 @@ ConfigurationParameters VegaCommandLine::readCommandLineParameters(const po::var
             throw invalid_argument("Nastran output dialect must be either cosmic95 (default) or modern.");
         }
     }
+    string nastranInputMode="mmap";
+    if (vm.count("nastran.InputMode")){
+        nastranInputMode = vm["nastran.InputMode"].as<string>();
+        set<string> availableModes { "mmap", "stream" };
+        if (availableModes.find(nastranInputMode) == availableModes.end()) {
+            throw invalid_argument("Nastran input mode must be either mmap (default) or stream.");
+        }
+    }
+    int nastranParserThreads=1;
+    if (vm.count("nastran.ParserThreads")){
+        nastranParserThreads = vm["nastran.ParserThreads"].as<int>();
+        if (nastranParserThreads < 0) {
+            throw invalid_argument("Nastran parser threads must be positive, or 0 for all the available cores.");
+        }
+    }
+    int asterMedChunkSize=0;
+    if (vm.count("aster.MedChunkSize")){
+        asterMedChunkSize = vm["aster.MedChunkSize"].as<int>();
+        if (asterMedChunkSize < 0) {
+            throw invalid_argument("Aster MED chunk size must be positive, or 0 to write each array at once.");
+        }
+    }
 
     // Option for Systus Conversion
     string systusRBE2TranslationMode="penalty";
@@ -391,6 +422,11 @@ ConfigurationParameters VegaCommandLine::readCommandLineParameters(const po::var
         cout << "\t Output directory: "<< outputDir << endl;
         cout << "\t Verbosity: "<< static_cast<int>(logLevel) << endl;
         cout << "\t Nastran Output Dialect: "<< nastranOutputDialect << endl;
+        cout << "\t Nastran Input Mode: "<< nastranInputMode << endl;
+        cout << "\t Nastran Parser Threads: "<< nastranParserThreads << endl;
+        cout << "\t Aster MED Chunk Size: "<< asterMedChunkSize << endl;
+        cout << "\t Legacy double digits: "<< legacyDoubleDigits << endl;
+        cout << "\t Result Reader Threads: "<< resultReaderThreads << endl;
         cout << "\t Systus RBE2 Translation Mode: "<< systusRBE2TranslationMode << endl;
         cout << "\t Systus RBE Stiffness: " << (is_equal(systusRBEStiffness, Globals::UNAVAILABLE_DOUBLE) ? "auto" : to_string(systusRBEStiffness)) << endl;
         cout << "\t Systus RBE Coefficient: " << systusRBECoefficient << endl;
@@ -415,7 +451,9 @@ ConfigurationParameters VegaCommandLine::readCommandLineParameters(const po::var
             solverVersion, modelName, outputDir, logLevel, translationMode, testFnamePath,
             tolerance, runSolver, createGraph, solverServer, solverCommand, convertCompletelyRigidsIntoMPCs,
             systusRBE2TranslationMode, systusRBEStiffness, systusRBECoefficient, systusOptionAnalysis, systusOutputProduct,
-            systusSubcases, systusOutputMatrix, systusSizeMatrix, systusDynamicMethod, nastranOutputDialect);
+            systusSubcases, systusOutputMatrix, systusSizeMatrix, systusDynamicMethod, nastranOutputDialect,
+            nastranInputMode, nastranParserThreads, asterMedChunkSize, legacyDoubleDigits,
+            resultReaderThreads);
     return configuration;
 }
 
@@ -503,12 +541,25 @@ VegaCommandLine::ExitCode VegaCommandLine::process(int ac, const char* av[]) {
                 "unrecognized keyword or parameter.")//
         ("convertCompletelyRigidsIntoMPCs", po::value<bool>(), "Always convert rigid constraints into MPCs") //
         ("graph,g", "Creates a graph of the study") //
+        ("legacy-digits", "Write doubles with 15 significant digits, as older versions, "
+                "instead of their round-trip exact representation.") //
+        ("result-threads", po::value<int>()->default_value(1),
+                "Threads parsing the sections of TESTFILE: 1 (default) for a serial parsing, 0 for all the cores.") //
         ("verbosity", po::value<string>(), "Verbosity of VEGA. From low to high: ERROR, WARN, INFO, DEBUG, TRACE"); //
 
         po::options_description nastranOptions("Nastran specific options");
         nastranOptions.add_options() //
         ("nastran.OutputDialect",po::value<string>()->default_value("cosmic95"),
-                 "Type of output: cosmic95 or modern.");
+                 "Type of output: cosmic95 or modern.") //
+        ("nastran.InputMode",po::value<string>()->default_value("mmap"),
+                 "Reading of input files: mmap (memory mapped, default) or stream.") //
+        ("nastran.ParserThreads",po::value<int>()->default_value(1),
+                 "Threads converting geometry cards: 1 (default) for a serial parsing, 0 for all the cores.");
+
+        po::options_description asterOptions("Aster specific options");
+        asterOptions.add_options() //
+        ("aster.MedChunkSize",po::value<int>()->default_value(0),
+                 "Nodes or cells written at once in the MED file: 0 (default) for all of them.");
 
         // Systus specific options
         // TODO: Some of these options are not so specific: rename and move them.
@@ -549,7 +600,7 @@ VegaCommandLine::ExitCode VegaCommandLine::process(int ac, const char* av[]) {
                 "output format. Allowed formats are ASTER, SYSTUS");
 
         po::options_description cmdline_options;
-        cmdline_options.add(commandLine).add(generic).add(nastranOptions).add(systusOptions).add(hidden);
+        cmdline_options.add(commandLine).add(generic).add(nastranOptions).add(asterOptions).add(systusOptions).add(hidden);
 
         po::options_description config_file_options;
         config_file_options.add(generic).add(systusOptions).add(hidden);
@@ -26,8 +26,10 @@
 #include <boost/algorithm/string/split.hpp>
 #include <boost/math/constants/constants.hpp>
 #include <boost/tokenizer.hpp>
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
 #include <ciso646>
 
@@ -42,6 +44,24 @@ using boost::trim;
 using boost::trim_copy;
 using boost::to_upper;
 
+namespace {
+
+/**
+ * Path of the file named by an INCLUDE line, relative to the including file.
+ */
+string includedFilePath(const string& includeLine, const string& includingFile) {
+    string fileName = includeLine.substr(7, includeLine.length() - 7);
+    trim(fileName);
+    if (!fileName.compare(0, 1, "'")
+            && !fileName.compare(fileName.size() - 1, fileName.size(), "'"))
+        fileName = fileName.substr(1, fileName.size() - 2);
+    fs::path currentFname(includingFile);
+    fs::path includePath = currentFname.parent_path() / fileName;
+    return includePath.string();
+}
+
+} // namespace
+
 const unordered_map<string, NastranParser::parseElementFPtr> NastranParser::PARSE_FUNCTION_BY_KEYWORD =
         {
                 { "BCONP", &NastranParser::parseBCONP },
@@ -535,38 +555,60 @@ NastranParser::parseElementFPtr NastranParser::findCmdParser(string keyword) con
 
 void NastranParser::parseBULKSection(NastranTokenizer &tok, Model& model) {
 
+    GeometryBatch batch;
     while (tok.nextSymbolType == NastranTokenizer::SymbolType::SYMBOL_KEYWORD) {
         string keyword = tok.nextString(true,"");
         tok.setCurrentKeyword(keyword);
-        try{
-            auto parser = findCmdParser(keyword);
-            if (parser != nullptr) {
-                (this->*parser)(tok, model);
+        if (parserThreads <= 1 or not batchGeometryCard(batch, keyword, tok, model)) {
+            flushGeometryBatch(batch, tok, model);
+            parseBULKCard(tok, model, keyword);
+        }
+        tok.nextLine();
+    }
+    flushGeometryBatch(batch, tok, model);
 
-            } else if (IGNORED_KEYWORDS.find(keyword) != IGNORED_KEYWORDS.end()) {
-                if (model.configuration.logLevel >= LogLevel::TRACE) {
-                    cout << "Keyword " << keyword << " ignored." << endl;
-                }
-                tok.skipToNextKeyword();
+}
 
-            } else if (!keyword.empty()) {
-                handleParsingError("Unknown keyword.", tok, model);
-                tok.skipToNextKeyword();
-            }
+void NastranParser::parseBULKCard(NastranTokenizer &tok, Model& model, const string& keyword) {
+    try{
+        auto parser = findCmdParser(keyword);
+        if (parser != nullptr) {
+            (this->*parser)(tok, model);
 
-            //Warning if there are unparsed fields. Skip the empty ones
-            if (!tok.isEmptyUntilNextKeyword()) {
-                handleParsingError("Parsing of line not complete:[" + tok.remainingTextUntilNextKeyword()+"]", tok, model);
+        } else if (IGNORED_KEYWORDS.find(keyword) != IGNORED_KEYWORDS.end()) {
+            if (model.configuration.logLevel >= LogLevel::TRACE) {
+                cout << "Keyword " << keyword << " ignored." << endl;
             }
+            tok.skipToNextKeyword();
 
-        } catch (std::string&) {
-            // Parsing errors are catched by VegaCommandLine.
-            // If we are not in strict mode, we dismiss this command and continue, hoping for the best.
+        } else if (!keyword.empty()) {
+            handleParsingError("Unknown keyword.", tok, model);
             tok.skipToNextKeyword();
         }
-        tok.nextLine();
+
+        //Warning if there are unparsed fields. Skip the empty ones
+        if (!tok.isEmptyUntilNextKeyword()) {
+            handleParsingError("Parsing of line not complete:[" + tok.remainingTextUntilNextKeyword()+"]", tok, model);
+        }
+
+    } catch (std::string&) {
+        // Parsing errors are catched by VegaCommandLine.
+        // If we are not in strict mode, we dismiss this command and continue, hoping for the best.
+        tok.skipToNextKeyword();
     }
+}
 
+void NastranParser::withFileTokenizer(const string& path, const function<void(NastranTokenizer&)>& action) const {
+    if (memoryMappedInput) {
+        MappedInputFile mappedFile(path);
+        NastranTokenizer tok {mappedFile, this->logLevel, path, this->translationMode};
+        action(tok);
+    } else {
+        ifstream istream(path);
+        NastranTokenizer tok {istream, this->logLevel, path, this->translationMode};
+        action(tok);
+        istream.close();
+    }
 }
 
 fs::path NastranParser::findModelFile(const string& filename) {
@@ -587,22 +629,29 @@ unique_ptr<Model> NastranParser::parse(const ConfigurationParameters& configurat
     const string modelName = inputFilePath.filename().string();
     unique_ptr<Model> model = make_unique<Model>(modelName, "UNKNOWN", SolverName::NASTRAN,
             configuration.getModelConfiguration());
+    this->memoryMappedInput = configuration.nastranInputMode == "mmap";
+    this->parserThreads = configuration.nastranParserThreads > 0 ?
+            static_cast<unsigned int>(configuration.nastranParserThreads) : max(1u, thread::hardware_concurrency());
     map<string, string> executive_section_context;
     const string inputFilePathStr = inputFilePath.string();
-    ifstream istream(inputFilePathStr);
-    NastranTokenizer tok {istream, logLevel, inputFilePath.string(), this->translationMode};
-
-    if (model->configuration.logLevel >= LogLevel::DEBUG) {
-        cout << "Parsing Executive section." << endl;
-    }
-    parseExecutiveSection(tok, *model, executive_section_context);
+    // Tokenizers print traces while reading: keep them in order
+    if (parserThreads > 1 and logLevel < LogLevel::TRACE) {
+        includePrefetcher = make_unique<IncludePrefetcher>(*this, parserThreads);
+        includePrefetcher->discover(inputFilePathStr);
+    }
+    withFileTokenizer(inputFilePathStr, [&](NastranTokenizer& tok) {
+        if (model->configuration.logLevel >= LogLevel::DEBUG) {
+            cout << "Parsing Executive section." << endl;
+        }
+        parseExecutiveSection(tok, *model, executive_section_context);
 
-    if (model->configuration.logLevel >= LogLevel::DEBUG) {
-        cout << "Parsing BULK section." << endl;
-    }
-    tok.bulkSection();
-    parseBULKSection(tok, *model);
-    istream.close();
+        if (model->configuration.logLevel >= LogLevel::DEBUG) {
+            cout << "Parsing BULK section." << endl;
+        }
+        tok.bulkSection();
+        parseBULKSection(tok, *model);
+    });
+    includePrefetcher = nullptr;
 
     if (model->configuration.logLevel >= LogLevel::DEBUG) {
         cout << "Parsing finished." << endl;
@@ -1350,10 +1399,11 @@ void NastranParser::parseDAREA(NastranTokenizer& tok, Model& model) {
         double ry = dofs.contains(DOF::RY) ? ai : 0;
         double rz = dofs.contains(DOF::RZ) ? ai : 0;
 
-        const auto& force1 = make_shared<NodalForce>(model, loadSet, tx, ty, tz, rx, ry, rz, Loading::NO_ORIGINAL_ID);
-        force1->addNodeId(node_id);
-        force1->setInputContext(tok.getInputContext());
-        model.add(force1);
+        const auto& nodalForces = model.getOrCreateNodalForceTable(loadSet);
+        if (nodalForces->rowCount() == 0)
+            nodalForces->setInputContext(tok.getInputContext());
+        nodalForces->add(node_id, CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID, VectorialValue(tx, ty, tz),
+                VectorialValue(rx, ry, rz), tok.getLineNumber());
     }
 }
 
@@ -1683,11 +1733,10 @@ void NastranParser::parseFORCE(NastranTokenizer& tok, Model& model) {
     double fz = tok.nextDouble(true,0.0) * force;
 
     const auto& loadSet = model.getOrCreateLoadSet(loadset_id, LoadSet::Type::LOAD);
-    const auto& force1 = make_shared<NodalForce>(model, loadSet, fx, fy, fz, 0., 0., 0., Loading::NO_ORIGINAL_ID,
-            Reference<CoordinateSystem>(CoordinateSystem::Type::ABSOLUTE, csid));
-    force1->addNodeId(node_id);
-    force1->setInputContext(tok.getInputContext());
-    model.add(force1);
+    const auto& nodalForces = model.getOrCreateNodalForceTable(loadSet);
+    if (nodalForces->rowCount() == 0)
+        nodalForces->setInputContext(tok.getInputContext());
+    nodalForces->add(node_id, csid, VectorialValue(fx, fy, fz), VectorialValue(0, 0, 0), tok.getLineNumber());
 }
 
 void NastranParser::parseFORCE1(NastranTokenizer& tok, Model& model) {
@@ -1811,28 +1860,148 @@ void NastranParser::parseGRAV(NastranTokenizer& tok, Model& model) {
     model.add(gravity);
 }
 void NastranParser::parseInclude(NastranTokenizer& tok, Model& model) {
-    string currentRawDataLine = tok.currentRawDataLine();
-    string fileName = currentRawDataLine.substr(7, currentRawDataLine.length() - 7);
-    trim(fileName);
-    if (!fileName.compare(0, 1, "'")
-            && !fileName.compare(fileName.size() - 1, fileName.size(), "'"))
-        fileName = fileName.substr(1, fileName.size() - 2);
-    fs::path currentFname(tok.getFileName());
-    fs::path includePath = currentFname.parent_path() / fileName;
-    const string includePathStr = includePath.string();
-    if (fs::exists(includePath)) {
-        ifstream istream(includePathStr);
-        NastranTokenizer tok2 {istream, this->logLevel, includePathStr, this->translationMode};
-        tok2.bulkSection();
-        tok2.nextLine();
-        parseBULKSection(tok2, model);
-        istream.close();
+    const string includePathStr = includedFilePath(tok.currentRawDataLine(), tok.getFileName());
+    if (fs::exists(includePathStr)) {
+        const auto& prereadCards = includePrefetcher == nullptr ? nullptr : includePrefetcher->take(includePathStr);
+        if (prereadCards != nullptr) {
+            NastranTokenizer tok2 {*prereadCards, this->logLevel, includePathStr, this->translationMode};
+            tok2.bulkSection();
+            tok2.nextLine();
+            parseBULKSection(tok2, model);
+        } else {
+            withFileTokenizer(includePathStr, [&](NastranTokenizer& tok2) {
+                tok2.bulkSection();
+                tok2.nextLine();
+                parseBULKSection(tok2, model);
+            });
+        }
     } else {
         handleParsingError("Missing include file "+includePathStr, tok, model);
     }
     tok.skipToNextKeyword();
 }
 
+NastranParser::IncludePrefetcher::IncludePrefetcher(const NastranParser& parser, unsigned int maxWorkers) :
+        parser(parser), maxWorkers(maxWorkers), maxReadAhead(2 * static_cast<size_t>(maxWorkers)) {
+}
+
+NastranParser::IncludePrefetcher::~IncludePrefetcher() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    workAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void NastranParser::IncludePrefetcher::discover(const string& inputFile) {
+    ifstream input(inputFile);
+    string line;
+    bool bulk = false;
+    while (getline(input, line)) {
+        // INCLUDE of the executive and case control sections are not parsed as bulk files
+        if (not bulk) {
+            bulk = boost::istarts_with(boost::trim_left_copy(line), "BEGIN");
+        } else if (boost::istarts_with(line, "INCLUDE")) {
+            const string& path = includedFilePath(line, inputFile);
+            if (fs::exists(path)) {
+                lock_guard<std::mutex> lock(mutex);
+                schedule(pendingPaths.size(), path);
+            }
+        }
+    }
+}
+
+bool NastranParser::IncludePrefetcher::schedule(const size_t index, const string& path) {
+    if (stopped or cardsByPath.find(path) != cardsByPath.end()) {
+        return false;
+    }
+    cardsByPath[path] = nullptr;
+    pendingPaths.insert(pendingPaths.begin() + static_cast<ptrdiff_t>(index), path);
+    if (workers.size() < maxWorkers) {
+        workers.emplace_back(&IncludePrefetcher::work, this);
+    }
+    workAvailable.notify_one();
+    return true;
+}
+
+shared_ptr<PrereadCards> NastranParser::IncludePrefetcher::take(const string& path) {
+    unique_lock<std::mutex> lock(mutex);
+    auto entry = cardsByPath.find(path);
+    if (entry == cardsByPath.end()) {
+        return nullptr;
+    }
+    const auto& pending = find(pendingPaths.begin(), pendingPaths.end(), path);
+    if (pending != pendingPaths.end()) {
+        pendingPaths.erase(pending);
+        if (readAhead >= maxReadAhead) {
+            // The read ahead is full of files taken later: waiting would never end
+            cardsByPath.erase(entry);
+            return nullptr;
+        }
+        pendingPaths.push_front(path);
+        workAvailable.notify_one();
+    }
+    readDone.wait(lock, [&entry]() {return entry->second != nullptr;});
+    const auto result = entry->second;
+    cardsByPath.erase(entry);
+    readAhead--;
+    workAvailable.notify_one();
+    return result;
+}
+
+void NastranParser::IncludePrefetcher::work() {
+    unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        workAvailable.wait(lock, [this]() {
+            return stopped or (not pendingPaths.empty() and readAhead < maxReadAhead);
+        });
+        if (stopped) {
+            return;
+        }
+        const string path = pendingPaths.front();
+        pendingPaths.pop_front();
+        readAhead++;
+        lock.unlock();
+
+        const auto& cards = make_shared<PrereadCards>();
+        try {
+            parser.withFileTokenizer(path, [&cards](NastranTokenizer& tok) {
+                tok.deferParsingErrors();
+                tok.bulkSection();
+                tok.nextLine();
+                tok.prereadBulkCards(*cards);
+            });
+        } catch (...) {
+            // Raised again when the cards are replayed, at the same point as the serial reading
+            cards->error = current_exception();
+        }
+
+        vector<string> nestedPaths;
+        for (size_t i = 0; i < cards->size(); i++) {
+            if (boost::iequals(trim_copy(cards->keyword(i).to_string()), "INCLUDE")) {
+                const string& nestedPath = includedFilePath(cards->rawLine(i).to_string(), path);
+                if (fs::exists(nestedPath)) {
+                    nestedPaths.push_back(nestedPath);
+                }
+            }
+        }
+
+        lock.lock();
+        // The nested files are read by the parser before the ones that follow this file
+        size_t index = 0;
+        for (const auto& nestedPath : nestedPaths) {
+            if (schedule(index, nestedPath)) {
+                index++;
+            }
+        }
+        cardsByPath[path] = cards;
+        readDone.notify_all();
+    }
+}
+
 void NastranParser::parseLSEQ(NastranTokenizer& tok, Model& model) {
     int set_id = tok.nextInt();
     // LSEQ will not be used unless selected in the Case Control Section with the LOADSET command.
@@ -2033,14 +2202,10 @@ void NastranParser::parseMOMENT(NastranTokenizer& tok, Model& model) {
     double frz = tok.nextDouble(true) * scale;
 
     const auto& loadSet = model.getOrCreateLoadSet(loadset_id, LoadSet::Type::LOAD);
-    const auto& moment1 = make_shared<NodalForce>(model, loadSet,
-                                                 VectorialValue(0, 0, 0),
-                                                 VectorialValue(frx, fry, frz),
-                                                 Loading::NO_ORIGINAL_ID,
-                                                 Reference<CoordinateSystem>(CoordinateSystem::Type::ABSOLUTE, csid));
-    moment1->addNodeId(node_id);
-    moment1->setInputContext(tok.getInputContext());
-    model.add(moment1);
+    const auto& nodalForces = model.getOrCreateNodalForceTable(loadSet);
+    if (nodalForces->rowCount() == 0)
+        nodalForces->setInputContext(tok.getInputContext());
+    nodalForces->add(node_id, csid, VectorialValue(0, 0, 0), VectorialValue(frx, fry, frz), tok.getLineNumber());
 }
 
 void NastranParser::parseMPC(NastranTokenizer& tok, Model& model) {
@@ -3479,10 +3644,11 @@ void NastranParser::parseSLOAD(NastranTokenizer& tok, Model& model) {
     while (tok.isNextInt()) {
         int grid_id = tok.nextInt();
         double magnitude = tok.nextDouble();
-        const auto& force1 = make_shared<NodalForce>(model, loadSet, magnitude, 0., 0., 0., 0., 0., Loading::NO_ORIGINAL_ID);
-        force1->addNodeId(grid_id);
-        force1->setInputContext(tok.getInputContext());
-        model.add(force1);
+        const auto& nodalForces = model.getOrCreateNodalForceTable(loadSet);
+        if (nodalForces->rowCount() == 0)
+            nodalForces->setInputContext(tok.getInputContext());
+        nodalForces->add(grid_id, CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID, VectorialValue(magnitude, 0., 0.),
+                VectorialValue(0., 0., 0.), tok.getLineNumber());
     }
 }
 void NastranParser::parseSPC(NastranTokenizer& tok, Model& model) {
@@ -3498,14 +3664,14 @@ void NastranParser::parseSPC(NastranTokenizer& tok, Model& model) {
         }
         const int gi = tok.nextInt(true, 123456);
         const double displacement = tok.nextDouble(true, 0.0);
-        const auto& spc = make_shared<SinglePointConstraint>(model, DOFS::nastranCodeToDOFS(gi), displacement);
+        const auto& spc = model.getOrCreateSinglePointConstraint(
+                Reference<ConstraintSet>(ConstraintSet::Type::SPC, spcSet_id),
+                DOFS::nastranCodeToDOFS(gi), displacement);
+        if (not spc->hasNodesExcludingGroups()) {
+            spc->setInputContext(tok.getInputContext());
+        }
         spc->addNodeId(nodeId);
         spcNodeGroup->addNodeId(nodeId);
-
-        spc->setInputContext(tok.getInputContext());
-        model.add(spc);
-        model.addConstraintIntoConstraintSet(*spc,
-                Reference<ConstraintSet>(ConstraintSet::Type::SPC, spcSet_id));
     }
 }
 
@@ -3513,21 +3679,16 @@ void NastranParser::parseSPC1(NastranTokenizer& tok, Model& model) {
     int set_id = tok.nextInt();
     const int dofInt = tok.nextInt();
 
-    const auto& spc = make_shared<SinglePointConstraint>(model, DOFS::nastranCodeToDOFS(dofInt), 0.0);
-
-    // Nodes are added to the constraint Node Group
-    string name = "SPC1_" + to_string(set_id);
-    //shared_ptr<NodeGroup> spcNodeGroup = model.mesh.findOrCreateNodeGroup(name,NodeGroup::NO_ORIGINAL_ID,"SPC1");
+    // SPC1 cards of a set blocking the same dofs share a single constraint
+    const auto& spc = model.getOrCreateSinglePointConstraint(
+            Reference<ConstraintSet>(ConstraintSet::Type::SPC, set_id),
+            DOFS::nastranCodeToDOFS(dofInt), 0.0);
+    if (not spc->hasNodesExcludingGroups()) {
+        spc->setInputContext(tok.getInputContext());
+    }
 
     // Parsing Nodes
     spc->addNodeIds(tok.nextInts());
-
-    // Adding the constraint to the model
-    spc->setInputContext(tok.getInputContext());
-    model.add(spc);
-    model.addConstraintIntoConstraintSet(*spc,
-            Reference<ConstraintSet>(ConstraintSet::Type::SPC, set_id));
-
 }
 
 void NastranParser::parseSPCADD(NastranTokenizer& tok, Model& model) {
@@ -29,6 +29,11 @@
 #include "../Abstract/SolverInterfaces.h"
 #include "NastranTokenizer.h"
 #include <type_traits>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 namespace vega {
 
@@ -70,6 +75,100 @@ private:
     };
     GrdSet grdSet;
 
+    /**
+     * Geometry cards (GRID and the most common elements) read from the BULK section but not yet added
+     * to the model. Their fields are converted by worker threads, then the cards are added to the model
+     * in the input order: node and cell positions are the same as with the serial parsing.
+     */
+    class GeometryBatch final {
+    public:
+        enum class Kind {
+            GRID,
+            SOLID, /**< parseElem() cards **/
+            SHELL, /**< parseShellElem() cards **/
+            ROD
+        };
+        struct CardType {
+            Kind kind;
+            parseElementFPtr parser; /**< Serial parser, also used for the cards which cannot be converted in batch **/
+            std::vector<CellType> cellTypes;
+        };
+        static const size_t MAX_NODES = 20;
+        static const size_t MAX_CARDS = 100000; /**< Bounds the memory used by the copied fields **/
+        struct Card {
+            const std::string* keyword;
+            const CardType* type;
+            int lineNumber;
+            size_t firstField;
+            size_t fieldCount;
+            size_t rawLineBegin;
+            size_t rawLineLength;
+            bool converted = false;
+            int id = 0;
+            int cp = CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID; /**< GRID only **/
+            int cd = CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID; /**< GRID only **/
+            int ps = 0;                                             /**< GRID only **/
+            int propertyId = 0;
+            double coords[3] = {0.0, 0.0, 0.0};                     /**< GRID only **/
+            double offset = 0.0;
+            const CellType* cellType = nullptr;
+            size_t nodeCount = 0;
+            int nodeIds[MAX_NODES];                                  /**< In Med order **/
+        };
+        std::vector<Card> cards;
+        std::string text; /**< Copy of the fields and raw lines of the cards **/
+        std::vector<std::pair<size_t, size_t>> fields; /**< Offset in text and length of each field **/
+        std::map<std::pair<NastranTokenizer::CommentType, int>, std::string> labels; /**< Tokenizer labels when the cards were read **/
+        size_t labelsRevision = 0;
+        NastranTokenizer::Field field(size_t index) const noexcept {
+            return NastranTokenizer::Field(text.data() + fields[index].first, fields[index].second);
+        }
+    };
+    static const std::unordered_map<std::string, GeometryBatch::CardType>& geometryCardTypes();//in NastranParser_geometry.cpp
+    unsigned int parserThreads = 1; /**< Threads converting geometry cards, 1 means serial parsing **/
+
+    /**
+     * Reads and splits the INCLUDE files in background threads, in the order the parser will need them,
+     * while the parser goes on with the including file. parseInclude() then replays their cards,
+     * so that the model is filled in the same order as with the serial parsing.
+     * At most maxReadAhead files are read or being read without having been taken, so that the
+     * deck is not held in memory when the parser is slower than the workers.
+     */
+    class IncludePrefetcher final {
+    private:
+        const NastranParser& parser;
+        const unsigned int maxWorkers;
+        const size_t maxReadAhead;
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable readDone;
+        std::deque<std::string> pendingPaths; /**< Scheduled files not started yet, in reading order **/
+        std::map<std::string, std::shared_ptr<PrereadCards>> cardsByPath; /**< nullptr until the file is read **/
+        size_t readAhead = 0; /**< Files started and not taken yet **/
+        bool stopped = false;
+        /**
+         * Inserts an existing file in pendingPaths at index, unless it was already scheduled. The mutex must be held.
+         * @return true if the file was inserted.
+         */
+        bool schedule(size_t index, const std::string& path);
+        std::vector<std::thread> workers;
+        void work();
+    public:
+        IncludePrefetcher(const NastranParser& parser, unsigned int maxWorkers);
+        ~IncludePrefetcher();
+        /**
+         * Schedules the files included by the INCLUDE lines of the bulk section of inputFile.
+         */
+        void discover(const std::string& inputFile);
+        /**
+         * Waits until a scheduled file is read and returns its cards, which are forgotten by the prefetcher.
+         * A file not started yet is read next, unless the read ahead is full.
+         * @return nullptr if the file was not scheduled or cannot be started: the caller reads it.
+         */
+        std::shared_ptr<PrereadCards> take(const std::string& path);
+    };
+    std::unique_ptr<IncludePrefetcher> includePrefetcher;
+
     std::unordered_map<std::string, Reference<ElementSet>> directMatrixByName;
     static const std::unordered_map<std::string, NastranAnalysis> ANALYSIS_BY_LABEL;
     static const std::unordered_map<std::string, parseElementFPtr> PARSE_FUNCTION_BY_KEYWORD;
@@ -82,7 +181,31 @@ private:
             Analysis::NO_ORIGINAL_ID);
 
     fs::path findModelFile(const std::string& filename);
+    /**
+     * Opens a Nastran input file, memory mapped or not (see memoryMappedInput), and hands its tokenizer to action.
+     * Thread safe.
+     */
+    void withFileTokenizer(const std::string& path, const std::function<void(NastranTokenizer&)>& action) const;
     void parseBULKSection(NastranTokenizer &tok, Model& model1);
+    /**
+     * Dispatch the current card of the tokenizer, whose keyword has already been read, to its parser.
+     */
+    void parseBULKCard(NastranTokenizer &tok, Model& model, const std::string& keyword);
+    /**
+     * Stores the current card in the batch if it is a geometry card handled by the batch.
+     * @return false if the card must be parsed immediately.
+     */
+    bool batchGeometryCard(GeometryBatch& batch, const std::string& keyword, NastranTokenizer& tok, Model& model);//in NastranParser_geometry.cpp
+    /**
+     * Converts the cards of the batch (in parallel) and adds them to the model in input order.
+     */
+    void flushGeometryBatch(GeometryBatch& batch, NastranTokenizer& tok, Model& model);//in NastranParser_geometry.cpp
+    /**
+     * Converts the fields of a batched card, without any side effect: thread safe.
+     * @return false if the card is not valid or would print warnings: it is then parsed serially.
+     */
+    bool convertGeometryCard(const GeometryBatch& batch, GeometryBatch::Card& card) const;//in NastranParser_geometry.cpp
+    void addGeometryCard(const GeometryBatch& batch, const GeometryBatch::Card& card, Model& model);//in NastranParser_geometry.cpp
 
     void parseExecutiveSection(NastranTokenizer& tok, Model& model, std::map<std::string, std::string>& context);
     /**Renumbers the nodes
@@ -862,6 +985,8 @@ private:
      *  Add the Cell to the CellGroup corresponding to the property_id (use getOrCreateCellGroup)
      */
     void addProperty(NastranTokenizer& tok, int property_id, int cell_id, Model& model);//in NastranParser_geometry.cpp
+    void addProperty(const std::map<std::pair<NastranTokenizer::CommentType, int>, std::string>& labels,
+            int property_id, int cell_id, Model& model);//in NastranParser_geometry.cpp
     /**
      *  Get the Cellgroup corresponding to the property_id. If this group does not exist, it is created.
      *  The name of the group is then "COMMAND_property_id".
@@ -886,6 +1011,7 @@ private:
     dof_int parseDOF(NastranTokenizer& tok, Model& model, bool returnDefaultIfNotFoundOrBlank = false, dof_int defaultValue = Globals::UNAVAILABLE_UCHAR);
 
     LogLevel logLevel = LogLevel::INFO;
+    bool memoryMappedInput = true; /**< Read input files through a MappedInputFile instead of an ifstream **/
     protected:
     // see also http://www.altairhyperworks.com/hwhelp/Altair/hw12.0/help/hm/hmbat.htm?design_variables.htm
     std::set<std::string> IGNORED_KEYWORDS = {
@@ -25,7 +25,9 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/tokenizer.hpp>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include "NastranParser.h"
 
@@ -97,11 +99,9 @@ void NastranParser::parseGRID(NastranTokenizer& tok, Model& model) {
 
     int ps = tok.nextInt(true, grdSet.ps);
     if (ps) {
-        string spcName = "SPC" + to_string(id);
-        const auto& spc = make_shared<SinglePointConstraint>(model, DOFS::nastranCodeToDOFS(ps));
+        const auto& spc = model.getOrCreateSinglePointConstraint(model.commonConstraintSet->getReference(),
+                DOFS::nastranCodeToDOFS(ps), 0.0);
         spc->addNodeId(id);
-        model.add(spc);
-        model.addConstraintIntoConstraintSet(*spc, *model.commonConstraintSet);
     }
 
     if (this->logLevel >= LogLevel::TRACE) {
@@ -110,12 +110,17 @@ void NastranParser::parseGRID(NastranTokenizer& tok, Model& model) {
 }
 
 void NastranParser::addProperty(NastranTokenizer& tok, int property_id, int cell_id, Model& model) {
+    addProperty(tok.labelByCommentTypeAndId, property_id, cell_id, model);
+}
+
+void NastranParser::addProperty(const map<pair<NastranTokenizer::CommentType, int>, string>& labels,
+        int property_id, int cell_id, Model& model) {
     auto cellGroup = dynamic_pointer_cast<CellGroup>(model.mesh.findGroup(property_id));
     if (cellGroup == nullptr) {
         string cellGroupName = "PROP_" + to_string(property_id);
         string comment = cellGroupName;
-        auto commentEntry = tok.labelByCommentTypeAndId.find({NastranTokenizer::CommentType::COMP, property_id});
-        if (commentEntry != tok.labelByCommentTypeAndId.end())
+        auto commentEntry = labels.find({NastranTokenizer::CommentType::COMP, property_id});
+        if (commentEntry != labels.end())
             comment = commentEntry->second;
         cellGroup = model.mesh.createCellGroup(cellGroupName, property_id, comment);
     }
@@ -134,7 +139,7 @@ shared_ptr<CellGroup> NastranParser::getOrCreateCellGroup(int group_id, Model& m
 pos_t NastranParser::parseOrientation(int point1, int point2, NastranTokenizer& tok,
         Model& model) {
 
-    const auto& line = tok.currentDataLine();
+    const auto& line = tok.currentFields();
     bool alternateFormat = line.size() < 8 || line[6].empty() || line[7].empty();
     shared_ptr<OrientationCoordinateSystem> ocs;
     if (alternateFormat) {
@@ -240,7 +245,7 @@ void NastranParser::parseCBUSH(NastranTokenizer& tok, Model& model) {
     // Local element coordinate system
     pos_t cpos = 0;
     if (!tok.isEmptyUntilNextKeyword()) {
-        vector<string> line = tok.currentDataLine();
+        const auto& line = tok.currentFields();
         if ( (line.size()>8) && !(line[8].empty())){
             // A CID is provided by the user
             tok.skip(3);
@@ -713,8 +718,345 @@ void NastranParser::parseSPOINT(NastranTokenizer& tok, Model& model) {
     model.addConstraintIntoConstraintSet(*spc, *model.commonConstraintSet);
 }
 
+namespace {
 
+/**
+ * Reads the fields of a batched geometry card with the same conventions as NastranTokenizer
+ * (missing or blank optional fields take their default value) but never reports an error:
+ * every method returns false when the tokenizer would have complained.
+ */
+class BatchFieldReader final {
+private:
+    const char* text;
+    const pair<size_t, size_t>* next;
+    const pair<size_t, size_t>* end;
+
+    NastranTokenizer::Field peek() const noexcept {
+        if (next == end) {
+            return NastranTokenizer::Field();
+        }
+        NastranTokenizer::Field field(text + next->first, next->second);
+        while (not field.empty() and isspace(static_cast<unsigned char>(field.front()))) {
+            field.remove_prefix(1);
+        }
+        while (not field.empty() and isspace(static_cast<unsigned char>(field.back()))) {
+            field.remove_suffix(1);
+        }
+        return field;
+    }
+public:
+    BatchFieldReader(const string& text, const pair<size_t, size_t>* begin, const pair<size_t, size_t>* end) noexcept :
+            text(text.data()), next(begin), end(end) {
+    }
+    /** Mandatory integer, as NastranTokenizer::nextInt() **/
+    bool readInt(int& value) noexcept {
+        const auto& field = peek();
+        skip(1);
+        return scanNastranInt(field, value);
+    }
+    /** Optional integer, as NastranTokenizer::nextInt(true, defaultValue) **/
+    bool readInt(int& value, int defaultValue) noexcept {
+        const auto& field = peek();
+        skip(1);
+        if (field.empty()) {
+            value = defaultValue;
+            return true;
+        }
+        return scanNastranInt(field, value);
+    }
+    /** Optional real, as NastranTokenizer::nextDouble(true, defaultValue) **/
+    bool readDouble(double& value, double defaultValue) noexcept {
+        const auto& field = peek();
+        skip(1);
+        if (field.empty()) {
+            value = defaultValue;
+            return true;
+        }
+        return scanNastranDouble(field, value);
+    }
+    /** Skips a field that must be blank **/
+    bool readBlank() noexcept {
+        const bool blank = peek().empty();
+        skip(1);
+        return blank;
+    }
+    void skip(size_t count) noexcept {
+        next += min(count, static_cast<size_t>(end - next));
+    }
+    /** Same test as NastranTokenizer::isNextInt() **/
+    bool isNextInt() const noexcept {
+        const auto& field = peek();
+        return not field.empty() and all_of(field.begin(), field.end(), [](char c) {
+            return c == '-' or (c >= '0' and c <= '9');
+        });
+    }
+    bool isNextTHRU() const noexcept {
+        return next != end and alg::iequals(peek(), "THRU");
+    }
+    bool isEmptyUntilEnd() const noexcept {
+        for (auto it = next; it != end; ++it) {
+            for (size_t i = 0; i < it->second; i++) {
+                if (not isspace(static_cast<unsigned char>(text[it->first + i]))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+
+}
+
+const unordered_map<string, NastranParser::GeometryBatch::CardType>& NastranParser::geometryCardTypes() {
+    // Built on first use, since CellType constants are defined in another translation unit
+    using Kind = GeometryBatch::Kind;
+    static const unordered_map<string, GeometryBatch::CardType> cardTypes = {
+            { "GRID", { Kind::GRID, &NastranParser::parseGRID, { } } },
+            { "CHEXA", { Kind::SOLID, &NastranParser::parseCHEXA, { CellType::HEXA8, CellType::HEXA20 } } },
+            { "CIHEX1", { Kind::SOLID, &NastranParser::parseCHEXA, { CellType::HEXA8, CellType::HEXA20 } } },
+            { "CIHEX2", { Kind::SOLID, &NastranParser::parseCHEXA, { CellType::HEXA8, CellType::HEXA20 } } },
+            { "CPENTA", { Kind::SOLID, &NastranParser::parseCPENTA, { CellType::PENTA6, CellType::PENTA15 } } },
+            { "CPYRA", { Kind::SOLID, &NastranParser::parseCPYRAM, { CellType::PYRA5, CellType::PYRA13 } } },
+            { "CPYRAM", { Kind::SOLID, &NastranParser::parseCPYRAM, { CellType::PYRA5, CellType::PYRA13 } } },
+            { "CQUAD", { Kind::SOLID, &NastranParser::parseCQUAD, { CellType::QUAD4, CellType::QUAD8, CellType::QUAD9 } } },
+            { "CTETRA", { Kind::SOLID, &NastranParser::parseCTETRA, { CellType::TETRA4, CellType::TETRA10 } } },
+            { "CQUAD4", { Kind::SHELL, &NastranParser::parseCQUAD4, { CellType::QUAD4 } } },
+            { "CQUAD8", { Kind::SHELL, &NastranParser::parseCQUAD8, { CellType::QUAD8 } } },
+            { "CQUADR", { Kind::SHELL, &NastranParser::parseCQUADR, { CellType::QUAD4 } } },
+            { "CTRIA3", { Kind::SHELL, &NastranParser::parseCTRIA3, { CellType::TRI3 } } },
+            { "CTRIA6", { Kind::SHELL, &NastranParser::parseCTRIA6, { CellType::TRI6 } } },
+            { "CTRIAR", { Kind::SHELL, &NastranParser::parseCTRIAR, { CellType::TRI3 } } },
+            { "CROD", { Kind::ROD, &NastranParser::parseCROD, { CellType::SEG2 } } },
+    };
+    return cardTypes;
+}
+
+bool NastranParser::batchGeometryCard(GeometryBatch& batch, const string& keyword, NastranTokenizer& tok, Model& model) {
+    const auto& cardTypes = geometryCardTypes();
+    const auto& cardTypeEntry = cardTypes.find(keyword);
+    // Derived parsers (e.g. Optistruct) may use another parser for the same keyword
+    if (cardTypeEntry == cardTypes.end() or findCmdParser(keyword) != cardTypeEntry->second.parser) {
+        return false;
+    }
+    // Cards must see the labels defined before them, as with the serial parsing
+    if (batch.cards.size() >= GeometryBatch::MAX_CARDS
+            or batch.labelsRevision != tok.getLabelsRevision()) {
+        flushGeometryBatch(batch, tok, model);
+    }
+    if (batch.cards.empty()) {
+        batch.labels = tok.labelByCommentTypeAndId;
+        batch.labelsRevision = tok.getLabelsRevision();
+    }
+
+    GeometryBatch::Card card;
+    card.keyword = &cardTypeEntry->first;
+    card.type = &cardTypeEntry->second;
+    card.lineNumber = tok.getLineNumber();
+    const auto& fields = tok.currentFields();
+    card.firstField = batch.fields.size();
+    card.fieldCount = fields.size() - 1; // without keyword
+    for (size_t i = 1; i < fields.size(); i++) {
+        batch.fields.push_back({batch.text.size(), fields[i].size()});
+        batch.text.append(fields[i].data(), fields[i].size());
+    }
+    const auto& rawLine = tok.currentRawLine();
+    card.rawLineBegin = batch.text.size();
+    card.rawLineLength = rawLine.size();
+    batch.text.append(rawLine.data(), rawLine.size());
+    batch.cards.push_back(card);
+    return true;
+}
 
+bool NastranParser::convertGeometryCard(const GeometryBatch& batch, GeometryBatch::Card& card) const {
+    const auto* firstField = batch.fields.data() + card.firstField;
+    BatchFieldReader reader(batch.text, firstField, firstField + card.fieldCount);
+    switch (card.type->kind) {
+    case GeometryBatch::Kind::GRID: {
+        if (not reader.readInt(card.id) or not reader.readInt(card.cp, static_cast<int>(grdSet.cp))
+                or not reader.readDouble(card.coords[0], 0.0) or not reader.readDouble(card.coords[1], 0.0)
+                or not reader.readDouble(card.coords[2], 0.0)
+                or not reader.readInt(card.cd, static_cast<int>(grdSet.cd)) or not reader.readInt(card.ps, grdSet.ps)) {
+            return false;
+        }
+        break;
+    }
+    case GeometryBatch::Kind::SOLID: {
+        if (not reader.readInt(card.id) or not reader.readInt(card.propertyId, card.id)) {
+            return false;
+        }
+        int nastranConnect[GeometryBatch::MAX_NODES];
+        size_t nodeCount = 0;
+        while (reader.isNextInt()) {
+            if (nodeCount == GeometryBatch::MAX_NODES or not reader.readInt(nastranConnect[nodeCount])) {
+                return false;
+            }
+            nodeCount++;
+        }
+        if (reader.isNextTHRU()) {
+            return false;
+        }
+        for (const CellType& cellType : card.type->cellTypes) {
+            if (cellType.numNodes == nodeCount) {
+                card.cellType = &cellType;
+                break;
+            }
+        }
+        if (card.cellType == nullptr) {
+            return false;
+        }
+        const auto& nastran2med_it = nastran2medNodeConnectByCellType.find(card.cellType->code);
+        for (size_t i = 0; i < nodeCount; i++) {
+            const size_t medIndex = nastran2med_it == nastran2medNodeConnectByCellType.end() ?
+                    i : static_cast<size_t>(nastran2med_it->second[i]);
+            card.nodeIds[medIndex] = nastranConnect[i];
+        }
+        card.nodeCount = nodeCount;
+        break;
+    }
+    case GeometryBatch::Kind::SHELL: {
+        card.cellType = &card.type->cellTypes.front();
+        card.nodeCount = card.cellType->numNodes;
+        if (not reader.readInt(card.id) or not reader.readInt(card.propertyId, card.id)) {
+            return false;
+        }
+        for (size_t i = 0; i < card.nodeCount; i++) {
+            if (not reader.readInt(card.nodeIds[i])) {
+                return false;
+            }
+        }
+        // Same field layouts as parseShellElem(): thicknesses must be blank, as they would raise warnings
+        double thetaOrMCID = 0.0;
+        int tflag = 0;
+        bool valid = true;
+        switch (card.cellType->code) {
+        case CellType::Code::TRI3_CODE:
+            valid = reader.readDouble(thetaOrMCID, 0.0) and reader.readDouble(card.offset, 0.0);
+            reader.skip(2);
+            valid = valid and reader.readInt(tflag, 0) and reader.readBlank() and reader.readBlank()
+                    and reader.readBlank();
+            break;
+        case CellType::Code::QUAD4_CODE:
+            valid = reader.readDouble(thetaOrMCID, 0.0) and reader.readDouble(card.offset, 0.0);
+            reader.skip(1);
+            valid = valid and reader.readInt(tflag, 0) and reader.readBlank() and reader.readBlank()
+                    and reader.readBlank() and reader.readBlank();
+            break;
+        case CellType::Code::TRI6_CODE:
+            valid = reader.readDouble(thetaOrMCID, 0.0) and reader.readDouble(card.offset, 0.0)
+                    and reader.readBlank() and reader.readBlank() and reader.readBlank()
+                    and reader.readInt(tflag, 0);
+            break;
+        case CellType::Code::QUAD8_CODE:
+            valid = reader.readBlank() and reader.readBlank() and reader.readBlank() and reader.readBlank()
+                    and reader.readDouble(thetaOrMCID, 0.0) and reader.readDouble(card.offset, 0.0)
+                    and reader.readInt(tflag, 0);
+            break;
+        default:
+            valid = false;
+        }
+        // Warnings are left to the serial parser
+        if (not valid or not is_zero(thetaOrMCID) or tflag != 0) {
+            return false;
+        }
+        break;
+    }
+    case GeometryBatch::Kind::ROD: {
+        card.cellType = &card.type->cellTypes.front();
+        card.nodeCount = 2;
+        if (not reader.readInt(card.id) or not reader.readInt(card.propertyId, card.id)
+                or not reader.readInt(card.nodeIds[0]) or not reader.readInt(card.nodeIds[1])) {
+            return false;
+        }
+        break;
+    }
+    default:
+        return false;
+    }
+    return reader.isEmptyUntilEnd();
+}
+
+void NastranParser::addGeometryCard(const GeometryBatch& batch, const GeometryBatch::Card& card, Model& model) {
+    if (card.type->kind != GeometryBatch::Kind::GRID) {
+        const vector<int> nodeIds(card.nodeIds, card.nodeIds + card.nodeCount);
+        model.mesh.addCell(card.id, *card.cellType, nodeIds, false, CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID,
+                card.propertyId, card.offset);
+        addProperty(batch.labels, card.propertyId, card.id, model);
+        return;
+    }
+    // Same steps as parseGRID()
+    pos_t cpos = CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID;
+    if (card.cp != CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID) {
+        cpos = model.mesh.findOrReserveCoordinateSystem(Reference<CoordinateSystem>(CoordinateSystem::Type::ABSOLUTE, card.cp));
+    }
+    pos_t cdos = CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID;
+    if (card.cd != CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID) {
+        cdos = model.mesh.findOrReserveCoordinateSystem(Reference<CoordinateSystem>(CoordinateSystem::Type::ABSOLUTE, card.cd));
+    }
+    model.mesh.addNode(card.id, card.coords[0], card.coords[1], card.coords[2], cpos, cdos);
+
+    if (card.ps) {
+        const auto& spc = model.getOrCreateSinglePointConstraint(model.commonConstraintSet->getReference(),
+                DOFS::nastranCodeToDOFS(card.ps), 0.0);
+        spc->addNodeId(card.id);
+    }
+
+    if (this->logLevel >= LogLevel::TRACE) {
+        string scp, scd;
+        if (card.cp != CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID)
+            scp=" in CS"+to_string(card.cp)+"_"+to_string(cpos);
+        if (card.cd != CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID)
+            scd=", DISP in CS"+to_string(card.cd)+"_"+to_string(cdos);
+        cout << fixed << "GRID " << card.id << ": (" << card.coords[0] << ";" << card.coords[1] << ";"
+                << card.coords[2] <<")"<< scp<<scd<< endl;
+    }
+}
+
+void NastranParser::flushGeometryBatch(GeometryBatch& batch, NastranTokenizer& tok, Model& model) {
+    if (batch.cards.empty()) {
+        return;
+    }
+    // Conversion of the fields, by contiguous ranges of cards
+    static const size_t MIN_CARDS_BY_THREAD = 4096;
+    const size_t cardCount = batch.cards.size();
+    const size_t threadCount = max<size_t>(1, min<size_t>(parserThreads, cardCount / MIN_CARDS_BY_THREAD));
+    const size_t cardsByThread = (cardCount + threadCount - 1) / threadCount;
+    const auto& convertCards = [this, &batch](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            batch.cards[i].converted = convertGeometryCard(batch, batch.cards[i]);
+        }
+    };
+    vector<thread> workers;
+    for (size_t begin = cardsByThread; begin < cardCount; begin += cardsByThread) {
+        workers.emplace_back(convertCards, begin, min(cardCount, begin + cardsByThread));
+    }
+    convertCards(0, min(cardCount, cardsByThread));
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Merge into the model, in input order
+    istringstream noInput;
+    NastranTokenizer replayTok(noInput, this->logLevel, tok.getFileName(), this->translationMode);
+    replayTok.labelByCommentTypeAndId = batch.labels;
+    vector<NastranTokenizer::Field> fields;
+    for (const auto& card : batch.cards) {
+        if (card.converted) {
+            addGeometryCard(batch, card, model);
+            continue;
+        }
+        // Cards that are invalid or raise warnings are parsed again serially, to report the same messages
+        fields.clear();
+        for (size_t i = card.firstField; i < card.firstField + card.fieldCount; i++) {
+            fields.push_back(batch.field(i));
+        }
+        replayTok.replayCard(*card.keyword, fields,
+                NastranTokenizer::Field(batch.text.data() + card.rawLineBegin, card.rawLineLength), card.lineNumber);
+        parseBULKCard(replayTok, model, *card.keyword);
+    }
+    batch.cards.clear();
+    batch.fields.clear();
+    batch.text.clear();
+}
 
 } /* namespace nastran */
 
@@ -11,13 +11,18 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/tokenizer.hpp>
 #include <boost/filesystem.hpp>
-#include <boost/lexical_cast.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include <iostream>
 #include <cassert>
 #include <string>
 #include <vector>
 #include <fstream>
 #include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
 #include "NastranTokenizer.h"
 #include "../Abstract/SolverInterfaces.h"
 #include <ciso646>
@@ -25,20 +30,213 @@
 using namespace std;
 using boost::tokenizer;
 using boost::offset_separator;
-using boost::lexical_cast;
 using boost::trim_copy;
 
 namespace vega {
 
 namespace nastran {
 
+namespace bip = boost::interprocess;
+
+class MappedInputFile::Impl final {
+private:
+	class MappedBuffer final : public std::streambuf {
+	public:
+		MappedBuffer(const char* begin, const char* end) {
+			setg(const_cast<char*>(begin), const_cast<char*>(begin), const_cast<char*>(end));
+		}
+	};
+public:
+	bip::file_mapping mapping;
+	bip::mapped_region region;
+	const char* begin = nullptr;
+	const char* end = nullptr;
+	std::unique_ptr<MappedBuffer> buffer;
+	std::unique_ptr<istream> stream;
+	Impl(const string& path) {
+		// An empty file cannot be mapped
+		if (fs::file_size(path) > 0) {
+			mapping = bip::file_mapping(path.c_str(), bip::read_only);
+			region = bip::mapped_region(mapping, bip::read_only);
+			begin = static_cast<const char*>(region.get_address());
+			end = begin + region.get_size();
+		}
+		buffer = make_unique<MappedBuffer>(begin, end);
+		stream = make_unique<istream>(buffer.get());
+	}
+};
+
+MappedInputFile::MappedInputFile(const string& path) : impl(make_unique<Impl>(path)) {
+}
+
+MappedInputFile::~MappedInputFile() = default;
+
+const char* MappedInputFile::begin() const noexcept {
+	return impl->begin;
+}
+
+const char* MappedInputFile::end() const noexcept {
+	return impl->end;
+}
+
+istream& MappedInputFile::stream() noexcept {
+	return *(impl->stream);
+}
+
+namespace {
+
+inline bool isSpace(char c) noexcept {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline bool isBlank(char c) noexcept {
+	return c == ' ' || c == '\t';
+}
+
+inline NastranTokenizer::Field trimRight(NastranTokenizer::Field field) noexcept {
+	while (not field.empty() and isSpace(field.back())) {
+		field.remove_suffix(1);
+	}
+	return field;
+}
+
+inline NastranTokenizer::Field trim(NastranTokenizer::Field field) noexcept {
+	while (not field.empty() and isSpace(field.front())) {
+		field.remove_prefix(1);
+	}
+	return trimRight(field);
+}
+
+/**
+ * Input of the tokenizers that do not read any stream.
+ */
+istream& noInput() {
+	static istream stream(nullptr);
+	return stream;
+}
+
+/**
+ * Same behavior as boost::split(result, text, is_any_of(separators), compress), but without copy.
+ */
+void splitFields(vector<NastranTokenizer::Field>& result, const NastranTokenizer::Field& text,
+		const char* separators, bool compress) {
+	size_t start = 0;
+	for (size_t i = 0; i < text.size(); ++i) {
+		if (text[i] != '\0' and strchr(separators, text[i]) != nullptr) {
+			result.push_back(text.substr(start, i - start));
+			while (compress and i + 1 < text.size() and text[i + 1] != '\0'
+					and strchr(separators, text[i + 1]) != nullptr) {
+				++i;
+			}
+			start = i + 1;
+		}
+	}
+	result.push_back(text.substr(start));
+}
+
+}
+
+bool scanNastranInt(const boost::string_ref& field, int& value) noexcept {
+	const NastranTokenizer::Field digits = trim(field);
+	size_t i = 0;
+	bool negative = false;
+	if (not digits.empty() and (digits[0] == '+' or digits[0] == '-')) {
+		negative = digits[0] == '-';
+		i = 1;
+	}
+	if (i == digits.size()) {
+		return false;
+	}
+	const long long limit = static_cast<long long>(numeric_limits<int>::max()) + (negative ? 1 : 0);
+	long long result = 0;
+	for (; i < digits.size(); ++i) {
+		const char c = digits[i];
+		if (c < '0' or c > '9') {
+			return false;
+		}
+		result = result * 10 + (c - '0');
+		if (result > limit) {
+			return false;
+		}
+	}
+	value = static_cast<int>(negative ? -result : result);
+	return true;
+}
+
+bool scanNastranDouble(const boost::string_ref& field, double& value) noexcept {
+	// Normalized characters (no blanks, explicit 'E' exponent) handed to strtod, kept on the stack
+	char normalized[128];
+	size_t length = 0;
+	bool dot = false;
+	bool mantissaDigits = false;
+	bool exponent = false;
+	bool exponentDigits = false;
+	for (char c : field) {
+		if (isSpace(c)) {
+			continue;
+		}
+		if (length + 2 >= sizeof(normalized)) {
+			return false;
+		}
+		if (c >= '0' and c <= '9') {
+			(exponent ? exponentDigits : mantissaDigits) = true;
+		} else if (c == '.') {
+			if (dot or exponent) {
+				return false;
+			}
+			dot = true;
+		} else if (c == 'e' or c == 'E' or c == 'd' or c == 'D') {
+			if (exponent or not mantissaDigits) {
+				return false;
+			}
+			exponent = true;
+			c = 'E';
+		} else if (c == '+' or c == '-') {
+			if (not exponent and mantissaDigits) {
+				// Implicit exponent: 1.5-3 stands for 1.5E-3
+				normalized[length++] = 'E';
+				exponent = true;
+			} else if (length != 0 and normalized[length - 1] != 'E') {
+				return false;
+			}
+		} else {
+			return false;
+		}
+		normalized[length++] = c;
+	}
+	if (not mantissaDigits or (exponent and not exponentDigits)) {
+		return false;
+	}
+	normalized[length] = '\0';
+	const double result = strtod(normalized, nullptr);
+	if (std::isinf(result)) {
+		return false;
+	}
+	value = result;
+	return true;
+}
+
 NastranTokenizer::NastranTokenizer(istream& stream, vega::LogLevel logLevel, const string fileName,
 		const vega::ConfigurationParameters::TranslationMode translationMode) :
 		Tokenizer(stream, logLevel, fileName, translationMode),
-		currentField(0), currentSection(SectionType::SECTION_EXECUTIVE),
+		currentField(0), memoryMapped(false), currentSection(SectionType::SECTION_EXECUTIVE),
 		nextSymbolType{SymbolType::SYMBOL_KEYWORD} {
 }
 
+NastranTokenizer::NastranTokenizer(MappedInputFile& mappedFile, vega::LogLevel logLevel, const string fileName,
+		const vega::ConfigurationParameters::TranslationMode translationMode) :
+		Tokenizer(mappedFile.stream(), logLevel, fileName, translationMode),
+		currentField(0), memoryMapped(true), mappedCursor(mappedFile.begin()), mappedEnd(mappedFile.end()),
+		currentSection(SectionType::SECTION_EXECUTIVE), nextSymbolType{SymbolType::SYMBOL_KEYWORD} {
+}
+
+NastranTokenizer::NastranTokenizer(const PrereadCards& cards, vega::LogLevel logLevel, const string fileName,
+		const vega::ConfigurationParameters::TranslationMode translationMode) :
+		Tokenizer(noInput(), logLevel, fileName, translationMode),
+		currentField(0), memoryMapped(false), preread(&cards),
+		currentSection(SectionType::SECTION_EXECUTIVE), nextSymbolType{SymbolType::SYMBOL_KEYWORD} {
+}
+
 const string NastranTokenizer::HM_COMMENT_START = "$HMNAME ";
 
 const map<string, NastranTokenizer::CommentType> NastranTokenizer::commentTypeByString = {
@@ -61,10 +259,10 @@ const map<string, NastranTokenizer::CommentType> NastranTokenizer::commentTypeBy
         { "VECTORCOL", CommentType::VECTORCOL },
 };
 
-NastranTokenizer::LineType NastranTokenizer::getLineType(const string& line) {
-	const string beginning = line.substr(0, 8);
-	if (beginning.find(",") == string::npos) {
-		if (beginning.find("*") == string::npos) {
+NastranTokenizer::LineType NastranTokenizer::getLineType(const Field& line) {
+	const Field beginning = line.substr(0, 8);
+	if (beginning.find(',') == Field::npos) {
+		if (beginning.find('*') == Field::npos) {
 			return LineType::SHORT_FORMAT;
 		} else {
 			return LineType::LONG_FORMAT;
@@ -75,41 +273,42 @@ NastranTokenizer::LineType NastranTokenizer::getLineType(const string& line) {
 }
 
 
-void NastranTokenizer::replaceTabs(string& line, bool longFormat) {
-	bool found = true;
-	do {
-		size_t pos = line.find("\t");
-		found = pos != string::npos;
-		if (found) {
-			int FIELD_SIZE = SFSIZE;
-			int offset = 0;
-			int ipos = static_cast<int>(pos);
-			if (longFormat){
-				if (ipos>7){
-					offset = SFSIZE;
-					FIELD_SIZE = LFSIZE;
-				}
-				if (ipos>71) FIELD_SIZE=LFSIZE;
+NastranTokenizer::Field NastranTokenizer::replaceTabs(const Field& line, bool longFormat) {
+	if (line.find('\t') == Field::npos) {
+		return line;
+	}
+	string& expanded = nextLineBuffer();
+	expanded.clear();
+	for (const char c : line) {
+		if (c != '\t') {
+			expanded.push_back(c);
+			continue;
+		}
+		int FIELD_SIZE = SFSIZE;
+		int offset = 0;
+		int ipos = static_cast<int>(expanded.size());
+		if (longFormat){
+			if (ipos>7){
+				offset = SFSIZE;
+				FIELD_SIZE = LFSIZE;
 			}
-			int numSpacesNeeded = FIELD_SIZE - ((ipos-offset) % FIELD_SIZE);
-			string filler(numSpacesNeeded, ' ');
-			boost::replace_first(line, "\t", filler);
+			if (ipos>71) FIELD_SIZE=LFSIZE;
 		}
-	} while (found);
+		int numSpacesNeeded = FIELD_SIZE - ((ipos-offset) % FIELD_SIZE);
+		expanded.append(static_cast<size_t>(numSpacesNeeded), ' ');
+	}
+	return Field(expanded);
 }
 
 
-string NastranTokenizer::nextSymbolString() {
+NastranTokenizer::Field NastranTokenizer::nextSymbolField() {
 
     if (this->currentField >= this->currentLineVector.size()){
         this->nextSymbolType = SymbolType::SYMBOL_KEYWORD;
-        return "";
+        return Field();
     }
 
-    string result = boost::trim_right_copy(currentLineVector[currentField]);
-    if (this->nextSymbolType == SymbolType::SYMBOL_KEYWORD) {
-        boost::to_upper(result);
-    }
+    const Field result = currentLineVector[currentField];
     this->nextSymbolType = SymbolType::SYMBOL_FIELD;
     this->currentField++;
     if (this->currentField >= this->currentLineVector.size()){
@@ -119,35 +318,90 @@ string NastranTokenizer::nextSymbolString() {
     return result;
 }
 
-bool NastranTokenizer::readLineSkipComment(string& line, bool firstLine) {
+string NastranTokenizer::nextSymbolString() {
+    const bool keyword = this->nextSymbolType == SymbolType::SYMBOL_KEYWORD;
+    string result = trimRight(nextSymbolField()).to_string();
+    if (keyword) {
+        boost::to_upper(result);
+    }
+    return result;
+}
+
+string& NastranTokenizer::nextLineBuffer() {
+	if (usedLineBuffers == lineBuffers.size()) {
+		lineBuffers.emplace_back();
+	}
+	return lineBuffers[usedLineBuffers++];
+}
+
+bool NastranTokenizer::readRawLine(Field& line, string& buffer) {
+	if (not memoryMapped) {
+		if (not getline(this->instrream, buffer)) {
+			return false;
+		}
+		line = Field(buffer);
+		return true;
+	}
+	if (mappedCursor == mappedEnd) {
+		return false;
+	}
+	const size_t remaining = static_cast<size_t>(mappedEnd - mappedCursor);
+	const char* endOfLine = static_cast<const char*>(memchr(mappedCursor, '\n', remaining));
+	if (endOfLine == nullptr) {
+		line = Field(mappedCursor, remaining);
+		mappedCursor = mappedEnd;
+	} else {
+		line = Field(mappedCursor, static_cast<size_t>(endOfLine - mappedCursor));
+		mappedCursor = endOfLine + 1;
+	}
+	return true;
+}
+
+void NastranTokenizer::skipRawLine() {
+	if (not memoryMapped) {
+		this->instrream.ignore(numeric_limits<streamsize>::max(), '\n');
+		return;
+	}
+	const char* endOfLine = static_cast<const char*>(memchr(mappedCursor, '\n', static_cast<size_t>(mappedEnd - mappedCursor)));
+	mappedCursor = endOfLine == nullptr ? mappedEnd : endOfLine + 1;
+}
+
+int NastranTokenizer::peekChar() {
+	if (not memoryMapped) {
+		return this->instrream.peek();
+	}
+	return mappedCursor == mappedEnd ? char_traits<char>::eof() : *mappedCursor;
+}
+
+bool NastranTokenizer::readLineSkipComment(Field& line, bool firstLine) {
 	bool eof = true;
-	while (getline(this->instrream, line)) {
+	string& buffer = nextLineBuffer();
+	while (readRawLine(line, buffer)) {
 		lineNumber += 1;
-		bool blankLine = all_of(line.begin(), line.end(), [](int c) {return isblank(c);});
+		bool blankLine = all_of(line.begin(), line.end(), isBlank);
 		if (not line.empty() and not blankLine and line[0] != '$') {
-			boost::iterator_range<string::iterator> middle_dollar = boost::find_first(line, "$");
-			if (middle_dollar) {
-				boost::erase_tail(line,
-						static_cast<int>(line.size())
-								- static_cast<int>(distance(line.begin(), middle_dollar.begin())));
+			const size_t middle_dollar = line.find('$');
+			if (middle_dollar != Field::npos) {
+				line = line.substr(0, middle_dollar);
 			}
 			//if the line is not blank exit the loop
-			if (!boost::all(line, [](int c) { return isblank(c); })){
+			if (not all_of(line.begin(), line.end(), isBlank)){
 				eof = false;
 				break;
 			}
         } else if (not firstLine and blankLine) {
             eof = false;
             break;
-		} else if (boost::starts_with(line, HM_COMMENT_START)) {
-		    boost::erase_head(line, static_cast<int>(HM_COMMENT_START.size()));
+		} else if (line.starts_with(HM_COMMENT_START)) {
+		    const string comment = line.substr(HM_COMMENT_START.size()).to_string();
 		    vector<string> commentParts;
-		    boost::split(commentParts, line, boost::is_any_of(" \""), boost::token_compress_on);
+		    boost::split(commentParts, comment, boost::is_any_of(" \""), boost::token_compress_on);
             if (commentParts.size() >= 3) {
                 bool isPart2Int = all_of(commentParts[1].begin(), commentParts[1].end(), ::isdigit);
                 auto result = commentTypeByString.find(commentParts[0]);
                 if (isPart2Int and result != commentTypeByString.end()) {
                     labelByCommentTypeAndId[{result->second, stoi(commentParts[1])}] = commentParts[2];
+                    labelsRevision++;
                 }
             }
 		}
@@ -155,33 +409,33 @@ bool NastranTokenizer::readLineSkipComment(string& line, bool firstLine) {
 	return eof;
 }
 
-void NastranTokenizer::splitFreeFormat(string line, bool firstLine) {
+void NastranTokenizer::splitFreeFormat(const Field& line, bool firstLine) {
 	if (firstLine) {
-		split(currentLineVector, line, boost::is_any_of(","));
+		currentLineVector.clear();
+		splitFields(currentLineVector, line, ",", false);
 	} else {
 		//skip first field;
-		string lineNoContinuation = line.substr(line.find(',') + 1);
-		vector<string> otherLine;
-		split(otherLine, lineNoContinuation, boost::is_any_of(","));
-		currentLineVector.insert(currentLineVector.end(), otherLine.begin(), otherLine.end());
+		const size_t comma = line.find(',');
+		const Field lineNoContinuation = comma == Field::npos ? line : line.substr(comma + 1);
+		splitFields(currentLineVector, lineNoContinuation, ",", false);
 	}
 	bool explicitContinuation = false;
 	for (size_t fieldIndex = 1; fieldIndex < currentLineVector.size(); fieldIndex += 8) {
-		string field = trim_copy(currentLineVector[fieldIndex]);
-		if (field[0] == '+') {
+		const Field field = trim(currentLineVector[fieldIndex]);
+		if (not field.empty() and field[0] == '+') {
 			explicitContinuation = true;
 			currentLineVector.erase(currentLineVector.begin() + fieldIndex);
 		}
 	}
-	char c = static_cast<char>(this->instrream.peek());
-    string line2;
+	int c = peekChar();
+    Field line2;
     if (explicitContinuation || c == ',' || c == '+' || c == '*') {
 		readLineSkipComment(line2, false);
 		splitFreeFormat(line2, false);
 	}
 }
 
-void NastranTokenizer::parseBulkSectionLine(string line) {
+void NastranTokenizer::parseBulkSectionLine(const Field& line) {
 	LineType lineType = getLineType(line);
 	switch (lineType) {
 	case LineType::LONG_FORMAT:
@@ -207,7 +461,7 @@ void NastranTokenizer::executiveControlSection() {
 void NastranTokenizer::bulkSection() {
 	this->currentSection = SectionType::SECTION_BULK;
 //if not first line, read again the current line
-	if (not currentLineVector.empty()) {
+	if (not currentLineVector.empty() and preread == nullptr) {
 		currentLineVector.clear();
 		//enough in 99% of lines
 		currentLineVector.reserve(64);
@@ -218,42 +472,42 @@ void NastranTokenizer::bulkSection() {
 }
 
 void NastranTokenizer::parseParameters() {
-	split(currentLineVector, this->currentLine, boost::is_any_of("\\="));
+	currentLineVector.clear();
+	splitFields(currentLineVector, this->currentLine, "\\=", false);
 }
 
 bool NastranTokenizer::isNextInt() {
 	if (nextSymbolType != SymbolType::SYMBOL_FIELD) {
 		return false;
 	}
-	string curField = trim_copy(currentLineVector[currentField]);
-	return !curField.empty() && (strspn(curField.c_str(), "-0123456789") == curField.size());
+	const Field curField = trim(currentLineVector[currentField]);
+	return !curField.empty() && all_of(curField.begin(), curField.end(), [](char c) {
+		return c == '-' or (c >= '0' and c <= '9');
+	});
 }
 
 bool NastranTokenizer::isNextTHRU() {
 	if (nextSymbolType != SymbolType::SYMBOL_FIELD) {
 		return false;
 	}
-	string curField = trim_copy(currentLineVector[currentField]);
-	boost::to_upper(curField);
-	return curField == "THRU";
+	return boost::iequals(trim(currentLineVector[currentField]), "THRU");
 }
 
 bool NastranTokenizer::isNextBY() {
 	if (nextSymbolType != SymbolType::SYMBOL_FIELD) {
 		return false;
 	}
-	string curField = trim_copy(currentLineVector[currentField]);
-	boost::to_upper(curField);
-	return curField == "BY";
+	return boost::iequals(trim(currentLineVector[currentField]), "BY");
 }
 
 bool NastranTokenizer::isNextDouble() {
 	if (nextSymbolType != SymbolType::SYMBOL_FIELD) {
 		return false;
 	}
-	string curField = trim_copy(currentLineVector[currentField]);
-	boost::algorithm::erase_all(curField, " ");
-	return !curField.empty() && (strspn(curField.c_str(), "-+0123456789.eEdD") == curField.size());
+	const Field curField = trim(currentLineVector[currentField]);
+	return !curField.empty() && all_of(curField.begin(), curField.end(), [](char c) {
+		return c == ' ' or strchr("-+0123456789.eEdD", c) != nullptr;
+	});
 }
 
 bool NastranTokenizer::isNextEmpty(int n) {
@@ -263,8 +517,7 @@ bool NastranTokenizer::isNextEmpty(int n) {
             result = false;
             break;
         }
-        string curField = trim_copy(currentLineVector[currentField + i]);
-        result &= curField.empty();
+        result &= trim(currentLineVector[currentField + i]).empty();
     }
 	return result;
 }
@@ -277,8 +530,7 @@ bool NastranTokenizer::isEmptyUntilNextKeyword() {
 	}
 	bool result = true;
 	for (size_t i = currentField; i < this->currentLineVector.size() && result; i++) {
-		string curField = trim_copy(currentLineVector[i]);
-		result &= curField.empty();
+		result &= trim(currentLineVector[i]).empty();
 	}
 	return result;
 }
@@ -291,7 +543,7 @@ string NastranTokenizer::remainingTextUntilNextKeyword() {
 	}
     ostringstream oss;
 	for (size_t i = currentField; i < this->currentLineVector.size(); i++) {
-        string curfield = trim_copy(currentLineVector[i]);
+        const Field curfield = trim(currentLineVector[i]);
         if (!curfield.empty()) {
             oss << "," << curfield;
         }
@@ -301,17 +553,22 @@ string NastranTokenizer::remainingTextUntilNextKeyword() {
 
 void NastranTokenizer::nextLine() {
 
+	if (preread != nullptr) {
+		nextPrereadCard();
+		return;
+	}
 	currentLineVector.clear();
 //enough in 99% of lines
 	currentLineVector.reserve(128);
 	currentField = 0;
+	usedLineBuffers = 0;
 
 	bool iseof = readLineSkipComment(this->currentLine, true);
 	if (!iseof) {
 		switch (currentSection) {
 		case SectionType::SECTION_EXECUTIVE:
-			boost::algorithm::trim(this->currentLine);
-			split(currentLineVector, this->currentLine, boost::is_any_of("\t\\= "), boost::algorithm::token_compress_on);
+			this->currentLine = trim(this->currentLine);
+			splitFields(currentLineVector, this->currentLine, "\t\\= ", true);
 			break;
 		case SectionType::SECTION_BULK:
 			parseBulkSectionLine(this->currentLine);
@@ -325,52 +582,61 @@ void NastranTokenizer::nextLine() {
 	}
 }
 
-void NastranTokenizer::splitFixedFormat(string& line, const bool longFormat, const bool firstLine) {
-	boost::offset_separator f;
-
-	int fieldMax;
-	if (longFormat) {
-		int offsets[] = { SFSIZE, LFSIZE, LFSIZE, LFSIZE, LFSIZE, SFSIZE };
-		fieldMax = 5;
-		f = offset_separator(offsets, offsets + 6);
-	} else {
-		int offsets[] = { SFSIZE, SFSIZE, SFSIZE, SFSIZE, SFSIZE, SFSIZE, SFSIZE, SFSIZE, SFSIZE, SFSIZE };
-		fieldMax = 9;
-		f = offset_separator(offsets, offsets + 10);
-	}
-
-	replaceTabs(line, longFormat);
-	tokenizer<offset_separator> tok(line, f);
-	tokenizer<offset_separator>::iterator beg = tok.begin();
+void NastranTokenizer::splitFixedFormat(Field line, const bool longFormat, const bool firstLine) {
+	static const size_t LONG_OFFSETS[] = { SFSIZE, LFSIZE, LFSIZE, LFSIZE, LFSIZE, SFSIZE };
+	static const size_t SHORT_OFFSETS[] = { SFSIZE, SFSIZE, SFSIZE, SFSIZE, SFSIZE, SFSIZE, SFSIZE, SFSIZE, SFSIZE, SFSIZE };
+	const size_t* offsets = longFormat ? LONG_OFFSETS : SHORT_OFFSETS;
+	const size_t offsetCount = longFormat ? 6 : 10;
+	const int fieldMax = longFormat ? 5 : 9;
+
+	line = replaceTabs(line, longFormat);
+	// Cuts the line like a boost::offset_separator (wrapping offsets, returning partial last field)
+	size_t linePosition = 0;
+	size_t currentOffset = 0;
+	auto nextToken = [&](Field& token) {
+		if (linePosition >= line.size()) {
+			return false;
+		}
+		token = line.substr(linePosition, offsets[currentOffset]);
+		linePosition += token.size();
+		currentOffset = (currentOffset + 1) % offsetCount;
+		return true;
+	};
+	Field token;
+	bool hasToken = nextToken(token);
 	int count = 0;
 	if (!firstLine) {
 		//todo:check that explicit continuation tokens are the same
-		++beg;
+		hasToken = hasToken and nextToken(token);
 		count++;
 	}
 	bool explicitContinuation = false;
-	for (; beg != tok.end(); ++beg) {
-		string trimCopy = trim_copy(*beg);
+	for (; hasToken; hasToken = nextToken(token)) {
+		Field trimmed = trim(token);
 		//erase all the long format specifiers
-		if (count == 0) {
-			boost::erase_all(trimCopy, "*");
+		if (count == 0 and trimmed.find('*') != Field::npos) {
+			string& withoutStars = nextLineBuffer();
+			withoutStars.assign(trimmed.begin(), trimmed.end());
+			boost::erase_all(withoutStars, "*");
+			trimmed = Field(withoutStars);
 		}
-		currentLineVector.push_back(trimCopy);
+		currentLineVector.push_back(trimmed);
 		if (++count == fieldMax) {
-			explicitContinuation = (++beg != tok.end()) && !(trim_copy(*beg).empty());
+			Field continuation;
+			explicitContinuation = nextToken(continuation) && !(trim(continuation).empty());
 			if (explicitContinuation && this->logLevel >= vega::LogLevel::TRACE) {
 				cout << "explicitContinuation" << endl;
 			}
 			break;
 		}
 	}
-	string line2;
-	char c0 = static_cast<char>(this->instrream.peek());
+	Field line2;
+	int c0 = peekChar();
 
 	while (c0 == '$') { // Trying to skip "comment inside card case"
-        getline(this->instrream, line2);
+        skipRawLine();
         lineNumber += 1;
-        c0 = static_cast<char>(this->instrream.peek());
+        c0 = peekChar();
     }
 
 	if (explicitContinuation or c0 == '+') {
@@ -385,12 +651,12 @@ void NastranTokenizer::splitFixedFormat(string& line, const bool longFormat, con
 		/** Test for automatic continuation : we allow tabulation
 		 *  Even if it's, strictly speaking, not authorized by Nastran
 		 */
-		char c = static_cast<char>(this->instrream.peek());
+		int c = peekChar();
 		if (c == ' ' || c == '+' || c == '*' || c=='\t') {
 			readLineSkipComment(line2, false);
 			//fill the current line with empty fields
 			for (; count < fieldMax; count++) {
-				currentLineVector.push_back("");
+				currentLineVector.push_back(Field());
 			}
 			bool longFormat2 = (c == '*');
 			splitFixedFormat(line2, longFormat2, false);
@@ -441,7 +707,7 @@ void NastranTokenizer::skipToNextKeyword() {
 
 int NastranTokenizer::nextInt(bool returnDefaultIfNotFoundOrBlank, int defaultValue) {
 	int result = 0;
-	string value = trim_copy(nextSymbolString());
+	const Field value = trim(nextSymbolField());
 	if (value.empty()) {
 	    if (returnDefaultIfNotFoundOrBlank){
 	        return defaultValue;
@@ -450,12 +716,10 @@ int NastranTokenizer::nextInt(bool returnDefaultIfNotFoundOrBlank, int defaultVa
 	        handleParsingError(message);
 	    }
 	}
-	try {
-		result = lexical_cast<int>(value);
-	} catch (boost::bad_lexical_cast &) {
+	if (not scanNastranInt(value, result)) {
 		string currentFieldstr =
 				currentField == 0 ? "LAST" : to_string(currentField - 1);
-		string message = "Value [" + value + "] can't be converted to int. Field Num: "
+		string message = "Value [" + value.to_string() + "] can't be converted to int. Field Num: "
 				+ currentFieldstr;
 		handleParsingError(message);
 	}
@@ -499,7 +763,7 @@ list<double> NastranTokenizer::nextDoubles() {
 
 double NastranTokenizer::nextDouble(bool returnDefaultIfNotFoundOrBlank, double defaultValue) {
 	double result = 0.0;
-	string value = trim_copy(nextSymbolString());
+	const Field value = trim(nextSymbolField());
 	if (value.empty()) {
 	    if (returnDefaultIfNotFoundOrBlank) {
 	        return defaultValue;
@@ -508,32 +772,110 @@ double NastranTokenizer::nextDouble(bool returnDefaultIfNotFoundOrBlank, double
 	        handleParsingError(message);
 	    }
 	}
-
-	boost::replace_all(value, "d", "e");
-	boost::replace_all(value, "D", "E");
-	boost::algorithm::erase_all(value, " ");
-	size_t position = value.find_first_of("+-", 1);
-	if (position != string::npos and position != value.find_first_of("eE", 1) + 1) {
-		value.insert(position, "E");
-	}
-	try {
-		result = lexical_cast<double>(value);
-	} catch (boost::bad_lexical_cast &) {
+	if (not scanNastranDouble(value, result)) {
 		string currentFieldstr =
 				currentField == 0 ? "LAST" : to_string(currentField - 1);
-		string message = "Value [" + value + "] can't be converted to double. Field Num: "
+		string message = "Value [" + value.to_string() + "] can't be converted to double. Field Num: "
 				+ currentFieldstr;
 		handleParsingError(message);
 	}
 	return result;
 }
 
+void NastranTokenizer::replayCard(const string& keyword, const vector<Field>& fields, const Field& rawLine,
+		int lineNumber) {
+	usedLineBuffers = 0;
+	string& keywordBuffer = nextLineBuffer();
+	keywordBuffer = keyword;
+	currentSection = SectionType::SECTION_BULK;
+	currentLineVector.clear();
+	currentLineVector.push_back(Field(keywordBuffer));
+	currentLineVector.insert(currentLineVector.end(), fields.begin(), fields.end());
+	currentLine = rawLine;
+	currentField = 1;
+	nextSymbolType = fields.empty() ? SymbolType::SYMBOL_KEYWORD : SymbolType::SYMBOL_FIELD;
+	this->lineNumber = lineNumber;
+	this->currentKeyword = keyword;
+}
+
+void NastranTokenizer::nextPrereadCard() {
+	currentLineVector.clear();
+	currentField = 0;
+	if (prereadPosition == preread->cards.size()) {
+		if (preread->error) {
+			try {
+				rethrow_exception(preread->error);
+			} catch (const ParsingException& parsingException) {
+				// Deferred by the reading thread: strict mode stops here, where the serial reading would have
+				if (translationMode == ConfigurationParameters::TranslationMode::MODE_STRICT) {
+					exitOnParsingError(parsingException);
+				}
+				throw;
+			}
+		}
+		this->nextSymbolType = SymbolType::SYMBOL_EOF;
+		return;
+	}
+	const auto& card = preread->cards[prereadPosition++];
+	for (size_t i = card.firstField; i < card.firstField + card.fieldCount; i++) {
+		currentLineVector.push_back(Field(preread->text.data() + preread->fields[i].first, preread->fields[i].second));
+	}
+	currentLine = Field(preread->text.data() + card.rawLineBegin, card.rawLineLength);
+	lineNumber = card.lineNumber;
+	if (labelsRevision == 0 or card.labels != prereadLabels) {
+		labelByCommentTypeAndId = preread->labels[card.labels];
+		prereadLabels = card.labels;
+		labelsRevision++;
+	}
+	this->nextSymbolType = SymbolType::SYMBOL_KEYWORD;
+}
+
+void NastranTokenizer::prereadBulkCards(PrereadCards& result) {
+	while (nextSymbolType != SymbolType::SYMBOL_EOF) {
+		if (result.labels.empty() or result.labelsRevision != labelsRevision) {
+			result.labels.push_back(labelByCommentTypeAndId);
+			result.labelsRevision = labelsRevision;
+		}
+		PrereadCards::Card card;
+		card.firstField = result.fields.size();
+		card.fieldCount = currentLineVector.size();
+		for (const Field& field : currentLineVector) {
+			result.fields.push_back({result.text.size(), field.size()});
+			result.text.append(field.data(), field.size());
+		}
+		card.rawLineBegin = result.text.size();
+		card.rawLineLength = currentLine.size();
+		result.text.append(currentLine.data(), currentLine.size());
+		card.lineNumber = lineNumber;
+		card.labels = result.labels.size() - 1;
+		result.cards.push_back(card);
+		nextLine();
+	}
+}
+
+NastranTokenizer::Field PrereadCards::keyword(size_t index) const noexcept {
+	const auto& card = cards[index];
+	if (card.fieldCount == 0) {
+		return NastranTokenizer::Field();
+	}
+	return NastranTokenizer::Field(text.data() + fields[card.firstField].first, fields[card.firstField].second);
+}
+
+NastranTokenizer::Field PrereadCards::rawLine(size_t index) const noexcept {
+	return NastranTokenizer::Field(text.data() + cards[index].rawLineBegin, cards[index].rawLineLength);
+}
+
 vector<string> NastranTokenizer::currentDataLine() const {
-	return currentLineVector;
+	vector<string> result;
+	result.reserve(currentLineVector.size());
+	for (const Field& field : currentLineVector) {
+		result.push_back(field.to_string());
+	}
+	return result;
 }
 
 string NastranTokenizer::currentRawDataLine() const {
-	return this->currentLine;
+	return this->currentLine.to_string();
 }
 
 } /* namespace nastran */
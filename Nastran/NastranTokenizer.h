@@ -27,8 +27,13 @@
 #include <string>
 #include <fstream>
 #include <vector>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
 #include <iostream>
 #include <limits>
+#include <boost/utility/string_ref.hpp>
 #include "../Abstract/ConfigurationParameters.h"
 #include "../Abstract/SolverInterfaces.h"
 
@@ -36,9 +41,46 @@ namespace vega {
 
 namespace nastran {
 
+/**
+ * Read-only memory mapping of a Nastran input file.
+ * Tokenizers built over it return fields pointing directly inside the mapped bytes,
+ * so it must outlive them.
+ */
+class MappedInputFile final {
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl;
+public:
+    explicit MappedInputFile(const std::string& path);
+    ~MappedInputFile();
+    MappedInputFile(const MappedInputFile& that) = delete;
+    const char* begin() const noexcept;
+    const char* end() const noexcept;
+    /**
+     * A stream over the mapped bytes (no copy is done).
+     */
+    std::istream& stream() noexcept;
+};
+
+/**
+ * Reads a Nastran integer field in place: surrounding blanks and an optional sign are accepted.
+ * @return false (value untouched) if the field is blank, not an integer or out of range.
+ */
+bool scanNastranInt(const boost::string_ref& field, int& value) noexcept;
+
+/**
+ * Reads a Nastran real field in place. Besides the usual C syntax it accepts blanks anywhere,
+ * "D" exponents (1.5D-3) and implicit exponents (1.5-3, -.2+1).
+ * @return false (value untouched) if the field is blank or not a number.
+ */
+bool scanNastranDouble(const boost::string_ref& field, double& value) noexcept;
+
+class PrereadCards;
+
 //TODO implements iterator
 class NastranTokenizer : public vega::Tokenizer {
 public:
+    using Field = boost::string_ref; /**< Non-owning slice of the input text **/
     enum class LineType {
         FREE_FORMAT,
         SHORT_FORMAT,
@@ -70,17 +112,36 @@ private:
     static const std::map<std::string, CommentType> commentTypeByString;
 
     unsigned int currentField;   /**< Current position of the Tokenizer, i.e, the next field to be interpreted **/
-    std::vector<std::string> currentLineVector;
-    std::string currentLine = "";
+    std::vector<Field> currentLineVector;
+    Field currentLine;
 
-    NastranTokenizer::LineType getLineType(const std::string& line); /**< Determine the LineType of the line.**/
-    void replaceTabs(std::string &line, bool longFormat); /**< Replace all tabulation by the needed number of space. **/
+    const bool memoryMapped;     /**< True if lines are sliced from a MappedInputFile instead of read from the stream **/
+    const char* mappedCursor = nullptr; /**< Next unread byte of the mapped file **/
+    const char* mappedEnd = nullptr;
+    /**
+     * Storage for the text of the current card, when it cannot be sliced from the input (stream mode, tabulations).
+     * Buffers are reused from one card to the next, a deque keeps the slices valid while it grows.
+     */
+    std::deque<std::string> lineBuffers;
+    size_t usedLineBuffers = 0;
+    size_t labelsRevision = 0;   /**< Incremented each time labelByCommentTypeAndId changes **/
+    const PrereadCards* preread = nullptr; /**< Cards replayed by nextLine() instead of reading the input **/
+    size_t prereadPosition = 0;
+    size_t prereadLabels = 0;
+    void nextPrereadCard();
 
-    void splitFixedFormat(std::string& line, bool longFormat, bool firstLine);
+    NastranTokenizer::LineType getLineType(const Field& line); /**< Determine the LineType of the line.**/
+    Field replaceTabs(const Field& line, bool longFormat); /**< Replace all tabulation by the needed number of space. **/
 
-    bool readLineSkipComment(std::string& line, bool firstLine);
-    void splitFreeFormat(std::string line, bool firstLine);
-    void parseBulkSectionLine(std::string line);
+    void splitFixedFormat(Field line, bool longFormat, bool firstLine);
+
+    std::string& nextLineBuffer();
+    bool readRawLine(Field& line, std::string& buffer);
+    void skipRawLine();
+    int peekChar();
+    bool readLineSkipComment(Field& line, bool firstLine);
+    void splitFreeFormat(const Field& line, bool firstLine);
+    void parseBulkSectionLine(const Field& line);
     void parseParameters();
 
     /**
@@ -89,6 +150,10 @@ private:
      */
     //string nextBulkString();
     std::string nextSymbolString();
+    /**
+     * Same as nextSymbolString, but returns the raw (untrimmed) field without any copy.
+     */
+    Field nextSymbolField();
 
 public:
     enum class SymbolType {
@@ -109,6 +174,20 @@ public:
     NastranTokenizer(std::istream& stream, vega::LogLevel logLevel = vega::LogLevel::INFO,
             const std::string fileName = "UNKNOWN",
             const vega::ConfigurationParameters::TranslationMode translationMode = vega::ConfigurationParameters::TranslationMode::BEST_EFFORT);
+    /**
+     * Tokenizer reading directly inside a memory mapped file: fields are slices of the mapped bytes
+     * and no copy is done for the lines of the file.
+     */
+    NastranTokenizer(MappedInputFile& mappedFile, vega::LogLevel logLevel = vega::LogLevel::INFO,
+            const std::string fileName = "UNKNOWN",
+            const vega::ConfigurationParameters::TranslationMode translationMode = vega::ConfigurationParameters::TranslationMode::BEST_EFFORT);
+    /**
+     * Tokenizer replaying cards already read (from the BULK section) by another tokenizer.
+     * The PrereadCards must outlive the tokenizer.
+     */
+    NastranTokenizer(const PrereadCards& cards, vega::LogLevel logLevel = vega::LogLevel::INFO,
+            const std::string fileName = "UNKNOWN",
+            const vega::ConfigurationParameters::TranslationMode translationMode = vega::ConfigurationParameters::TranslationMode::BEST_EFFORT);
     virtual ~NastranTokenizer() = default;
     NastranTokenizer(const NastranTokenizer& that) = delete;
 
@@ -185,15 +264,72 @@ public:
      * Return a vector containing the full data line with unparsed arguments.
      */
     std::vector<std::string> currentDataLine() const;
+    /**
+     * Loads a card that was already split, as if it had just been read from the BULK section with its
+     * keyword already consumed. Used to parse cards stored away from their input file.
+     */
+    void replayCard(const std::string& keyword, const std::vector<Field>& fields, const Field& rawLine, int lineNumber);
+    /**
+     * Same as currentDataLine(), without copy: fields are only valid until next line is read.
+     */
+    const std::vector<Field>& currentFields() const noexcept {
+        return currentLineVector;
+    }
+    /**
+     * Same as currentRawDataLine(), without copy: only valid until next line is read.
+     */
+    const Field& currentRawLine() const noexcept {
+        return currentLine;
+    }
 
     std::string currentRawDataLine() const override;
     /**
      * Advances to next data line, discarding the current content.
      */
     void nextLine();
+    /**
+     * Copies the current card and all the following ones into result, until the end of the input.
+     * Exceptions thrown while reading are not caught: result then holds the cards read before.
+     */
+    void prereadBulkCards(PrereadCards& result);
+    inline size_t getLabelsRevision() const noexcept {
+        return labelsRevision;
+    }
 
 };
 
+/**
+ * Cards of a BULK section split ahead of time by NastranTokenizer::prereadBulkCards(), possibly in
+ * another thread, then replayed by a NastranTokenizer built over them.
+ */
+class PrereadCards final {
+private:
+    friend class NastranTokenizer;
+    struct Card {
+        size_t firstField;
+        size_t fieldCount;
+        size_t rawLineBegin;
+        size_t rawLineLength;
+        int lineNumber;
+        size_t labels; /**< Index in labels **/
+    };
+    std::vector<Card> cards;
+    std::string text; /**< Copy of the fields and raw lines of the cards **/
+    std::vector<std::pair<size_t, size_t>> fields; /**< Offset in text and length of each field **/
+    std::vector<std::map<std::pair<NastranTokenizer::CommentType, int>, std::string>> labels; /**< Successive labels of the reading tokenizer **/
+    size_t labelsRevision = 0;
+public:
+    std::exception_ptr error; /**< What stopped the reading before the end of the input, if anything **/
+    inline size_t size() const noexcept {
+        return cards.size();
+    }
+    /**
+     * Keywords of the cards, as written in the input (not trimmed nor uppercased).
+     */
+    NastranTokenizer::Field keyword(size_t index) const noexcept;
+    NastranTokenizer::Field rawLine(size_t index) const noexcept;
+};
+
 } /* namespace nastran */
 
 } /* namespace vega */
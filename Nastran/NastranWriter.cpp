@@ -18,6 +18,8 @@
 #include <string>
 #include <fstream>
 #include <limits>
+#include <cstring>
+#include <cstdio>
 #include <ciso646>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string.hpp>
@@ -151,6 +153,208 @@ Line& Line::add(const VectorialValue vector) noexcept {
 	return *this;
 }
 
+const size_t CardWriter::BUFFER_SIZE;
+
+CardWriter::CardWriter(ostream& out) : out(out), buffer(BUFFER_SIZE) {
+}
+
+CardWriter::~CardWriter() {
+	flush();
+}
+
+void CardWriter::write(const char* chars, size_t length) {
+	if (used + length > buffer.size()) {
+		out.write(buffer.data(), static_cast<streamsize>(used));
+		used = 0;
+		if (length > buffer.size()) {
+			out.write(chars, static_cast<streamsize>(length));
+			return;
+		}
+	}
+	memcpy(buffer.data() + used, chars, length);
+	used += length;
+}
+
+void CardWriter::fill(const char c, size_t count) {
+	while (count > 0) {
+		if (used == buffer.size()) {
+			out.write(buffer.data(), static_cast<streamsize>(used));
+			used = 0;
+		}
+		const size_t length = min(count, buffer.size() - used);
+		memset(buffer.data() + used, c, length);
+		used += length;
+		count -= length;
+	}
+}
+
+void CardWriter::endCard() {
+	if (cardStarted) {
+		write("\n", 1);
+		cardStarted = false;
+	}
+}
+
+void CardWriter::nextField() {
+	if (++fieldCount % fieldNum == 0) {
+		char continuation[16];
+		const size_t length = static_cast<size_t>(snprintf(continuation, sizeof(continuation), "+%d", ++Line::newlineCounter));
+		write(continuation, length);
+		write("\n", 1);
+		write(continuation, length);
+		if (length < fieldLength) {
+			fill(' ', fieldLength - length);
+		}
+		fieldCount++;
+	}
+}
+
+void CardWriter::addRight(const char* chars, size_t length) {
+	nextField();
+	if (length < fieldLength) {
+		fill(' ', fieldLength - length);
+	}
+	write(chars, length);
+}
+
+CardWriter& CardWriter::card(const char* keyword) {
+	endCard();
+	const size_t length = strlen(keyword);
+	if (length > 0 and keyword[length - 1] == '*') {
+		fieldLength = 16;
+		fieldNum = 5;
+	} else {
+		fieldLength = 8;
+		fieldNum = 9;
+	}
+	fieldCount = 0;
+	cardStarted = true;
+	write(keyword, length);
+	if (length < 8) {
+		fill(' ', 8 - length);
+	}
+	return *this;
+}
+
+CardWriter& CardWriter::add() {
+	nextField();
+	fill(' ', fieldLength);
+	return *this;
+}
+
+size_t CardWriter::formatDouble(const double value, const unsigned int fieldLength, char* chars) noexcept {
+	if (is_zero(value)) {
+		chars[0] = '0';
+		chars[1] = '.';
+		return 2;
+	}
+	// Same steps as Line::add(double): mantissa and exponent from the scientific notation, then the
+	// mantissa is rounded to the digits left by the exponent and its useless zeros are removed
+	char scientific[32];
+	snprintf(scientific, sizeof(scientific), "%.11e", value);
+	char* exponentStart = strchr(scientific, 'e');
+	if (exponentStart == nullptr) {
+		// inf or nan
+		return static_cast<size_t>(snprintf(chars, 32, "%s", scientific));
+	}
+	*exponentStart = '\0';
+	const double mantissa = strtod(scientific, nullptr);
+	const int exponent = abs(atoi(exponentStart + 1));
+	const int exponentLength = exponent < 10 ? 1 : exponent < 100 ? 2 : 3;
+	const int decimals = 5 - exponentLength - (value < 0 ? 1 : 0);
+	int length = snprintf(chars, 32, "%.*f", decimals, mantissa);
+	int begin = 0;
+	while (begin < length and chars[begin] == '0') {
+		begin++;
+	}
+	while (length > begin and chars[length - 1] == '0') {
+		length--;
+	}
+	if (begin > 0) {
+		memmove(chars, chars + begin, static_cast<size_t>(length - begin));
+		length -= begin;
+	}
+	chars[length++] = abs(value) < 1. ? '-' : '+';
+	length += snprintf(chars + length, 8, "%d", exponent);
+	if (length > static_cast<int>(fieldLength)) {
+		length = snprintf(chars, 32, "%4.2e", value);
+	}
+	return static_cast<size_t>(length);
+}
+
+CardWriter& CardWriter::add(const double value) {
+	char chars[32];
+	addRight(chars, formatDouble(value, fieldLength, chars));
+	return *this;
+}
+
+CardWriter& CardWriter::add(const int value) {
+	// internal adjustment, as Line: the sign is left aligned and the digits right aligned
+	char digits[16];
+	size_t length = 0;
+	unsigned int absValue = value < 0 ? 0u - static_cast<unsigned int>(value) : static_cast<unsigned int>(value);
+	do {
+		digits[sizeof(digits) - ++length] = static_cast<char>('0' + absValue % 10);
+		absValue /= 10;
+	} while (absValue > 0);
+	nextField();
+	size_t width = length;
+	if (value < 0) {
+		write("-", 1);
+		width++;
+	}
+	if (width < fieldLength) {
+		fill(' ', fieldLength - width);
+	}
+	write(digits + sizeof(digits) - length, length);
+	return *this;
+}
+
+CardWriter& CardWriter::add(const string& value) {
+	addRight(value.data(), value.size());
+	return *this;
+}
+
+CardWriter& CardWriter::add(const char* value) {
+	addRight(value, strlen(value));
+	return *this;
+}
+
+CardWriter& CardWriter::skip(int numFieldsToSkip) {
+	for (int i = 0; i < numFieldsToSkip; i++) {
+		add();
+	}
+	return *this;
+}
+
+CardWriter& CardWriter::add(const vector<int>& values) {
+	for (const int value : values) {
+		add(value);
+	}
+	return *this;
+}
+
+CardWriter& CardWriter::add(const vector<double>& values) {
+	for (const double value : values) {
+		add(value);
+	}
+	return *this;
+}
+
+CardWriter& CardWriter::add(const DOFS dofs) {
+	return add(dofs.nastranCode());
+}
+
+CardWriter& CardWriter::add(const VectorialValue& vector) {
+	return add(vector.x()).add(vector.y()).add(vector.z());
+}
+
+void CardWriter::flush() {
+	endCard();
+	out.write(buffer.data(), static_cast<streamsize>(used));
+	used = 0;
+}
+
 const unordered_map<CellType::Code, vector<int>, EnumClassHash> NastranWriter::med2nastranNodeConnectByCellType =
         {
                 { CellType::Code::TRI3_CODE, { 0, 2, 1 } },
@@ -244,6 +448,8 @@ void NastranWriter::writeSOL(const Model& model, ofstream& out) const
 
 void NastranWriter::writeCells(const Model& model, ofstream& out) const
 		{
+	CardWriter cards(out);
+	vector<int> nasConnect;
 	for (const auto& elementSet : model.elementSets) {
 		if (elementSet->isMatrixElement()) {
 			continue;
@@ -331,18 +537,17 @@ void NastranWriter::writeCells(const Model& model, ofstream& out) const
                     }
 			    }
 			}
-            vector<int> nasConnect;
             auto entry = med2nastranNodeConnectByCellType.find(cell.type.code);
             if (entry == med2nastranNodeConnectByCellType.end()) {
                 nasConnect = cell.nodeIds;
             } else {
-                vector<int> med2nastranNodeConnectByCellType = entry->second;
+                const vector<int>& med2nastranNodeConnect = entry->second;
                 nasConnect.resize(cell.type.numNodes);
                 for (unsigned int i2 = 0; i2 < cell.type.numNodes; i2++)
-                    nasConnect[med2nastranNodeConnectByCellType[i2]] = cell.nodeIds[i2];
+                    nasConnect[med2nastranNodeConnect[i2]] = cell.nodeIds[i2];
             }
 
-            Line cellLine{keyword};
+            CardWriter& cellLine = cards.card(keyword.c_str());
             if (isCosmic() && (cell.type.code == CellType::Code::TETRA4_CODE || cell.type.code == CellType::Code::TETRA10_CODE)) {
                 cellLine.add(cell.id).add(elementSet->mainMaterial()->bestId()).add(nasConnect);
             } else {
@@ -361,19 +566,19 @@ void NastranWriter::writeCells(const Model& model, ofstream& out) const
                 cellLine.add(); // theta (real) or matid (int)
                 cellLine.add(cell.offset);
             }
-			out << cellLine;
 		}
 	}
 }
 
 void NastranWriter::writeNodes(const Model& model, ofstream& out) const
 		{
-	for (Node node : model.mesh.nodes) {
+	CardWriter cards(out);
+	for (const Node& node : model.mesh.nodes) {
 	    if (node.positionCS!= CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID)
 	        cerr << "Warning in GRID "<<node.id<<" CP not supported and dismissed."<<endl;
         if (node.displacementCS!= CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID)
             cerr << "Warning in GRID "<<node.id<<" CD not supported and dismissed."<<endl;
-		out << Line("GRID").add(node.id).add().add(node.lx).add(node.ly).add(node.lz);
+		cards.card("GRID").add(node.id).add().add(node.lx).add(node.ly).add(node.lz);
 	}
 }
 
@@ -741,17 +946,17 @@ void NastranWriter::writeLoadings(const Model& model, ofstream& out) const
                 continue;
 
             const auto& nodalForce = static_pointer_cast<NodalForce>(loading);
-            for (const auto nodePosition : nodalForce->getNodePositionsIncludingGroups()) {
+            for (const auto& nodeForce : nodalForce->getForcesInGlobalCS()) {
                 Line force("FORCE");
                 force.add(loadingSet->bestId());
-                force.add(model.mesh.findNodeId(nodePosition));
+                force.add(model.mesh.findNodeId(nodeForce.nodePosition));
                 force.add(0);
-                const auto& forceVector = nodalForce->getForceInGlobalCS(nodePosition);
+                const auto& forceVector = nodeForce.force;
                 force.add(1.0);
                 force.add(forceVector.x());
                 force.add(forceVector.y());
                 force.add(forceVector.z());
-                if (!nodalForce->getMomentInGlobalCS(nodePosition).iszero()) {
+                if (!nodeForce.moment.iszero()) {
                     handleWritingError("Unimplemented moment in FORCE");
                 }
                 out << force;
@@ -924,7 +1129,7 @@ string NastranWriter::writeModel(Model& model,
 	out << "TIME  10000" << endl;
 	out << "CEND" << endl;
 	for (const auto& analysis : model.analyses) {
-        for (const auto& objective : analysis->getObjectives()) {
+        for (const auto& objective : analysis->getIndividualObjectives()) {
             if (objective->type != Objective::Type::NODAL_DISPLACEMENT_OUTPUT)
                 continue;
             const auto& displacementOutput = static_pointer_cast<const NodalDisplacementOutput>(objective);
@@ -995,7 +1200,7 @@ string NastranWriter::writeModel(Model& model,
 			string typeName = constraintSet->stringByType.find(constraintSet->type)->second;
 			out << "  " << typeName << "=" << constraintSet->bestId() << endl;
 		}
-		for (const auto& objective : analysis->getObjectives()) {
+		for (const auto& objective : analysis->getIndividualObjectives()) {
             switch (objective->type) {
             case Objective::Type::NODAL_DISPLACEMENT_OUTPUT: {
                 out << "  DISP = ";
@@ -1017,7 +1222,7 @@ string NastranWriter::writeModel(Model& model,
                 continue;
             }
 		}
-		for (const auto& assertion : analysis->getAssertions()) {
+		for (const auto& assertion : analysis->getIndividualAssertions()) {
 		    assertion->markAsWritten(); // Nastran cannot write assertions AFAIK
 		}
 		analysis->markAsWritten();
@@ -24,9 +24,12 @@
 namespace vega {
 namespace nastran {
 
+class CardWriter;
+
 class Line {
     static int newlineCounter;
 	friend std::ostream &operator<<(std::ostream &out, const Line& line) noexcept;
+	friend CardWriter;
 	unsigned int fieldLength = 0;
 	unsigned int fieldNum = 0;
 	const std::string keyword = "";
@@ -47,6 +50,55 @@ public:
 
 std::ostream &operator<<(std::ostream &out, const Line& line) noexcept;
 
+/**
+ * Writes the same cards as Line, but formats the fields directly into a large buffer.
+ * The buffer is flushed to the output stream when it is full, so no string is allocated per field or per card.
+ * A card is ended by the next call to card() or by flush(), which is also called by the destructor.
+ */
+class CardWriter final {
+    std::ostream& out;
+    std::vector<char> buffer;
+    size_t used = 0;
+    unsigned int fieldLength = 8;
+    unsigned int fieldNum = 9;
+    unsigned int fieldCount = 0;
+    bool cardStarted = false;
+    void write(const char* chars, size_t length);
+    void fill(char c, size_t count);
+    void endCard();
+    void nextField();
+    void addRight(const char* chars, size_t length);
+public:
+    static const size_t BUFFER_SIZE = 1 << 20;
+    explicit CardWriter(std::ostream& out);
+    CardWriter(const CardWriter&) = delete;
+    CardWriter& operator=(const CardWriter&) = delete;
+    ~CardWriter();
+    /**
+     * Starts a new card: a keyword ending with "*" gives a large field card, as with Line.
+     */
+    CardWriter& card(const char* keyword);
+    CardWriter& add();
+    CardWriter& add(double);
+    CardWriter& add(int);
+    CardWriter& add(const std::string&);
+    CardWriter& add(const char*);
+    CardWriter& skip(int);
+    CardWriter& add(const std::vector<int>&);
+    CardWriter& add(const std::vector<double>&);
+    CardWriter& add(const DOFS);
+    CardWriter& add(const VectorialValue&);
+    /**
+     * Ends the current card and writes the buffer to the output stream.
+     */
+    void flush();
+    /**
+     * Writes in chars (at least 32 characters) the compact encoding of value used by Line
+     * (see pyNastran field_writer_8), without padding, and returns its length.
+     */
+    static size_t formatDouble(double value, unsigned int fieldLength, char* chars) noexcept;
+};
+
 class NastranWriter final : public Writer {
     enum class Dialect {
         COSMIC95,
@@ -126,14 +126,18 @@ struct CsvGrammar: qi::grammar<stream_iterator_type, void(), qi::locals<vector<L
 		if (analysis != nullptr) {
             analysis->add(objectiveSet);
 		}
+		auto& assertions = objectiveSet->nodalDisplacementAssertions;
+		pos_t nodePosition = Globals::UNAVAILABLE_POS;
 		for (LineItems position : positions) {
 			auto it = dofPosition_by_lineItemEnum.find(position);
 			if (it != dofPosition_by_lineItemEnum.end()) {
 				double value = atof(columns[i].c_str());
 				assert(nodeId != Node::UNAVAILABLE_NODE);
-				const auto& nda = make_shared<NodalDisplacementAssertion>(model, objectiveSet, configuration.testTolerance, nodeId,
-						DOF::findByPosition(it->second), value, time);
-				model.add(nda);
+				if (nodePosition == Globals::UNAVAILABLE_POS) {
+					nodePosition = model.mesh.findOrReserveNode(nodeId);
+				}
+				assertions.add(nodePosition, nodeId, DOF::findByPosition(it->second), value, time,
+						configuration.testTolerance);
 			}
 			i++;
 		}
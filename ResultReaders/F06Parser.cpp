@@ -19,8 +19,12 @@
 #include <fstream>
 #include <string>
 #include <stdlib.h>
+#include <algorithm>
+#include <atomic>
 #include <exception>
-#include <boost/algorithm/string.hpp>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
 #include <ciso646>
 #include "../Abstract/Model.h"
 #include "../Abstract/ConfigurationParameters.h"
@@ -30,344 +34,374 @@ using namespace std;
 namespace vega {
 namespace result {
 
-using boost::algorithm::trim;
-using boost::algorithm::trim_copy;
+namespace {
 
-int F06Parser::readDisplacementSection(int currentSubCase, Model& model,
-		const ConfigurationParameters& configuration, ifstream& istream,
-		vector<shared_ptr<Assertion>>& assertions, double loadStep) {
-	string header;
-	string currentLine;
-	int subcase_id = NO_SUBCASE;
+/**
+ * Value following a "LABEL = ", the previous value is kept when it cannot be read.
+ */
+template<typename T>
+T parseLabelValue(T previous, const F06Line& text) {
+	vector<F06Line> tokens;
+	if (text.split(tokens) == 0) {
+		return previous;
+	}
+	try {
+		return is_integral<T>::value ? static_cast<T>(tokens[0].toInt()) : static_cast<T>(tokens[0].toDouble());
+	} catch (logic_error&) {
+		return previous;
+	}
+}
+
+}
+
+const size_t F06Parser::PARALLEL_MIN_SECTIONS;
+const size_t F06Parser::SECTIONS_BY_CHUNK;
+const size_t F06Parser::SECTIONS_BY_BATCH;
+
+bool F06Parser::Context::operator==(const Context& other) const noexcept {
+	return subcase == other.subcase and is_equal(loadStep, other.loadStep, 0.)
+			and is_equal(frequency, other.frequency, 0.) and pointId == other.pointId;
+}
+
+F06Parser::Section::Section(Type type, streamoff titleOffset, streamoff begin, int lineNumber,
+		const Context& context) noexcept :
+		type(type), titleOffset(titleOffset), begin(begin), lineNumber(lineNumber), context(context) {
+}
+
+string F06Parser::errorMessage(const ConfigurationParameters& configuration, const exception& e, int lineNumber,
+		const string& line) {
+	string message("Error ");
+	message += string(e.what()) + " parsing:";
+	message += configuration.resultFile.string();
+	message += " Line number " + to_string(lineNumber);
+	message += " Line: " + line;
+	return message;
+}
+
+void F06Parser::reportError(const ConfigurationParameters& configuration, const exception& e,
+		const Section& section) {
+	cerr << errorMessage(configuration, e, section.lineNumber, "") << endl;
+	if (ConfigurationParameters::TranslationMode::MODE_STRICT == configuration.translationMode) {
+		throw e;
+	}
+}
+
+void F06Parser::parseDisplacementSection(const Model& model,
+		const ConfigurationParameters& configuration, F06Scanner& scanner, Section& section) const {
+	F06Line currentLine;
+	vector<F06Line> tokens;
 	//skip header line
-	this->readLine(istream, header);
+	scanner.readLine(currentLine);
 	try {
-		while (this->readLine(istream, currentLine)) {
-			size_t subCasePosition = currentLine.find("SUBCASE");
-			if (currentLine.find("DIAGNOSTIC TOOLS") != string::npos) {
+		while (scanner.peekLine(currentLine)) {
+			if (currentLine.contains("DIAGNOSTIC TOOLS")) {
 				//skip
-			} else if (subCasePosition != string::npos) {
-				/*
-				 * Only used to detect if this section has ended.
-				 * Since the line has been consumed, we will return the (next) subcase
-				 * LD : All this should simply be replaced by a buffer parser and a "peek" getline
-				 */
-				subcase_id = parseSubcase(subcase_id, currentLine);
+				scanner.readLine(currentLine);
+			} else if (currentLine.contains("SUBCASE")) {
+				// the section has ended, the next subcase is left to the caller
 				break;
-			} else if (!isspace(currentLine.at(0))) {
+			} else if (!isspace(currentLine.front())) {
 				//stop parsing the section at the first line that don't start with a space
 				break;
 			} else {
-				istringstream istringLine(currentLine);
-				vector<string> tokens;
-				copy(istream_iterator<string>(istringLine), istream_iterator<string>(),
-						back_inserter(tokens));
-				if (tokens.size() != 8)
+				if (currentLine.split(tokens) != 8)
 					break;
+				scanner.readLine(currentLine);
 
-				int nodeId = stoi(tokens[0]);
+				int nodeId = tokens[0].toInt();
 				if (tokens[1] != "G"){
 					//cerr << "unsupported assertion type " << assertionType
 					//		<< " : line n." << lineNumber << " " << currentLine
 					//		<< endl;
 					continue;
 				}
-				shared_ptr<ObjectiveSet> objectiveSet = nullptr;
-				if (currentSubCase == NO_SUBCASE) {
-                    objectiveSet = model.commonObjectiveSet;
-				} else {
-                    objectiveSet = model.getOrCreateObjectiveSet(currentSubCase, ObjectiveSet::Type::ASSERTION);
+				double values[6];
+				for (dof_int i = 0; i < 6; i++) {
+					values[i] = tokens[2 + i].toDouble();
 				}
-				VectorialValue translation(stod(tokens[2]), stod(tokens[3]), stod(tokens[4]));
-				VectorialValue rotation(stod(tokens[5]), stod(tokens[6]), stod(tokens[7]));
-
-				const Node& node = model.mesh.findNode(model.mesh.findNodePosition(nodeId));
-				if (node.displacementCS != CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID) {
-					const auto& coordSystem = model.mesh.getCoordinateSystemByPosition(node.displacementCS);
-					coordSystem->updateLocalBase(VectorialValue(node.x, node.y, node.z));
-					translation = coordSystem->vectorToGlobal(translation);
-					rotation = coordSystem->vectorToGlobal(rotation);
+				// the mesh is only read here: the node is looked up again when merged
+				const pos_t nodePosition = model.mesh.findNodePosition(nodeId);
+				if (nodePosition == Node::UNAVAILABLE_NODE) {
+					throw invalid_argument(
+							"Node id " + to_string(nodeId) + " not found.");
 				}
-				double values[6] = {
-						translation.x(), translation.y(), translation.z(),
-						rotation.x(), rotation.y(), rotation.z(),
-				};
 				for (dof_int i = 0; i < 6; i++) {
-					double value = values[i];
-					if (abs(value) < 1e-12)
-						value = 0.;
-					assertions.push_back(make_shared<NodalDisplacementAssertion>(model, objectiveSet, configuration.testTolerance,
-									nodeId, DOF::findByPosition(i), value, loadStep));
+					section.displacements.add(nodePosition, nodeId, DOF::findByPosition(i), values[i],
+							section.context.loadStep, configuration.testTolerance);
 				}
-
 			}
 		}
 	} catch (const exception &e) {
-		string message("Error ");
-		message += string(e.what()) + " parsing:";
-		message += configuration.resultFile.string();
-		message += " Line number " + to_string(lineNumber);
-		message += " Line: " + currentLine;
-		cerr << message << endl;
-		if (ConfigurationParameters::TranslationMode::MODE_STRICT == configuration.translationMode) {
-			throw e;
-		} else {
-			//cerr << "Conditions not added, parsing next section" << endl;
-		}
+		section.error = current_exception();
+		section.errorMessage = errorMessage(configuration, e, scanner.lineNumber, currentLine.str());
 	}
-	return subcase_id /* It could have consumed the next subcase id so we give it back for the next section parsing */;
 }
 
-int F06Parser::readEigenvalueSection(int currentSubCase, Model& model,
-		const ConfigurationParameters& configuration, ifstream& istream,
-		vector<shared_ptr<Assertion>>& assertions) {
-	string currentLine;
-	int subcase_id = NO_SUBCASE;
+void F06Parser::parseEigenvalueSection(const ConfigurationParameters& configuration,
+		F06Scanner& scanner, Section& section) const {
+	F06Line currentLine;
+	vector<F06Line> tokens;
 	try {
-		while (this->readLine(istream, currentLine)) {
-			size_t orderPosition = currentLine.find("ORDER");
-			if (orderPosition != string::npos) {
+		while (scanner.readLine(currentLine)) {
+			if (currentLine.contains("ORDER")) {
 				break;
 			}
-			orderPosition = currentLine.find("AFTER AUGMENTATION OF RESIDUAL VECTORS");
-			if (orderPosition != string::npos) {
+			if (currentLine.contains("AFTER AUGMENTATION OF RESIDUAL VECTORS")) {
 				//not taking into account RESVEC result
-				return subcase_id;
+				return;
 			}
-			orderPosition = currentLine.find("ACTUAL MODES USED IN THE DYNAMIC ANALYSIS");
-			if (orderPosition != string::npos) {
+			if (currentLine.contains("ACTUAL MODES USED IN THE DYNAMIC ANALYSIS")) {
 				//not taking into account modes used in dynamic analysis
-				return subcase_id;
+				return;
 			}
 		}
-		while (this->readLine(istream, currentLine)) {
-            size_t subCasePosition = currentLine.find("SUBCASE");
-            if (subCasePosition != string::npos) {
-				/*
-				 * Only used to detect if this section has ended.
-				 * Since the line has been consumed, we will return the (next) subcase
-				 * LD : All this should simply be replaced by a buffer parser and a "peek" getline
-				 */
-				subcase_id = parseSubcase(subcase_id, currentLine);
+		while (scanner.peekLine(currentLine)) {
+			if (currentLine.contains("SUBCASE")) {
+				// the section has ended, the next subcase is left to the caller
 				break;
-            }
-			istringstream istringLine(currentLine);
-			vector<string> tokens;
-			copy(istream_iterator<string>(istringLine), istream_iterator<string>(),
-					back_inserter(tokens));
-			if (tokens.size() != 7)
+			}
+			if (currentLine.split(tokens) != 7)
 				break;
-			int number = stoi(tokens.at(0));
-			double eigenValue = stod(tokens.at(2));
-			double cycles = stod(tokens.at(4));
-			double generalizedMass = stod(tokens.at(5));
-			double generalizedStiffness = stod(tokens.at(6));
-			if (abs(cycles) < 1e-12)
-				cycles = 0.;
-            shared_ptr<ObjectiveSet> objectiveSet = nullptr;
-            if (currentSubCase == NO_SUBCASE) {
-                    objectiveSet = model.commonObjectiveSet;
-            } else {
-                    objectiveSet = model.getOrCreateObjectiveSet(currentSubCase, ObjectiveSet::Type::ASSERTION);
-            }
-			assertions.push_back(
-					make_shared<FrequencyAssertion>(model, objectiveSet, number, cycles, eigenValue, generalizedMass, generalizedStiffness, configuration.testTolerance));
+			scanner.readLine(currentLine);
+			EigenvalueRow row;
+			row.number = tokens[0].toInt();
+			row.eigenValue = tokens[2].toDouble();
+			row.cycles = tokens[4].toDouble();
+			row.generalizedMass = tokens[5].toDouble();
+			row.generalizedStiffness = tokens[6].toDouble();
+			if (abs(row.cycles) < 1e-12)
+				row.cycles = 0.;
+			section.eigenvalues.push_back(row);
 		}
 	} catch (const exception &e) {
-		string message("Error ");
-		message += string(e.what()) + " parsing:";
-		message += configuration.resultFile.string();
-		message += " Line number " + to_string(lineNumber);
-		message += " Line: " + currentLine;
-		cerr << message << endl;
-		if (ConfigurationParameters::TranslationMode::MODE_STRICT == configuration.translationMode) {
-			throw e;
-		} else {
-			//cerr << "Conditions not added, parsing next section" << endl;
-		}
+		section.error = current_exception();
+		section.errorMessage = errorMessage(configuration, e, scanner.lineNumber, currentLine.str());
 	}
-	return subcase_id /* It could have consumed the next subcase id so we give it back for the next section parsing */;
 }
 
-int F06Parser::readComplexDisplacementSection(int currentSubCase, Model& model,
-		const ConfigurationParameters& configuration, ifstream& istream,
-		vector<shared_ptr<Assertion>>& assertions, double frequency) {
-	string currentLine;
-	int subcase_id = NO_SUBCASE;
+void F06Parser::parseComplexDisplacementSection(const ConfigurationParameters& configuration,
+		F06Scanner& scanner, Section& section) const {
+	F06Line currentLine;
+	vector<F06Line> tokens;
 	try {
-
-		while (this->readLine(istream, currentLine)) {
-			size_t orderPosition =
-					currentLine.find(
-							"POINT ID.   TYPE          T1             T2             T3             R1             R2             R3");
-			if (orderPosition != string::npos)
+		while (scanner.readLine(currentLine)) {
+			if (currentLine.contains(
+							"POINT ID.   TYPE          T1             T2             T3             R1             R2             R3"))
 				break;
 		}
-		while (this->readLine(istream, currentLine)) {
-			size_t subCasePosition = currentLine.find("SUBCASE");
-			if (subCasePosition != string::npos) {
-				subcase_id = parseSubcase(subcase_id, currentLine);
+		while (scanner.peekLine(currentLine)) {
+			if (currentLine.contains("SUBCASE")) {
+				// the section has ended, the next subcase is left to the caller
 				break;
 			}
 
-			istringstream istringLine(currentLine);
-			vector<string> tokens;
-			copy(istream_iterator<string>(istringLine), istream_iterator<string>(),
-					back_inserter(tokens));
-			if (tokens.size() != 9)
+			if (currentLine.split(tokens) != 9)
 				break;
+			scanner.readLine(currentLine);
 
-			this->readLine(istream, currentLine);
-			istringLine.clear();
-			istringLine.str(currentLine);
-			copy(istream_iterator<string>(istringLine), istream_iterator<string>(),
-					back_inserter(tokens));
-			if (tokens.size() != 15)
+			ComplexDisplacementRow row;
+			row.nodeId = tokens[1].toInt();
+			double reals[6];
+			for (dof_int i = 0; i < 6; i++) {
+				reals[i] = tokens[3 + i].toDouble();
+			}
+			// tokens are views over the buffer: they are not valid after the next line is read
+			if (not scanner.readLine(currentLine) or currentLine.split(tokens) != 6)
 				throw exception();
 
-			int nodeId = stoi(tokens[1]);
-			shared_ptr<ObjectiveSet> objectiveSet = nullptr;
-            if (currentSubCase == NO_SUBCASE) {
-                objectiveSet = model.commonObjectiveSet;
-            } else {
-                objectiveSet = model.getOrCreateObjectiveSet(currentSubCase, ObjectiveSet::Type::ASSERTION);
-            }
 			for (dof_int i = 0; i < 6; i++) {
-				double real = stod(tokens[3 + i]);
+				double real = reals[i];
 				if (abs(real) < 1e-12)
 					real = 0;
-				double imag = stod(tokens[9 + i]);
+				double imag = tokens[i].toDouble();
 				if (abs(imag) < 1e-12)
 					imag = 0;
-				complex<double> value(real, imag);
-
-				assertions.push_back(
-						make_shared<NodalComplexDisplacementAssertion>(model, objectiveSet, configuration.testTolerance,
-								nodeId, DOF::findByPosition(i), value, frequency));
+				row.values[i] = complex<double>(real, imag);
 			}
+			section.complexDisplacements.push_back(row);
 		}
 	} catch (const exception &e) {
-		string message("Error ");
-		message += string(e.what()) + " parsing:";
-		message += configuration.resultFile.string();
-		message += " Line number " + to_string(lineNumber);
-		message += " Line: " + currentLine;
-		cerr << message << endl;
-		if (ConfigurationParameters::TranslationMode::MODE_STRICT == configuration.translationMode) {
-			throw e;
-		} else {
-			//cerr << "Conditions not added, parsing next section" << endl;
-		}
+		section.error = current_exception();
+		section.errorMessage = errorMessage(configuration, e, scanner.lineNumber, currentLine.str());
 	}
-	return subcase_id /* It could have consumed the next subcase id so we give it back for the next section parsing */;
 }
 
-int F06Parser::readStressesForSolidsSection(int currentSubCase, Model& model,
-		const ConfigurationParameters& configuration, ifstream& istream,
-		vector<shared_ptr<Assertion>>& assertions) {
-	string currentLine;
-	int subcase_id = NO_SUBCASE;
+void F06Parser::parseStressesForSolidsSection(const ConfigurationParameters& configuration,
+		F06Scanner& scanner, Section& section) const {
+	F06Line currentLine;
+	vector<F06Line> tokens;
 	try {
-
-        bool foundHeader = false;
-		while (this->readLine(istream, currentLine) and currentLine[0] != '1') {
-			size_t orderPosition =
-					currentLine.find(
-							"ELEMENT-ID    GRID-ID        NORMAL              SHEAR             PRINCIPAL       -A-  -B-  -C-     PRESSURE       VON MISES");
-			if (orderPosition != string::npos) {
-                foundHeader = true;
+		bool foundHeader = false;
+		while (scanner.readLine(currentLine) and currentLine.front() != '1') {
+			if (currentLine.contains(
+							"ELEMENT-ID    GRID-ID        NORMAL              SHEAR             PRINCIPAL       -A-  -B-  -C-     PRESSURE       VON MISES")) {
+				foundHeader = true;
 				break;
 			}
 		}
-		while (foundHeader and this->readLine(istream, currentLine)) {
-			size_t subCasePosition = currentLine.find("SUBCASE");
-			if (subCasePosition != string::npos) {
-                subcase_id = parseSubcase(subcase_id, currentLine);
-                if (subcase_id == currentSubCase) {
-                    continue;
-                } else {
-                    break;
-                }
+		while (foundHeader and scanner.peekLine(currentLine)) {
+			if (currentLine.contains("SUBCASE")) {
+				if (parseSubcase(NO_SUBCASE, currentLine) == section.context.subcase) {
+					// page header of the same subcase
+					scanner.readLine(currentLine);
+					continue;
+				} else {
+					// the section has ended, the next subcase is left to the caller
+					break;
+				}
 			}
 
-			if (currentLine[0] == '0' and currentLine.find("0GRID") == string::npos) {
-                throw exception();
+			if (currentLine.front() == '0' and not currentLine.contains("0GRID")) {
+				throw exception();
 			}
 
-			istringstream istringLine(currentLine);
-			vector<string> tokens;
-
 			// Element header
-			copy(istream_iterator<string>(istringLine), istream_iterator<string>(),
-					back_inserter(tokens));
-			if (tokens.size() != 6)
+			if (currentLine.split(tokens) != 6)
 				break;
-            int cellId = stoi(tokens[1]);
-            int nodeNum = stoi(tokens[4]);
-
-            for (int nodePos = 1; nodePos <= nodeNum + 1 /* for CENTER stress */; nodePos++) {
-                for (int dir = 1; dir <= 3; dir++) {
-                    // PAGE should only happen between nodes
-                    this->readLine(istream, currentLine);
-                    if (currentLine[0] == '1' and currentLine.find("PAGE") != string::npos) {
-                        for (int i = 1; i < 5; i++) {  // skip page header
-                            this->readLine(istream, currentLine);
-                        }
-                        nodePos--;
-                        break;
-                    }
-                    if (currentLine[0] != '0' or currentLine.find("CENTER") != string::npos) {
-                        continue; // only first line of this node has node id (and von mises)
-                    }
-                    istringLine.clear();
-                    tokens.clear();
-                    istringLine.str(currentLine);
-                    copy(istream_iterator<string>(istringLine), istream_iterator<string>(),
-                            back_inserter(tokens));
-                    int nodeId = stoi(tokens[1]);
-                    double vonMises = stod(tokens[tokens.size() - 1] /* sometimes smaller values have (or not) spaces between them, should cut using columns */);
-                    shared_ptr<ObjectiveSet> objectiveSet = nullptr;
-                    if (currentSubCase == NO_SUBCASE) {
-                        objectiveSet = model.commonObjectiveSet;
-                    } else {
-                        objectiveSet = model.getOrCreateObjectiveSet(currentSubCase, ObjectiveSet::Type::ASSERTION);
-                    }
-                    assertions.push_back(
-                            make_shared<NodalCellVonMisesAssertion>(model, objectiveSet, configuration.testTolerance, cellId,
-                                    nodeId, vonMises));
-                    if (configuration.outputSolver.getSolverName() == SolverName::CODE_ASTER) {
-                        // Workaround to avoid MAILLE in COMM file
-                        const auto cellPosition = model.mesh.findCellPosition(cellId);
-                        const string& groupName = Cell::MedName(cellPosition);
-                        if (not model.mesh.hasGroup(groupName)) {
-                            const auto& cellGrp = model.mesh.createCellGroup(groupName, Group::NO_ORIGINAL_ID, "Single cell group over vmis elno assertion");
-                            cellGrp->addCellPosition(cellPosition);
-                        }
-                    }
-                }
-            }
+			scanner.readLine(currentLine);
+			int cellId = tokens[1].toInt();
+			int nodeNum = tokens[4].toInt();
+
+			for (int nodePos = 1; nodePos <= nodeNum + 1 /* for CENTER stress */; nodePos++) {
+				for (int dir = 1; dir <= 3; dir++) {
+					// PAGE should only happen between nodes
+					scanner.readLine(currentLine);
+					if (currentLine.front() == '1' and currentLine.contains("PAGE")) {
+						for (int i = 1; i < 5; i++) {  // skip page header
+							scanner.readLine(currentLine);
+						}
+						nodePos--;
+						break;
+					}
+					if (currentLine.front() != '0' or currentLine.contains("CENTER")) {
+						continue; // only first line of this node has node id (and von mises)
+					}
+					currentLine.split(tokens);
+					VonMisesRow row;
+					row.cellId = cellId;
+					row.nodeId = tokens.at(1).toInt();
+					row.value = tokens.back().toDouble() /* sometimes smaller values have (or not) spaces between them, should cut using columns */;
+					section.vonMises.push_back(row);
+				}
+			}
 		}
 	} catch (const exception &e) {
-		string message("Error ");
-		message += string(e.what()) + " parsing:";
-		message += configuration.resultFile.string();
-		message += " Line number " + to_string(lineNumber);
-		message += " Line: " + currentLine;
-		cerr << message << endl;
+		section.error = current_exception();
+		section.errorMessage = errorMessage(configuration, e, scanner.lineNumber, currentLine.str());
+	}
+}
+
+void F06Parser::parseSection(const Model& model, const ConfigurationParameters& configuration,
+		F06Scanner& scanner, Section& section) const {
+	// errors are kept with the section, the rows read before them are merged
+	switch (section.type) {
+	case Section::Type::DISPLACEMENT:
+		parseDisplacementSection(model, configuration, scanner, section);
+		break;
+	case Section::Type::EIGENVALUES:
+		parseEigenvalueSection(configuration, scanner, section);
+		break;
+	case Section::Type::COMPLEX_DISPLACEMENT:
+		parseComplexDisplacementSection(configuration, scanner, section);
+		break;
+	case Section::Type::SOLID_STRESSES:
+		parseStressesForSolidsSection(configuration, scanner, section);
+		break;
+	default:
+		//nothing to do
+		break;
+	}
+	section.end = scanner.position();
+}
+
+void F06Parser::parseSections(const Model& model, const ConfigurationParameters& configuration,
+		vector<Section>& sections, size_t begin, size_t end, size_t threadCount) const {
+	// Contiguous sections by chunk: each thread keeps reading its file forward
+	const size_t chunkCount = (end - begin + SECTIONS_BY_CHUNK - 1) / SECTIONS_BY_CHUNK;
+	atomic<size_t> nextChunk(0);
+	const auto worker = [this, &model, &configuration, &sections, begin, end, chunkCount, &nextChunk]() {
+		ifstream istream(configuration.resultFile.string(), ios::binary);
+		F06Scanner scanner(istream);
+		for (size_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++) {
+			const size_t chunkBegin = begin + chunk * SECTIONS_BY_CHUNK;
+			const size_t chunkEnd = min(end, chunkBegin + SECTIONS_BY_CHUNK);
+			for (size_t i = chunkBegin; i < chunkEnd; i++) {
+				scanner.seek(sections[i].begin, sections[i].lineNumber);
+				parseSection(model, configuration, scanner, sections[i]);
+			}
+		}
+	};
+	vector<thread> workers;
+	for (size_t i = 1; i < min(threadCount, chunkCount); ++i) {
+		workers.emplace_back(worker);
+	}
+	worker();
+	for (auto& workerThread : workers) {
+		workerThread.join();
+	}
+}
+
+void F06Parser::mergeSection(Model& model, const ConfigurationParameters& configuration, Section& section) const {
+	if (section.error) {
+		cerr << section.errorMessage << endl;
 		if (ConfigurationParameters::TranslationMode::MODE_STRICT == configuration.translationMode) {
-			throw e;
+			rethrow_exception(section.error);
 		} else {
 			//cerr << "Conditions not added, parsing next section" << endl;
 		}
 	}
-	return subcase_id /* It could have consumed the next subcase id so we give it back for the next section parsing */;
+	switch (section.type) {
+	case Section::Type::DISPLACEMENT:
+		addAssertionsToModel(model, configuration, section);
+		break;
+	case Section::Type::EIGENVALUES:
+		addFrequencyAssertionsToModel(model, configuration, section);
+		break;
+	case Section::Type::COMPLEX_DISPLACEMENT:
+		addComplexAssertionsToModel(model, configuration, section);
+		break;
+	case Section::Type::SOLID_STRESSES:
+		addVonMisesAssertionsToModel(model, configuration, section);
+		break;
+	default:
+		//nothing to do
+		break;
+	}
 }
 
-int F06Parser::addAssertionsToModel(int currentSubcase, double loadStep, Model &model,
-		const ConfigurationParameters& configuration, ifstream& istream) {
-
-	vector<shared_ptr<Assertion>> assertions;
-	int nextSubcase = readDisplacementSection(currentSubcase,model, configuration, istream, assertions, loadStep);
+void F06Parser::addAssertionsToModel(Model &model, const ConfigurationParameters& configuration,
+		Section& section) const {
+	const int currentSubcase = section.context.subcase;
+	NodalDisplacementAssertionTable& assertions = section.displacements;
+	// Values are read in the displacement coordinate system of each node (six rows by node)
+	size_t row = 0;
+	try {
+		for (; row < assertions.size(); row += 6) {
+			const Node& node = model.mesh.findNode(assertions.nodePositions[row]);
+			double* values = assertions.values.data() + row;
+			if (node.displacementCS != CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID) {
+				const auto& coordSystem = model.mesh.getCoordinateSystemByPosition(node.displacementCS);
+				coordSystem->updateLocalBase(VectorialValue(node.x, node.y, node.z));
+				const VectorialValue translation = coordSystem->vectorToGlobal(VectorialValue(values[0], values[1], values[2]));
+				const VectorialValue rotation = coordSystem->vectorToGlobal(VectorialValue(values[3], values[4], values[5]));
+				values[0] = translation.x();
+				values[1] = translation.y();
+				values[2] = translation.z();
+				values[3] = rotation.x();
+				values[4] = rotation.y();
+				values[5] = rotation.z();
+			}
+			for (dof_int i = 0; i < 6; i++) {
+				if (abs(values[i]) < 1e-12)
+					values[i] = 0.;
+			}
+		}
+	} catch (const exception &e) {
+		vector<bool> keep(assertions.size(), false);
+		fill(keep.begin(), keep.begin() + static_cast<ptrdiff_t>(row), true);
+		assertions.filter(keep);
+		reportError(configuration, e, section);
+	}
 	shared_ptr<Analysis> analysis;
 	if (currentSubcase != NO_SUBCASE) {
 		analysis = model.analyses.find(currentSubcase);
@@ -379,31 +413,48 @@ int F06Parser::addAssertionsToModel(int currentSubcase, double loadStep, Model &
 		// LD If no subcase indicated, the first one is used if exists.
 		analysis = model.analyses.first();
 	}
-	for (const auto& assertion : assertions) {
-		if (analysis != nullptr) {
-			model.add(assertion);
-			if (model.configuration.logLevel >= LogLevel::TRACE) {
-				cout << "Adding NodalDisplacementAssertion : " << *assertion << " to subcase: "
-						<< currentSubcase << endl;
-			}
-		} else if (model.configuration.logLevel >= LogLevel::DEBUG) {
-			cout << "Discarding NodalDisplacementAssertion : " << *assertion
-					<< " because subcase id: " << currentSubcase << " was not found." << endl;
+	if (assertions.empty()) {
+		return;
+	}
+	if (analysis != nullptr) {
+		shared_ptr<ObjectiveSet> objectiveSet = nullptr;
+		if (currentSubcase == NO_SUBCASE) {
+			objectiveSet = model.commonObjectiveSet;
+		} else {
+			objectiveSet = model.getOrCreateObjectiveSet(currentSubcase, ObjectiveSet::Type::ASSERTION);
+		}
+		objectiveSet->add(assertions);
+		if (model.configuration.logLevel >= LogLevel::TRACE) {
+			cout << "Adding " << assertions.size() << " NodalDisplacementAssertions to subcase: "
+					<< currentSubcase << endl;
 		}
+	} else if (model.configuration.logLevel >= LogLevel::DEBUG) {
+		cout << "Discarding " << assertions.size() << " NodalDisplacementAssertions"
+				<< " because subcase id: " << currentSubcase << " was not found." << endl;
 	}
-	return nextSubcase;
 }
 
-int F06Parser::addFrequencyAssertionsToModel(int currentSubCase, Model& model,
-		const ConfigurationParameters& configuration, ifstream& istream) {
+void F06Parser::addFrequencyAssertionsToModel(Model& model,
+		const ConfigurationParameters& configuration, const Section& section) const {
+	const int currentSubCase = section.context.subcase;
 	vector<shared_ptr<Assertion>> assertions;
-	int nextSubcase = readEigenvalueSection(currentSubCase, model, configuration, istream, assertions);
+	for (const auto& row : section.eigenvalues) {
+		shared_ptr<ObjectiveSet> objectiveSet = nullptr;
+		if (currentSubCase == NO_SUBCASE) {
+			objectiveSet = model.commonObjectiveSet;
+		} else {
+			objectiveSet = model.getOrCreateObjectiveSet(currentSubCase, ObjectiveSet::Type::ASSERTION);
+		}
+		assertions.push_back(
+				make_shared<FrequencyAssertion>(model, objectiveSet, row.number, row.cycles, row.eigenValue,
+						row.generalizedMass, row.generalizedStiffness, configuration.testTolerance));
+	}
 	shared_ptr<Analysis> analysis;
 	if (currentSubCase != NO_SUBCASE) {
 		analysis = model.analyses.find(currentSubCase);
 		if (analysis == nullptr) {
             cout << "Cannot find analysis:" << currentSubCase << " in model, assertion are incoherents." << endl;
-            return nextSubcase;
+            return;
 		}
 		analysis->add(Reference<ObjectiveSet>{ObjectiveSet::Type::ASSERTION, currentSubCase});
 		if (analysis == nullptr and model.configuration.logLevel >= LogLevel::INFO) {
@@ -411,7 +462,7 @@ int F06Parser::addFrequencyAssertionsToModel(int currentSubCase, Model& model,
 		}
     } else if (model.analyses.empty()) {
         cout << "There is no analysis in model." << endl;
-        return nextSubcase;
+        return;
 	} else {
 		// LD If no subcase indicated, the first one is used.
 		// FIXME: what if the model don't have an analysis and the default one is
@@ -430,14 +481,25 @@ int F06Parser::addFrequencyAssertionsToModel(int currentSubCase, Model& model,
 					<< currentSubCase << " was not found." << endl;
 		}
 	}
-	return nextSubcase;
 }
 
-int F06Parser::addComplexAssertionsToModel(int currentSubCase, double frequency, Model& model,
-		const ConfigurationParameters& configuration, ifstream& istream) {
+void F06Parser::addComplexAssertionsToModel(Model& model,
+		const ConfigurationParameters& configuration, const Section& section) const {
+	const int currentSubCase = section.context.subcase;
 	vector<shared_ptr<Assertion>> assertions;
-	int nextSubcase = readComplexDisplacementSection(currentSubCase, model, configuration, istream, assertions,
-			frequency);
+	for (const auto& row : section.complexDisplacements) {
+		shared_ptr<ObjectiveSet> objectiveSet = nullptr;
+		if (currentSubCase == NO_SUBCASE) {
+			objectiveSet = model.commonObjectiveSet;
+		} else {
+			objectiveSet = model.getOrCreateObjectiveSet(currentSubCase, ObjectiveSet::Type::ASSERTION);
+		}
+		for (dof_int i = 0; i < 6; i++) {
+			assertions.push_back(
+					make_shared<NodalComplexDisplacementAssertion>(model, objectiveSet, configuration.testTolerance,
+							row.nodeId, DOF::findByPosition(i), row.values[i], section.context.frequency));
+		}
+	}
 	shared_ptr<Analysis> analysis;
 	if (currentSubCase != NO_SUBCASE) {
 		analysis = model.analyses.find(currentSubCase);
@@ -463,14 +525,36 @@ int F06Parser::addComplexAssertionsToModel(int currentSubCase, double frequency,
 					<< " because subcase id: " << currentSubCase << " was not found." << endl;
 		}
 	}
-	return nextSubcase;
 }
 
-int F06Parser::addVonMisesAssertionsToModel(int currentSubcase, Model &model,
-		const ConfigurationParameters& configuration, ifstream& istream) {
-
+void F06Parser::addVonMisesAssertionsToModel(Model &model,
+		const ConfigurationParameters& configuration, const Section& section) const {
+	const int currentSubcase = section.context.subcase;
 	vector<shared_ptr<Assertion>> assertions;
-	int nextSubcase = readStressesForSolidsSection(currentSubcase, model, configuration, istream, assertions);
+	try {
+		for (const auto& row : section.vonMises) {
+			shared_ptr<ObjectiveSet> objectiveSet = nullptr;
+			if (currentSubcase == NO_SUBCASE) {
+				objectiveSet = model.commonObjectiveSet;
+			} else {
+				objectiveSet = model.getOrCreateObjectiveSet(currentSubcase, ObjectiveSet::Type::ASSERTION);
+			}
+			assertions.push_back(
+					make_shared<NodalCellVonMisesAssertion>(model, objectiveSet, configuration.testTolerance, row.cellId,
+							row.nodeId, row.value));
+			if (configuration.outputSolver.getSolverName() == SolverName::CODE_ASTER) {
+				// Workaround to avoid MAILLE in COMM file
+				const auto cellPosition = model.mesh.findCellPosition(row.cellId);
+				const string& groupName = Cell::MedName(cellPosition);
+				if (not model.mesh.hasGroup(groupName)) {
+					const auto& cellGrp = model.mesh.createCellGroup(groupName, Group::NO_ORIGINAL_ID, "Single cell group over vmis elno assertion");
+					cellGrp->addCellPosition(cellPosition);
+				}
+			}
+		}
+	} catch (const exception &e) {
+		reportError(configuration, e, section);
+	}
 	shared_ptr<Analysis> analysis;
 	if (currentSubcase != NO_SUBCASE) {
 		analysis = model.analyses.find(currentSubcase);
@@ -494,18 +578,20 @@ int F06Parser::addVonMisesAssertionsToModel(int currentSubcase, Model &model,
 					<< " because subcase id: " << currentSubcase << " was not found." << endl;
 		}
 	}
-	return nextSubcase;
 }
 
 
-int F06Parser::parseSubcase(int currentSubCase, const string& currentLine) {
+int F06Parser::parseSubcase(int currentSubCase, const F06Line& currentLine) {
 	size_t subCasePosition = currentLine.find("SUBCASE");
-	string subcaseN = trim_copy(currentLine.substr(subCasePosition + 7));
-	bool has_digits_or_space = (subcaseN.find_first_not_of("0123456789 ") == string::npos);
+	F06Line subcaseN = currentLine.substr(subCasePosition + 7).trimmed();
+	bool has_digits_or_space = true;
+	for (const char* c = subcaseN.begin; c < subcaseN.end and has_digits_or_space; c++) {
+		has_digits_or_space = isdigit(static_cast<unsigned char>(*c)) or *c == ' ';
+	}
 	int parsedSubCase = currentSubCase;
 	if (has_digits_or_space) {
 		try {
-			parsedSubCase = stoi(subcaseN);
+			parsedSubCase = subcaseN.toInt();
 		} catch (invalid_argument&) {
 			//many different subcase keywords, exception may happen, ignore
 		}
@@ -513,62 +599,143 @@ int F06Parser::parseSubcase(int currentSubCase, const string& currentLine) {
 	return parsedSubCase;
 }
 
+bool F06Parser::updateContext(Context& context, const F06Line& currentLine) {
+	bool found = false;
+	size_t subCasePosition = currentLine.find("SUBCASE");
+	if (subCasePosition != string::npos) {
+		context.subcase = parseSubcase(context.subcase, currentLine);
+		context.loadStep = -1;
+		found = true;
+	}
+	size_t pointIdPosition = currentLine.find("POINT-ID = ");
+	if (pointIdPosition != string::npos) {
+		context.pointId = parseLabelValue(context.pointId, currentLine.substr(pointIdPosition + 11));
+		found = true;
+	}
+	size_t loadStepPosition = currentLine.find("LOAD STEP = ");
+	if (loadStepPosition != string::npos) {
+		context.loadStep = parseLabelValue(context.loadStep, currentLine.substr(loadStepPosition + 12));
+		found = true;
+	}
+	size_t frequencyPosition = currentLine.find("FREQUENCY = ");
+	if (frequencyPosition != string::npos) {
+		context.frequency = parseLabelValue(context.frequency, currentLine.substr(frequencyPosition + 12));
+		found = true;
+	}
+	return found;
+}
+
+bool F06Parser::findSectionType(const F06Line& currentLine, Section::Type& type) {
+	if (currentLine == "D I S P L A C E M E N T   V E C T O R") {
+		type = Section::Type::DISPLACEMENT;
+	} else if (currentLine == "R E A L   E I G E N V A L U E S") {
+		type = Section::Type::EIGENVALUES;
+	} else if (currentLine == "C O M P L E X   D I S P L A C E M E N T   V E C T O R") {
+		type = Section::Type::COMPLEX_DISPLACEMENT;
+	} else if (currentLine.contains("S T R E S S E S") and currentLine.contains("S O L I D   E L E M E N T S")) {
+		type = Section::Type::SOLID_STRESSES;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+void F06Parser::addAssertions(Model& model, const ConfigurationParameters& configuration,
+		F06Scanner& scanner) const {
+	F06Line line;
+	Context context;
+	Section::Type type;
+	while (scanner.peekLine(line)) {
+		const streamoff titleOffset = scanner.position();
+		scanner.readLine(line);
+		const F06Line currentLine = line.trimmed();
+		updateContext(context, currentLine);
+		/*
+		 * Sections stop before the line that ends them (often the next SUBCASE),
+		 * it is read again by this loop. The subcase is kept after a section until
+		 * a SUBCASE line changes it.
+		 */
+		if (findSectionType(currentLine, type)) {
+			Section section(type, titleOffset, scanner.position(), scanner.lineNumber, context);
+			parseSection(model, configuration, scanner, section);
+			mergeSection(model, configuration, section);
+		}
+	}
+}
+
+void F06Parser::addAssertionsInParallel(Model& model, const ConfigurationParameters& configuration,
+		F06Scanner& scanner, size_t threadCount) const {
+	// Pre-scan: offsets of the section titles and of the lines changing the context
+	const streamoff start = scanner.position();
+	vector<Section> sections;
+	vector<ContextLine> contextLines;
+	F06Line line;
+	Context context;
+	Section::Type type;
+	while (scanner.peekLine(line)) {
+		const streamoff offset = scanner.position();
+		scanner.readLine(line);
+		const F06Line currentLine = line.trimmed();
+		if (updateContext(context, currentLine)) {
+			contextLines.push_back({offset, currentLine.str()});
+		}
+		if (findSectionType(currentLine, type)) {
+			sections.emplace_back(type, offset, scanner.position(), scanner.lineNumber, context);
+		}
+	}
+	if (sections.size() < PARALLEL_MIN_SECTIONS) {
+		scanner.seek(start, 0);
+		addAssertions(model, configuration, scanner);
+		return;
+	}
+
+	/*
+	 * Merge in file order. The pre-scan saw every line, while the sequential reading skips the
+	 * lines consumed by a section: the context is replayed from the end of each merged section,
+	 * sections whose title was consumed are dropped and the ones whose context differs are parsed again.
+	 */
+	Context replayed;
+	streamoff resume = start;
+	size_t nextContextLine = 0;
+	for (size_t batchBegin = 0; batchBegin < sections.size(); batchBegin += SECTIONS_BY_BATCH) {
+		const size_t batchEnd = min(sections.size(), batchBegin + SECTIONS_BY_BATCH);
+		parseSections(model, configuration, sections, batchBegin, batchEnd, threadCount);
+		for (size_t i = batchBegin; i < batchEnd; i++) {
+			Section& section = sections[i];
+			if (section.titleOffset >= resume) {
+				for (; nextContextLine < contextLines.size()
+						and contextLines[nextContextLine].offset <= section.titleOffset; nextContextLine++) {
+					const ContextLine& contextLine = contextLines[nextContextLine];
+					if (contextLine.offset >= resume) {
+						const char* text = contextLine.line.data();
+						updateContext(replayed, F06Line(text, text + contextLine.line.size()));
+					}
+				}
+				if (not (replayed == section.context)) {
+					section = Section(section.type, section.titleOffset, section.begin, section.lineNumber, replayed);
+					scanner.seek(section.begin, section.lineNumber);
+					parseSection(model, configuration, scanner, section);
+				}
+				mergeSection(model, configuration, section);
+				resume = section.end;
+			}
+			// rows are not needed anymore
+			section = Section(section.type, section.titleOffset, section.begin, section.lineNumber, section.context);
+		}
+	}
+}
+
 void F06Parser::add_assertions(const ConfigurationParameters& configuration,
 		Model& model) {
 	if (!configuration.resultFile.empty()) {
-		ifstream istream(configuration.resultFile.string());
-		string currentLine;
-		int currentSubCase = NO_SUBCASE;
-		double loadStep = -1;
-		double frequency = -1;
-		int pointId = -1;
-		while (this->readLine(istream, currentLine)) {
-			trim(currentLine);
-			size_t subCasePosition = currentLine.find("SUBCASE");
-			if (subCasePosition != string::npos) {
-				string subcaseN = trim_copy(currentLine.substr(subCasePosition + 7));
-				//cout << "SUBCASE "<<subcaseN<< "  " << currentLine <<endl;
-				currentSubCase = parseSubcase(currentSubCase, currentLine);
-				loadStep = -1;
-			}
-            size_t pointIdPosition = currentLine.find("POINT-ID = ");
-			if (pointIdPosition != string::npos) {
-				string pointIdString = trim_copy(currentLine.substr(pointIdPosition + 11));
-				//cout << "POINT-ID "<<pointId<< "  " << currentLine <<endl;
-				istringstream istringLine(pointIdString);
-				istringLine >> pointId;
-			}
-			size_t loadStepPosition = currentLine.find("LOAD STEP = ");
-			if (loadStepPosition != string::npos) {
-				string loadStepString = trim_copy(currentLine.substr(loadStepPosition + 12));
-				istringstream istringLine(loadStepString);
-				istringLine >> loadStep;
-			}
-			size_t frequencyPosition = currentLine.find("FREQUENCY = ");
-			if (frequencyPosition != string::npos) {
-				string frequencyString = trim_copy(currentLine.substr(frequencyPosition + 12));
-				istringstream istringLine(frequencyString);
-				istringLine >> frequency;
-			}
-			if (currentLine == "D I S P L A C E M E N T   V E C T O R") {
-				/*
-				 * The next subcase can be consumed to understand if the section has ended.
-				 * In this case, it will be given back as return value, to be used for the next section.
-				 */
-				currentSubCase = addAssertionsToModel(currentSubCase, loadStep, model,
-						configuration, istream);
-			} else if (currentLine == "R E A L   E I G E N V A L U E S") {
-				currentSubCase = addFrequencyAssertionsToModel(currentSubCase, model, configuration, istream);
-			} else if (currentLine == "C O M P L E X   D I S P L A C E M E N T   V E C T O R") {
-				currentSubCase = addComplexAssertionsToModel(currentSubCase, frequency, model,
-						configuration, istream);
-			}
-			size_t stressesPos = currentLine.find("S T R E S S E S");
-			size_t solidElementsPos = currentLine.find("S O L I D   E L E M E N T S");
-			if (stressesPos != string::npos and solidElementsPos != string::npos) {
-				currentSubCase = addVonMisesAssertionsToModel(currentSubCase, model,
-						configuration, istream);
-			}
+		ifstream istream(configuration.resultFile.string(), ios::binary);
+		F06Scanner scanner(istream);
+		const size_t threadCount = configuration.resultReaderThreads > 0 ?
+				static_cast<size_t>(configuration.resultReaderThreads) : max(1u, thread::hardware_concurrency());
+		if (threadCount > 1) {
+			addAssertionsInParallel(model, configuration, scanner, threadCount);
+		} else {
+			addAssertions(model, configuration, scanner);
 		}
 		istream.close();
 	}
@@ -578,19 +745,5 @@ F06Parser::~F06Parser() {
 
 }
 
-bool F06Parser::readLine(istream &istream, string& line) {
-	bool lineAvailable = false;
-	while (getline(istream, line)) {
-		lineNumber += 1;
-		if (!line.empty()) {
-			if (not trim_copy(line).empty()) {
-				lineAvailable = true;
-				break;
-			}
-		}
-	}
-	return lineAvailable;
-}
-
 }
 } /* namespace vega */
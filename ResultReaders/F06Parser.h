@@ -11,7 +11,13 @@
 #ifndef F06PARSER_H_
 #define F06PARSER_H_
 #include "../Abstract/SolverInterfaces.h"
+#include "../Abstract/Objective.h"
+#include "F06Scanner.h"
+#include <complex>
+#include <exception>
 #include <iostream>
+#include <string>
+#include <vector>
 
 namespace vega {
 class Model;
@@ -19,27 +25,104 @@ class Model;
 namespace result {
 class F06Parser: public vega::ResultReader {
 private:
-	int lineNumber = 0;
-	bool readLine(std::istream &istream, std::string& line);
-	int addAssertionsToModel(int currentSubcase, double loadStep, Model &model,
-			const ConfigurationParameters&, std::ifstream& istream);
-	int addFrequencyAssertionsToModel(int currentSubCase, Model&, const ConfigurationParameters&,
-			std::ifstream&);
-	int addComplexAssertionsToModel(int currentSubCase, double frequency, Model&,
-			const ConfigurationParameters&, std::ifstream&);
-    int addVonMisesAssertionsToModel(int currentSubCase, Model&,
-			const ConfigurationParameters&, std::ifstream&);
-	int readDisplacementSection(int currentSubCase, Model& model, const ConfigurationParameters&,
-			std::ifstream& istream, std::vector<std::shared_ptr<Assertion>>& assertions, double loadStep);
-	int readEigenvalueSection(int currentSubCase, Model&, const ConfigurationParameters&, std::ifstream&,
-			std::vector<std::shared_ptr<Assertion>>&);
-	int readComplexDisplacementSection(int currentSubCase, Model&, const ConfigurationParameters&, std::ifstream&,
-			std::vector<std::shared_ptr<Assertion>>&, double frequency);
-    int readStressesForSolidsSection(int currentSubCase, Model& model, const ConfigurationParameters&,
-			std::ifstream& istream, std::vector<std::shared_ptr<Assertion>>& assertions);
-
-	int parseSubcase(int currentSubCase, const std::string& currentLine);
 	static const int NO_SUBCASE = -1;
+	/**
+	 * Minimum number of sections before the parsing is split between threads.
+	 */
+	static const size_t PARALLEL_MIN_SECTIONS = 64;
+	/**
+	 * Sections parsed by a thread at once, they are contiguous to keep reading the file forward.
+	 */
+	static const size_t SECTIONS_BY_CHUNK = 16;
+	/**
+	 * Sections parsed before being merged into the model, it bounds the memory held by parsed rows.
+	 */
+	static const size_t SECTIONS_BY_BATCH = 4096;
+
+	/**
+	 * Values of the last SUBCASE, LOAD STEP, FREQUENCY and POINT-ID lines.
+	 */
+	struct Context {
+		int subcase = NO_SUBCASE;
+		double loadStep = -1;
+		double frequency = -1;
+		int pointId = -1;
+		bool operator==(const Context&) const noexcept;
+	};
+	/**
+	 * Line holding context values, the lines consumed by a section are ignored when merging.
+	 */
+	struct ContextLine {
+		std::streamoff offset;
+		std::string line;
+	};
+	struct EigenvalueRow {
+		int number;
+		double eigenValue;
+		double cycles;
+		double generalizedMass;
+		double generalizedStiffness;
+	};
+	struct ComplexDisplacementRow {
+		int nodeId;
+		std::complex<double> values[6];
+	};
+	struct VonMisesRow {
+		int cellId;
+		int nodeId;
+		double value;
+	};
+	/**
+	 * Section of the F06 file: it is parsed into rows without touching the model, so that
+	 * sections can be parsed concurrently, then merged into the model in file order.
+	 */
+	struct Section {
+		enum class Type {
+			DISPLACEMENT,
+			EIGENVALUES,
+			COMPLEX_DISPLACEMENT,
+			SOLID_STRESSES
+		};
+		Type type;
+		std::streamoff titleOffset; /**< Offset of the title line **/
+		std::streamoff begin; /**< Offset of the line following the title **/
+		std::streamoff end = -1; /**< Offset where the parsing stopped **/
+		int lineNumber; /**< Number of the title line **/
+		Context context;
+		NodalDisplacementAssertionTable displacements; /**< Six rows by node, in the node displacement CS **/
+		std::vector<EigenvalueRow> eigenvalues;
+		std::vector<ComplexDisplacementRow> complexDisplacements;
+		std::vector<VonMisesRow> vonMises;
+		std::exception_ptr error;
+		std::string errorMessage;
+		Section(Type type, std::streamoff titleOffset, std::streamoff begin, int lineNumber, const Context& context) noexcept;
+	};
+
+	/**
+	 * Updates the context with the values found in the line, returns true if it holds any.
+	 */
+	static bool updateContext(Context&, const F06Line& trimmedLine);
+	static bool findSectionType(const F06Line& trimmedLine, Section::Type&);
+	static int parseSubcase(int currentSubCase, const F06Line& currentLine);
+	static std::string errorMessage(const ConfigurationParameters&, const std::exception&, int lineNumber,
+			const std::string& line);
+	static void reportError(const ConfigurationParameters&, const std::exception&, const Section&);
+
+	void parseSection(const Model&, const ConfigurationParameters&, F06Scanner&, Section&) const;
+	void parseDisplacementSection(const Model&, const ConfigurationParameters&, F06Scanner&, Section&) const;
+	void parseEigenvalueSection(const ConfigurationParameters&, F06Scanner&, Section&) const;
+	void parseComplexDisplacementSection(const ConfigurationParameters&, F06Scanner&, Section&) const;
+	void parseStressesForSolidsSection(const ConfigurationParameters&, F06Scanner&, Section&) const;
+	void parseSections(const Model&, const ConfigurationParameters&, std::vector<Section>&, size_t begin, size_t end,
+			size_t threadCount) const;
+
+	void mergeSection(Model&, const ConfigurationParameters&, Section&) const;
+	void addAssertionsToModel(Model&, const ConfigurationParameters&, Section&) const;
+	void addFrequencyAssertionsToModel(Model&, const ConfigurationParameters&, const Section&) const;
+	void addComplexAssertionsToModel(Model&, const ConfigurationParameters&, const Section&) const;
+	void addVonMisesAssertionsToModel(Model&, const ConfigurationParameters&, const Section&) const;
+	void addAssertions(Model&, const ConfigurationParameters&, F06Scanner&) const;
+	void addAssertionsInParallel(Model&, const ConfigurationParameters&, F06Scanner&, size_t threadCount) const;
 
 public:
 	F06Parser() = default;
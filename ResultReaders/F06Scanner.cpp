@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) Alneos, s. a r. l. (contact@alneos.fr)
+ * Released under the GNU General Public License
+ *
+ * F06Scanner.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: devel
+ */
+
+#include "F06Scanner.h"
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace vega {
+namespace result {
+
+namespace {
+
+inline bool isBlank(char c) noexcept {
+	return isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+/**
+ * Null terminated copy of a token, strtol and strtod cannot be bounded.
+ */
+class TokenString final {
+	static const size_t LOCAL_SIZE = 64;
+	char local[LOCAL_SIZE];
+	string remote;
+public:
+	const char* c_str;
+	explicit TokenString(const F06Line& token) {
+		if (token.size() < LOCAL_SIZE) {
+			memcpy(local, token.begin, token.size());
+			local[token.size()] = '\0';
+			c_str = local;
+		} else {
+			remote = token.str();
+			c_str = remote.c_str();
+		}
+	}
+};
+
+}
+
+size_t F06Line::find(const char* text) const noexcept {
+	const size_t length = strlen(text);
+	if (length == 0) {
+		return 0;
+	}
+	if (length > size()) {
+		return string::npos;
+	}
+	const char* last = end - length;
+	for (const char* candidate = begin; candidate <= last; candidate++) {
+		candidate = static_cast<const char*>(memchr(candidate, text[0], static_cast<size_t>(last - candidate) + 1));
+		if (candidate == nullptr) {
+			break;
+		}
+		if (memcmp(candidate, text, length) == 0) {
+			return static_cast<size_t>(candidate - begin);
+		}
+	}
+	return string::npos;
+}
+
+F06Line F06Line::substr(size_t position) const noexcept {
+	return F06Line(position < size() ? begin + position : end, end);
+}
+
+F06Line F06Line::trimmed() const noexcept {
+	const char* first = begin;
+	const char* last = end;
+	while (first < last and isBlank(*first))
+		first++;
+	while (last > first and isBlank(*(last - 1)))
+		last--;
+	return F06Line(first, last);
+}
+
+bool F06Line::operator==(const char* text) const noexcept {
+	const size_t length = strlen(text);
+	return length == size() and memcmp(begin, text, length) == 0;
+}
+
+string F06Line::str() const {
+	return string(begin, end);
+}
+
+size_t F06Line::split(vector<F06Line>& tokens) const {
+	tokens.clear();
+	const char* current = begin;
+	while (current < end) {
+		while (current < end and isBlank(*current))
+			current++;
+		if (current == end)
+			break;
+		const char* tokenBegin = current;
+		while (current < end and not isBlank(*current))
+			current++;
+		tokens.emplace_back(tokenBegin, current);
+	}
+	return tokens.size();
+}
+
+int F06Line::toInt() const {
+	const TokenString token(*this);
+	char* parsedEnd = nullptr;
+	errno = 0;
+	const long value = strtol(token.c_str, &parsedEnd, 10);
+	if (parsedEnd == token.c_str) {
+		throw invalid_argument("F06Line::toInt " + str());
+	}
+	if (errno == ERANGE or value < INT_MIN or value > INT_MAX) {
+		throw out_of_range("F06Line::toInt " + str());
+	}
+	return static_cast<int>(value);
+}
+
+double F06Line::toDouble() const {
+	const TokenString token(*this);
+	char* parsedEnd = nullptr;
+	errno = 0;
+	const double value = strtod(token.c_str, &parsedEnd);
+	if (parsedEnd == token.c_str) {
+		throw invalid_argument("F06Line::toDouble " + str());
+	}
+	if (errno == ERANGE) {
+		throw out_of_range("F06Line::toDouble " + str());
+	}
+	return value;
+}
+
+const size_t F06Scanner::BLOCK_SIZE;
+
+F06Scanner::F06Scanner(istream& in, size_t blockSize) :
+		in(in), blockSize(blockSize), buffer(blockSize + 1, '\0'), origin(max<streamoff>(0, in.tellg())) {
+}
+
+void F06Scanner::seek(streamoff offset, int lineNumber) {
+	if (offset >= position() and offset <= origin + static_cast<streamoff>(dataEnd)) {
+		cursor = static_cast<size_t>(offset - origin);
+	} else {
+		in.clear();
+		in.seekg(offset);
+		origin = offset;
+		dataEnd = 0;
+		cursor = 0;
+		buffer[0] = '\0';
+	}
+	lineFound = false;
+	this->lineNumber = lineNumber;
+}
+
+bool F06Scanner::fill() {
+	if (cursor > 0) {
+		memmove(buffer.data(), buffer.data() + cursor, dataEnd - cursor);
+		dataEnd -= cursor;
+		origin += static_cast<streamoff>(cursor);
+		cursor = 0;
+	}
+	if (buffer.size() < dataEnd + blockSize + 1) {
+		// a line longer than a block
+		buffer.resize(dataEnd + blockSize + 1);
+	}
+	in.read(buffer.data() + dataEnd, static_cast<streamsize>(blockSize));
+	const size_t readCount = static_cast<size_t>(in.gcount());
+	dataEnd += readCount;
+	buffer[dataEnd] = '\0';
+	return readCount > 0;
+}
+
+bool F06Scanner::findLine() {
+	if (lineFound) {
+		return true;
+	}
+	size_t searchFrom = cursor;
+	while (true) {
+		const void* newline = memchr(buffer.data() + searchFrom, '\n', dataEnd - searchFrom);
+		if (newline != nullptr) {
+			lineEnd = static_cast<size_t>(static_cast<const char*>(newline) - buffer.data());
+			lineFound = true;
+			return true;
+		}
+		const size_t scanned = dataEnd - cursor;
+		if (not fill()) {
+			if (cursor < dataEnd) {
+				// last line without end of line
+				lineEnd = dataEnd;
+				lineFound = true;
+			}
+			return lineFound;
+		}
+		searchFrom = cursor + scanned;
+	}
+}
+
+bool F06Scanner::peekLine(F06Line& line) {
+	while (findLine()) {
+		const F06Line candidate(buffer.data() + cursor, buffer.data() + lineEnd);
+		if (not candidate.trimmed().empty()) {
+			line = candidate;
+			return true;
+		}
+		lineNumber++;
+		cursor = lineEnd < dataEnd ? lineEnd + 1 : dataEnd;
+		lineFound = false;
+	}
+	line = F06Line();
+	return false;
+}
+
+bool F06Scanner::readLine(F06Line& line) {
+	if (not peekLine(line)) {
+		return false;
+	}
+	lineNumber++;
+	cursor = lineEnd < dataEnd ? lineEnd + 1 : dataEnd;
+	lineFound = false;
+	return true;
+}
+
+}
+} /* namespace vega */
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) Alneos, s. a r. l. (contact@alneos.fr)
+ * Released under the GNU General Public License
+ *
+ * F06Scanner.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: devel
+ */
+
+#ifndef F06SCANNER_H_
+#define F06SCANNER_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace vega {
+namespace result {
+
+/**
+ * View over a line (or a part of a line) held in the buffer of a F06Scanner.
+ * It is valid until the scanner is asked for a line after it.
+ */
+class F06Line final {
+public:
+	const char* begin;
+	const char* end;
+	F06Line(const char* begin = nullptr, const char* end = nullptr) noexcept :
+			begin(begin), end(end) {
+	}
+	inline size_t size() const noexcept {return static_cast<size_t>(end - begin);};
+	inline bool empty() const noexcept {return begin == end;};
+	/**
+	 * First character of the line, '\0' if the line is empty.
+	 */
+	inline char front() const noexcept {return empty() ? '\0' : *begin;};
+	/**
+	 * Position of text in the line, std::string::npos if not found.
+	 */
+	size_t find(const char* text) const noexcept;
+	inline bool contains(const char* text) const noexcept {return find(text) != std::string::npos;};
+	F06Line substr(size_t position) const noexcept;
+	F06Line trimmed() const noexcept;
+	bool operator==(const char* text) const noexcept;
+	inline bool operator!=(const char* text) const noexcept {return not (*this == text);};
+	std::string str() const;
+	/**
+	 * Split the line on blanks, tokens are views over this line.
+	 * Returns the number of tokens.
+	 */
+	size_t split(std::vector<F06Line>& tokens) const;
+	/**
+	 * Parse the leading integer of the token, like std::stoi.
+	 * Throws std::invalid_argument or std::out_of_range.
+	 */
+	int toInt() const;
+	/**
+	 * Parse the leading floating point number of the token, like std::stod.
+	 * Throws std::invalid_argument or std::out_of_range.
+	 */
+	double toDouble() const;
+};
+
+/**
+ * Reads a F06 file by blocks and hands its non blank lines as F06Line views.
+ * One line of lookahead is available: sections can stop before the line that
+ * ends them and leave it to the caller.
+ */
+class F06Scanner final {
+	std::istream& in;
+	const size_t blockSize;
+	std::vector<char> buffer;
+	std::streamoff origin; /**< Offset in the stream of the start of buffer **/
+	size_t dataEnd = 0; /**< Bytes read in buffer, followed by a '\0' sentinel **/
+	size_t cursor = 0; /**< Start of the next line to read in buffer **/
+	size_t lineEnd = 0; /**< End of the line at cursor, if found **/
+	bool lineFound = false;
+	bool fill();
+	bool findLine();
+public:
+	static const size_t BLOCK_SIZE = 1 << 20;
+	int lineNumber = 0; /**< Number of the last line read, blank lines included **/
+	explicit F06Scanner(std::istream&, size_t blockSize = BLOCK_SIZE);
+	F06Scanner(const F06Scanner&) = delete;
+	/**
+	 * Skip blank lines and return the next line without consuming it.
+	 */
+	bool peekLine(F06Line& line);
+	/**
+	 * Skip blank lines and consume the next line.
+	 */
+	bool readLine(F06Line& line);
+	/**
+	 * Offset in the stream of the next line to read (or of the line peeked).
+	 */
+	inline std::streamoff position() const noexcept {return origin + static_cast<std::streamoff>(cursor);};
+	/**
+	 * Continue reading at offset, lineNumber being the number of the line before it.
+	 * Seeking forward inside the buffer does not read the stream again.
+	 */
+	void seek(std::streamoff offset, int lineNumber);
+};
+
+}
+} /* namespace vega */
+#endif /* F06SCANNER_H_ */
@@ -78,21 +78,20 @@ void SystusTable::fill(std::shared_ptr<MatrixElement> me, int nbDOFS){
     }
 
     // Building the table
-    for (const auto np : me->nodePairs()){
-        int pairCode = positionToSytusNumber[np.first]*1000 + positionToSytusNumber[np.second]*100;
-        const auto& dM = me->findSubmatrix(np.first, np.second);
-        for (const auto& dof: dM->componentByDofs){
-            int dofi=DOFToInt(dof.first.first);
+    me->getComponents().visitBlocks([&](const pos_t rowNodePosition, const pos_t colNodePosition, const DOFBlockMatrix::Block& block) {
+        const int pairCode = positionToSytusNumber[rowNodePosition]*1000 + positionToSytusNumber[colNodePosition]*100;
+        block.visitComponents([&](const DOF rowDof, const DOF colDof, const double value) {
+            int dofi=DOFToInt(rowDof);
             if (dofi> nbDOFS)
                 throw logic_error("Invalid degree of freedom ("+to_string(dofi)+") for Systus Table.");
-            int dofj=DOFToInt(dof.first.second);
+            int dofj=DOFToInt(colDof);
             if (dofj> nbDOFS)
                 throw logic_error("Invalid degree of freedom ("+to_string(dofj)+") for Systus Table.");
             int dofCode = 10*dofi + dofj;
             this->values.push_back(pairCode+dofCode);
-            this->values.push_back(dof.second);
-        }
-    }
+            this->values.push_back(value);
+        });
+    });
 
 }
 
@@ -358,7 +358,7 @@ string SystusWriter::writeModel(Model& model,
     }
 
     // On Systus output, we build a "general" solver file
-    ofstream dat_file_ofs;
+    OutputFile dat_file_ofs{configuration.legacyDoubleDigits};
     string dat_path = systusModel.getOutputFileName("_ALL.DAT");
     if (configuration.systusOutputProduct=="systus"){
         dat_file_ofs.open(dat_path.c_str(), ios::trunc);
@@ -379,7 +379,7 @@ string SystusWriter::writeModel(Model& model,
 
         /* ASCI file */
         string asc_path = systusModel.getOutputFileName("_SC" + to_string(idSubcase+1)+ "_DATA1.ASC");
-        ofstream asc_file_ofs;
+        OutputFile asc_file_ofs{configuration.legacyDoubleDigits};
         asc_file_ofs.precision(DBL_DIG);
         asc_file_ofs.open(asc_path.c_str(), ios::trunc | ios::out);
         if (!asc_file_ofs.is_open()) {
@@ -392,7 +392,7 @@ string SystusWriter::writeModel(Model& model,
         this->writeMatrixFiles(systusModel, idSubcase);
 
         /* Analysis file */
-        ofstream analyse_file_ofs;
+        OutputFile analyse_file_ofs{configuration.legacyDoubleDigits};
         analyse_file_ofs.precision(DBL_DIG);
         string analyse_path = systusModel.getOutputFileName("_SC" + to_string(idSubcase+1) + ".DAT");
         analyse_file_ofs.open(analyse_path.c_str(), ios::trunc);
@@ -1051,10 +1051,10 @@ void SystusWriter::fillLoads(const SystusModel& systusModel, const int idSubcase
 
 void SystusWriter::writeNodalForceVector(const SystusModel& systusModel, const shared_ptr<NodalForce>& nodalForce, const int idLoadCase, systus_ascid_t& vectorId) {
 
-    for(const pos_t nodePosition : nodalForce->nodePositions()) {
-        const auto& force = nodalForce->getForceInGlobalCS(nodePosition);
-        const auto& moment = nodalForce->getMomentInGlobalCS(nodePosition);
-        const int nodeId = systusModel.model.mesh.findNodeId(nodePosition);
+    for(const auto& nodeForce : nodalForce->getForcesInGlobalCS()) {
+        const auto& force = nodeForce.force;
+        const auto& moment = nodeForce.moment;
+        const int nodeId = systusModel.model.mesh.findNodeId(nodeForce.nodePosition);
 
         vector<double> vec;
         double normvec = 0.0;
@@ -1074,7 +1074,7 @@ void SystusWriter::writeNodalForceVector(const SystusModel& systusModel, const s
         }
         if (!is_zero(normvec)){
             vectors[vectorId]=vec;
-            loadingVectorsIdByLocalLoadingByNodePosition[nodePosition][idLoadCase].push_back(vectorId);
+            loadingVectorsIdByLocalLoadingByNodePosition[nodeForce.nodePosition][idLoadCase].push_back(vectorId);
             vectorId++;
         }
         // Rigid Body Element in option 3D.
@@ -2325,17 +2325,16 @@ void SystusWriter::fillMatrices(const SystusModel& systusModel, const int idSubc
 
         // Building the Systus Matrix
         SystusMatrix aMatrix = SystusMatrix(seId, nbDOFS, iSystus-1);
-        for (const auto np : dam->nodePairs()){
-            int nI = positionToSytusNumber[np.first];
-            int nJ = positionToSytusNumber[np.second];
-            const auto& dM = dam->findSubmatrix(np.first, np.second);
-            for (const auto dof: dM->componentByDofs){
-                int dofI = DOFToInt(dof.first.first);
-                int dofJ = DOFToInt(dof.first.second);
-                aMatrix.setValue(nI, nJ, dofI, dofJ, dof.second);
-                aMatrix.setValue(nJ, nI, dofJ, dofI, dof.second);
-            }
-        }
+        dam->getComponents().visitBlocks([&](const pos_t rowNodePosition, const pos_t colNodePosition, const DOFBlockMatrix::Block& block) {
+            const int nI = positionToSytusNumber[rowNodePosition];
+            const int nJ = positionToSytusNumber[colNodePosition];
+            block.visitComponents([&](const DOF rowDof, const DOF colDof, const double value) {
+                const int dofI = DOFToInt(rowDof);
+                const int dofJ = DOFToInt(colDof);
+                aMatrix.setValue(nI, nJ, dofI, dofJ, value);
+                aMatrix.setValue(nJ, nI, dofJ, dofI, value);
+            });
+        });
 
         tableByElementSet[elementSet->getId()]=-SystusWriter::DampingAccessId*10000;
         seIdByElementSet[elementSet->getId()]= seId;
@@ -2358,17 +2357,16 @@ void SystusWriter::fillMatrices(const SystusModel& systusModel, const int idSubc
 
         // Building the Systus Matrix
         SystusMatrix aMatrix = SystusMatrix(seId, nbDOFS, iSystus-1);
-        for (const auto np : mm->nodePairs()){
-            int nI = positionToSytusNumber[np.first];
-            int nJ = positionToSytusNumber[np.second];
-            const auto& dM = mm->findSubmatrix(np.first, np.second);
-            for (const auto dof: dM->componentByDofs){
-                int dofI = DOFToInt(dof.first.first);
-                int dofJ = DOFToInt(dof.first.second);
-                aMatrix.setValue(nI, nJ, dofI, dofJ, dof.second);
-                aMatrix.setValue(nJ, nI, dofJ, dofI, dof.second);
-            }
-        }
+        mm->getComponents().visitBlocks([&](const pos_t rowNodePosition, const pos_t colNodePosition, const DOFBlockMatrix::Block& block) {
+            const int nI = positionToSytusNumber[rowNodePosition];
+            const int nJ = positionToSytusNumber[colNodePosition];
+            block.visitComponents([&](const DOF rowDof, const DOF colDof, const double value) {
+                const int dofI = DOFToInt(rowDof);
+                const int dofJ = DOFToInt(colDof);
+                aMatrix.setValue(nI, nJ, dofI, dofJ, value);
+                aMatrix.setValue(nJ, nI, dofJ, dofI, value);
+            });
+        });
 
         tableByElementSet[elementSet->getId()]=-SystusWriter::MassAccessId*100;
         seIdByElementSet[elementSet->getId()]= seId;
@@ -2390,17 +2388,16 @@ void SystusWriter::fillMatrices(const SystusModel& systusModel, const int idSubc
 
         // Building the Systus Matrix
         SystusMatrix aMatrix = SystusMatrix(seId, nbDOFS, iSystus-1);
-        for (const auto np : sm->nodePairs()){
-            int nI = positionToSytusNumber[np.first];
-            int nJ = positionToSytusNumber[np.second];
-            const auto& dM = sm->findSubmatrix(np.first, np.second);
-            for (const auto dof: dM->componentByDofs){
-                int dofI = DOFToInt(dof.first.first);
-                int dofJ = DOFToInt(dof.first.second);
-                aMatrix.setValue(nI, nJ, dofI, dofJ, dof.second);
-                aMatrix.setValue(nJ, nI, dofJ, dofI, dof.second);
-            }
-        }
+        sm->getComponents().visitBlocks([&](const pos_t rowNodePosition, const pos_t colNodePosition, const DOFBlockMatrix::Block& block) {
+            const int nI = positionToSytusNumber[rowNodePosition];
+            const int nJ = positionToSytusNumber[colNodePosition];
+            block.visitComponents([&](const DOF rowDof, const DOF colDof, const double value) {
+                const int dofI = DOFToInt(rowDof);
+                const int dofJ = DOFToInt(colDof);
+                aMatrix.setValue(nI, nJ, dofI, dofJ, value);
+                aMatrix.setValue(nJ, nI, dofJ, dofI, value);
+            });
+        });
 
         tableByElementSet[elementSet->getId()]=-SystusWriter::StiffnessAccessId;
         seIdByElementSet[elementSet->getId()]= seId;
@@ -3212,15 +3209,21 @@ void SystusWriter::writeDat(const SystusModel& systusModel, const vega::Configur
         if (analysis== nullptr){
             handleWritingError("Analysis " + to_string(idAnalysis) + " not found.");
         }
-        const auto& assertions = analysis->getAssertions();
-        if (not assertions.empty()) {
+        if (analysis->hasAssertions()) {
             out << "LANGAGE" << endl;
             out << "variable displacement[" << nbDOFS << "],"
                     "frequency, phase[" << nbDOFS << "];" << endl;
             out << "iResu=open_file(\"" << systusModel.getName() << "_" << analysis->getId()
                                             << ".RESU\", \"write\");" << endl << endl;
 
-            for (const auto& assertion : assertions) {
+            for (const auto& table : analysis->getNodalDisplacementAssertionTables()) {
+                for (size_t row = 0; row < table->size(); row++) {
+                    writeNodalDisplacementAssertion(table->nodeIds[row], table->dofs[row], table->values[row],
+                            table->instants[row], table->tolerances[row], out);
+                    out << endl;
+                }
+            }
+            for (const auto& assertion : analysis->getIndividualAssertions()) {
                 switch (assertion->type) {
                 case Objective::Type::NODAL_DISPLACEMENT_ASSERTION: {
                     writeNodalDisplacementAssertion(*assertion, out);
@@ -3257,7 +3260,7 @@ void SystusWriter::writeDat(const SystusModel& systusModel, const vega::Configur
             out << "end;" << endl;
         }
 
-        for (const auto& objective : analysis->getObjectives()) {
+        for (const auto& objective : analysis->getIndividualObjectives()) {
             if (objective->isOutput()) {
                 handleWritingWarning("Output request " + to_str(objective) + " not yet implemented, ignoring");
                 objective->markAsWritten();
@@ -3272,29 +3275,33 @@ void SystusWriter::writeDat(const SystusModel& systusModel, const vega::Configur
 
 void SystusWriter::writeNodalDisplacementAssertion(Assertion& assertion, ostream& out) {
     NodalDisplacementAssertion& nda = dynamic_cast<NodalDisplacementAssertion&>(assertion);
-//    if (systusOption == SystusOption::CONTINUOUS and nda.dof.isRotation) {
+    writeNodalDisplacementAssertion(nda.nodeId, nda.dof, nda.value, nda.instant, nda.tolerance, out);
+}
+
+void SystusWriter::writeNodalDisplacementAssertion(int nodeId, DOF dof, double value, double instant,
+        double tolerance, ostream& out) {
+//    if (systusOption == SystusOption::CONTINUOUS and dof.isRotation()) {
 //        return;
 //    }
-    if (!is_equal(nda.instant, -1))
+    if (!is_equal(instant, -1))
         handleWritingError("Instant in NodalDisplacementAssertion not supported");
-    int nodeId = nda.nodeId;
-    int dofPos = nda.dof.position + 1;
+    int dofPos = dof.position() + 1;
 
     out << scientific;
     out << "displacement = node_displacement(1" << "," << nodeId << ");" << endl;
-    out << "diff = abs((displacement[" << dofPos << "]-(" << nda.value << "))/("
-            << (abs(nda.value) >= 1e-9 ? nda.value : 1.) << "));" << endl;
+    out << "diff = abs((displacement[" << dofPos << "]-(" << value << "))/("
+            << (abs(value) >= 1e-9 ? value : 1.) << "));" << endl;
 
     out << "fprintf(iResu,\" ------------------------ TEST_RESU DISPLACEMENT ASSERTION ------------------------\\n\")"
             << endl;
     out
     << "fprintf(iResu,\"      NOEUD        NUM_CMP      VALE_REFE             VALE_CALC    ERREUR       TOLE\\n\");"
     << endl;
-    out << "if (diff > abs(" << nda.tolerance
+    out << "if (diff > abs(" << tolerance
             << ")) fprintf(iResu,\" NOOK \"); else fprintf(iResu,\" OK   \");" << endl;
     out << "fprintf(iResu,\"" << setw(8) << nodeId << "     " << setw(8) << dofPos << "     "
-            << nda.value
-            << " %e %e " << nda.tolerance << " \\n\\n\", displacement[" << dofPos << "], diff);"
+            << value
+            << " %e %e " << tolerance << " \\n\\n\", displacement[" << dofPos << "], diff);"
             << endl;
     out.unsetf(ios::scientific);
 }
@@ -3303,7 +3310,7 @@ void SystusWriter::writeNodalComplexDisplacementAssertion(Assertion& assertion,
     NodalComplexDisplacementAssertion& ncda = dynamic_cast<NodalComplexDisplacementAssertion&>(assertion);
 
     int nodeId = ncda.nodeId;
-    int dofPos = ncda.dof.position + 1;
+    int dofPos = ncda.dof.position() + 1;
     double puls = ncda.frequency*2*M_PI;
     out << scientific;
     out << "nb_map = number_of_tran_maps(1);" << endl;
@@ -3357,7 +3364,7 @@ void SystusWriter::writeMatrixFiles(const SystusModel& systusModel, const int id
 
     /* Writing Damping Matrices */
     if (dampingMatrices.size()>0){
-        ofstream ofsMatrixFile;
+        OutputFile ofsMatrixFile{systusModel.configuration.legacyDoubleDigits};
         ofsMatrixFile.precision(DBL_DIG);
         string matrixFile = systusModel.getOutputFileName("_SC" + to_string(idSubcase+1) + "_DAMGEN.ASC");
         ofsMatrixFile.open(matrixFile.c_str(), ios::trunc);
@@ -3372,7 +3379,7 @@ void SystusWriter::writeMatrixFiles(const SystusModel& systusModel, const int id
 
     /* Writing Mass Matrices */
     if (massMatrices.size()>0){
-        ofstream ofsMatrixFile;
+        OutputFile ofsMatrixFile{systusModel.configuration.legacyDoubleDigits};
         ofsMatrixFile.precision(DBL_DIG);
         string matrixFile = systusModel.getOutputFileName("_SC" + to_string(idSubcase+1) + "_MASGEN.ASC");
         ofsMatrixFile.open(matrixFile.c_str(), ios::trunc);
@@ -3387,7 +3394,7 @@ void SystusWriter::writeMatrixFiles(const SystusModel& systusModel, const int id
 
     /* Writing Stiffness Matrices */
     if (stiffnessMatrices.size()>0){
-        ofstream ofsMatrixFile;
+        OutputFile ofsMatrixFile{systusModel.configuration.legacyDoubleDigits};
         ofsMatrixFile.precision(DBL_DIG);
         string matrixFile = systusModel.getOutputFileName("_SC" + to_string(idSubcase+1) + "_STIGEN.ASC");
         ofsMatrixFile.open(matrixFile.c_str(), ios::trunc);
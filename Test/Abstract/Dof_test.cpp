@@ -13,6 +13,21 @@ using namespace vega;
 BOOST_AUTO_TEST_CASE( test_dof ) {
 	BOOST_CHECK_EQUAL(DOF::DX, DOF::findByPosition(0));
 	BOOST_CHECK_EQUAL(DOF::RZ, DOF::findByPosition(5));
+	BOOST_CHECK_THROW(DOF::findByPosition(6), invalid_argument);
+	for (dof_int position = 0; position < 6; position++) {
+		const DOF dof = DOF::findByPosition(position);
+		BOOST_CHECK_EQUAL(position, dof.position());
+		BOOST_CHECK_EQUAL(position < 3, dof.isTranslation());
+		BOOST_CHECK_EQUAL(position >= 3, dof.isRotation());
+	}
+	BOOST_CHECK_EQUAL(string("RY"), DOF::RY.label());
+	static_assert(DOF(DOF::Code::RX_CODE).position() == 3, "DOF tables should be usable at compile time");
+}
+
+BOOST_AUTO_TEST_CASE( test_nastran_code ) {
+	BOOST_CHECK_EQUAL(DOFS(DOF::DX) + DOF::RZ, DOFS::nastranCodeToDOFS(16));
+	BOOST_CHECK_EQUAL(135, DOFS::nastranCodeToDOFS(531).nastranCode());
+	BOOST_CHECK_THROW(DOFS::nastranCodeToDOFS(17), invalid_argument);
 }
 
 BOOST_AUTO_TEST_CASE( test_dofS ) {
@@ -64,6 +79,7 @@ BOOST_AUTO_TEST_CASE( empty_DOFS ) {
 	DOFS dofs;
 	BOOST_CHECK_EQUAL(dofs.begin(), dofs.end());
 	for (DOF dof : dofs) {
+		UNUSEDV(dof);
 		BOOST_FAIL("Empty dofs should exit for loop immediately");
 	}
 }
@@ -125,3 +141,75 @@ BOOST_AUTO_TEST_CASE( dofs_intersection ) {
 	BOOST_CHECK(is_equal(found, expected));
 	BOOST_CHECK(is_equal(a & b, expected));
 }
+
+BOOST_AUTO_TEST_CASE( test_block_matrix ) {
+	DOFBlockMatrix matrix(MatrixType::SYMMETRIC);
+	BOOST_CHECK(matrix.empty());
+	matrix.addComponent(7, DOF::DX, 3, DOF::RZ, 1.0);
+	matrix.addComponent(3, DOF::RY, 3, DOF::DY, 2.0);
+	matrix.addComponent(3, DOF::DY, 3, DOF::RY, 5.0); // overwrites the previous one
+	matrix.addComponent(5, DOF::DZ, 5, DOF::DZ, 3.0);
+	BOOST_CHECK_EQUAL(3u, matrix.blockCount());
+	BOOST_CHECK(matrix.findBlock(7, 3) == nullptr);
+	const auto couple = matrix.findBlock(3, 7);
+	BOOST_REQUIRE(couple != nullptr);
+	BOOST_CHECK_EQUAL(1.0, couple->findComponent(DOF::RZ, DOF::DX));
+	BOOST_CHECK(couple->hasRotations());
+	BOOST_CHECK(couple->hasTranslations());
+	const auto diagonal = matrix.findBlock(3, 3);
+	BOOST_REQUIRE(diagonal != nullptr);
+	BOOST_CHECK_EQUAL(5.0, diagonal->findComponent(DOF::DY, DOF::RY));
+	BOOST_CHECK_EQUAL(0.0, diagonal->findComponent(DOF::RY, DOF::DY));
+	BOOST_CHECK(not matrix.findBlock(5, 5)->hasRotations());
+	BOOST_CHECK(matrix.nodePositions() == PositionSet({3, 5, 7}));
+
+	vector<pair<pos_t, pos_t>> couples;
+	int componentCount = 0;
+	matrix.visitBlocks([&](const pos_t rowNode, const pos_t colNode, const DOFBlockMatrix::Block& block) {
+		couples.push_back({rowNode, colNode});
+		block.visitComponents([&componentCount](const DOF, const DOF, const double) {
+			componentCount++;
+		});
+	});
+	const vector<pair<pos_t, pos_t>> expectedCouples = {{3, 3}, {3, 7}, {5, 5}};
+	BOOST_CHECK(couples == expectedCouples);
+	BOOST_CHECK_EQUAL(3, componentCount);
+
+	// components added after a read are merged with the stored blocks
+	matrix.addComponent(3, DOF::DX, 3, DOF::DX, 4.0);
+	matrix.addComponent(1, DOF::DX, 1, DOF::DX, 6.0);
+	BOOST_CHECK_EQUAL(4u, matrix.blockCount());
+	BOOST_CHECK_EQUAL(4.0, matrix.findBlock(3, 3)->findComponent(DOF::DX, DOF::DX));
+	BOOST_CHECK_EQUAL(5.0, matrix.findBlock(3, 3)->findComponent(DOF::DY, DOF::RY));
+	BOOST_CHECK_EQUAL(6.0, matrix.findBlock(1, 1)->findComponent(DOF::DX, DOF::DX));
+	matrix.clear();
+	BOOST_CHECK(matrix.empty());
+}
+
+BOOST_AUTO_TEST_CASE( test_block_matrix_many_components ) {
+	// more components than MAX_PENDING_COMPONENTS: they are compressed while they are added
+	DOFBlockMatrix matrix(MatrixType::SYMMETRIC);
+	const pos_t nodeCount = 500;
+	for (pos_t col = 0; col < nodeCount; col++) {
+		for (pos_t row = 0; row <= col; row++) {
+			for (dof_int i = 0; i < 6; i++) {
+				for (dof_int j = 0; j < 6; j++) {
+					matrix.addComponent(row, DOF::findByPosition(i), col, DOF::findByPosition(j), row + col + 0.5 * i);
+				}
+			}
+		}
+	}
+	BOOST_CHECK_EQUAL(static_cast<size_t>(nodeCount * (nodeCount + 1) / 2), matrix.blockCount());
+	bool ok = true;
+	matrix.visitBlocks([&ok](const pos_t rowNode, const pos_t colNode, const DOFBlockMatrix::Block& block) {
+		ok &= rowNode <= colNode;
+		if (rowNode == colNode) {
+			// (RZ, RX) was given last and stored in the upper triangle
+			ok &= is_equal(block.findComponent(DOF::RX, DOF::RZ), rowNode + colNode + 2.5);
+			ok &= is_equal(block.findComponent(DOF::RZ, DOF::RX), 0.0);
+		} else {
+			ok &= is_equal(block.findComponent(DOF::RX, DOF::RZ), rowNode + colNode + 1.5);
+		}
+	});
+	BOOST_CHECK(ok);
+}
@@ -41,3 +41,17 @@ BOOST_AUTO_TEST_CASE( test_structuralsegment ) {
 	BOOST_CHECK(structuralElement->isDiagonal());
 	BOOST_CHECK(structuralElement->hasRotations());
 }
+
+BOOST_AUTO_TEST_CASE( test_matrix_dofs_for_node ) {
+	Model model("fakemodel");
+	model.mesh.addNode(10, 0.0, 0.0, 0.0);
+	model.mesh.addNode(20, 1.0, 0.0, 0.0);
+	model.mesh.addNode(30, 2.0, 0.0, 0.0);
+	StiffnessMatrix matrix(model, MatrixType::SYMMETRIC);
+	matrix.addStiffness(10, DOF::DX, 20, DOF::DX, 1.0);
+	matrix.addStiffness(20, DOF::RX, 30, DOF::RX, 2.0);
+	// Only the blocks touching the node count
+	BOOST_CHECK_EQUAL(matrix.getDOFSForNode(model.mesh.findNodePosition(10)), DOFS::TRANSLATIONS);
+	BOOST_CHECK_EQUAL(matrix.getDOFSForNode(model.mesh.findNodePosition(20)), DOFS::ALL_DOFS);
+	BOOST_CHECK_EQUAL(matrix.getDOFSForNode(model.mesh.findNodePosition(30)), DOFS::ROTATIONS);
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) Alneos, s. a r. l. (contact@alneos.fr)
+ * Released under the GNU General Public License
+ *
+ * Mesh_benchmark.cpp
+ *
+ * addCell throughput on a grid of HEXA8, with compact then sparse ids, compared with the id lookups
+ * that the former std::map indexes did for the same cells. Timings depend on the machine: this is not
+ * a ctest test.
+ *
+ * Usage: Mesh_benchmark [cells by side]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../../Abstract/Mesh.h"
+
+using namespace std;
+using namespace vega;
+
+int main(int argc, char* argv[]) {
+    const int size = argc > 1 ? atoi(argv[1]) : 60;
+    if (size <= 0) {
+        cerr << "Invalid grid size" << endl;
+        return 1;
+    }
+    const auto& nodeId = [size](int i, int j, int k) {return 1 + i + (size + 1) * (j + (size + 1) * k);};
+    using Clock = chrono::steady_clock;
+    for (const int idStride : {1, 1009}) {
+        Mesh mesh(LogLevel::INFO, "mesh_benchmark");
+        for (int k = 0; k <= size; k++)
+            for (int j = 0; j <= size; j++)
+                for (int i = 0; i <= size; i++)
+                    mesh.addNode(nodeId(i, j, k) * idStride, i, j, k);
+        vector<vector<int>> connectivities;
+        for (int k = 0; k < size; k++)
+            for (int j = 0; j < size; j++)
+                for (int i = 0; i < size; i++)
+                    connectivities.push_back({nodeId(i, j, k) * idStride, nodeId(i + 1, j, k) * idStride,
+                        nodeId(i + 1, j + 1, k) * idStride, nodeId(i, j + 1, k) * idStride,
+                        nodeId(i, j, k + 1) * idStride, nodeId(i + 1, j, k + 1) * idStride,
+                        nodeId(i + 1, j + 1, k + 1) * idStride, nodeId(i, j + 1, k + 1) * idStride});
+
+        const auto start = Clock::now();
+        int cellId = 1;
+        for (const auto& connectivity : connectivities) {
+            mesh.addCell(cellId * idStride, CellType::HEXA8, connectivity);
+            cellId++;
+        }
+        const auto addCellTime = Clock::now() - start;
+
+        // Lookups done by addCell with the former indexes: one insertion by cell, one search by node
+        map<int, pos_t> nodePositionById;
+        for (const Node& node : mesh.nodes) {
+            nodePositionById[node.id] = node.position;
+        }
+        map<int, pos_t> cellPositionById;
+        const auto mapStart = Clock::now();
+        pos_t checksum = 0;
+        cellId = 1;
+        for (const auto& connectivity : connectivities) {
+            cellPositionById[cellId * idStride] = static_cast<pos_t>(cellId - 1);
+            for (int id : connectivity) {
+                checksum += nodePositionById.find(id)->second;
+            }
+            cellId++;
+        }
+        const auto mapTime = Clock::now() - mapStart;
+
+        cout << connectivities.size() << " HEXA8 with id stride " << idStride << ": addCell "
+                << chrono::duration_cast<chrono::microseconds>(addCellTime).count() << "us, std::map lookups alone "
+                << chrono::duration_cast<chrono::microseconds>(mapTime).count() << "us (checksum " << checksum
+                << ")" << endl;
+        if (mesh.countCells() != connectivities.size()) {
+            cerr << "Unexpected cell count " << mesh.countCells() << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -7,9 +7,11 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/geometry.hpp>
 #include <boost/geometry/algorithms/comparable_distance.hpp>
+#include <map>
 
 #include "../../Abstract/MeshComponents.h"
 #include "../../Abstract/Mesh.h"
+#include "../../Abstract/CoordinateSystem.h"
 
 using namespace std;
 using namespace vega;
@@ -90,6 +92,140 @@ BOOST_AUTO_TEST_CASE( test_faceIds_pload4 )
                                   expectedFace1NodeIds.begin(), expectedFace1NodeIds.end());
 }
 
+BOOST_AUTO_TEST_CASE( test_volcell_from_skincell )
+{
+    Mesh mesh(LogLevel::INFO, "skin");
+    mesh.addCell(1, CellType::HEXA8, { 101, 102, 103, 104, 105, 106, 107, 108 });
+    mesh.addCell(2, CellType::TETRA10, { 201, 202, 203, 204, 205, 206, 207, 208, 209, 210 });
+    const Cell&& quad = mesh.findCell(mesh.addCell(3, CellType::QUAD4, { 103, 107, 106, 102 }));
+    const auto& hexaFace = mesh.volcellAndFaceNum_from_skincell(quad);
+    BOOST_CHECK_EQUAL(hexaFace.first.id, 1);
+    BOOST_CHECK_EQUAL(hexaFace.second, 4);
+    // Same corners, but a TRI3 is not a face of a TETRA10
+    const Cell&& tri3 = mesh.findCell(mesh.addCell(4, CellType::TRI3, { 201, 204, 202 }));
+    BOOST_CHECK_THROW(mesh.volcellAndFaceNum_from_skincell(tri3), logic_error);
+    const Cell&& tri6 = mesh.findCell(mesh.addCell(5, CellType::TRI6, { 204, 202, 201, 209, 205, 208 }));
+    const auto& tetraFace = mesh.volcellAndFaceNum_from_skincell(tri6);
+    BOOST_CHECK_EQUAL(tetraFace.first.id, 2);
+    BOOST_CHECK_EQUAL(tetraFace.second, 2);
+    // Volume cells added after the first lookup must be found too
+    mesh.addCell(6, CellType::HEXA8, { 105, 106, 107, 108, 109, 110, 111, 112 });
+    const Cell&& top = mesh.findCell(mesh.addCell(7, CellType::QUAD4, { 109, 110, 111, 112 }));
+    BOOST_CHECK_EQUAL(mesh.volcellAndFaceNum_from_skincell(top).first.id, 6);
+}
+
+BOOST_AUTO_TEST_CASE( test_cell_positions_by_node )
+{
+    Mesh mesh(LogLevel::INFO, "nodecells");
+    const pos_t quad = mesh.addCell(1, CellType::QUAD4, { 101, 102, 103, 104 });
+    const pos_t seg = mesh.addCell(2, CellType::SEG2, { 104, 105 });
+    const auto& cells104 = mesh.findCellPositionsByNode(mesh.findNodePosition(104));
+    const vector<pos_t> expected104 = { quad, seg };
+    BOOST_CHECK_EQUAL_COLLECTIONS(cells104.begin(), cells104.end(), expected104.begin(), expected104.end());
+    BOOST_CHECK_EQUAL(mesh.findCellPositionsByNode(mesh.findNodePosition(101)).size(), 1);
+    // Index must follow the changes
+    const pos_t tri = mesh.addCell(3, CellType::TRI3, { 105, 106, 101 });
+    BOOST_CHECK_EQUAL(mesh.findCellPositionsByNode(mesh.findNodePosition(101)).size(), 2);
+    BOOST_CHECK_EQUAL(mesh.findCellPositionsByNode(mesh.findNodePosition(106)).front(), tri);
+    mesh.addNode(107, 0.0, 0.0, 0.0);
+    BOOST_CHECK(mesh.findCellPositionsByNode(mesh.findNodePosition(107)).empty());
+
+    // Big enough to be indexed in parallel
+    Mesh big(LogLevel::INFO, "bignodecells");
+    const int size = 80;
+    int cellId = 1;
+    const auto nodeId = [size](int i, int j, int k) {
+        return 1 + i + (size + 1) * (j + (size + 1) * k);
+    };
+    for (int k = 0; k < size; k++) {
+        for (int j = 0; j < size; j++) {
+            for (int i = 0; i < size; i++) {
+                big.addCell(cellId++, CellType::HEXA8, { nodeId(i, j, k), nodeId(i + 1, j, k), nodeId(i + 1, j + 1, k), nodeId(i, j + 1, k),
+                        nodeId(i, j, k + 1), nodeId(i + 1, j, k + 1), nodeId(i + 1, j + 1, k + 1), nodeId(i, j + 1, k + 1) });
+            }
+        }
+    }
+    for (int cellSegment = 1; cellSegment <= 20; cellSegment++) {
+        big.addCell(cellId++, CellType::SEG2, { nodeId(cellSegment, cellSegment, cellSegment), nodeId(0, 0, 0) });
+    }
+    map<pos_t, vector<pos_t>> expected;
+    for (pos_t cellPosition = 0; cellPosition < big.countCells(); cellPosition++) {
+        for (const pos_t nodePosition : big.cellView(cellPosition).nodePositions) {
+            expected[nodePosition].push_back(cellPosition);
+        }
+    }
+    BOOST_CHECK_EQUAL(expected.size(), big.countNodes());
+    bool same = true;
+    for (const auto& entry : expected) {
+        const auto& found = big.findCellPositionsByNode(entry.first);
+        vector<pos_t> sorted(entry.second);
+        sort(sorted.begin(), sorted.end());
+        same = same and found.size() == sorted.size() and equal(found.begin(), found.end(), sorted.begin());
+    }
+    BOOST_CHECK(same);
+    BOOST_CHECK_EQUAL(big.findCellPositionsByNode(big.findNodePosition(nodeId(0, 0, 0))).size(), 21);
+}
+
+BOOST_AUTO_TEST_CASE( test_cell_view )
+{
+    Mesh mesh(LogLevel::INFO, "test_cell_view");
+    mesh.addCell(1, CellType::QUAD4, { 101, 102, 103, 104 });
+    mesh.addCell(2, CellType::SEG2, { 104, 105 });
+    const auto cellPosition = mesh.addCell(3, CellType::QUAD4, { 104, 103, 106, 107 }, false, CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID, 42);
+    const Cell& cell = mesh.findCell(cellPosition);
+    const CellView& view = mesh.cellView(cellPosition);
+    BOOST_CHECK_EQUAL(view.id, 3);
+    BOOST_CHECK(view.type == CellType::QUAD4);
+    BOOST_CHECK_EQUAL(view.position, cellPosition);
+    BOOST_CHECK_EQUAL(view.elementId, 42);
+    BOOST_CHECK_EQUAL(view.cellTypePosition, 1);
+    BOOST_CHECK_EQUAL_COLLECTIONS(view.nodePositions.begin(), view.nodePositions.end(),
+                                  cell.nodePositions.begin(), cell.nodePositions.end());
+    vector<int> nodeIds;
+    for (const pos_t nodePosition : view.nodePositions) {
+        nodeIds.push_back(mesh.findNodeId(nodePosition));
+    }
+    BOOST_CHECK_EQUAL_COLLECTIONS(nodeIds.begin(), nodeIds.end(), cell.nodeIds.begin(), cell.nodeIds.end());
+}
+
+BOOST_AUTO_TEST_CASE( test_visit_cells )
+{
+    Mesh mesh(LogLevel::INFO, "test_visit_cells");
+    mesh.addCell(1, CellType::QUAD4, { 101, 102, 103, 104 });
+    mesh.addCell(2, CellType::SEG2, { 104, 105 });
+    mesh.addCell(3, CellType::QUAD4, { 104, 103, 106, 107 });
+    vector<int> visitedIds;
+    vector<pos_t> visitedNodePositions;
+    mesh.visitCells(CellType::QUAD4, [&](const CellView& cell) {
+        visitedIds.push_back(cell.id);
+        visitedNodePositions.insert(visitedNodePositions.end(), cell.nodePositions.begin(), cell.nodePositions.end());
+    });
+    const vector<int> expectedIds = { 1, 3 };
+    BOOST_CHECK_EQUAL_COLLECTIONS(visitedIds.begin(), visitedIds.end(), expectedIds.begin(), expectedIds.end());
+    vector<pos_t> expectedNodePositions;
+    for (int nodeId : { 101, 102, 103, 104, 104, 103, 106, 107 }) {
+        expectedNodePositions.push_back(mesh.findNodePosition(nodeId));
+    }
+    BOOST_CHECK_EQUAL_COLLECTIONS(visitedNodePositions.begin(), visitedNodePositions.end(),
+                                  expectedNodePositions.begin(), expectedNodePositions.end());
+
+    const auto& cellGroup = mesh.createCellGroup("GROUP");
+    cellGroup->addCellId(3);
+    cellGroup->addCellId(2);
+    visitedIds.clear();
+    mesh.visitCells(*cellGroup, [&visitedIds](const CellView& cell) {
+        visitedIds.push_back(cell.id);
+    });
+    const vector<int> expectedGroupIds = { 2, 3 };
+    BOOST_CHECK_EQUAL_COLLECTIONS(visitedIds.begin(), visitedIds.end(), expectedGroupIds.begin(), expectedGroupIds.end());
+
+    size_t visitedCount = 0;
+    mesh.visitCells(CellType::HEXA8, [&visitedCount](const CellView&) {
+        visitedCount++;
+    });
+    BOOST_CHECK_EQUAL(visitedCount, 0);
+}
+
 BOOST_AUTO_TEST_CASE( test_NodeGroup )
 {
     Mesh mesh(LogLevel::INFO, "test");
@@ -166,3 +302,94 @@ BOOST_AUTO_TEST_CASE( test_node_iterator )
     }
     BOOST_CHECK_EQUAL(mesh.countNodes(), i);
 }
+
+BOOST_AUTO_TEST_CASE( test_global_coordinates )
+{
+    Mesh mesh(LogLevel::INFO, "test");
+    const Reference<CoordinateSystem> csref(CoordinateSystem::Type::ABSOLUTE, 7);
+    // Nodes can reference a coordinate system defined later
+    const pos_t cpos = mesh.findOrReserveCoordinateSystem(csref);
+    mesh.addNode(1, 1.0, 2.0, 3.0);
+    mesh.addNode(2, 1.0, 2.0, 3.0, cpos);
+
+    const NodeCoordinates& local = mesh.nodes.getLocalCoordinates();
+    BOOST_CHECK_EQUAL(local.size(), 2);
+    BOOST_CHECK_CLOSE(local.x[1], 1.0, Globals::DOUBLE_COMPARE_TOLERANCE);
+
+    CartesianCoordinateSystem cs(mesh, VectorialValue(10., 20., 30.), VectorialValue::X, VectorialValue::Y,
+            CoordinateSystem::GLOBAL_COORDINATE_SYSTEM, 7);
+    mesh.add(cs);
+    const NodeCoordinates& global = mesh.nodes.getGlobalCoordinates();
+    BOOST_CHECK_CLOSE(global.x[0], 1.0, Globals::DOUBLE_COMPARE_TOLERANCE);
+    BOOST_CHECK_CLOSE(global.x[1], 11.0, Globals::DOUBLE_COMPARE_TOLERANCE);
+    BOOST_CHECK_CLOSE(global.y[1], 22.0, Globals::DOUBLE_COMPARE_TOLERANCE);
+    BOOST_CHECK_CLOSE(global.z[1], 33.0, Globals::DOUBLE_COMPARE_TOLERANCE);
+    BOOST_CHECK_CLOSE(mesh.findNode(1).z, 33.0, Globals::DOUBLE_COMPARE_TOLERANCE);
+
+    // Moving a node must be seen by the next call
+    mesh.addNode(2, 0.0, 0.0, 0.0, cpos);
+    BOOST_CHECK_CLOSE(mesh.nodes.getGlobalCoordinates().x[1], 10.0, Globals::DOUBLE_COMPARE_TOLERANCE);
+    BOOST_CHECK_CLOSE(mesh.findNode(1).x, 10.0, Globals::DOUBLE_COMPARE_TOLERANCE);
+}
+
+BOOST_AUTO_TEST_CASE( test_id_index )
+{
+    IdIndex index;
+    for (int id = 1; id <= 1000; id++) {
+        index.set(id, static_cast<pos_t>(id - 1));
+    }
+    BOOST_CHECK(index.isDense());
+    BOOST_CHECK_EQUAL(index.find(500), 499);
+    BOOST_CHECK_EQUAL(index.find(0), Globals::UNAVAILABLE_POS);
+    BOOST_CHECK_EQUAL(index.find(1001), Globals::UNAVAILABLE_POS);
+    index.set(500, 2000);
+    BOOST_CHECK_EQUAL(index.find(500), 2000);
+    BOOST_CHECK_EQUAL(index.size(), 1000);
+    const auto& denseEntries = index.sorted();
+
+    // Sparse (like the automatic ids) and negative ids move the index to the hash table
+    const int autoId = 9999999;
+    index.set(autoId, 1000);
+    index.set(-5, 1001);
+    BOOST_CHECK(not index.isDense());
+    BOOST_CHECK_EQUAL(index.size(), 1002);
+    BOOST_CHECK_EQUAL(index.find(500), 2000);
+    BOOST_CHECK_EQUAL(index.find(1000), 999);
+    BOOST_CHECK_EQUAL(index.find(autoId), 1000);
+    BOOST_CHECK_EQUAL(index.find(-5), 1001);
+    BOOST_CHECK_EQUAL(index.find(-6), Globals::UNAVAILABLE_POS);
+
+    const auto& entries = index.sorted();
+    BOOST_REQUIRE_EQUAL(entries->size(), 1002);
+    BOOST_CHECK_EQUAL(entries->front().first, -5);
+    BOOST_CHECK_EQUAL(entries->back().first, autoId);
+    BOOST_CHECK(is_sorted(entries->begin(), entries->end()));
+    // Previous snapshots are left untouched
+    BOOST_CHECK_EQUAL(denseEntries->size(), 1000);
+}
+
+BOOST_AUTO_TEST_CASE( test_add_cell_sparse_ids )
+{
+    // Builds a grid of HEXA8 with compact then sparse ids: both index layouts must resolve the same cells
+    const int size = 4;
+    const auto& nodeId = [size](int i, int j, int k) {return 1 + i + (size + 1) * (j + (size + 1) * k);};
+    for (const int idStride : {1, 1009}) {
+        Mesh mesh(LogLevel::INFO, "test_add_cell_sparse_ids");
+        for (int k = 0; k <= size; k++)
+            for (int j = 0; j <= size; j++)
+                for (int i = 0; i <= size; i++)
+                    mesh.addNode(nodeId(i, j, k) * idStride, i, j, k);
+        int cellId = 1;
+        for (int k = 0; k < size; k++)
+            for (int j = 0; j < size; j++)
+                for (int i = 0; i < size; i++)
+                    mesh.addCell(cellId++ * idStride, CellType::HEXA8, {nodeId(i, j, k) * idStride, nodeId(i + 1, j, k) * idStride,
+                        nodeId(i + 1, j + 1, k) * idStride, nodeId(i, j + 1, k) * idStride,
+                        nodeId(i, j, k + 1) * idStride, nodeId(i + 1, j, k + 1) * idStride,
+                        nodeId(i + 1, j + 1, k + 1) * idStride, nodeId(i, j + 1, k + 1) * idStride});
+        BOOST_CHECK_EQUAL(mesh.countCells(), size * size * size);
+        BOOST_CHECK_EQUAL(mesh.findCellPosition(idStride), 0);
+        BOOST_CHECK_EQUAL(mesh.findCellPosition((cellId - 1) * idStride), size * size * size - 1);
+        BOOST_CHECK_EQUAL(mesh.findNodeId(mesh.findNodePosition(nodeId(size, size, size) * idStride)), nodeId(size, size, size) * idStride);
+    }
+}
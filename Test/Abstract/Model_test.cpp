@@ -14,6 +14,7 @@
 #include "Model_test.h"
 #include <cstddef>
 #include <new>
+#include <sstream>
 #include <string>
 #include <vector>
 #if VALGRIND_FOUND && defined VDEBUG && defined __GNUC__  && !defined(_WIN32)
@@ -132,13 +133,13 @@ BOOST_AUTO_TEST_CASE( test_Elements ) {
 	cout << "NODES:" << model.mesh.countNodes() << endl;
 	model.finish();
 	BOOST_CHECK(model.validate());
-	const vector<shared_ptr<ElementSet>> beams = model.elementSets.filter(ElementSet::Type::RECTANGULAR_SECTION_BEAM);
+	const auto& beams = model.elementSets.filter(ElementSet::Type::RECTANGULAR_SECTION_BEAM);
 	BOOST_CHECK_EQUAL(1, beams.size());
 	BOOST_CHECK(model.elementSets.contains(ElementSet::Type::RECTANGULAR_SECTION_BEAM));
 
 //no virtual elements
 
-	const vector<shared_ptr<ElementSet>> discrets = model.elementSets.filter(ElementSet::Type::DISCRETE_0D);
+	const auto& discrets = model.elementSets.filter(ElementSet::Type::DISCRETE_0D);
 	BOOST_CHECK_EQUAL(0, discrets.size());
 	BOOST_CHECK(not model.elementSets.contains(ElementSet::Type::DISCRETE_0D));
 	//const auto& assignment = model.getOrCreateMaterial(1)->getAssignment();
@@ -497,6 +498,30 @@ BOOST_AUTO_TEST_CASE(test_ineffective_assertions_removed) {
 	BOOST_CHECK_EQUAL(assertions.size(), 1);
 }
 
+BOOST_AUTO_TEST_CASE(test_assertion_table_views_keep_ids) {
+	unique_ptr<Model> model = createModelWith1HEXA8();
+	const auto& analysis = make_shared<LinearMecaStat>(*model);
+	const auto& objectiveSet = model->getOrCreateObjectiveSet(1, ObjectiveSet::Type::ASSERTION);
+	const auto& nda = make_shared<NodalDisplacementAssertion>(*model, objectiveSet, 0.0001, 50, DOF::DZ, 1., 1);
+	model->add(nda);
+	NodalDisplacementAssertionTable table;
+	table.add(model->mesh.findNodePosition(50), 50, DOF::DX, 2., 1., 0.0001);
+	table.add(model->mesh.findNodePosition(51), 51, DOF::DY, 3., 1., 0.0001);
+	objectiveSet->add(table);
+	analysis->add(objectiveSet);
+	model->add(analysis);
+
+	const int lastId = Identifiable<Objective>::lastAutoId();
+	BOOST_CHECK_EQUAL(3, objectiveSet->getObjectives().size());
+	BOOST_CHECK_EQUAL(3, objectiveSet->getObjectivesByType(Objective::Type::NODAL_DISPLACEMENT_ASSERTION).size());
+	BOOST_CHECK_EQUAL(3, analysis->filter(Objective::Type::NODAL_DISPLACEMENT_ASSERTION).size());
+	BOOST_CHECK_EQUAL(3, analysis->getAssertions().size());
+	BOOST_CHECK(analysis->contains(Objective::Type::NODAL_DISPLACEMENT_ASSERTION));
+	BOOST_CHECK(analysis->filter(Objective::Type::FREQUENCY_ASSERTION).empty());
+	BOOST_CHECK(not analysis->contains(Objective::Type::FREQUENCY_ASSERTION));
+	BOOST_CHECK_EQUAL(lastId, Identifiable<Objective>::lastAutoId());
+}
+
 BOOST_AUTO_TEST_CASE(test_rbe3_assertions_not_removed) {
 	Model model{"fakemodelfortest", "10.3", SolverName::NASTRAN};
 	model.mesh.addNode(100, 0.0, 0.0, 0.0);
@@ -573,6 +598,95 @@ BOOST_AUTO_TEST_CASE(test_spc_dof_remove) {
 }
 
 
+BOOST_AUTO_TEST_CASE( test_remove_all ) {
+	Model model{"inputfile", "10.3", SolverName::NASTRAN};
+	model.mesh.addNode(1, 0.0, 0.0, 0.0);
+	const auto& loadSet1 = make_shared<LoadSet>(model, LoadSet::Type::LOAD, 1);
+	model.add(loadSet1);
+	const auto& loadSet2 = make_shared<LoadSet>(model, LoadSet::Type::LOAD, 2);
+	model.add(loadSet2);
+	vector<Reference<Loading>> forceReferences;
+	for (int i = 1; i <= 4; i++) {
+		const auto& force = make_shared<NodalForce>(model, loadSet1, 1, i);
+		model.add(force);
+		model.addLoadingIntoLoadSet(force->getReference(), loadSet2->getReference());
+		forceReferences.push_back(force->getReference());
+	}
+	BOOST_CHECK_EQUAL(model.getLoadingsByLoadSet(loadSet1->getReference()).size(), 4);
+	forceReferences.pop_back();
+	model.removeAll(forceReferences);
+	BOOST_CHECK_EQUAL(model.loadings.size(), 1);
+	BOOST_CHECK_EQUAL(model.getLoadingsByLoadSet(loadSet1->getReference()).size(), 1);
+	BOOST_CHECK_EQUAL(model.getLoadingsByLoadSet(loadSet2->getReference()).size(), 1);
+
+	const auto& constraintSet1 = make_shared<ConstraintSet>(model, ConstraintSet::Type::SPC, 1);
+	model.add(constraintSet1);
+	const auto& constraintSet2 = make_shared<ConstraintSet>(model, ConstraintSet::Type::SPC, 2);
+	model.add(constraintSet2);
+	vector<Reference<Constraint>> spcReferences;
+	for (int i = 1; i <= 3; i++) {
+		const auto& spc = make_shared<SinglePointConstraint>(model, DOFS::ALL_DOFS, 0.0);
+		spc->addNodeId(1);
+		model.add(spc);
+		model.addConstraintIntoConstraintSet(spc->getReference(), constraintSet1->getReference());
+		model.addConstraintIntoConstraintSet(spc->getReference(), constraintSet2->getReference());
+		spcReferences.push_back(spc->getReference());
+	}
+	BOOST_CHECK_EQUAL(model.getConstraintSetsByConstraint(spcReferences[0]).size(), 2);
+	model.removeAll({spcReferences[0]}, constraintSet1->getReference());
+	BOOST_CHECK_EQUAL(constraintSet1->getConstraints().size(), 2);
+	model.removeAll<Constraint>({spcReferences[1], spcReferences[2]});
+	BOOST_CHECK_EQUAL(model.constraints.size(), 0);
+	BOOST_CHECK(constraintSet1->empty());
+	BOOST_CHECK_EQUAL(model.getConstraintSetsByConstraint(spcReferences[1]).size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE( test_loadset_members_cached ) {
+	Model model{"inputfile", "10.3", SolverName::NASTRAN};
+	model.mesh.addNode(1, 0.0, 0.0, 0.0);
+	const auto& loadSet1 = make_shared<LoadSet>(model, LoadSet::Type::LOAD, 1);
+	model.add(loadSet1);
+	model.add(make_shared<NodalForce>(model, loadSet1, 1, 1.0));
+	model.add(make_shared<Gravity>(model, loadSet1, 9.81, VectorialValue(0, 0, -1)));
+	const auto& loadings = loadSet1->getLoadings();
+	BOOST_CHECK_EQUAL(loadings.size(), 2);
+	BOOST_CHECK_EQUAL(loadSet1->getLoadingsByType(Loading::Type::NODAL_FORCE).size(), 1);
+	BOOST_CHECK_EQUAL(loadSet1->getLoadingsByType(Loading::Type::GRAVITY).size(), 1);
+	BOOST_CHECK(loadSet1->getLoadingsByType(Loading::Type::ROTATION).empty());
+	BOOST_CHECK(loadSet1->getLoadings().begin() == loadings.begin()); // resolved only once
+
+	const auto& force2 = make_shared<NodalForce>(model, loadSet1, 1, 2.0);
+	model.add(force2);
+	BOOST_CHECK_EQUAL(loadings.size(), 2); // views are not affected by later changes
+	BOOST_CHECK_EQUAL(loadSet1->getLoadings().size(), 3);
+	BOOST_CHECK_EQUAL(loadSet1->getLoadingsByType(Loading::Type::NODAL_FORCE).size(), 2);
+	model.remove(force2->getReference());
+	BOOST_CHECK_EQUAL(loadSet1->getLoadingsByType(Loading::Type::NODAL_FORCE).size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE( test_container_type_index ) {
+	Model model{"inputfile", "10.3", SolverName::NASTRAN};
+	const auto& loadSet1 = make_shared<LoadSet>(model, LoadSet::Type::LOAD, 7);
+	model.add(loadSet1);
+	const auto& dloadSet = make_shared<LoadSet>(model, LoadSet::Type::DLOAD, 7);
+	model.add(dloadSet);
+	model.add(make_shared<LoadSet>(model, LoadSet::Type::LOAD, 8));
+	BOOST_CHECK(model.loadSets.contains(LoadSet::Type::DLOAD));
+	BOOST_CHECK(not model.loadSets.contains(LoadSet::Type::EXCITEID));
+	const auto& loads = model.loadSets.filter(LoadSet::Type::LOAD);
+	BOOST_CHECK_EQUAL(loads.size(), 2);
+	BOOST_CHECK(loads[0] == loadSet1);
+	BOOST_CHECK(model.loadSets.find(7) != nullptr);
+
+	model.loadSets.erase(dloadSet->getReference());
+	BOOST_CHECK(not model.loadSets.contains(LoadSet::Type::DLOAD));
+	BOOST_CHECK(model.loadSets.find(7) == loadSet1);
+	model.loadSets.erase(loadSet1->getReference());
+	BOOST_CHECK(model.loadSets.find(7) == nullptr);
+	BOOST_CHECK_EQUAL(loads.size(), 2);
+	BOOST_CHECK_EQUAL(model.loadSets.filter(LoadSet::Type::LOAD).size(), 1);
+}
+
 BOOST_AUTO_TEST_CASE( test_cdnoanalysis )
 {
     // https://github.com/Alneos/vega/issues/15
@@ -593,6 +707,83 @@ BOOST_AUTO_TEST_CASE( test_globalcs_force )
     BOOST_CHECK_EQUAL(force1.csref, CoordinateSystem::GLOBAL_COORDINATE_SYSTEM);
 }
 
+BOOST_AUTO_TEST_CASE( test_nodal_force_table )
+{
+    Model model{"nodal force table", "10.3", SolverName::NASTRAN};
+    model.mesh.addNode(1, 0.0, 0.0, 0.0);
+    model.mesh.addNode(2, 1.0, 0.0, 0.0);
+    const auto& loadSet = model.getOrCreateLoadSet(1, LoadSet::Type::LOAD);
+    const auto& nodalForces = model.getOrCreateNodalForceTable(loadSet);
+    BOOST_CHECK(model.getOrCreateNodalForceTable(loadSet) == nodalForces);
+    nodalForces->add(2, CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID, VectorialValue(1.0, 0.0, 0.0));
+    nodalForces->add(1, CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID, VectorialValue(0.0, 2.0, 0.0));
+    nodalForces->add(2, CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID, VectorialValue(0.5, 0.0, 0.0),
+            VectorialValue(0.0, 0.0, 3.0));
+    BOOST_CHECK_EQUAL(nodalForces->rowCount(), 3);
+    BOOST_CHECK_EQUAL(model.loadings.size(), 1);
+    BOOST_CHECK_EQUAL(loadSet->getLoadingsByType(Loading::Type::NODAL_FORCE).size(), 1);
+
+    const auto& nodeForces = nodalForces->getForcesInGlobalCS();
+    BOOST_REQUIRE_EQUAL(nodeForces.size(), 2);
+    const pos_t nodePosition2 = model.mesh.findNodePosition(2);
+    BOOST_CHECK_EQUAL(nodeForces[1].nodePosition, nodePosition2);
+    BOOST_CHECK_EQUAL(nodeForces[1].force, VectorialValue(1.5, 0.0, 0.0));
+    BOOST_CHECK_EQUAL(nodeForces[1].moment, VectorialValue(0.0, 0.0, 3.0));
+    BOOST_CHECK_EQUAL(nodalForces->getForceInGlobalCS(nodePosition2), VectorialValue(1.5, 0.0, 0.0));
+    BOOST_CHECK(nodalForces->getDOFSForNode(nodePosition2) == DOFS(DOF::DX) + DOF::RZ);
+
+    const auto& scaled = static_pointer_cast<NodalForceTable>(shared_ptr<Loading>(nodalForces->clone()));
+    scaled->scale(2.0);
+    BOOST_CHECK_EQUAL(scaled->getMomentInGlobalCS(nodePosition2), VectorialValue(0.0, 0.0, 6.0));
+    BOOST_CHECK_EQUAL(nodalForces->getMomentInGlobalCS(nodePosition2), VectorialValue(0.0, 0.0, 3.0));
+    BOOST_CHECK(not nodalForces->ineffective());
+    scaled->scale(0.0);
+    BOOST_CHECK(scaled->ineffective());
+
+    // an unknown coordinate system is reported with the row that uses it
+    BOOST_CHECK(nodalForces->validate());
+    nodalForces->add(1, 99, VectorialValue(1.0, 0.0, 0.0), VectorialValue(0.0, 0.0, 0.0), 123);
+    ostringstream errors;
+    streambuf* previous = cerr.rdbuf(errors.rdbuf());
+    const bool valid = nodalForces->validate();
+    cerr.rdbuf(previous);
+    BOOST_CHECK(not valid);
+    BOOST_CHECK(errors.str().find("(node 1, line 123) not found") != string::npos);
+}
+
+BOOST_AUTO_TEST_CASE( test_spc_groups )
+{
+    Model model{"spc groups", "10.3", SolverName::NASTRAN};
+    model.mesh.addNode(1, 0.0, 0.0, 0.0);
+    model.mesh.addNode(2, 1.0, 0.0, 0.0);
+    model.mesh.addNode(3, 2.0, 0.0, 0.0);
+    const auto& constraintSet = make_shared<ConstraintSet>(model, ConstraintSet::Type::SPC, 1);
+    model.add(constraintSet);
+    const DOFS translations = DOFS::nastranCodeToDOFS(123);
+    const auto& clamped = model.getOrCreateSinglePointConstraint(constraintSet->getReference(), translations, 0.0);
+    clamped->addNodeId(1);
+    model.getOrCreateSinglePointConstraint(constraintSet->getReference(), translations, 0.0)->addNodeId(2);
+    const auto& moved = model.getOrCreateSinglePointConstraint(constraintSet->getReference(), translations, 1.0);
+    moved->addNodeId(3);
+    BOOST_CHECK(clamped != moved);
+    BOOST_CHECK_EQUAL(clamped->nodePositions().size(), 2);
+    BOOST_CHECK_EQUAL(model.constraints.size(), 2);
+    BOOST_CHECK_EQUAL(constraintSet->getConstraintsByType(Constraint::Type::SPC).size(), 2);
+
+    const auto& analysis = make_shared<LinearMecaStat>(model);
+    model.add(analysis);
+    analysis->removeSPCNodeDofs(*clamped, clamped->nodePositions(), DOF::DZ);
+    BOOST_CHECK(clamped->empty());
+    BOOST_CHECK_EQUAL(model.constraints.size(), 3);
+    for (const auto& constraint : constraintSet->getConstraintsByType(Constraint::Type::SPC)) {
+        if (constraint == clamped or constraint == moved) {
+            continue;
+        }
+        BOOST_CHECK_EQUAL(constraint->nodePositions().size(), 2);
+        BOOST_CHECK_EQUAL(constraint->getDOFSForNode(model.mesh.findNodePosition(1)), translations - DOF::DZ);
+    }
+}
+
 BOOST_AUTO_TEST_CASE( test_indentifiable_sort )
 {
     // https://github.com/Alneos/vega/issues/15
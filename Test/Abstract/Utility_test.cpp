@@ -7,6 +7,10 @@
 #include "build_properties.h"
 #include "../../Abstract/Utility.h"
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
 
 using namespace std;
 using namespace vega;
@@ -15,3 +19,134 @@ BOOST_AUTO_TEST_CASE( test_backtrace ) {
 	stacktrace(); // Only to check if this works
 	BOOST_CHECK(true);
 }
+
+BOOST_AUTO_TEST_CASE( test_position_set ) {
+    PositionSet positions;
+    BOOST_CHECK(positions.empty());
+    for (pos_t i = 10; i < 20; i++) {
+        positions.insert(i);
+    }
+    positions.insert(30);
+    BOOST_CHECK_EQUAL(positions.getRuns().size(), 2);
+    positions.insert(5); // out of order
+    positions.insert(15); // already there
+    positions.insert(20); // joins both runs
+    BOOST_CHECK_EQUAL(positions.size(), 13);
+    BOOST_CHECK_EQUAL(positions.getRuns().size(), 3);
+    BOOST_CHECK(positions.contains(20));
+    BOOST_CHECK(not positions.contains(21));
+    BOOST_CHECK_EQUAL(*positions.find(12), 12);
+    BOOST_CHECK(positions.find(4) == positions.end());
+
+    BOOST_CHECK_EQUAL(positions.erase(15), 1);
+    BOOST_CHECK_EQUAL(positions.erase(15), 0);
+    const vector<pos_t> expected = {5, 10, 11, 12, 13, 14, 16, 17, 18, 19, 20, 30};
+    BOOST_CHECK_EQUAL_COLLECTIONS(positions.begin(), positions.end(), expected.begin(), expected.end());
+
+    PositionSet others = {1, 2, 3, 21, 22, 31, 40};
+    positions.insert(others);
+    const vector<pos_t> expectedUnion = {1, 2, 3, 5, 10, 11, 12, 13, 14, 16, 17, 18, 19, 20, 21, 22, 30, 31, 40};
+    BOOST_CHECK_EQUAL_COLLECTIONS(positions.begin(), positions.end(), expectedUnion.begin(), expectedUnion.end());
+    BOOST_CHECK_EQUAL(positions.size(), expectedUnion.size());
+    BOOST_CHECK(positions == PositionSet(expectedUnion.begin(), expectedUnion.end()));
+    BOOST_CHECK(positions < others);
+    positions.insert(Globals::UNAVAILABLE_POS);
+    BOOST_CHECK(positions.contains(Globals::UNAVAILABLE_POS));
+    positions.clear();
+    BOOST_CHECK(positions.empty());
+}
+
+BOOST_AUTO_TEST_CASE( test_position_set_random ) {
+    mt19937 generator(42);
+    uniform_int_distribution<pos_t> distribution(0, 5000);
+    PositionSet positions;
+    set<pos_t> reference;
+    for (int i = 0; i < 20000; i++) {
+        const pos_t position = distribution(generator);
+        if (i % 3 == 0) {
+            BOOST_CHECK_EQUAL(positions.erase(position), reference.erase(position));
+        } else {
+            positions.insert(position);
+            reference.insert(position);
+        }
+    }
+    BOOST_CHECK_EQUAL(positions.size(), reference.size());
+    BOOST_CHECK_EQUAL_COLLECTIONS(positions.begin(), positions.end(), reference.begin(), reference.end());
+}
+
+BOOST_AUTO_TEST_CASE( test_position_set_difference ) {
+    PositionSet positions = {1, 2, 3, 4, 5, 10, 11, 12, 20, 21, 30};
+    // cuts a run in two, removes a whole run and spans two runs
+    BOOST_CHECK_EQUAL(positions.erase(PositionSet{0, 3, 11, 12, 13, 19, 20, 21, 22, 40}), 5);
+    const vector<pos_t> expected = {1, 2, 4, 5, 10, 30};
+    BOOST_CHECK_EQUAL_COLLECTIONS(positions.begin(), positions.end(), expected.begin(), expected.end());
+    BOOST_CHECK_EQUAL(positions.size(), expected.size());
+    BOOST_CHECK_EQUAL(positions.erase(positions), expected.size());
+    BOOST_CHECK(positions.empty());
+
+    mt19937 generator(42);
+    uniform_int_distribution<pos_t> distribution(0, 3000);
+    for (int round = 0; round < 20; round++) {
+        PositionSet left, right;
+        set<pos_t> leftReference, rightReference;
+        for (int i = 0; i < 2000; i++) {
+            const pos_t position = distribution(generator);
+            if (i % 2 == 0) {
+                left.insert(position);
+                leftReference.insert(position);
+            } else {
+                right.insert(position);
+                rightReference.insert(position);
+            }
+        }
+        vector<pos_t> difference;
+        set_difference(leftReference.begin(), leftReference.end(), rightReference.begin(), rightReference.end(),
+                back_inserter(difference));
+        BOOST_CHECK_EQUAL(left.erase(right), leftReference.size() - difference.size());
+        BOOST_CHECK_EQUAL(left.size(), difference.size());
+        BOOST_CHECK_EQUAL_COLLECTIONS(left.begin(), left.end(), difference.begin(), difference.end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_round_trip_double ) {
+    char chars[DOUBLE_CHARS];
+    const vector<pair<double, string>> expected = {{0.0, "0"}, {-0.0, "-0"}, {1.0, "1"}, {0.1, "0.1"},
+            {-2.5, "-2.5"}, {1e-4, "0.0001"}, {1e-5, "1e-05"}, {123456.0, "123456"}, {1e15, "1e+15"},
+            {1.0 / 3, "0.3333333333333333"}, {5e-324, "5e-324"}, {1.7976931348623157e308, "1.7976931348623157e+308"},
+            // Grisu2 is round-trip exact but not always shortest: -3.407736226711167e+16 would read back too
+            {-3.4077362267111672e16, "-3.4077362267111672e+16"}};
+    for (const auto& valueAndText : expected) {
+        BOOST_CHECK_EQUAL(valueAndText.second, string(chars, formatRoundTripDouble(valueAndText.first, chars)));
+    }
+    // reads back to the same value, and never longer than 17 significant digits
+    mt19937_64 generator(42);
+    uniform_real_distribution<double> mantissas(-10.0, 10.0);
+    uniform_int_distribution<int> exponents(-300, 300);
+    for (int i = 0; i < 100000; i++) {
+        const double value = ldexp(mantissas(generator), exponents(generator));
+        const string text(chars, formatRoundTripDouble(value, chars));
+        BOOST_REQUIRE_EQUAL(value, strtod(text.c_str(), nullptr));
+        const string mantissa = text.substr(0, text.find('e'));
+        const auto firstDigit = mantissa.find_first_not_of("-0.");
+        BOOST_REQUIRE(count_if(mantissa.begin() + firstDigit, mantissa.end(), ::isdigit) <= 17);
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_output_file ) {
+    const string path = PROJECT_BINARY_DIR "/Testing/output_file.txt";
+    {
+        OutputFile out(path, ios::out | ios::trunc);
+        out.precision(DBL_DIG);
+        out << 0.1 << " " << 1.0 / 3 << " " << 42 << " " << scientific << 2.5 << endl;
+        OutputFile legacy(path + ".legacy", ios::out | ios::trunc, true);
+        legacy.precision(DBL_DIG);
+        legacy << 0.1 << " " << 1.0 / 3 << endl;
+    }
+    ifstream in(path);
+    string line;
+    getline(in, line);
+    BOOST_CHECK_EQUAL("0.1 0.3333333333333333 42 2.500000000000000e+00", line);
+    ifstream legacyIn(path + ".legacy");
+    getline(legacyIn, line);
+    BOOST_CHECK_EQUAL("0.1 0.333333333333333", line);
+}
@@ -15,6 +15,8 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/filesystem.hpp>
 #include <iostream>
+#include <map>
+#include <random>
 #if VALGRIND_FOUND && defined VDEBUG && defined __GNUC_ && !defined(_WIN32)
 #include <valgrind/memcheck.h>
 #endif
@@ -80,6 +82,86 @@ BOOST_AUTO_TEST_CASE( nastran_med_write ) {
 	}
 }
 
+namespace {
+
+/**
+ * Reads back the coordinates and the HEXA8 connectivity written by MedWriter.
+ */
+void readHexaMesh(const string& medFileName, vector<med_float>& coordinates, vector<med_int>& connectivity) {
+	const char meshname[MED_NAME_SIZE + 1] = "3D unstructured mesh";
+	const med_geometry_type hexa8 = static_cast<med_geometry_type>(CellType::HEXA8.code);
+	med_idt fid = MEDfileOpen(medFileName.c_str(), MED_ACC_RDONLY);
+	BOOST_REQUIRE(fid >= 0);
+	med_bool changement, transformation;
+	const med_int nnodes = MEDmeshnEntity(fid, meshname, MED_NO_DT, MED_NO_IT, MED_NODE, MED_NONE,
+			MED_COORDINATE, MED_NO_CMODE, &changement, &transformation);
+	const med_int ncells = MEDmeshnEntity(fid, meshname, MED_NO_DT, MED_NO_IT, MED_CELL, hexa8,
+			MED_CONNECTIVITY, MED_NODAL, &changement, &transformation);
+	BOOST_REQUIRE(nnodes > 0 and ncells > 0);
+	coordinates.resize(3 * static_cast<size_t>(nnodes));
+	connectivity.resize(8 * static_cast<size_t>(ncells));
+	BOOST_CHECK(MEDmeshNodeCoordinateRd(fid, meshname, MED_NO_DT, MED_NO_IT, MED_FULL_INTERLACE,
+			coordinates.data()) >= 0);
+	BOOST_CHECK(MEDmeshElementConnectivityRd(fid, meshname, MED_NO_DT, MED_NO_IT, MED_CELL, hexa8, MED_NODAL,
+			MED_FULL_INTERLACE, connectivity.data()) >= 0);
+	MEDfileClose(fid);
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( med_write_chunks ) {
+	// 5x4x3 nodes and 4x3x2 HEXA8: a chunk of 7 divides neither count, the last chunks are partial
+	Model model{"chunks", "10.3", SolverName::CODE_ASTER};
+	const int nx = 5, ny = 4, nz = 3;
+	const auto& nodeId = [nx, ny](int i, int j, int k) {return 1 + i + nx * (j + ny * k);};
+	for (int k = 0; k < nz; k++)
+		for (int j = 0; j < ny; j++)
+			for (int i = 0; i < nx; i++)
+				model.mesh.addNode(nodeId(i, j, k), 0.5 * i, 0.25 * j, 2.0 * k);
+	int cellId = 1;
+	for (int k = 0; k < nz - 1; k++)
+		for (int j = 0; j < ny - 1; j++)
+			for (int i = 0; i < nx - 1; i++)
+				model.mesh.addCell(cellId++, CellType::HEXA8, {nodeId(i, j, k), nodeId(i + 1, j, k),
+					nodeId(i + 1, j + 1, k), nodeId(i, j + 1, k), nodeId(i, j, k + 1), nodeId(i + 1, j, k + 1),
+					nodeId(i + 1, j + 1, k + 1), nodeId(i, j + 1, k + 1)});
+	const size_t nnodes = static_cast<size_t>(nx * ny * nz);
+	const size_t ncells = static_cast<size_t>(cellId - 1);
+	BOOST_REQUIRE_NE(nnodes % 7, 0u);
+	BOOST_REQUIRE_NE(ncells % 7, 0u);
+
+	const string wholeFile = fs::path(PROJECT_BINARY_DIR "/bin/chunks_whole.med").make_preferred().string();
+	MedWriter().writeMED(model, wholeFile);
+	vector<med_float> wholeCoordinates;
+	vector<med_int> wholeConnectivity;
+	readHexaMesh(wholeFile, wholeCoordinates, wholeConnectivity);
+	BOOST_REQUIRE_EQUAL(wholeCoordinates.size(), 3 * nnodes);
+	BOOST_REQUIRE_EQUAL(wholeConnectivity.size(), 8 * ncells);
+
+	// one entity by chunk, partial last chunks, and a chunk larger than every count
+	for (const size_t chunkSize : {size_t(1), size_t(7), nnodes + ncells}) {
+		BOOST_TEST_CHECKPOINT("chunk size " << chunkSize);
+		const string chunkedFile = fs::path(PROJECT_BINARY_DIR "/bin/chunks_" + to_string(chunkSize)
+				+ ".med").make_preferred().string();
+		MedWriter(chunkSize).writeMED(model, chunkedFile);
+		vector<med_float> chunkedCoordinates;
+		vector<med_int> chunkedConnectivity;
+		readHexaMesh(chunkedFile, chunkedCoordinates, chunkedConnectivity);
+		BOOST_CHECK_EQUAL_COLLECTIONS(wholeCoordinates.begin(), wholeCoordinates.end(),
+				chunkedCoordinates.begin(), chunkedCoordinates.end());
+		BOOST_CHECK_EQUAL_COLLECTIONS(wholeConnectivity.begin(), wholeConnectivity.end(),
+				chunkedConnectivity.begin(), chunkedConnectivity.end());
+	}
+
+	// Spot checks against the mesh: last node, and first node of the last cell (med numbering starts at 1)
+	const pos_t lastNode = model.mesh.findNodePosition(nodeId(nx - 1, ny - 1, nz - 1));
+	BOOST_CHECK_EQUAL(wholeCoordinates[3 * lastNode], 0.5 * (nx - 1));
+	BOOST_CHECK_EQUAL(wholeCoordinates[3 * lastNode + 1], 0.25 * (ny - 1));
+	BOOST_CHECK_EQUAL(wholeCoordinates[3 * lastNode + 2], 2.0 * (nz - 1));
+	BOOST_CHECK_EQUAL(wholeConnectivity[8 * (ncells - 1)],
+			static_cast<med_int>(model.mesh.findNodePosition(nodeId(nx - 2, ny - 2, nz - 2))) + 1);
+}
+
 BOOST_AUTO_TEST_CASE( test_NodeGroup2Families )
 {
     Mesh mesh(LogLevel::INFO, "test");
@@ -107,6 +189,141 @@ BOOST_AUTO_TEST_CASE( test_NodeGroup2Families )
     BOOST_CHECK(famGN1_GN2_found);
 }
 
+BOOST_AUTO_TEST_CASE( test_NodeGroup2Families_overlapping )
+{
+    Mesh mesh(LogLevel::INFO, "test");
+    vector<shared_ptr<NodeGroup>> nodeGroups;
+    const vector<vector<pos_t>> positionsByGroup = {{0, 1, 2, 3}, {2, 3, 4}, {1, 3, 4, 5, 9}};
+    for (size_t i = 0; i < positionsByGroup.size(); i++) {
+        const auto& group = mesh.findOrCreateNodeGroup("G" + to_string(i + 1));
+        for (const pos_t position : positionsByGroup[i]) {
+            group->addNodeByPosition(position);
+        }
+        nodeGroups.push_back(group);
+    }
+    // position 9 is out of the nodes and ignored
+    NodeGroup2Families ng(6, nodeGroups);
+    // numbered as if groups were assigned one after the other: family 3 (G2 alone) is split by G3
+    med_int expected[] = { 1, 4, 2, 5, 6, 7 };
+    const auto& result = ng.getFamilyOnNodes();
+    BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), expected, expected + 6);
+    const vector<string> expectedNames = {"G1", "G1_G2", "G1_G3", "G1_G2_G3", "G2_G3", "G3"};
+    const auto& families = ng.getFamilies();
+    BOOST_REQUIRE_EQUAL(expectedNames.size(), families.size());
+    for (size_t i = 0; i < families.size(); i++) {
+        BOOST_CHECK_EQUAL(expectedNames[i], families[i].name);
+    }
+    BOOST_CHECK_EQUAL(3u, families[3].groups.size());
+}
+
+namespace {
+
+/**
+ * Reference numbering: groups assigned one after the other, each one splitting the families of its
+ * entities. Also gives, for each entity, the family created by each of its groups.
+ */
+vector<med_int> sequentialFamilies(const size_t entityCount, const vector<vector<pos_t>>& positionsByGroup,
+		vector<vector<pair<size_t, med_int>>>& createdByEntity) {
+	vector<med_int> result(entityCount, 0);
+	createdByEntity.assign(entityCount, {});
+	med_int lastFamily = 0;
+	for (size_t groupIndex = 0; groupIndex < positionsByGroup.size(); groupIndex++) {
+		map<med_int, med_int> splitFamilies;
+		for (const pos_t entity : positionsByGroup[groupIndex]) {
+			auto split = splitFamilies.find(result[entity]);
+			if (split == splitFamilies.end()) {
+				split = splitFamilies.insert({result[entity], ++lastFamily}).first;
+			}
+			result[entity] = split->second;
+			createdByEntity[entity].push_back({groupIndex, split->second});
+		}
+	}
+	return result;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( test_NodeGroup2Families_random )
+{
+	// Enough memberships for the threaded path, and names long enough to be truncated
+	const size_t nodeCount = 50000;
+	const size_t groupCount = 12;
+	Mesh mesh(LogLevel::INFO, "test");
+	mt19937 generator(20181129);
+	bernoulli_distribution inGroup(0.3);
+	vector<vector<pos_t>> positionsByGroup(groupCount);
+	vector<shared_ptr<NodeGroup>> nodeGroups;
+	size_t membershipCount = 0;
+	for (size_t groupIndex = 0; groupIndex < groupCount; groupIndex++) {
+		const auto& group = mesh.findOrCreateNodeGroup("RANDOM_GROUP_WITH_A_LONG_NAME_" + to_string(groupIndex));
+		for (pos_t position = 0; position < static_cast<pos_t>(nodeCount); position++) {
+			if (inGroup(generator)) {
+				positionsByGroup[groupIndex].push_back(position);
+				group->addNodeByPosition(position);
+			}
+		}
+		membershipCount += positionsByGroup[groupIndex].size();
+		nodeGroups.push_back(group);
+	}
+	BOOST_REQUIRE(membershipCount >= 100000);
+	vector<vector<pair<size_t, med_int>>> createdByNode;
+	const auto& expected = sequentialFamilies(nodeCount, positionsByGroup, createdByNode);
+
+	NodeGroup2Families ng(static_cast<med_int>(nodeCount), nodeGroups);
+	const auto& result = ng.getFamilyOnNodes();
+	BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), expected.begin(), expected.end());
+
+	map<med_int, string> expectedNames;
+	for (size_t node = 0; node < nodeCount; node++) {
+		if (expected[node] == 0 or expectedNames.find(expected[node]) != expectedNames.end()) {
+			continue;
+		}
+		string name;
+		for (const auto& created : createdByNode[node]) {
+			const string& groupName = nodeGroups[created.first]->getName();
+			if (name.empty()) {
+				name = groupName;
+			} else {
+				name += "_" + groupName;
+				if (name.length() >= MED_LNAME_SIZE) {
+					name = "Family" + to_string(created.second);
+				}
+			}
+		}
+		expectedNames[expected[node]] = name;
+	}
+	const auto& families = ng.getFamilies();
+	BOOST_REQUIRE_EQUAL(expectedNames.size(), families.size());
+	bool truncatedFound = false;
+	auto expectedName = expectedNames.begin();
+	for (const auto& family : families) {
+		BOOST_CHECK_EQUAL(expectedName->first, family.num);
+		BOOST_CHECK_EQUAL(expectedName->second, family.name);
+		truncatedFound |= family.name.compare(0, 6, "Family") == 0;
+		++expectedName;
+	}
+	BOOST_CHECK(truncatedFound);
+
+	// Hashes reduced to 2 bits: prefixes collide all the time and must still be told apart
+	vector<PositionSet> positionSets;
+	for (const auto& nodeGroup : nodeGroups) {
+		positionSets.push_back(nodeGroup->nodePositions());
+	}
+	vector<const PositionSet*> groupPositions;
+	for (const auto& positionSet : positionSets) {
+		groupPositions.push_back(&positionSet);
+	}
+	const GroupSignatures colliding(nodeCount, groupPositions, 0x3);
+	BOOST_CHECK(colliding.getThreadCount() >= 1);
+	size_t mismatches = 0;
+	for (pos_t node = 0; node < static_cast<pos_t>(nodeCount); node++) {
+		if (colliding.familyNumber(node) != expected[node]) {
+			mismatches++;
+		}
+	}
+	BOOST_CHECK_EQUAL(0u, mismatches);
+}
+
 BOOST_AUTO_TEST_CASE( test_CellGroup2Families )
 {
     Mesh mesh(LogLevel::INFO, "test");
@@ -13,6 +13,7 @@
 #include "build_properties.h"
 #include <boost/test/unit_test.hpp>
 #include <boost/filesystem.hpp>
+#include <fstream>
 #include <iostream>
 #if VALGRIND_FOUND && defined VDEBUG && defined __GNUC_ && !defined(_WIN32)
 #include <valgrind/memcheck.h>
@@ -63,6 +64,49 @@ BOOST_AUTO_TEST_CASE( test_include ) {
 	//expected 1 material elastic
 }
 
+BOOST_AUTO_TEST_CASE( test_many_includes ) {
+    // More INCLUDE files than the read ahead of two threads, some of them nested, and one in the
+    // case control section: the threads must fill the mesh in the serial order
+    const fs::path directory = fs::temp_directory_path() / fs::unique_path("includes_%%%%%%");
+    fs::create_directories(directory);
+    {
+        ofstream caseControl((directory / "case.dat").string());
+        caseControl << "TITLE = MANY INCLUDES\n";
+        ofstream master((directory / "master.dat").string());
+        master << "SOL 101\nCEND\nINCLUDE 'case.dat'\nBEGIN BULK\n";
+        int nodeId = 1;
+        for (int part = 0; part < 20; part++) {
+            const string partName = "part" + to_string(part) + ".dat";
+            master << "INCLUDE '" << partName << "'\n";
+            ofstream partFile((directory / partName).string());
+            partFile << "GRID    " << nodeId++ << "               0.0     0.0     0.0\n";
+            if (part % 4 == 0) {
+                const string nestedName = "nested" + to_string(part) + ".dat";
+                partFile << "INCLUDE '" << nestedName << "'\n";
+                ofstream nestedFile((directory / nestedName).string());
+                nestedFile << "GRID    " << nodeId++ << "               1.0     0.0     0.0\n";
+            }
+            partFile << "GRID    " << nodeId++ << "               2.0     0.0     0.0\n";
+        }
+        master << "ENDDATA\n";
+    }
+    const auto& parseWithThreads = [&directory](int threads) {
+        nastran::NastranParser parser;
+        return parser.parse(ConfigurationParameters{(directory / "master.dat").string(), SolverName::CODE_ASTER, "",
+            "vega", ".", LogLevel::INFO, ConfigurationParameters::TranslationMode::BEST_EFFORT, "", 0.02, false, false,
+            "", "", false, "lagrangian", 0.0, 0.0, "auto", "systus", {}, "table", 9, "auto", "cosmic95", "mmap", threads});
+    };
+    const unique_ptr<Model> serial = parseWithThreads(1);
+    const unique_ptr<Model> parallel = parseWithThreads(2);
+    fs::remove_all(directory);
+    BOOST_REQUIRE_EQUAL(serial->mesh.countNodes(), 45);
+    BOOST_REQUIRE_EQUAL(parallel->mesh.countNodes(), 45);
+    for (pos_t position = 0; position < serial->mesh.countNodes(); position++) {
+        BOOST_CHECK_EQUAL(serial->mesh.findNode(position).id, static_cast<int>(position) + 1);
+        BOOST_CHECK_EQUAL(parallel->mesh.findNode(position).id, static_cast<int>(position) + 1);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(test_comments_in_the_end) {
 	//a short version of Optistruct test, that fails in windows
 	string testLocation = fs::path(
@@ -308,3 +352,69 @@ BOOST_AUTO_TEST_CASE(test_github_issue28_conm2_coord) {
 
 
 //____________________________________________________________________________//
+
+BOOST_AUTO_TEST_CASE(test_parallel_geometry_same_mesh) {
+    // The geometry cards converted by several threads, and the INCLUDE files read ahead of time,
+    // must give exactly the serial mesh
+    const vector<string> decks = {
+            "/irt/minirbs/minirbs_old.bdf",
+            "/irt/aero2728/Bulk_DFEM.bdf",
+            "/irt/cantibox/cantibox.nas",
+            "/irt/ssnv104i/ssnv104i.bdf",
+            "/alneos/test4a/test4a.dat",
+            "/irt/aero2728/aero2728.nas",
+            "/irt/nas102prob6/nas102prob6.nas",
+            "/irt/cord2c/INPUT.dat",
+            "/caw/prob19/prob19.dat",
+    };
+    for (const auto& deck : decks) {
+        const string testLocation = fs::path(PROJECT_BASE_DIR "/testdata/nastran" + deck).make_preferred().string();
+        const auto& parseWithThreads = [&testLocation](int threads) {
+            nastran::NastranParser parser;
+            return parser.parse(ConfigurationParameters{testLocation, SolverName::CODE_ASTER, "", "vega", ".",
+                LogLevel::INFO, ConfigurationParameters::TranslationMode::BEST_EFFORT, "", 0.02, false, false, "", "",
+                false, "lagrangian", 0.0, 0.0, "auto", "systus", {}, "table", 9, "auto", "cosmic95", "mmap", threads});
+        };
+        const auto& coordinateSystemId = [](const Model& model, pos_t position) {
+            return position == CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID ? CoordinateSystem::GLOBAL_COORDINATE_SYSTEM_ID
+                    : model.mesh.getCoordinateSystemByPosition(position)->getOriginalId();
+        };
+        const unique_ptr<Model> serial = parseWithThreads(1);
+        const unique_ptr<Model> parallel = parseWithThreads(4);
+        BOOST_TEST_CHECKPOINT(deck);
+        BOOST_REQUIRE_EQUAL(serial->mesh.countNodes(), parallel->mesh.countNodes());
+        for (pos_t position = 0; position < serial->mesh.countNodes(); position++) {
+            const Node& serialNode = serial->mesh.findNode(position);
+            const Node& parallelNode = parallel->mesh.findNode(position);
+            BOOST_CHECK_EQUAL(serialNode.id, parallelNode.id);
+            BOOST_CHECK_EQUAL(serialNode.lx, parallelNode.lx);
+            BOOST_CHECK_EQUAL(serialNode.ly, parallelNode.ly);
+            BOOST_CHECK_EQUAL(serialNode.lz, parallelNode.lz);
+            // Coordinate system positions are numbered for all the models: compare their ids
+            BOOST_CHECK_EQUAL(coordinateSystemId(*serial, serialNode.positionCS), coordinateSystemId(*parallel, parallelNode.positionCS));
+            BOOST_CHECK_EQUAL(coordinateSystemId(*serial, serialNode.displacementCS), coordinateSystemId(*parallel, parallelNode.displacementCS));
+        }
+        BOOST_REQUIRE_EQUAL(serial->mesh.countCells(), parallel->mesh.countCells());
+        for (pos_t position = 0; position < serial->mesh.countCells(); position++) {
+            const Cell& serialCell = serial->mesh.findCell(position);
+            const Cell& parallelCell = parallel->mesh.findCell(position);
+            BOOST_CHECK_EQUAL(serialCell.id, parallelCell.id);
+            BOOST_CHECK(serialCell.type == parallelCell.type);
+            BOOST_CHECK_EQUAL(serialCell.elementId, parallelCell.elementId);
+            BOOST_CHECK_EQUAL(serialCell.offset, parallelCell.offset);
+            BOOST_CHECK_EQUAL_COLLECTIONS(serialCell.nodePositions.begin(), serialCell.nodePositions.end(),
+                    parallelCell.nodePositions.begin(), parallelCell.nodePositions.end());
+        }
+        const auto& serialGroups = serial->mesh.getCellGroups();
+        const auto& parallelGroups = parallel->mesh.getCellGroups();
+        BOOST_REQUIRE_EQUAL(serialGroups.size(), parallelGroups.size());
+        for (size_t i = 0; i < serialGroups.size(); i++) {
+            BOOST_CHECK_EQUAL(serialGroups[i]->getName(), parallelGroups[i]->getName());
+            BOOST_CHECK_EQUAL(serialGroups[i]->comment, parallelGroups[i]->comment);
+            const auto& serialIds = serialGroups[i]->cellIds();
+            const auto& parallelIds = parallelGroups[i]->cellIds();
+            BOOST_CHECK(serialIds == parallelIds);
+        }
+        BOOST_CHECK_EQUAL(serial->constraints.size(), parallel->constraints.size());
+    }
+}
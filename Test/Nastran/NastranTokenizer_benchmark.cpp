@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) Alneos, s. a r. l. (contact@alneos.fr)
+ * Released under the GNU General Public License
+ *
+ * NastranTokenizer_benchmark.cpp
+ *
+ * Compares the in place numeric scanner with the former lexical_cast conversion on the numeric fields
+ * of the testdata/nastran decks. Timings depend on the machine: this is not a ctest test.
+ *
+ * Usage: NastranTokenizer_benchmark [repetitions]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "build_properties.h"
+#include "NastranTokenizer_test.h"
+
+using namespace std;
+using namespace vega::nastran;
+
+int main(int argc, char* argv[]) {
+    const int repetitions = argc > 1 ? atoi(argv[1]) : 20;
+    const vector<string>& fields = collectNumericFields(PROJECT_BASE_DIR "/testdata/nastran");
+    if (fields.empty() or repetitions <= 0) {
+        cerr << "No numeric field found, or invalid repetition count" << endl;
+        return 1;
+    }
+    using Clock = chrono::steady_clock;
+    double value = 0.0;
+    double legacySum = 0.0;
+    size_t legacyValid = 0;
+    const auto legacyStart = Clock::now();
+    for (int repetition = 0; repetition < repetitions; repetition++) {
+        for (const auto& field : fields) {
+            if (legacyNastranDouble(field, value)) {
+                legacySum += value;
+                legacyValid++;
+            }
+        }
+    }
+    const auto legacyTime = Clock::now() - legacyStart;
+
+    double scannedSum = 0.0;
+    size_t scannedValid = 0;
+    const auto scannerStart = Clock::now();
+    for (int repetition = 0; repetition < repetitions; repetition++) {
+        for (const auto& field : fields) {
+            if (scanNastranDouble(field, value)) {
+                scannedSum += value;
+                scannedValid++;
+            }
+        }
+    }
+    const auto scannerTime = Clock::now() - scannerStart;
+
+    const auto legacyMicros = chrono::duration_cast<chrono::microseconds>(legacyTime).count();
+    const auto scannerMicros = chrono::duration_cast<chrono::microseconds>(scannerTime).count();
+    cout << fields.size() << " numeric fields x " << repetitions << endl;
+    cout << "lexical_cast: " << legacyMicros << "us (" << legacyValid << " valid, sum " << legacySum << ")" << endl;
+    cout << "scanner:      " << scannerMicros << "us (" << scannedValid << " valid, sum " << scannedSum << ")" << endl;
+    if (scannerMicros > 0) {
+        cout << "speedup:      " << static_cast<double>(legacyMicros) / static_cast<double>(scannerMicros) << endl;
+    }
+    return legacyValid == scannedValid ? 0 : 1;
+}
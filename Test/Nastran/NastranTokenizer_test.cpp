@@ -24,11 +24,14 @@
 #define BOOST_TEST_MODULE nastran_tokenizer_tests
 #include <boost/test/unit_test.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 #include <cstddef>
 #include <fstream>
 #include <vector>
 #include "build_properties.h"
 #include "../../Nastran/NastranTokenizer.h"
+#include "NastranTokenizer_test.h"
 
 namespace fs = boost::filesystem;
 using namespace std;
@@ -493,3 +496,187 @@ BOOST_AUTO_TEST_CASE(nastran_cord2c_multiline) {
     BOOST_CHECK_EQUAL(100.0, tok.nextDouble());
     BOOST_CHECK_EQUAL(0.0, tok.nextDouble());
 }
+
+BOOST_AUTO_TEST_CASE(nastran_mapped_file_long_format_continuation) {
+    const fs::path deckPath = fs::temp_directory_path() / fs::unique_path("mapped_%%%%%%.bdf");
+    {
+        ofstream deck(deckPath.string());
+        deck << "$ mapped deck\n"
+                "GRID*                  1               0 1.0000000000+00 2.0000000000+00\n"
+                "*                3.0D+00\n"
+                "GRID\t2\t\t4.\t5.\t6.\n";
+    }
+    {
+        MappedInputFile mappedFile(deckPath.string());
+        NastranTokenizer tok(mappedFile);
+        tok.bulkSection();
+        tok.nextLine();
+        BOOST_CHECK_EQUAL("GRID", tok.nextString());
+        BOOST_CHECK_EQUAL(1, tok.nextInt());
+        BOOST_CHECK_EQUAL(0, tok.nextInt());
+        BOOST_CHECK_EQUAL(1.0, tok.nextDouble());
+        BOOST_CHECK_EQUAL(2.0, tok.nextDouble());
+        BOOST_CHECK_EQUAL(3.0, tok.nextDouble());
+        tok.nextLine();
+        BOOST_CHECK_EQUAL("GRID", tok.nextString());
+        BOOST_CHECK_EQUAL(2, tok.nextInt());
+        BOOST_CHECK(tok.isNextEmpty());tok.skip(1);
+        BOOST_CHECK_EQUAL(4.0, tok.nextDouble());
+        BOOST_CHECK_EQUAL(5.0, tok.nextDouble());
+        BOOST_CHECK_EQUAL(6.0, tok.nextDouble());
+        BOOST_CHECK_EQUAL("GRID\t2\t\t4.\t5.\t6.", tok.currentRawDataLine());
+        tok.nextLine();
+        BOOST_CHECK(tok.nextSymbolType == NastranTokenizer::SymbolType::SYMBOL_EOF);
+    }
+    fs::remove(deckPath);
+}
+
+BOOST_AUTO_TEST_CASE(nastran_mapped_file_same_fields_as_stream) {
+    // Every test deck must be split in exactly the same fields by both reading modes
+    int deckCount = 0;
+    for (fs::recursive_directory_iterator it(PROJECT_BASE_DIR "/testdata/nastran"), end; it != end; ++it) {
+        const string extension = it->path().extension().string();
+        if (extension != ".dat" and extension != ".nas" and extension != ".bdf") {
+            continue;
+        }
+        const string deckPath = it->path().string();
+        ifstream istr(deckPath);
+        NastranTokenizer streamTok(istr, LogLevel::INFO, deckPath);
+        MappedInputFile mappedFile(deckPath);
+        NastranTokenizer mappedTok(mappedFile, LogLevel::INFO, deckPath);
+        streamTok.bulkSection();
+        mappedTok.bulkSection();
+        deckCount++;
+        try {
+            while (streamTok.nextSymbolType != NastranTokenizer::SymbolType::SYMBOL_EOF) {
+                streamTok.nextLine();
+                mappedTok.nextLine();
+                BOOST_REQUIRE(streamTok.nextSymbolType == mappedTok.nextSymbolType);
+                BOOST_REQUIRE_EQUAL(streamTok.getLineNumber(), mappedTok.getLineNumber());
+                BOOST_REQUIRE_EQUAL(streamTok.currentRawDataLine(), mappedTok.currentRawDataLine());
+                const auto& streamFields = streamTok.currentDataLine();
+                const auto& mappedFields = mappedTok.currentDataLine();
+                BOOST_REQUIRE_EQUAL_COLLECTIONS(streamFields.begin(), streamFields.end(),
+                        mappedFields.begin(), mappedFields.end());
+            }
+        } catch (std::string&) {
+            // Malformed continuation: both tokenizers must have stopped on the same line
+            BOOST_CHECK_EQUAL(streamTok.getLineNumber(), mappedTok.getLineNumber());
+        }
+        BOOST_CHECK(streamTok.labelByCommentTypeAndId == mappedTok.labelByCommentTypeAndId);
+    }
+    BOOST_CHECK(deckCount > 0);
+}
+
+BOOST_AUTO_TEST_CASE(nastran_preread_cards_replay) {
+    // Cards replayed from PrereadCards must look exactly as read from the input, with their labels
+    string nastranText = "GRID    1               0.      0.      0.\n"
+            "$HMNAME COMP                   2\"Skin\"\n"
+            "CQUAD4  1       2       1       2       3       4\n"
+            "GRID           2\n"
+            "       ,0., 1.,\n";
+    istringstream prereadStream(nastranText);
+    NastranTokenizer prereadTok(prereadStream);
+    prereadTok.bulkSection();
+    prereadTok.nextLine();
+    PrereadCards cards;
+    prereadTok.prereadBulkCards(cards);
+    BOOST_CHECK_EQUAL(3, cards.size());
+    BOOST_CHECK_EQUAL("CQUAD4", cards.keyword(1));
+
+    istringstream istr(nastranText);
+    NastranTokenizer tok(istr);
+    NastranTokenizer replayTok(cards);
+    tok.bulkSection();
+    replayTok.bulkSection();
+    tok.nextLine();
+    replayTok.nextLine();
+    while (tok.nextSymbolType != NastranTokenizer::SymbolType::SYMBOL_EOF) {
+        BOOST_REQUIRE(tok.nextSymbolType == replayTok.nextSymbolType);
+        BOOST_CHECK_EQUAL(tok.getLineNumber(), replayTok.getLineNumber());
+        BOOST_CHECK_EQUAL(tok.currentRawDataLine(), replayTok.currentRawDataLine());
+        const auto& fields = tok.currentDataLine();
+        const auto& replayFields = replayTok.currentDataLine();
+        BOOST_CHECK_EQUAL_COLLECTIONS(fields.begin(), fields.end(), replayFields.begin(), replayFields.end());
+        BOOST_CHECK(tok.labelByCommentTypeAndId == replayTok.labelByCommentTypeAndId);
+        tok.nextLine();
+        replayTok.nextLine();
+    }
+    BOOST_CHECK(replayTok.nextSymbolType == NastranTokenizer::SymbolType::SYMBOL_EOF);
+}
+
+BOOST_AUTO_TEST_CASE(nastran_deferred_strict_errors) {
+    // A reading thread must not exit in strict mode: the error is thrown, then raised again by the replay
+    string nastranText = "GRID    ABC             0.      0.      0.\n";
+    istringstream istr(nastranText);
+    NastranTokenizer tok(istr, LogLevel::INFO, "UNKNOWN", ConfigurationParameters::TranslationMode::MODE_STRICT);
+    tok.deferParsingErrors();
+    tok.bulkSection();
+    tok.nextLine();
+    tok.nextString();
+    PrereadCards cards;
+    try {
+        tok.nextInt();
+        BOOST_FAIL("ParsingException expected");
+    } catch (...) {
+        cards.error = current_exception();
+    }
+    BOOST_CHECK_THROW(rethrow_exception(cards.error), ParsingException);
+
+    NastranTokenizer replayTok(cards);
+    replayTok.bulkSection();
+    BOOST_CHECK_THROW(replayTok.nextLine(), ParsingException);
+}
+
+BOOST_AUTO_TEST_CASE(nastran_numeric_scanner) {
+    int intValue = 0;
+    BOOST_CHECK(scanNastranInt("  42 ", intValue));
+    BOOST_CHECK_EQUAL(42, intValue);
+    BOOST_CHECK(scanNastranInt("-2147483648", intValue));
+    BOOST_CHECK_EQUAL(numeric_limits<int>::min(), intValue);
+    BOOST_CHECK(scanNastranInt("+7", intValue));
+    BOOST_CHECK_EQUAL(7, intValue);
+    BOOST_CHECK(not scanNastranInt("2147483648", intValue));
+    BOOST_CHECK(not scanNastranInt("1.", intValue));
+    BOOST_CHECK(not scanNastranInt("-", intValue));
+    BOOST_CHECK(not scanNastranInt("  ", intValue));
+    BOOST_CHECK_EQUAL(7, intValue);
+
+    double doubleValue = 0.0;
+    BOOST_CHECK(scanNastranDouble("1.5-3", doubleValue));
+    BOOST_CHECK_EQUAL(1.5e-3, doubleValue);
+    BOOST_CHECK(scanNastranDouble("-.2+1", doubleValue));
+    BOOST_CHECK_EQUAL(-2.0, doubleValue);
+    BOOST_CHECK(scanNastranDouble("1.5D+3", doubleValue));
+    BOOST_CHECK_EQUAL(1500.0, doubleValue);
+    BOOST_CHECK(scanNastranDouble("7.d-1", doubleValue));
+    BOOST_CHECK_EQUAL(0.7, doubleValue);
+    BOOST_CHECK(scanNastranDouble(" 1 .2 5 E- 1", doubleValue));
+    BOOST_CHECK_EQUAL(0.125, doubleValue);
+    BOOST_CHECK(scanNastranDouble("3", doubleValue));
+    BOOST_CHECK_EQUAL(3.0, doubleValue);
+    BOOST_CHECK(not scanNastranDouble("1.5E", doubleValue));
+    BOOST_CHECK(not scanNastranDouble("1.2.3", doubleValue));
+    BOOST_CHECK(not scanNastranDouble("+-1", doubleValue));
+    BOOST_CHECK(not scanNastranDouble(".E5", doubleValue));
+    BOOST_CHECK(not scanNastranDouble("1.E5-2", doubleValue));
+    BOOST_CHECK(not scanNastranDouble("THRU", doubleValue));
+    BOOST_CHECK(not scanNastranDouble("", doubleValue));
+    BOOST_CHECK_EQUAL(3.0, doubleValue);
+}
+
+BOOST_AUTO_TEST_CASE(nastran_numeric_scanner_matches_lexical_cast) {
+    const vector<string>& fields = collectNumericFields(PROJECT_BASE_DIR "/testdata/nastran");
+    BOOST_REQUIRE(not fields.empty());
+
+    for (const auto& field : fields) {
+        double legacyValue = 0.0;
+        double scannedValue = 0.0;
+        const bool legacyValid = legacyNastranDouble(field, legacyValue);
+        const bool scannedValid = scanNastranDouble(field, scannedValue);
+        BOOST_CHECK_MESSAGE(legacyValid == scannedValid, "Field [" + field + "] validity differs");
+        if (legacyValid and scannedValid) {
+            BOOST_CHECK_EQUAL(legacyValue, scannedValue);
+        }
+    }
+}
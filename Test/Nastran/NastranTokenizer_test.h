@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) Alneos, s. a r. l. (contact@alneos.fr)
+ * Released under the GNU General Public License
+ *
+ * NastranTokenizer_test.h
+ *
+ * Numeric fields of the test decks and the conversion done before the in place scanner,
+ * shared by the tokenizer test and benchmark.
+ */
+
+#ifndef NASTRANTOKENIZER_TEST_H_
+#define NASTRANTOKENIZER_TEST_H_
+
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../../Nastran/NastranTokenizer.h"
+
+/**
+ * Conversion done by nextDouble before the in place scanner, kept as a reference.
+ */
+inline bool legacyNastranDouble(const std::string& field, double& result) {
+    std::string value = boost::trim_copy(field);
+    boost::replace_all(value, "d", "e");
+    boost::replace_all(value, "D", "E");
+    boost::algorithm::erase_all(value, " ");
+    size_t position = value.find_first_of("+-", 1);
+    if (position != std::string::npos and position != value.find_first_of("eE", 1) + 1) {
+        value.insert(position, "E");
+    }
+    try {
+        result = boost::lexical_cast<double>(value);
+    } catch (boost::bad_lexical_cast &) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Collects the numeric fields of all the decks found under directory.
+ */
+inline std::vector<std::string> collectNumericFields(const std::string& directory) {
+    using vega::nastran::NastranTokenizer;
+    std::vector<std::string> fields;
+    for (boost::filesystem::recursive_directory_iterator it(directory), end; it != end; ++it) {
+        const std::string extension = it->path().extension().string();
+        if (extension != ".dat" and extension != ".nas" and extension != ".bdf") {
+            continue;
+        }
+        std::ifstream istr(it->path().string());
+        NastranTokenizer tok(istr);
+        tok.bulkSection();
+        try {
+            while (tok.nextSymbolType != NastranTokenizer::SymbolType::SYMBOL_EOF) {
+                tok.nextLine();
+                for (const auto& field : tok.currentFields()) {
+                    const std::string value = boost::trim_copy(field.to_string());
+                    if (not value.empty() and value.find_first_not_of("+-0123456789.eEdD ") == std::string::npos) {
+                        fields.push_back(field.to_string());
+                    }
+                }
+            }
+        } catch (std::string&) {
+            // Malformed test decks: keep the fields read so far
+        }
+    }
+    return fields;
+}
+
+#endif /* NASTRANTOKENIZER_TEST_H_ */
@@ -10,10 +10,13 @@
 
 #define BOOST_TEST_MODULE nastran_parser_tests
 #include "../../Nastran/NastranWriter.h"
+#include "../../Nastran/NastranParser.h"
 #include "build_properties.h"
 #include <boost/test/unit_test.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/algorithm/string.hpp>
 #include <iostream>
+#include <regex>
 #if VALGRIND_FOUND && defined VDEBUG && defined __GNUC_ && !defined(_WIN32)
 #include <valgrind/memcheck.h>
 #endif
@@ -31,4 +34,80 @@ BOOST_AUTO_TEST_CASE( test_float_write ) {
 }
 
 
+namespace {
+
+/**
+ * Continuation markers are numbered by a counter shared by all the cards: they are renumbered from 1
+ * (keeping the width of the fields) before comparing outputs.
+ */
+string renumberContinuations(const string& cards) {
+    static const regex continuation("\\+(\\d+)\n\\+\\1");
+    string result;
+    int counter = 0;
+    auto last = cards.cbegin();
+    for (sregex_iterator it(cards.begin(), cards.end(), continuation), end; it != end; ++it) {
+        result.append(last, (*it)[0].first);
+        const string number = to_string(++counter);
+        const size_t originalLength = static_cast<size_t>((*it)[1].length());
+        result += "+" + number + "\n+" + number + string(originalLength > number.size() ? originalLength - number.size() : 0, ' ');
+        last = (*it)[0].second;
+    }
+    result.append(last, cards.cend());
+    return result;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( test_card_writer ) {
+    std::ostringstream strs;
+    {
+        CardWriter cards(strs);
+        cards.card("GRID").add(3.141593);
+        cards.card("GRID*").add(-5).add().add("ab").add(-0.5).add(1e20).add(7).add(DOF::DX + DOF::RZ);
+    }
+    const string expected = "GRID    3.1416+0\n"
+            "GRID*   -              5                              ab           -5.-1+1\n"
+            "+1                         1.+20               7              16\n";
+    BOOST_CHECK_EQUAL(expected, renumberContinuations(strs.str()));
+}
+
+BOOST_AUTO_TEST_CASE( test_card_writer_decks ) {
+    // Same output as Line for all the nodes and cells of the test decks, in small and large fields
+    size_t deckCount = 0;
+    for (fs::recursive_directory_iterator it(PROJECT_BASE_DIR "/testdata"), end; it != end; ++it) {
+        const string extension = boost::algorithm::to_lower_copy(it->path().extension().string());
+        if (not fs::is_regular_file(it->path()) or (extension != ".nas" and extension != ".dat" and extension != ".bdf")) {
+            continue;
+        }
+        shared_ptr<Model> model;
+        try {
+            nastran::NastranParser parser;
+            model = parser.parse(ConfigurationParameters{it->path().string(), SolverName::CODE_ASTER, "", "vega", ".", LogLevel::ERROR});
+        } catch (exception&) {
+            continue; // not a Nastran deck, or not supported
+        }
+        deckCount++;
+        ostringstream lines;
+        ostringstream buffered;
+        {
+            CardWriter cards(buffered);
+            for (const string keyword : {"GRID", "GRID*"}) {
+                for (const Node& node : model->mesh.nodes) {
+                    lines << Line(keyword).add(node.id).add().add(node.lx).add(node.ly).add(node.lz).add(static_cast<int>(node.displacementCS));
+                    cards.card(keyword.c_str()).add(node.id).add().add(node.lx).add(node.ly).add(node.lz).add(static_cast<int>(node.displacementCS));
+                }
+                for (pos_t cellPosition = 0; cellPosition < model->mesh.countCells(); cellPosition++) {
+                    const Cell& cell = model->mesh.findCell(cellPosition);
+                    lines << Line(keyword).add(cell.id).add(cell.type.description).add(cell.nodeIds);
+                    cards.card(keyword.c_str()).add(cell.id).add(cell.type.description).add(cell.nodeIds);
+                }
+            }
+        }
+        BOOST_CHECK_MESSAGE(renumberContinuations(lines.str()) == renumberContinuations(buffered.str()),
+                "CardWriter differs from Line on " + it->path().string());
+    }
+    BOOST_CHECK(deckCount > 0);
+}
+
+
 //____________________________________________________________________________//
@@ -26,6 +26,17 @@ BOOST_AUTO_TEST_CASE(read_tut_01_csv) {
 	unique_ptr<Model> model = make_unique<Model>("tut_01", "", SolverName::CODE_ASTER,
 					params.getModelConfiguration());
 	reader.add_assertions(params, *model);
-	BOOST_CHECK_EQUAL(model->objectives.size(), 126);
+	// displacement assertions are stored as table rows, not as individual objectives
+	BOOST_CHECK_EQUAL(model->objectives.size(), 0);
+	size_t rowCount = 0;
+	for (const auto& objectiveSet : model->objectiveSets) {
+		const auto& table = objectiveSet->nodalDisplacementAssertions;
+		rowCount += table.size();
+		BOOST_CHECK_EQUAL(table.nodeIds.size(), table.size());
+		BOOST_CHECK_EQUAL(table.dofs.size(), table.size());
+		BOOST_CHECK_EQUAL(table.tolerances.size(), table.size());
+		BOOST_CHECK_EQUAL(objectiveSet->getObjectives().size(), table.size());
+	}
+	BOOST_CHECK_EQUAL(rowCount, 126);
 }
 
@@ -15,6 +15,7 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/pointer_cast.hpp>
 #include <boost/assign.hpp>
+#include <fstream>
 #include <string>
 
 using namespace std;
@@ -341,3 +342,184 @@ BOOST_AUTO_TEST_CASE(nastran_f06_vonmises_tetra) {
 	BOOST_CHECK_EQUAL(found, true);
 }
 
+
+BOOST_AUTO_TEST_CASE(nastran_f06_parallel_sections) {
+	// enough sections to be parsed by several threads
+	const fs::path f06Path = fs::temp_directory_path() / fs::unique_path("sections_%%%%%%.f06");
+	{
+		ofstream f06(f06Path.string());
+		for (int step = 1; step <= 100; step++) {
+			if (step != 51) {
+				f06 << "0                                                                            SUBCASE " << 1 + step % 2 << "\n"
+						"0      LOAD STEP =  " << step << ".0\n";
+			}
+			f06 << "                                             D I S P L A C E M E N T   V E C T O R\n"
+					" \n"
+					"      POINT ID.   TYPE          T1             T2             T3             R1             R2             R3\n";
+			for (int nodeId = 1; nodeId <= 3; nodeId++) {
+				f06 << "             " << nodeId << "      G      " << step << ".0E-01  " << nodeId
+						<< ".0E-02   0.0            0.0            0.0            1.0E-13\n";
+			}
+			if (step == 50) {
+				// the lines before ORDER are consumed by the eigenvalue section, not read as context
+				f06 << "                                              R E A L   E I G E N V A L U E S\n"
+						"0      LOAD STEP =  42.0\n"
+						"   MODE    EXTRACTION      EIGENVALUE            RADIANS             CYCLES            GENERALIZED         GENERALIZED\n"
+						"    NO.       ORDER                                                                       MASS              STIFFNESS\n"
+						"        1         1        1.000000E+00        1.000000E+00        1.591549E-01        1.000000E+00        1.000000E+00\n";
+			}
+		}
+	}
+	vector<unique_ptr<Model>> models;
+	for (int threads : {1, 4}) {
+		ConfigurationParameters confParams("inputFile", SolverName::CODE_ASTER, "..", "vega", ".",
+				LogLevel::INFO, ConfigurationParameters::TranslationMode::MODE_STRICT, f06Path, 0.0003,
+				false, false, "", "", false, "lagrangian", 0.0, 0.0, "auto", "systus", {}, "table", 9, "auto",
+				"cosmic95", "mmap", 1, 0, false, threads);
+		unique_ptr<Model> model = make_unique<Model>("mname", "unknown", SolverName::NASTRAN);
+		for (int nodeId = 1; nodeId <= 3; nodeId++) {
+			model->mesh.addNode(nodeId, 2, 3, 4);
+		}
+		model->add(make_shared<LinearMecaStat>(*model, "", 1));
+		model->add(make_shared<LinearMecaStat>(*model, "", 2));
+		F06Parser f06parser;
+		f06parser.add_assertions(confParams, *model);
+		models.push_back(move(model));
+	}
+	fs::remove(f06Path);
+
+	for (int subcase : {1, 2}) {
+		const auto& serial = models[0]->getOrCreateObjectiveSet(subcase, ObjectiveSet::Type::ASSERTION);
+		const auto& parallel = models[1]->getOrCreateObjectiveSet(subcase, ObjectiveSet::Type::ASSERTION);
+		const auto& serialRows = serial->nodalDisplacementAssertions;
+		const auto& parallelRows = parallel->nodalDisplacementAssertions;
+		BOOST_CHECK_EQUAL(serialRows.size(), (subcase == 1 ? 51 : 49) * 3 * 6);
+		BOOST_CHECK(serialRows.nodeIds == parallelRows.nodeIds);
+		BOOST_CHECK(serialRows.dofs == parallelRows.dofs);
+		BOOST_CHECK(serialRows.values == parallelRows.values);
+		BOOST_CHECK(serialRows.instants == parallelRows.instants);
+		BOOST_CHECK_EQUAL(serial->getIndividualObjectives().size(), parallel->getIndividualObjectives().size());
+	}
+	// the step following the eigenvalues (without header) keeps the load step of the previous one
+	const auto& rows = models[1]->getOrCreateObjectiveSet(1, ObjectiveSet::Type::ASSERTION)->nodalDisplacementAssertions;
+	BOOST_CHECK_EQUAL(rows.instants[25 * 18], 50.0);
+	BOOST_CHECK_EQUAL(rows.values[25 * 18], 5.1);
+	BOOST_CHECK_EQUAL(rows.values[25 * 18 + 5], 0.0);
+	BOOST_CHECK_EQUAL(models[1]->getOrCreateObjectiveSet(1, ObjectiveSet::Type::ASSERTION)->getIndividualObjectives().size(), 1);
+}
+
+namespace {
+
+void writeDisplacementSection(ostream& f06, double value) {
+	f06 << "                                             D I S P L A C E M E N T   V E C T O R\n"
+			" \n"
+			"      POINT ID.   TYPE          T1             T2             T3             R1             R2             R3\n"
+			"             1      G      " << value << "  0.0            0.0            0.0            0.0            0.0\n";
+}
+
+unique_ptr<Model> parseF06(const string& content) {
+	const fs::path f06Path = fs::temp_directory_path() / fs::unique_path("context_%%%%%%.f06");
+	{
+		ofstream f06(f06Path.string());
+		f06 << content;
+	}
+	ConfigurationParameters confParams("inputFile", SolverName::CODE_ASTER, "..", "vega", ".",
+			LogLevel::INFO, ConfigurationParameters::TranslationMode::MODE_STRICT, f06Path, 0.0003);
+	unique_ptr<Model> model = make_unique<Model>("mname", "unknown", SolverName::NASTRAN);
+	model->mesh.addNode(1, 2, 3, 4);
+	model->add(make_shared<LinearMecaStat>(*model, "", 1));
+	model->add(make_shared<LinearMecaStat>(*model, "", 2));
+	F06Parser f06parser;
+	f06parser.add_assertions(confParams, *model);
+	fs::remove(f06Path);
+	return model;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(f06_subcase_kept_after_section) {
+	// the second section has no SUBCASE header: it belongs to the subcase of the first one
+	ostringstream f06;
+	f06 << "0                                                                            SUBCASE 2\n";
+	writeDisplacementSection(f06, 1.0);
+	f06 << "1    MSC.NASTRAN JOB                                                         PAGE     2\n";
+	writeDisplacementSection(f06, 2.0);
+	unique_ptr<Model> model = parseF06(f06.str());
+	const auto& rows1 = model->getOrCreateObjectiveSet(1, ObjectiveSet::Type::ASSERTION)->nodalDisplacementAssertions;
+	const auto& rows2 = model->getOrCreateObjectiveSet(2, ObjectiveSet::Type::ASSERTION)->nodalDisplacementAssertions;
+	BOOST_CHECK_EQUAL(rows1.size(), 0);
+	BOOST_REQUIRE_EQUAL(rows2.size(), 2 * 6);
+	BOOST_CHECK_EQUAL(rows2.values[0], 1.0);
+	BOOST_CHECK_EQUAL(rows2.values[6], 2.0);
+}
+
+BOOST_AUTO_TEST_CASE(f06_unreadable_label_keeps_value) {
+	// an unreadable LOAD STEP leaves the previous one, it is not read as 0
+	ostringstream f06;
+	f06 << "0                                                                            SUBCASE 1\n"
+			"0      LOAD STEP =  2.0\n";
+	writeDisplacementSection(f06, 1.0);
+	f06 << "0      LOAD STEP =  ******\n";
+	writeDisplacementSection(f06, 2.0);
+	unique_ptr<Model> model = parseF06(f06.str());
+	const auto& rows = model->getOrCreateObjectiveSet(1, ObjectiveSet::Type::ASSERTION)->nodalDisplacementAssertions;
+	BOOST_REQUIRE_EQUAL(rows.size(), 2 * 6);
+	BOOST_CHECK_EQUAL(rows.instants[0], 2.0);
+	BOOST_CHECK_EQUAL(rows.instants[6], 2.0);
+	BOOST_CHECK_EQUAL(rows.values[6], 2.0);
+}
+
+BOOST_AUTO_TEST_CASE(f06_unknown_node_reported) {
+	ostringstream f06;
+	f06 << "0                                                                            SUBCASE 1\n"
+			"                                             D I S P L A C E M E N T   V E C T O R\n"
+			" \n"
+			"      POINT ID.   TYPE          T1             T2             T3             R1             R2             R3\n"
+			"            77      G      1.0  0.0            0.0            0.0            0.0            0.0\n";
+	BOOST_CHECK_EXCEPTION(parseF06(f06.str()), invalid_argument, [](const invalid_argument& e) {
+		return string(e.what()) == "Node id 77 not found.";
+	});
+}
+
+BOOST_AUTO_TEST_CASE(f06_scanner) {
+	using vega::result::F06Line;
+	using vega::result::F06Scanner;
+	// a block smaller than the lines forces refills and buffer growth
+	istringstream input("0          SUBCASE 1\n"
+			"   \n"
+			"\n"
+			"      POINT ID.   TYPE          T1\n"
+			"             3      G      4.901961E-01  -1.5E-02\r\n"
+			"1    LAST LINE WITHOUT END OF LINE");
+	F06Scanner scanner(input, 7);
+	F06Line line;
+	BOOST_CHECK(scanner.peekLine(line));
+	BOOST_CHECK(line.contains("SUBCASE"));
+	BOOST_CHECK_EQUAL(scanner.lineNumber, 0);
+	BOOST_CHECK(scanner.readLine(line));
+	BOOST_CHECK_EQUAL(line.str(), "0          SUBCASE 1");
+	BOOST_CHECK_EQUAL(scanner.lineNumber, 1);
+
+	// blank lines are skipped but counted
+	BOOST_CHECK(scanner.readLine(line));
+	BOOST_CHECK_EQUAL(scanner.lineNumber, 4);
+	BOOST_CHECK(line.trimmed() == "POINT ID.   TYPE          T1");
+	BOOST_CHECK_EQUAL(line.find("TYPE"), 18);
+	BOOST_CHECK_EQUAL(line.find("T2"), string::npos);
+
+	BOOST_CHECK(scanner.readLine(line));
+	vector<F06Line> tokens;
+	BOOST_CHECK_EQUAL(line.split(tokens), 4);
+	BOOST_CHECK_EQUAL(tokens[0].toInt(), 3);
+	BOOST_CHECK(tokens[1] == "G");
+	BOOST_CHECK_EQUAL(tokens[2].toDouble(), 4.901961E-01);
+	BOOST_CHECK_EQUAL(tokens[3].toDouble(), -1.5E-02);
+	BOOST_CHECK_THROW(tokens[1].toInt(), invalid_argument);
+
+	BOOST_CHECK(scanner.readLine(line));
+	BOOST_CHECK_EQUAL(line.str(), "1    LAST LINE WITHOUT END OF LINE");
+	BOOST_CHECK_EQUAL(line.front(), '1');
+	BOOST_CHECK(not scanner.peekLine(line));
+	BOOST_CHECK(not scanner.readLine(line));
+	BOOST_CHECK_EQUAL(scanner.lineNumber, 6);
+}